@@ -15,10 +15,11 @@ static muggle_thread_ret_t alloc_thread(void *p_arg)
 	void **data_container = args->data_container;
 
 	fn_alloc cb_alloc = args->cb_alloc;
-	void *allocator = args->allocator;
+	void *allocator = args->cb_thread_init ? args->cb_thread_init(args->allocator) : args->allocator;
 	muggle_atomic_int *alloc_cursor = &args->alloc_cursor;
 	muggle_atomic_int *fetch_cursor = &args->fetch_cursor;
 	size_t data_size = args->data_size;
+	size_t *data_sizes = args->data_sizes;
 
 	muggle_atomic_int idx;
 	void *data = NULL;
@@ -34,7 +35,7 @@ static muggle_thread_ret_t alloc_thread(void *p_arg)
 		while (1)
 		{
 			timespec_get(&blocks[idx].ts[0], TIME_UTC);
-			data = cb_alloc(allocator, data_size);
+			data = cb_alloc(allocator, data_sizes ? data_sizes[idx] : data_size);
 			timespec_get(&blocks[idx].ts[1], TIME_UTC);
 
 			if (data)
@@ -63,6 +64,11 @@ static muggle_thread_ret_t alloc_thread(void *p_arg)
 
 	MUGGLE_LOG_INFO("allocate thread exit, allocate cnt: %d", cnt);
 
+	if (args->cb_thread_exit)
+	{
+		args->cb_thread_exit(allocator);
+	}
+
 	return 0;
 }
 
@@ -74,7 +80,7 @@ static muggle_thread_ret_t free_thread(void *p_arg)
 	void **data_container = args->data_container;
 
 	fn_free cb_free = args->cb_free;
-	void *allocator = args->allocator;
+	void *allocator = args->cb_thread_init ? args->cb_thread_init(args->allocator) : args->allocator;
 	muggle_atomic_int *free_cursor = &args->free_cursor;
 	muggle_atomic_int *alloc_cursor = &args->alloc_cursor;
 
@@ -107,6 +113,11 @@ static muggle_thread_ret_t free_thread(void *p_arg)
 
 	MUGGLE_LOG_INFO("free thread exit, free cnt: %d", cnt);
 
+	if (args->cb_thread_exit)
+	{
+		args->cb_thread_exit(allocator);
+	}
+
 	return 0;
 }
 
@@ -117,7 +128,7 @@ void run_alloc_free_benchmark(const char *name, struct alloc_free_args *args)
 		args->cnt_blocks <= 0 ||
 		args->blocks == NULL ||
 		args->data_container == NULL ||
-		args->data_size <= 0 ||
+		(args->data_size <= 0 && args->data_sizes == NULL) ||
 		args->cb_alloc == NULL ||
 		args->cb_free == NULL)
 	{
@@ -139,6 +150,9 @@ void run_alloc_free_benchmark(const char *name, struct alloc_free_args *args)
 	args->alloc_cursor = 0;
 	args->free_cursor = 0;
 
+	struct timespec ts_begin, ts_end;
+	timespec_get(&ts_begin, TIME_UTC);
+
 	if (args->num_alloc_threads == 0 || args->num_free_threads == 0)
 	{
 		MUGGLE_LOG_INFO("start %s allocate", name);
@@ -182,6 +196,9 @@ void run_alloc_free_benchmark(const char *name, struct alloc_free_args *args)
 		free(free_threads);
 	}
 
+	timespec_get(&ts_end, TIME_UTC);
+	args->elapsed_ns = (uint64_t)(ts_end.tv_sec - ts_begin.tv_sec) * 1000000000 + ts_end.tv_nsec - ts_begin.tv_nsec;
+
 	// gen report
 	MUGGLE_LOG_INFO("start gen report for benchmark %s", name);
 	gen_benchmark_report(name, args->blocks, args->cfg, args->cnt_blocks);
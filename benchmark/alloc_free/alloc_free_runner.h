@@ -12,6 +12,8 @@
 
 typedef void* (*fn_alloc)(void *allocator, size_t size);
 typedef void (*fn_free)(void *allocator, void *data);
+typedef void* (*fn_thread_init)(void *allocator);
+typedef void (*fn_thread_exit)(void *thread_allocator);
 
 struct alloc_free_args
 {
@@ -27,11 +29,16 @@ struct alloc_free_args
 
 	void                     *allocator;
 	size_t                   data_size;
+	size_t                   *data_sizes;    // optional, size of every block for mixed size workload, override data_size
 	fn_alloc                 cb_alloc;
 	fn_free                  cb_free;
+	fn_thread_init           cb_thread_init; // optional, return per thread allocator for cb_alloc and cb_free
+	fn_thread_exit           cb_thread_exit; // optional, release per thread allocator
 
 	int                      num_alloc_threads;
 	int                      num_free_threads;
+
+	uint64_t                 elapsed_ns;     // output, elapsed of all alloc and free
 };
 
 void run_alloc_free_benchmark(const char *name, struct alloc_free_args *args);
@@ -10,6 +10,7 @@
 #include "benchmark_memory_pool.h"
 #include "benchmark_sowr_memory_pool.h"
 #include "benchmark_ts_memory_pool.h"
+#include "benchmark_slab_allocator.h"
 
 int main(int argc, char *argv[])
 {
@@ -272,5 +273,11 @@ int main(int argc, char *argv[])
 		muggle_ts_memory_pool_destroy(&pool);
 	}
 
+	// cross thread alloc/free matrix
+	run_ts_memory_pool_matrix(&args, alloc_free_num, mul_thread_pool_capacity, 512);
+
+	// mixed size workload
+	run_slab_allocator_mixed(&args, alloc_free_num, 0);
+
 	return 0;
 }
@@ -0,0 +1,155 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "benchmark_slab_allocator.h"
+#include "benchmark_malloc_free.h"
+
+void* run_slab_allocator_alloc(void *allocator, size_t size)
+{
+	return muggle_slab_allocator_alloc((muggle_slab_allocator_t*)allocator, size);
+}
+
+void run_slab_allocator_free(void *allocator, void *data)
+{
+	muggle_slab_allocator_free((muggle_slab_allocator_t*)allocator, data);
+}
+
+/*
+ * deterministic mixed sizes, every run use the same sequence
+ * - 1/64 of blocks are large object in (64K, 256K]
+ * - others are log uniform in [16, 4096]
+ */
+static void gen_mixed_sizes(size_t *data_sizes, int cnt)
+{
+	uint32_t seed = 20211017;
+	for (int i = 0; i < cnt; i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		uint32_t r = seed >> 8;
+		if ((r & 0x3f) == 0)
+		{
+			data_sizes[i] = MUGGLE_SLAB_ALLOCATOR_MAX_SIZE + 1 + (r >> 6) % (3 * MUGGLE_SLAB_ALLOCATOR_MAX_SIZE);
+		}
+		else
+		{
+			// 2^4 ~ 2^12
+			size_t base = (size_t)1 << (4 + (r >> 6) % 8);
+			data_sizes[i] = base + (r >> 9) % base;
+		}
+	}
+}
+
+enum
+{
+	MIXED_ALLOCATOR_MALLOC = 0,
+	MIXED_ALLOCATOR_SLAB,
+	MIXED_ALLOCATOR_TS_SLAB,
+	MIXED_ALLOCATOR_MAX,
+};
+
+void run_slab_allocator_mixed(struct alloc_free_args *args, int alloc_free_num, size_t class_bytes)
+{
+	const char *allocator_names[MIXED_ALLOCATOR_MAX] = { "malloc", "slab", "ts_slab" };
+	int num_threads[] = { 0, 1, 2 };
+	const int cnt_num_threads = (int)(sizeof(num_threads) / sizeof(num_threads[0]));
+
+	size_t *data_sizes = (size_t*)malloc(sizeof(size_t) * alloc_free_num);
+	gen_mixed_sizes(data_sizes, alloc_free_num);
+
+	// operations per millisecond
+	double ops[MIXED_ALLOCATOR_MAX][sizeof(num_threads) / sizeof(num_threads[0])];
+	char name[64];
+
+	for (int k = 0; k < MIXED_ALLOCATOR_MAX; k++)
+	{
+		for (int i = 0; i < cnt_num_threads; i++)
+		{
+			ops[k][i] = 0.0;
+
+			// single thread slab allocator only run alloc and free in same thread
+			if (k == MIXED_ALLOCATOR_SLAB && num_threads[i] != 0)
+			{
+				continue;
+			}
+
+			muggle_slab_allocator_t slab;
+
+			MUGGLE_LOG_INFO("=======================================================");
+			snprintf(name, sizeof(name), "mixed_%s_alloc_%d_free_%d_%d",
+				allocator_names[k], num_threads[i], num_threads[i], alloc_free_num);
+
+			args->cnt_blocks = alloc_free_num;
+			args->data_size = 0;
+			args->data_sizes = data_sizes;
+			args->num_alloc_threads = num_threads[i];
+			args->num_free_threads = num_threads[i];
+			args->cb_thread_init = NULL;
+			args->cb_thread_exit = NULL;
+			switch (k)
+			{
+				case MIXED_ALLOCATOR_MALLOC:
+				{
+					args->allocator = NULL;
+					args->cb_alloc = run_malloc;
+					args->cb_free = run_free;
+				}break;
+				case MIXED_ALLOCATOR_SLAB:
+				{
+					muggle_slab_allocator_init(&slab, MUGGLE_SLAB_ALLOCATOR_FLAG_STATS, class_bytes);
+					args->allocator = &slab;
+					args->cb_alloc = run_slab_allocator_alloc;
+					args->cb_free = run_slab_allocator_free;
+				}break;
+				case MIXED_ALLOCATOR_TS_SLAB:
+				{
+					muggle_slab_allocator_init(&slab,
+						MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE | MUGGLE_SLAB_ALLOCATOR_FLAG_STATS, class_bytes);
+					args->allocator = &slab;
+					args->cb_alloc = run_slab_allocator_alloc;
+					args->cb_free = run_slab_allocator_free;
+				}break;
+			}
+
+			run_alloc_free_benchmark(name, args);
+
+			ops[k][i] = (double)alloc_free_num / ((double)args->elapsed_ns / 1000000.0);
+
+			if (k != MIXED_ALLOCATOR_MALLOC)
+			{
+				MUGGLE_LOG_INFO("%s class statistics: size | capacity | alloc | free | fallback", name);
+				for (int c = 0; c <= MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS; c++)
+				{
+					muggle_slab_class_stats_t stats;
+					muggle_slab_allocator_get_stats(&slab, c, &stats);
+					MUGGLE_LOG_INFO("%6llu | %6llu | %8llu | %8llu | %8llu",
+						(unsigned long long)stats.size,
+						(unsigned long long)stats.capacity,
+						(unsigned long long)stats.cnt_alloc,
+						(unsigned long long)stats.cnt_free,
+						(unsigned long long)stats.cnt_fallback);
+				}
+				muggle_slab_allocator_destroy(&slab);
+			}
+		}
+	}
+	args->data_sizes = NULL;
+
+	MUGGLE_LOG_INFO("=======================================================");
+	MUGGLE_LOG_INFO("mixed size alloc/free per ms, column: same thread, 1x1 threads, 2x2 threads");
+	for (int k = 0; k < MIXED_ALLOCATOR_MAX; k++)
+	{
+		char line[256];
+		int offset = snprintf(line, sizeof(line), "%8s |", allocator_names[k]);
+		for (int i = 0; i < cnt_num_threads; i++)
+		{
+			offset += snprintf(line + offset, sizeof(line) - offset, " %10.1f", ops[k][i]);
+		}
+		MUGGLE_LOG_INFO("%s", line);
+	}
+
+	free(data_sizes);
+}
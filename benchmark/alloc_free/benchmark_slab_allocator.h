@@ -0,0 +1,24 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#ifndef BENCHMARK_SLAB_ALLOCATOR_H_
+#define BENCHMARK_SLAB_ALLOCATOR_H_
+
+#include "alloc_free_runner.h"
+
+void* run_slab_allocator_alloc(void *allocator, size_t size);
+
+void run_slab_allocator_free(void *allocator, void *data);
+
+/**
+ * mixed size workload of malloc and slab allocator, block sizes are log
+ * uniform in [16, 4096] with a few large objects, print throughput and
+ * per class statistics at the end
+ */
+void run_slab_allocator_mixed(struct alloc_free_args *args, int alloc_free_num, size_t class_bytes);
+
+#endif
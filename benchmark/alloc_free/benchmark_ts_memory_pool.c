@@ -6,6 +6,7 @@
  */
 
 #include "benchmark_ts_memory_pool.h"
+#include "benchmark_malloc_free.h"
 
 void* run_ts_memory_pool_alloc(void *allocator, size_t size)
 {
@@ -17,3 +18,147 @@ void run_ts_memory_pool_free(void *allocator, void *data)
 {
 	muggle_ts_memory_pool_free(data);
 }
+
+void* run_tc_memory_pool_thread_init(void *allocator)
+{
+	muggle_tc_memory_pool_t *pool = (muggle_tc_memory_pool_t*)allocator;
+	muggle_tc_memory_pool_cache_t *cache = (muggle_tc_memory_pool_cache_t*)malloc(sizeof(muggle_tc_memory_pool_cache_t));
+	muggle_tc_memory_pool_cache_init(cache, pool);
+	return cache;
+}
+
+void run_tc_memory_pool_thread_exit(void *thread_allocator)
+{
+	muggle_tc_memory_pool_cache_t *cache = (muggle_tc_memory_pool_cache_t*)thread_allocator;
+	muggle_tc_memory_pool_cache_destroy(cache);
+
+	if (cache->cnt_alloc > 0)
+	{
+		MUGGLE_LOG_INFO("tc cache alloc: %llu, hit rate: %.2f%%, refill batch: %llu",
+			(unsigned long long)cache->cnt_alloc,
+			100.0 * (double)cache->cnt_alloc_hit / (double)cache->cnt_alloc,
+			(unsigned long long)cache->cnt_refill);
+	}
+	if (cache->cnt_free > 0)
+	{
+		MUGGLE_LOG_INFO("tc cache free: %llu, hit rate: %.2f%%, flush batch: %llu",
+			(unsigned long long)cache->cnt_free,
+			100.0 * (double)cache->cnt_free_hit / (double)cache->cnt_free,
+			(unsigned long long)cache->cnt_flush);
+	}
+
+	free(cache);
+}
+
+void* run_tc_memory_pool_alloc(void *allocator, size_t size)
+{
+	(void)size;
+
+	muggle_tc_memory_pool_cache_t *cache = (muggle_tc_memory_pool_cache_t*)allocator;
+	return muggle_tc_memory_pool_alloc(cache);
+}
+
+void run_tc_memory_pool_free(void *allocator, void *data)
+{
+	muggle_tc_memory_pool_cache_t *cache = (muggle_tc_memory_pool_cache_t*)allocator;
+	muggle_tc_memory_pool_free(cache, data);
+}
+
+enum
+{
+	MATRIX_ALLOCATOR_MALLOC = 0,
+	MATRIX_ALLOCATOR_TS,
+	MATRIX_ALLOCATOR_TC,
+	MATRIX_ALLOCATOR_MAX,
+};
+
+void run_ts_memory_pool_matrix(struct alloc_free_args *args, int alloc_free_num, int pool_capacity, int data_size)
+{
+	const char *allocator_names[MATRIX_ALLOCATOR_MAX] = { "malloc", "ts", "tc" };
+	int num_threads[] = { 1, 2, 4, 8 };
+	const int cnt_num_threads = (int)(sizeof(num_threads) / sizeof(num_threads[0]));
+
+	// operations per millisecond
+	double ops[MATRIX_ALLOCATOR_MAX][sizeof(num_threads) / sizeof(num_threads[0])][sizeof(num_threads) / sizeof(num_threads[0])];
+	char name[64];
+
+	for (int k = 0; k < MATRIX_ALLOCATOR_MAX; k++)
+	{
+		for (int i = 0; i < cnt_num_threads; i++)
+		{
+			for (int j = 0; j < cnt_num_threads; j++)
+			{
+				muggle_ts_memory_pool_t ts_pool;
+				muggle_tc_memory_pool_t tc_pool;
+
+				MUGGLE_LOG_INFO("=======================================================");
+				snprintf(name, sizeof(name), "matrix_%s_alloc_%d_free_%d_%d_%dbyte",
+					allocator_names[k], num_threads[i], num_threads[j], alloc_free_num, data_size);
+
+				args->cnt_blocks = alloc_free_num;
+				args->data_size = data_size;
+				args->num_alloc_threads = num_threads[i];
+				args->num_free_threads = num_threads[j];
+				args->cb_thread_init = NULL;
+				args->cb_thread_exit = NULL;
+				switch (k)
+				{
+					case MATRIX_ALLOCATOR_MALLOC:
+					{
+						args->allocator = NULL;
+						args->cb_alloc = run_malloc;
+						args->cb_free = run_free;
+					}break;
+					case MATRIX_ALLOCATOR_TS:
+					{
+						muggle_ts_memory_pool_init(&ts_pool, pool_capacity, data_size);
+						args->allocator = &ts_pool;
+						args->cb_alloc = run_ts_memory_pool_alloc;
+						args->cb_free = run_ts_memory_pool_free;
+					}break;
+					case MATRIX_ALLOCATOR_TC:
+					{
+						muggle_tc_memory_pool_init(&tc_pool, pool_capacity, data_size, 0);
+						args->allocator = &tc_pool;
+						args->cb_alloc = run_tc_memory_pool_alloc;
+						args->cb_free = run_tc_memory_pool_free;
+						args->cb_thread_init = run_tc_memory_pool_thread_init;
+						args->cb_thread_exit = run_tc_memory_pool_thread_exit;
+					}break;
+				}
+
+				run_alloc_free_benchmark(name, args);
+
+				ops[k][i][j] = (double)alloc_free_num / ((double)args->elapsed_ns / 1000000.0);
+
+				if (k == MATRIX_ALLOCATOR_TS)
+				{
+					muggle_ts_memory_pool_destroy(&ts_pool);
+				}
+				else if (k == MATRIX_ALLOCATOR_TC)
+				{
+					muggle_tc_memory_pool_destroy(&tc_pool);
+				}
+			}
+		}
+	}
+	args->cb_thread_init = NULL;
+	args->cb_thread_exit = NULL;
+
+	// print scalability table
+	for (int k = 0; k < MATRIX_ALLOCATOR_MAX; k++)
+	{
+		MUGGLE_LOG_INFO("=======================================================");
+		MUGGLE_LOG_INFO("%s alloc/free per ms, row: alloc threads, column: free threads", allocator_names[k]);
+		for (int i = 0; i < cnt_num_threads; i++)
+		{
+			char line[256];
+			int offset = snprintf(line, sizeof(line), "%d |", num_threads[i]);
+			for (int j = 0; j < cnt_num_threads; j++)
+			{
+				offset += snprintf(line + offset, sizeof(line) - offset, " %10.1f", ops[k][i][j]);
+			}
+			MUGGLE_LOG_INFO("%s", line);
+		}
+	}
+}
@@ -14,4 +14,18 @@ void* run_ts_memory_pool_alloc(void *allocator, size_t size);
 
 void run_ts_memory_pool_free(void *allocator, void *data);
 
+void* run_tc_memory_pool_thread_init(void *allocator);
+
+void run_tc_memory_pool_thread_exit(void *thread_allocator);
+
+void* run_tc_memory_pool_alloc(void *allocator, size_t size);
+
+void run_tc_memory_pool_free(void *allocator, void *data);
+
+/**
+ * alloc threads x free threads matrix of malloc, ts_memory_pool and
+ * tc_memory_pool, print throughput table at the end
+ */
+void run_ts_memory_pool_matrix(struct alloc_free_args *args, int alloc_free_num, int pool_capacity, int data_size);
+
 #endif
@@ -0,0 +1,330 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "muggle_benchmark/muggle_benchmark.h"
+
+#define RING_SLOT_NUM (1024 * 16)
+#define END_MSG_IDX UINT64_MAX
+
+typedef struct bench_msg
+{
+	uint64_t idx;
+	char payload[1];
+}bench_msg_t;
+
+struct consumer_thread_args
+{
+	muggle_byte_ring_t *byte_ring;
+	muggle_ring_buffer_t *ring;
+	muggle_atomic_int *consumer_ready;
+	muggle_benchmark_block_t *blocks;
+	uint64_t read_num;
+};
+
+struct producer_thread_args
+{
+	muggle_byte_ring_t *byte_ring;
+	muggle_ring_buffer_t *ring;
+	muggle_benchmark_config_t *config;
+	muggle_benchmark_block_t *blocks;
+	muggle_atomic_int *consumer_ready;
+	int msg_size;
+	muggle_atomic_int pool_size;
+	uint64_t start_idx;
+	uint64_t end_idx;
+};
+
+static void fill_msg(bench_msg_t *msg, uint64_t idx, int msg_size)
+{
+	msg->idx = idx;
+	memset(msg->payload, (int)(idx & 0xff), msg_size - sizeof(uint64_t));
+}
+
+/*
+ * byte ring: messages are written in place
+ */
+muggle_thread_ret_t byte_ring_consumer(void *void_arg)
+{
+	struct consumer_thread_args *arg = (struct consumer_thread_args*)void_arg;
+
+	muggle_atomic_fetch_add(arg->consumer_ready, 1, muggle_memory_order_relaxed);
+	uint64_t cnt = 0;
+	while (1)
+	{
+		int num_bytes = 0;
+		bench_msg_t *msg = (bench_msg_t*)muggle_byte_ring_reader_wait(arg->byte_ring, &num_bytes);
+		uint64_t idx = msg->idx;
+		if (idx == END_MSG_IDX)
+		{
+			muggle_byte_ring_reader_move(arg->byte_ring, msg);
+			break;
+		}
+
+		timespec_get(&arg->blocks[idx].ts[2], TIME_UTC);
+		muggle_byte_ring_reader_move(arg->byte_ring, msg);
+
+		++cnt;
+	}
+	arg->read_num = cnt;
+
+	return 0;
+}
+
+muggle_thread_ret_t byte_ring_producer(void *void_arg)
+{
+	struct producer_thread_args *arg = (struct producer_thread_args*)void_arg;
+
+	while (muggle_atomic_load(arg->consumer_ready, muggle_memory_order_relaxed) != 1);
+
+	for (uint64_t i = 0; i < arg->config->loop; ++i)
+	{
+		for (uint64_t j = arg->start_idx; j < arg->end_idx; ++j)
+		{
+			uint64_t idx = i * arg->config->cnt_per_loop + j;
+			memset(&arg->blocks[idx], 0, sizeof(muggle_benchmark_block_t));
+			arg->blocks[idx].idx = idx;
+
+			timespec_get(&arg->blocks[idx].ts[0], TIME_UTC);
+			bench_msg_t *msg = NULL;
+			while ((msg = (bench_msg_t*)muggle_byte_ring_writer_reserve(arg->byte_ring, arg->msg_size)) == NULL)
+			{
+				muggle_thread_yield();
+			}
+			fill_msg(msg, idx, arg->msg_size);
+			muggle_byte_ring_writer_commit(arg->byte_ring, msg);
+			timespec_get(&arg->blocks[idx].ts[1], TIME_UTC);
+		}
+		if (arg->config->loop_interval_ms > 0)
+		{
+			muggle_msleep((unsigned int)arg->config->loop_interval_ms);
+		}
+	}
+
+	free(arg);
+	return 0;
+}
+
+/*
+ * pointer ring: messages are allocated from producer's sowr memory pool
+ */
+muggle_thread_ret_t ring_consumer(void *void_arg)
+{
+	struct consumer_thread_args *arg = (struct consumer_thread_args*)void_arg;
+
+	muggle_atomic_fetch_add(arg->consumer_ready, 1, muggle_memory_order_relaxed);
+	muggle_atomic_int pos = 0;
+	uint64_t cnt = 0;
+	while (1)
+	{
+		bench_msg_t *msg = (bench_msg_t*)muggle_ring_buffer_read(arg->ring, pos++);
+		if (!msg)
+		{
+			break;
+		}
+
+		timespec_get(&arg->blocks[msg->idx].ts[2], TIME_UTC);
+		muggle_sowr_memory_pool_free(msg);
+
+		++cnt;
+	}
+	arg->read_num = cnt;
+
+	return 0;
+}
+
+muggle_thread_ret_t ring_producer(void *void_arg)
+{
+	struct producer_thread_args *arg = (struct producer_thread_args*)void_arg;
+
+	while (muggle_atomic_load(arg->consumer_ready, muggle_memory_order_relaxed) != 1);
+
+	// total number of in-flight messages is limited by pool size, so ring
+	// buffer never overwrite unread message
+	muggle_sowr_memory_pool_t pool;
+	muggle_sowr_memory_pool_init(&pool, arg->pool_size, arg->msg_size);
+
+	for (uint64_t i = 0; i < arg->config->loop; ++i)
+	{
+		for (uint64_t j = arg->start_idx; j < arg->end_idx; ++j)
+		{
+			uint64_t idx = i * arg->config->cnt_per_loop + j;
+			memset(&arg->blocks[idx], 0, sizeof(muggle_benchmark_block_t));
+			arg->blocks[idx].idx = idx;
+
+			timespec_get(&arg->blocks[idx].ts[0], TIME_UTC);
+			bench_msg_t *msg = NULL;
+			while ((msg = (bench_msg_t*)muggle_sowr_memory_pool_alloc(&pool)) == NULL)
+			{
+				muggle_thread_yield();
+			}
+			fill_msg(msg, idx, arg->msg_size);
+			muggle_ring_buffer_write(arg->ring, msg);
+			timespec_get(&arg->blocks[idx].ts[1], TIME_UTC);
+		}
+		if (arg->config->loop_interval_ms > 0)
+		{
+			muggle_msleep((unsigned int)arg->config->loop_interval_ms);
+		}
+	}
+
+	while (!muggle_sowr_memory_pool_is_all_free(&pool))
+	{
+		muggle_msleep((unsigned int)1);
+	}
+	muggle_sowr_memory_pool_destroy(&pool);
+
+	free(arg);
+	return 0;
+}
+
+void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer, int msg_size, int use_byte_ring)
+{
+	uint64_t cnt = config->loop * config->cnt_per_loop;
+	muggle_benchmark_block_t *blocks = (muggle_benchmark_block_t*)malloc(cnt * sizeof(muggle_benchmark_block_t));
+	muggle_atomic_int consumer_ready = 0;
+
+	muggle_byte_ring_t byte_ring;
+	muggle_ring_buffer_t ring;
+	if (use_byte_ring)
+	{
+		int flags = cnt_producer == 1 ? MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER : MUGGLE_BYTE_RING_FLAG_MULTI_WRITER;
+		muggle_byte_ring_init(&byte_ring, RING_SLOT_NUM * (msg_size + 8), flags);
+	}
+	else
+	{
+		int flags = MUGGLE_RING_BUFFER_FLAG_SINGLE_READER;
+		if (cnt_producer == 1)
+		{
+			flags |= MUGGLE_RING_BUFFER_FLAG_SINGLE_WRITER;
+		}
+		muggle_ring_buffer_init(&ring, RING_SLOT_NUM, flags);
+	}
+
+	// consumer
+	muggle_thread_t consumer;
+	struct consumer_thread_args consumer_args;
+	memset(&consumer_args, 0, sizeof(consumer_args));
+	consumer_args.byte_ring = &byte_ring;
+	consumer_args.ring = &ring;
+	consumer_args.consumer_ready = &consumer_ready;
+	consumer_args.blocks = blocks;
+	muggle_thread_create(&consumer, use_byte_ring ? byte_ring_consumer : ring_consumer, &consumer_args);
+
+	// producer
+	muggle_thread_t *producers = (muggle_thread_t*)malloc(cnt_producer * sizeof(muggle_thread_t));
+	for (int i = 0; i < cnt_producer; ++i)
+	{
+		struct producer_thread_args *producer_args = (struct producer_thread_args*)malloc(sizeof(struct producer_thread_args));
+		producer_args->byte_ring = &byte_ring;
+		producer_args->ring = &ring;
+		producer_args->config = config;
+		producer_args->blocks = blocks;
+		producer_args->consumer_ready = &consumer_ready;
+		producer_args->msg_size = msg_size;
+		producer_args->pool_size = (muggle_atomic_int)(RING_SLOT_NUM / 2 / cnt_producer);
+		producer_args->start_idx = i * (config->cnt_per_loop / cnt_producer);
+		producer_args->end_idx = (i + 1) * (config->cnt_per_loop / cnt_producer);
+		if (i == cnt_producer - 1)
+		{
+			producer_args->end_idx = config->cnt_per_loop;
+		}
+		muggle_thread_create(&producers[i],
+			use_byte_ring ? byte_ring_producer : ring_producer, producer_args);
+	}
+
+	for (int i = 0; i < cnt_producer; ++i)
+	{
+		muggle_thread_join(&producers[i]);
+	}
+
+	if (use_byte_ring)
+	{
+		bench_msg_t *msg = NULL;
+		while ((msg = (bench_msg_t*)muggle_byte_ring_writer_reserve(&byte_ring, sizeof(uint64_t))) == NULL)
+		{
+			muggle_thread_yield();
+		}
+		msg->idx = END_MSG_IDX;
+		muggle_byte_ring_writer_commit(&byte_ring, msg);
+	}
+	else
+	{
+		muggle_ring_buffer_write(&ring, NULL);
+	}
+
+	muggle_thread_join(&consumer);
+
+	free(producers);
+	if (use_byte_ring)
+	{
+		muggle_byte_ring_destroy(&byte_ring);
+	}
+	else
+	{
+		muggle_ring_buffer_destroy(&ring);
+	}
+
+	const char *name = use_byte_ring ? "byte_ring" : "ptr_ring_sowr";
+	printf("%s %dw1r %dB consumer read %llu %s\n",
+		name, cnt_producer, msg_size, (unsigned long long)consumer_args.read_num,
+		consumer_args.read_num == cnt ? "" : "(message loss)");
+
+	char buf[128];
+
+	snprintf(buf, sizeof(buf) - 1, "%s-%dw1r-%dB-write", name, cnt_producer, msg_size);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 1, 0);
+
+	snprintf(buf, sizeof(buf) - 1, "%s-%dw1r-%dB-write-sorted", name, cnt_producer, msg_size);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 1, 1);
+
+	snprintf(buf, sizeof(buf) - 1, "%s-%dw1r-%dB-trans", name, cnt_producer, msg_size);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 2, 0);
+
+	snprintf(buf, sizeof(buf) - 1, "%s-%dw1r-%dB-trans-sorted", name, cnt_producer, msg_size);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 2, 1);
+
+	free(blocks);
+}
+
+int main()
+{
+	muggle_benchmark_config_t config;
+	strncpy(config.name, "byte_ring", sizeof(config.name)-1);
+	config.loop = 50;
+	config.cnt_per_loop = 20000;
+	config.loop_interval_ms = 10;
+	config.report_step = 10;
+	config.elapsed_unit = MUGGLE_BENCHMARK_ELAPSED_UNIT_NS;
+
+	char file_name[128];
+	snprintf(file_name, sizeof(file_name)-1, "benchmark_%s.csv", config.name);
+	FILE *fp = fopen(file_name, "wb");
+	if (fp == NULL)
+	{
+		printf("failed open file: %s\n", file_name);
+		exit(1);
+	}
+
+	muggle_benchmark_gen_reports_head(fp, &config);
+
+	int hc = (int)muggle_thread_hardware_concurrency();
+	printf("hardware_concurrency: %d\n", hc);
+
+	int msg_sizes[] = { 64, 512 };
+	for (size_t i = 0; i < sizeof(msg_sizes) / sizeof(msg_sizes[0]); ++i)
+	{
+		// 1 writer, 1 reader
+		Benchmark_wr(fp, &config, 1, msg_sizes[i], 1);
+		Benchmark_wr(fp, &config, 1, msg_sizes[i], 0);
+
+		// hc writer, 1 reader
+		Benchmark_wr(fp, &config, hc, msg_sizes[i], 1);
+		Benchmark_wr(fp, &config, hc, msg_sizes[i], 0);
+	}
+
+	fclose(fp);
+}
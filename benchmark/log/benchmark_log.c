@@ -0,0 +1,277 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "log_runner.h"
+#include "log_disabled.h"
+#include "log_handlers.h"
+
+#define PARAM_NUM 6
+
+int get_argv(int argc, int idx, char **argv, const char *name, int default_val)
+{
+	int val;
+	if (idx >= PARAM_NUM || idx >= argc || !muggle_str_toi(argv[idx], &val, 10))
+	{
+		MUGGLE_LOG_WARNING("failed get value of %s, use default val: %d", name, default_val);
+		val = default_val;
+	}
+
+	return val;
+}
+
+/**
+ * max_lane > 0 means every producer thread own a single writer lane
+ */
+void run_async_logger(const char *name, struct log_bench_args *args, FILE *fp, bool deferred, int max_lane)
+{
+	null_log_handler_t handler;
+	null_log_handler_init(&handler);
+
+	muggle_async_logger_t async_logger;
+	if (max_lane > 0)
+	{
+		muggle_async_logger_init_lanes(&async_logger, 1024 * 8, max_lane, 1024);
+	}
+	else
+	{
+		muggle_async_logger_init(&async_logger, 1024 * 8);
+	}
+	muggle_async_logger_set_deferred(&async_logger, deferred);
+	muggle_logger_t *logger = (muggle_logger_t*)&async_logger;
+	logger->add_handler(logger, &handler.handler);
+
+	args->logger = logger;
+	args->handler = &handler;
+	run_log_benchmark(name, args, fp);
+
+	logger->destroy(logger);
+	handler.handler.destroy(&handler.handler);
+}
+
+/**
+ * sync logger write into file, compare stdio file handler and memory
+ * mapped file handler
+ */
+void run_file_handlers(struct log_bench_args *args, FILE *fp, int msg_size)
+{
+	char name[64];
+	muggle_sync_logger_t sync_logger;
+	muggle_logger_t *logger = (muggle_logger_t*)&sync_logger;
+	args->logger = logger;
+	args->handler = NULL;
+
+	// file handler
+	{
+		MUGGLE_LOG_INFO("=======================================================");
+		muggle_log_file_handler_t handler;
+		muggle_log_file_handler_init(&handler, "log/benchmark_log_file.log", "wb");
+		muggle_log_handler_set_fmt((muggle_log_handler_t*)&handler, muggle_log_fmt_get_complicated());
+
+		muggle_sync_logger_init(&sync_logger);
+		logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+
+		snprintf(name, sizeof(name), "file_%dw_%dB", args->num_thread, msg_size);
+		run_log_benchmark(name, args, fp);
+
+		logger->destroy(logger);
+		handler.handler.destroy((muggle_log_handler_t*)&handler);
+	}
+
+	// memory mapped file handler
+	{
+		MUGGLE_LOG_INFO("=======================================================");
+		muggle_os_remove("log/benchmark_log_mmap.log");
+		muggle_log_mmap_handler_t handler;
+		if (muggle_log_mmap_handler_init(&handler, "log/benchmark_log_mmap.log",
+				0, 0, 0, MUGGLE_LOG_MMAP_FLAG_SYNC_SHUTDOWN) != 0)
+		{
+			MUGGLE_LOG_WARNING("failed init mmap handler, skip");
+			return;
+		}
+		muggle_log_handler_set_fmt((muggle_log_handler_t*)&handler, muggle_log_fmt_get_complicated());
+
+		muggle_sync_logger_init(&sync_logger);
+		logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+
+		snprintf(name, sizeof(name), "mmap_%dw_%dB", args->num_thread, msg_size);
+		run_log_benchmark(name, args, fp);
+
+		logger->destroy(logger);
+		handler.handler.destroy((muggle_log_handler_t*)&handler);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	// init log
+	if (muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed initalize log");
+		exit(EXIT_FAILURE);
+	}
+
+	// convert input arguments
+	if (argc < PARAM_NUM)
+	{
+		MUGGLE_LOG_WARNING("usage: %s <num-thread> <rounds> <msg-per-round> <msg-size> <handler-rounds>", argv[0]);
+		MUGGLE_LOG_WARNING("missing arguments will use default value");
+	}
+
+	int num_thread = get_argv(argc, 1, argv, "num-thread", 4);
+	int rounds = get_argv(argc, 2, argv, "rounds", 100);
+	int msg_per_round = get_argv(argc, 3, argv, "msg-per-round", 1000);
+	int msg_size = get_argv(argc, 4, argv, "msg-size", 128);
+	int handler_rounds = get_argv(argc, 5, argv, "handler-rounds", 10);
+
+	MUGGLE_LOG_INFO("num_thread: %d", num_thread);
+	MUGGLE_LOG_INFO("rounds: %d", rounds);
+	MUGGLE_LOG_INFO("msg_per_round: %d", msg_per_round);
+	MUGGLE_LOG_INFO("msg_size: %d", msg_size);
+	MUGGLE_LOG_INFO("handler_rounds: %d", handler_rounds);
+
+	muggle_benchmark_config_t benchmark_cfg;
+	memset(&benchmark_cfg, 0, sizeof(benchmark_cfg));
+	strncpy(benchmark_cfg.name, "log", sizeof(benchmark_cfg.name) - 1);
+	benchmark_cfg.loop = rounds;
+	benchmark_cfg.loop_interval_ms = 0;
+	benchmark_cfg.cnt_per_loop = msg_per_round;
+	benchmark_cfg.report_step = 10;
+	benchmark_cfg.elapsed_unit = MUGGLE_BENCHMARK_ELAPSED_UNIT_NS;
+
+	char file_name[128];
+	snprintf(file_name, sizeof(file_name)-1, "benchmark_%s.csv", benchmark_cfg.name);
+	FILE *fp = fopen(file_name, "wb");
+	if (fp == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed open file: %s", file_name);
+		exit(EXIT_FAILURE);
+	}
+	muggle_benchmark_gen_reports_head(fp, &benchmark_cfg);
+
+	// allocate memory
+	uint64_t total_msg_num = (uint64_t)num_thread * rounds * msg_per_round;
+	if (handler_rounds > rounds)
+	{
+		total_msg_num = (uint64_t)num_thread * handler_rounds * msg_per_round;
+	}
+	muggle_benchmark_block_t *blocks =
+		(muggle_benchmark_block_t*)malloc(sizeof(muggle_benchmark_block_t) * total_msg_num);
+
+	char *payload = (char*)malloc(msg_size + 1);
+	memset(payload, 'x', msg_size);
+	payload[msg_size] = '\0';
+
+	struct log_bench_args args;
+	memset(&args, 0, sizeof(args));
+	args.cfg = &benchmark_cfg;
+	args.blocks = blocks;
+	args.num_thread = num_thread;
+	args.payload = payload;
+
+	char name[64];
+
+	// sync logger
+	{
+		MUGGLE_LOG_INFO("=======================================================");
+		null_log_handler_t handler;
+		null_log_handler_init(&handler);
+
+		muggle_sync_logger_t sync_logger;
+		muggle_sync_logger_init(&sync_logger);
+		muggle_logger_t *logger = (muggle_logger_t*)&sync_logger;
+		logger->add_handler(logger, &handler.handler);
+
+		args.logger = logger;
+		args.handler = &handler;
+		snprintf(name, sizeof(name), "sync_%dw_%dB", num_thread, msg_size);
+		run_log_benchmark(name, &args, fp);
+
+		logger->destroy(logger);
+		handler.handler.destroy(&handler.handler);
+	}
+
+	// async logger
+	MUGGLE_LOG_INFO("=======================================================");
+	snprintf(name, sizeof(name), "async_%dw_%dB", num_thread, msg_size);
+	run_async_logger(name, &args, fp, false, 0);
+
+	// async logger, deferred format
+	MUGGLE_LOG_INFO("=======================================================");
+	snprintf(name, sizeof(name), "async_deferred_%dw_%dB", num_thread, msg_size);
+	run_async_logger(name, &args, fp, true, 0);
+
+	// file handlers
+	run_file_handlers(&args, fp, msg_size);
+
+	// disabled level
+	run_log_disabled_benchmark(&benchmark_cfg, blocks, fp);
+
+	// producer scaling, shared channel vs per thread lanes
+	for (int n = 1; ; n *= 2)
+	{
+		if (n > num_thread)
+		{
+			n = num_thread;
+		}
+		args.num_thread = n;
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "scale_async_%dw_%dB", n, msg_size);
+		run_async_logger(name, &args, fp, false, 0);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "scale_async_lanes_%dw_%dB", n, msg_size);
+		run_async_logger(name, &args, fp, false, n);
+
+		if (n == num_thread)
+		{
+			break;
+		}
+	}
+
+	// every handler type, caller latency in cpu cycles and throughput
+	{
+		muggle_benchmark_config_t handlers_cfg;
+		memcpy(&handlers_cfg, &benchmark_cfg, sizeof(handlers_cfg));
+		strncpy(handlers_cfg.name, "log_handlers", sizeof(handlers_cfg.name) - 1);
+		handlers_cfg.loop = handler_rounds;
+		handlers_cfg.elapsed_unit = MUGGLE_BENCHMARK_ELAPSED_UNIT_CPU_CYCLE;
+
+		snprintf(file_name, sizeof(file_name)-1, "benchmark_%s.csv", handlers_cfg.name);
+		FILE *fp_latency = fopen(file_name, "wb");
+		snprintf(file_name, sizeof(file_name)-1, "benchmark_%s_throughput.csv", handlers_cfg.name);
+		FILE *fp_throughput = fopen(file_name, "wb");
+		if (fp_latency && fp_throughput)
+		{
+			muggle_benchmark_gen_reports_head(fp_latency, &handlers_cfg);
+
+			const int msg_sizes[] = { 32, 128, 512 };
+			run_log_handlers_benchmark(&handlers_cfg, blocks, num_thread,
+				msg_sizes, (int)(sizeof(msg_sizes) / sizeof(msg_sizes[0])),
+				fp_latency, fp_throughput);
+		}
+		else
+		{
+			MUGGLE_LOG_ERROR("failed open handlers report files");
+		}
+
+		if (fp_latency)
+		{
+			fclose(fp_latency);
+		}
+		if (fp_throughput)
+		{
+			fclose(fp_throughput);
+		}
+	}
+
+	free(payload);
+	free(blocks);
+	fclose(fp);
+
+	return 0;
+}
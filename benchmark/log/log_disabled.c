@@ -0,0 +1,105 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+// debug and trace are removed at compile time in this file
+#define MUGGLE_LOG_ACTIVE_LEVEL MUGGLE_LOG_ACTIVE_INFO
+#include "log_disabled.h"
+#include "log_runner.h"
+
+static uint64_t s_cnt_eval = 0;
+
+/**
+ * argument of log, count how many times it is evaluated
+ */
+static unsigned long long log_disabled_arg(uint64_t idx)
+{
+	s_cnt_eval++;
+	return (unsigned long long)idx;
+}
+
+enum
+{
+	LOG_DISABLED_CALL = 0,
+	LOG_DISABLED_RUNTIME,
+	LOG_DISABLED_COMPILE,
+};
+
+static void log_disabled_run(
+	const char *name, int mode, muggle_logger_t *logger,
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks, FILE *fp)
+{
+	uint64_t total = cfg->loop * cfg->cnt_per_loop;
+	s_cnt_eval = 0;
+
+	uint64_t idx = 0;
+	for (uint64_t i = 0; i < cfg->loop; i++)
+	{
+		for (uint64_t j = 0; j < cfg->cnt_per_loop; j++)
+		{
+			memset(&blocks[idx], 0, sizeof(blocks[idx]));
+			blocks[idx].idx = idx;
+
+			timespec_get(&blocks[idx].ts[0], TIME_UTC);
+			switch (mode)
+			{
+				case LOG_DISABLED_CALL:
+				{
+					// what MUGGLE_LOG expand to before level check moved into caller
+					muggle_log_src_loc_t loc = { __FILE__, __LINE__, __FUNCTION__ };
+					logger->log(logger, MUGGLE_LOG_LEVEL_INFO, &loc, "%llu", log_disabled_arg(idx));
+				}break;
+				case LOG_DISABLED_RUNTIME:
+				{
+					MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%llu", log_disabled_arg(idx));
+				}break;
+				case LOG_DISABLED_COMPILE:
+				{
+					MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_DEBUG, "%llu", log_disabled_arg(idx));
+				}break;
+			}
+			timespec_get(&blocks[idx].ts[1], TIME_UTC);
+
+			idx++;
+		}
+	}
+
+	MUGGLE_LOG_INFO("%s: %llu calls, arguments evaluated %llu times",
+		name, (unsigned long long)total, (unsigned long long)s_cnt_eval);
+
+	char buf[128];
+	snprintf(buf, sizeof(buf), "%s", name);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, buf, total, 0, 1, 0);
+
+	snprintf(buf, sizeof(buf), "%s-sorted", name);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, buf, total, 0, 1, 1);
+}
+
+void run_log_disabled_benchmark(
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks, FILE *fp)
+{
+	// handler only accept warning and above
+	null_log_handler_t handler;
+	null_log_handler_init(&handler);
+	muggle_log_handler_set_level(&handler.handler, MUGGLE_LOG_LEVEL_WARNING);
+
+	muggle_sync_logger_t sync_logger;
+	muggle_sync_logger_init(&sync_logger);
+	muggle_logger_t *logger = (muggle_logger_t*)&sync_logger;
+	logger->add_handler(logger, &handler.handler);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	log_disabled_run("disabled_call", LOG_DISABLED_CALL, logger, cfg, blocks, fp);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	log_disabled_run("disabled_runtime", LOG_DISABLED_RUNTIME, logger, cfg, blocks, fp);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	log_disabled_run("disabled_compile", LOG_DISABLED_COMPILE, logger, cfg, blocks, fp);
+
+	logger->destroy(logger);
+	handler.handler.destroy(&handler.handler);
+}
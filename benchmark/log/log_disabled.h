@@ -0,0 +1,22 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#ifndef LOG_DISABLED_H_
+#define LOG_DISABLED_H_
+
+#include "muggle_benchmark/muggle_benchmark.h"
+
+/**
+ * cost of log call with disabled level in caller thread
+ *   - call: call logger->log directly, level is checked in callee
+ *   - runtime: MUGGLE_LOG with level lower than handlers
+ *   - compile: MUGGLE_LOG with level lower than MUGGLE_LOG_ACTIVE_LEVEL
+ */
+void run_log_disabled_benchmark(
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks, FILE *fp);
+
+#endif
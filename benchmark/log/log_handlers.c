@@ -0,0 +1,215 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "log_handlers.h"
+
+#if !MUGGLE_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+enum
+{
+	LOG_HANDLER_CONSOLE = 0,
+	LOG_HANDLER_FILE,
+	LOG_HANDLER_ROTATE,
+	LOG_HANDLER_TIME_ROT,
+	MAX_LOG_HANDLER,
+};
+
+static const char *s_log_handler_names[MAX_LOG_HANDLER] = {
+	"console", "file", "rotate", "time_rot",
+};
+
+union log_any_handler
+{
+	muggle_log_console_handler_t       console;
+	muggle_log_file_handler_t          file;
+	muggle_log_file_rotate_handler_t   rotate;
+	muggle_log_file_time_rot_handler_t time_rot;
+};
+
+/**
+ * redirect stdout into /dev/null while console handler is measured, so
+ * terminal speed is not part of result
+ */
+static int s_saved_stdout = -1;
+
+static int log_handlers_mute_stdout()
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	return -1;
+#else
+	int fd = open("/dev/null", O_WRONLY);
+	if (fd == -1)
+	{
+		return -1;
+	}
+
+	fflush(stdout);
+	s_saved_stdout = dup(STDOUT_FILENO);
+	dup2(fd, STDOUT_FILENO);
+	close(fd);
+
+	return 0;
+#endif
+}
+
+static void log_handlers_restore_stdout()
+{
+#if !MUGGLE_PLATFORM_WINDOWS
+	if (s_saved_stdout != -1)
+	{
+		fflush(stdout);
+		dup2(s_saved_stdout, STDOUT_FILENO);
+		close(s_saved_stdout);
+		s_saved_stdout = -1;
+	}
+#endif
+}
+
+static int log_handlers_init(union log_any_handler *handler, int handler_type)
+{
+	int ret = 0;
+	switch (handler_type)
+	{
+		case LOG_HANDLER_CONSOLE:
+		{
+			ret = muggle_log_console_handler_init(&handler->console, 0);
+		}break;
+		case LOG_HANDLER_FILE:
+		{
+			ret = muggle_log_file_handler_init(&handler->file,
+				"log/benchmark_log_handlers_file.log", "wb");
+		}break;
+		case LOG_HANDLER_ROTATE:
+		{
+			ret = muggle_log_file_rotate_handler_init(&handler->rotate,
+				"log/benchmark_log_handlers_rotate.log", 16 * 1024 * 1024, 4);
+		}break;
+		case LOG_HANDLER_TIME_ROT:
+		{
+			ret = muggle_log_file_time_rot_handler_init(&handler->time_rot,
+				"log/benchmark_log_handlers_time_rot.log", MUGGLE_LOG_TIME_ROTATE_UNIT_HOUR, 1, false);
+		}break;
+		default:
+		{
+			ret = MUGGLE_ERR_INVALID_PARAM;
+		}break;
+	}
+
+	if (ret == 0)
+	{
+		muggle_log_handler_set_fmt((muggle_log_handler_t*)handler, muggle_log_fmt_get_complicated());
+	}
+
+	return ret;
+}
+
+static void log_handlers_run_case(
+	struct log_bench_args *args, bool async, int handler_type, int msg_size,
+	FILE *fp_latency, FILE *fp_throughput)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "%s_%s_%dw_%dB",
+		async ? "async" : "sync", s_log_handler_names[handler_type], args->num_thread, msg_size);
+
+	MUGGLE_LOG_INFO("=======================================================");
+
+	union log_any_handler handler;
+	if (log_handlers_init(&handler, handler_type) != 0)
+	{
+		MUGGLE_LOG_WARNING("failed init handler, skip case: %s", name);
+		return;
+	}
+
+	muggle_sync_logger_t sync_logger;
+	muggle_async_logger_t async_logger;
+	muggle_logger_t *logger = NULL;
+	if (async)
+	{
+		muggle_async_logger_init(&async_logger, 1024 * 8);
+		logger = (muggle_logger_t*)&async_logger;
+	}
+	else
+	{
+		muggle_sync_logger_init(&sync_logger);
+		logger = (muggle_logger_t*)&sync_logger;
+	}
+	logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+
+	args->logger = logger;
+	args->handler = NULL;
+
+	bool muted = false;
+	if (handler_type == LOG_HANDLER_CONSOLE)
+	{
+		muted = log_handlers_mute_stdout() == 0;
+	}
+
+	run_log_benchmark(name, args, fp_latency);
+
+	if (muted)
+	{
+		log_handlers_restore_stdout();
+	}
+
+	logger->destroy(logger);
+	((muggle_log_handler_t*)&handler)->destroy((muggle_log_handler_t*)&handler);
+
+	uint64_t total = args->cfg->loop * args->cfg->cnt_per_loop * (uint64_t)args->num_thread;
+	double elapsed_sec = (double)args->elapsed_ns / 1000000000.0;
+	fprintf(fp_throughput, "%s,%s,%s,%d,%d,%llu,%llu,%.1f\n",
+		name, async ? "async" : "sync", s_log_handler_names[handler_type],
+		args->num_thread, msg_size,
+		(unsigned long long)total, (unsigned long long)args->elapsed_ns,
+		elapsed_sec > 0.0 ? (double)total / elapsed_sec : 0.0);
+}
+
+void run_log_handlers_benchmark(
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks,
+	int max_thread, const int *msg_sizes, int cnt_msg_size,
+	FILE *fp_latency, FILE *fp_throughput)
+{
+	fprintf(fp_throughput, "case_name,logger,handler,num_thread,msg_size,total,elapsed_ns,msg_per_sec\n");
+
+	struct log_bench_args args;
+	memset(&args, 0, sizeof(args));
+	args.cfg = cfg;
+	args.blocks = blocks;
+
+	for (int i = 0; i < cnt_msg_size; i++)
+	{
+		int msg_size = msg_sizes[i];
+		char *payload = (char*)malloc(msg_size + 1);
+		memset(payload, 'x', msg_size);
+		payload[msg_size] = '\0';
+		args.payload = payload;
+
+		for (int n = 1; ; n *= 2)
+		{
+			if (n > max_thread)
+			{
+				n = max_thread;
+			}
+			args.num_thread = n;
+
+			for (int handler_type = 0; handler_type < MAX_LOG_HANDLER; handler_type++)
+			{
+				log_handlers_run_case(&args, false, handler_type, msg_size, fp_latency, fp_throughput);
+				log_handlers_run_case(&args, true, handler_type, msg_size, fp_latency, fp_throughput);
+			}
+
+			if (n == max_thread)
+			{
+				break;
+			}
+		}
+
+		free(payload);
+	}
+}
@@ -0,0 +1,26 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#ifndef LOG_HANDLERS_H_
+#define LOG_HANDLERS_H_
+
+#include "log_runner.h"
+
+/**
+ * sync and async logger with every handler type, producer threads from 1 to
+ * max_thread(power of 2), message size from msg_sizes
+ *   - fp_latency: caller latency in cpu cycles, cfg->elapsed_unit must be
+ *     MUGGLE_BENCHMARK_ELAPSED_UNIT_CPU_CYCLE
+ *   - fp_throughput: one row per case, messages per second from first call
+ *     to all messages written out
+ */
+void run_log_handlers_benchmark(
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks,
+	int max_thread, const int *msg_sizes, int cnt_msg_size,
+	FILE *fp_latency, FILE *fp_throughput);
+
+#endif
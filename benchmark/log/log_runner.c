@@ -0,0 +1,146 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "log_runner.h"
+
+static int null_log_handler_write(muggle_log_handler_t *base_handler, const muggle_log_msg_t *msg)
+{
+	null_log_handler_t *handler = (null_log_handler_t*)base_handler;
+
+	char buf[MUGGLE_LOG_MSG_MAX_LEN];
+	int ret = base_handler->fmt->fmt_func(msg, buf, sizeof(buf));
+
+	muggle_atomic_fetch_add64(&handler->cnt, 1, muggle_memory_order_release);
+
+	return ret;
+}
+
+int null_log_handler_init(null_log_handler_t *handler)
+{
+	int ret = muggle_log_handler_init_default(&handler->handler);
+	if (ret != 0)
+	{
+		return ret;
+	}
+
+	handler->handler.write = null_log_handler_write;
+	handler->handler.destroy = muggle_log_handler_destroy_default;
+	muggle_log_handler_set_fmt(&handler->handler, muggle_log_fmt_get_complicated());
+	handler->cnt = 0;
+
+	return 0;
+}
+
+struct log_thread_args
+{
+	struct log_bench_args *args;
+	int                   thread_idx;
+};
+
+static muggle_thread_ret_t log_thread(void *p_arg)
+{
+	struct log_thread_args *thread_args = (struct log_thread_args*)p_arg;
+	struct log_bench_args *args = thread_args->args;
+	muggle_benchmark_config_t *cfg = args->cfg;
+	muggle_logger_t *logger = args->logger;
+
+	uint64_t cnt_per_thread = cfg->loop * cfg->cnt_per_loop;
+	muggle_benchmark_block_t *blocks = args->blocks + cnt_per_thread * thread_args->thread_idx;
+
+	uint64_t idx = 0;
+	for (uint64_t i = 0; i < cfg->loop; i++)
+	{
+		for (uint64_t j = 0; j < cfg->cnt_per_loop; j++)
+		{
+			memset(&blocks[idx], 0, sizeof(blocks[idx]));
+			blocks[idx].idx = idx;
+
+			if (cfg->elapsed_unit == MUGGLE_BENCHMARK_ELAPSED_UNIT_CPU_CYCLE)
+			{
+				blocks[idx].cpu_cycles[0] = muggle_get_cpu_cycle();
+				MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%llu %s", (unsigned long long)idx, args->payload);
+				blocks[idx].cpu_cycles[1] = muggle_get_cpu_cycle();
+			}
+			else
+			{
+				timespec_get(&blocks[idx].ts[0], TIME_UTC);
+				MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%llu %s", (unsigned long long)idx, args->payload);
+				timespec_get(&blocks[idx].ts[1], TIME_UTC);
+			}
+
+			idx++;
+		}
+
+		if (cfg->loop_interval_ms > 0)
+		{
+			muggle_msleep((unsigned long)cfg->loop_interval_ms);
+		}
+	}
+
+	return 0;
+}
+
+void run_log_benchmark(const char *name, struct log_bench_args *args, FILE *fp)
+{
+	int64_t total = (int64_t)(args->cfg->loop * args->cfg->cnt_per_loop) * args->num_thread;
+
+	muggle_thread_t *threads = (muggle_thread_t*)malloc(sizeof(muggle_thread_t) * args->num_thread);
+	struct log_thread_args *thread_args =
+		(struct log_thread_args*)malloc(sizeof(struct log_thread_args) * args->num_thread);
+
+	int64_t cnt_begin = 0;
+	if (args->handler)
+	{
+		cnt_begin = muggle_atomic_fetch_add64(&args->handler->cnt, 0, muggle_memory_order_acquire);
+	}
+
+	struct timespec ts_begin, ts_end;
+	timespec_get(&ts_begin, TIME_UTC);
+
+	for (int i = 0; i < args->num_thread; i++)
+	{
+		thread_args[i].args = args;
+		thread_args[i].thread_idx = i;
+		muggle_thread_create(&threads[i], log_thread, &thread_args[i]);
+	}
+
+	for (int i = 0; i < args->num_thread; i++)
+	{
+		muggle_thread_join(&threads[i]);
+	}
+
+	if (args->handler)
+	{
+		while (muggle_atomic_fetch_add64(&args->handler->cnt, 0, muggle_memory_order_acquire) - cnt_begin < total)
+		{
+			muggle_thread_yield();
+		}
+	}
+	else
+	{
+		// real handlers, wait until all messages written out
+		muggle_logger_flush(args->logger);
+	}
+
+	timespec_get(&ts_end, TIME_UTC);
+	args->elapsed_ns = (uint64_t)(ts_end.tv_sec - ts_begin.tv_sec) * 1000000000 + ts_end.tv_nsec - ts_begin.tv_nsec;
+
+	MUGGLE_LOG_INFO("%s: %lld messages, elapsed %.3f ms, %.1f messages/ms",
+		name, (long long)total, (double)args->elapsed_ns / 1000000.0,
+		(double)total / ((double)args->elapsed_ns / 1000000.0));
+
+	free(thread_args);
+	free(threads);
+
+	// per call latency
+	char buf[128];
+	snprintf(buf, sizeof(buf), "%s-call", name);
+	muggle_benchmark_gen_reports_body(fp, args->cfg, args->blocks, buf, (uint64_t)total, 0, 1, 0);
+
+	snprintf(buf, sizeof(buf), "%s-call-sorted", name);
+	muggle_benchmark_gen_reports_body(fp, args->cfg, args->blocks, buf, (uint64_t)total, 0, 1, 1);
+}
@@ -0,0 +1,43 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#ifndef LOG_RUNNER_H_
+#define LOG_RUNNER_H_
+
+#include "muggle_benchmark/muggle_benchmark.h"
+
+/**
+ * handler that format message and discard it, count messages it received
+ */
+typedef struct null_log_handler
+{
+	muggle_log_handler_t handler;
+	muggle_atomic_int64  cnt;
+}null_log_handler_t;
+
+int null_log_handler_init(null_log_handler_t *handler);
+
+struct log_bench_args
+{
+	muggle_benchmark_config_t *cfg;
+	muggle_benchmark_block_t  *blocks;
+	muggle_logger_t           *logger;
+	null_log_handler_t        *handler;  // wait handler receive all messages before stop timer, NULL means flush logger instead
+	int                       num_thread;
+	const char                *payload;
+
+	uint64_t                  elapsed_ns; // output, elapsed from first call to last message handled
+};
+
+/**
+ * every thread log cfg->loop * cfg->cnt_per_loop messages, ts[0] and ts[1]
+ * of block record begin and end of log call, cpu_cycles[0] and
+ * cpu_cycles[1] when cfg->elapsed_unit is MUGGLE_BENCHMARK_ELAPSED_UNIT_CPU_CYCLE
+ */
+void run_log_benchmark(const char *name, struct log_bench_args *args, FILE *fp);
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "muggle_benchmark/muggle_benchmark.h"
+
+#define PARAM_NUM 4
+
+int get_argv(int argc, int idx, char **argv, const char *name, int default_val)
+{
+	int val;
+	if (idx >= PARAM_NUM || idx >= argc || !muggle_str_toi(argv[idx], &val, 10))
+	{
+		MUGGLE_LOG_WARNING("failed get value of %s, use default val: %d", name, default_val);
+		val = default_val;
+	}
+
+	return val;
+}
+
+static const char *s_src_files[] = {
+	__FILE__,
+	"/home/user/project/src/server/session/session_manager.c",
+	"/home/user/project/src/net/reactor.c",
+	"/home/user/project/include/project/base/object.h",
+};
+
+/**
+ * format messages from several source files, timestamp of message is
+ * taken just before format, so date time changes as in real log
+ */
+void run_fmt(
+	const char *name, muggle_log_fmt_t *fmt,
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks,
+	const char *payload, FILE *fp)
+{
+	muggle_log_msg_t msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.level = MUGGLE_LOG_LEVEL_INFO;
+	msg.tid = muggle_thread_current_id();
+	msg.src_loc.func = __FUNCTION__;
+	msg.payload = payload;
+
+	const int num_file = (int)(sizeof(s_src_files) / sizeof(s_src_files[0]));
+	uint64_t total = cfg->loop * cfg->cnt_per_loop;
+	char buf[MUGGLE_LOG_MSG_MAX_LEN];
+	uint64_t total_len = 0;
+
+	struct timespec ts_begin, ts_end;
+	timespec_get(&ts_begin, TIME_UTC);
+
+	uint64_t idx = 0;
+	for (uint64_t i = 0; i < cfg->loop; i++)
+	{
+		for (uint64_t j = 0; j < cfg->cnt_per_loop; j++)
+		{
+			memset(&blocks[idx], 0, sizeof(blocks[idx]));
+			blocks[idx].idx = idx;
+
+			msg.src_loc.file = s_src_files[idx % num_file];
+			msg.src_loc.line = (unsigned int)(idx % 1000);
+			timespec_get(&msg.ts, TIME_UTC);
+
+			timespec_get(&blocks[idx].ts[0], TIME_UTC);
+			int n = fmt->fmt_func(&msg, buf, sizeof(buf));
+			timespec_get(&blocks[idx].ts[1], TIME_UTC);
+
+			total_len += (uint64_t)n;
+			idx++;
+		}
+
+		if (cfg->loop_interval_ms > 0)
+		{
+			muggle_msleep((unsigned long)cfg->loop_interval_ms);
+		}
+	}
+
+	timespec_get(&ts_end, TIME_UTC);
+	uint64_t elapsed_ns = (uint64_t)(ts_end.tv_sec - ts_begin.tv_sec) * 1000000000 + ts_end.tv_nsec - ts_begin.tv_nsec;
+
+	MUGGLE_LOG_INFO("%s: %llu messages, %llu bytes, elapsed %.3f ms, %.1f messages/ms",
+		name, (unsigned long long)total, (unsigned long long)total_len,
+		(double)elapsed_ns / 1000000.0,
+		(double)total / ((double)elapsed_ns / 1000000.0));
+
+	char report_name[128];
+	snprintf(report_name, sizeof(report_name), "%s", name);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, report_name, total, 0, 1, 0);
+
+	snprintf(report_name, sizeof(report_name), "%s-sorted", name);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, report_name, total, 0, 1, 1);
+}
+
+int main(int argc, char *argv[])
+{
+	// init log
+	if (muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed initalize log");
+		exit(EXIT_FAILURE);
+	}
+
+	// convert input arguments
+	if (argc < PARAM_NUM)
+	{
+		MUGGLE_LOG_WARNING("usage: %s <rounds> <msg-per-round> <msg-size>", argv[0]);
+		MUGGLE_LOG_WARNING("missing arguments will use default value");
+	}
+
+	int rounds = get_argv(argc, 1, argv, "rounds", 100);
+	int msg_per_round = get_argv(argc, 2, argv, "msg-per-round", 10000);
+	int msg_size = get_argv(argc, 3, argv, "msg-size", 128);
+
+	MUGGLE_LOG_INFO("rounds: %d", rounds);
+	MUGGLE_LOG_INFO("msg_per_round: %d", msg_per_round);
+	MUGGLE_LOG_INFO("msg_size: %d", msg_size);
+
+	muggle_benchmark_config_t benchmark_cfg;
+	memset(&benchmark_cfg, 0, sizeof(benchmark_cfg));
+	strncpy(benchmark_cfg.name, "log_fmt", sizeof(benchmark_cfg.name) - 1);
+	benchmark_cfg.loop = rounds;
+	benchmark_cfg.loop_interval_ms = 0;
+	benchmark_cfg.cnt_per_loop = msg_per_round;
+	benchmark_cfg.report_step = 10;
+	benchmark_cfg.elapsed_unit = MUGGLE_BENCHMARK_ELAPSED_UNIT_NS;
+
+	char file_name[128];
+	snprintf(file_name, sizeof(file_name)-1, "benchmark_%s.csv", benchmark_cfg.name);
+	FILE *fp = fopen(file_name, "wb");
+	if (fp == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed open file: %s", file_name);
+		exit(EXIT_FAILURE);
+	}
+	muggle_benchmark_gen_reports_head(fp, &benchmark_cfg);
+
+	// allocate memory
+	uint64_t total_msg_num = (uint64_t)rounds * msg_per_round;
+	muggle_benchmark_block_t *blocks =
+		(muggle_benchmark_block_t*)malloc(sizeof(muggle_benchmark_block_t) * total_msg_num);
+
+	char *payload = (char*)malloc(msg_size + 1);
+	memset(payload, 'x', msg_size);
+	payload[msg_size] = '\0';
+
+	char name[64];
+
+	MUGGLE_LOG_INFO("=======================================================");
+	snprintf(name, sizeof(name), "complicated_%dB", msg_size);
+	run_fmt(name, muggle_log_fmt_get_complicated(), &benchmark_cfg, blocks, payload, fp);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	snprintf(name, sizeof(name), "cached_%dB", msg_size);
+	run_fmt(name, muggle_log_fmt_get_cached(), &benchmark_cfg, blocks, payload, fp);
+
+	// free memory
+	free(payload);
+	free(blocks);
+
+	fclose(fp);
+
+	return 0;
+}
@@ -10,6 +10,8 @@
 #include "udp_receiver.h"
 #include "tcp_serv.h"
 #include "tcp_client.h"
+#include "conn_scale.h"
+#include "utils.h"
 
 int main(int argc, char *argv[])
 {
@@ -29,7 +31,7 @@ int main(int argc, char *argv[])
 
 	if (argc < 4)
 	{
-		MUGGLE_LOG_ERROR("usage: %s <udp-send|udp-recv|tcp-serv|tcp-client> <host> <port>", argv[0]);
+		MUGGLE_LOG_ERROR("usage: %s <udp-send|udp-recv|tcp-serv|tcp-client|tcp-frame-client|conn-scale> <host> <port> [event-loop|max-conn]", argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
@@ -37,21 +39,41 @@ int main(int argc, char *argv[])
 	const char *host = argv[2];
 	const char *port = argv[3];
 
+	// optional event loop type of udp-recv, tcp-serv and tcp-client
+	int ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_NULL;
+	if (argc > 4 && strcmp(app_type, "conn-scale") != 0)
+	{
+		ev_loop_type = get_event_loop_type(argv[4]);
+	}
+
 	if (strcmp(app_type, "udp-send") == 0)
 	{
 		run_udp_sender(host, port);
 	}
 	else if (strcmp(app_type, "udp-recv") == 0)
 	{
-		run_udp_receiver(host, port);
+		run_udp_receiver(host, port, ev_loop_type);
 	}
 	else if (strcmp(app_type, "tcp-serv") == 0)
 	{
-		run_tcp_serv(host, port);
+		run_tcp_serv(host, port, ev_loop_type);
 	}
 	else if (strcmp(app_type, "tcp-client") == 0)
 	{
-		run_tcp_client(host, port);
+		run_tcp_client(host, port, ev_loop_type);
+	}
+	else if (strcmp(app_type, "tcp-frame-client") == 0)
+	{
+		run_tcp_frame_client(host, port, ev_loop_type);
+	}
+	else if (strcmp(app_type, "conn-scale") == 0)
+	{
+		int max_conn = 256;
+		if (argc > 4)
+		{
+			max_conn = atoi(argv[4]);
+		}
+		run_conn_scale(host, port, max_conn);
 	}
 	else
 	{
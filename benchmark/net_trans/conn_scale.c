@@ -0,0 +1,382 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "conn_scale.h"
+#include "utils.h"
+
+enum
+{
+	CONN_SCALE_ROUND = 200,
+	CONN_SCALE_MIN_CONN = 1,
+};
+
+struct conn_scale_serv
+{
+	muggle_socket_event_t ev;
+	muggle_thread_t       thread;
+};
+
+struct conn_scale_client
+{
+	const char               *host;
+	const char               *port;
+	muggle_socket_t          *fds;
+	int                      cnt_fd;
+	muggle_benchmark_block_t *blocks; // size is cnt_fd * CONN_SCALE_ROUND
+	muggle_thread_t          thread;
+	int                      ret;
+};
+
+static const char* conn_scale_loop_name(int ev_loop_type)
+{
+	switch (ev_loop_type)
+	{
+		case MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL: return "epoll";
+		case MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD: return "multhread";
+		case MUGGLE_SOCKET_EVENT_LOOP_TYPE_IO_URING: return "io_uring";
+		default: return "unknown";
+	}
+}
+
+/****************** echo server ******************/
+static void conn_scale_serv_on_connect(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *listen_peer, struct muggle_socket_peer *peer)
+{
+	(void)ev;
+	(void)listen_peer;
+
+	int enable = 1;
+	setsockopt(peer->fd, IPPROTO_TCP, TCP_NODELAY, (char*)&enable, sizeof(enable));
+}
+
+static void conn_scale_serv_on_message(struct muggle_socket_event *ev, struct muggle_socket_peer *peer)
+{
+	(void)ev;
+
+	// pkg is small and client wait for reply, so echo back whatever received
+	char buf[4096];
+	while (1)
+	{
+		int n = muggle_socket_peer_recv(peer, buf, sizeof(buf), 0);
+		if (n <= 0)
+		{
+			break;
+		}
+
+		if (muggle_socket_send(peer->fd, buf, (size_t)n, 0) != n)
+		{
+			muggle_socket_peer_close(peer);
+			break;
+		}
+
+		if (n < (int)sizeof(buf))
+		{
+			break;
+		}
+	}
+}
+
+static muggle_thread_ret_t conn_scale_serv_run(void *arg)
+{
+	struct conn_scale_serv *serv = (struct conn_scale_serv*)arg;
+	muggle_socket_event_loop(&serv->ev);
+	return 0;
+}
+
+static int conn_scale_serv_start(
+	struct conn_scale_serv *serv, const char *host, const char *port,
+	int ev_loop_type, int max_conn)
+{
+	muggle_socket_peer_t tcp_peer;
+	if (muggle_tcp_listen(host, port, 512, &tcp_peer) == MUGGLE_INVALID_SOCKET)
+	{
+		MUGGLE_LOG_ERROR("failed create tcp listen for %s:%s", host, port);
+		return -1;
+	}
+
+	muggle_socket_event_init_arg_t ev_init_arg;
+	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+	ev_init_arg.ev_loop_type = ev_loop_type;
+	ev_init_arg.hints_max_peer = max_conn + 8;
+	ev_init_arg.cnt_peer = 1;
+	ev_init_arg.peers = &tcp_peer;
+	ev_init_arg.timeout_ms = 100;
+	ev_init_arg.on_connect = conn_scale_serv_on_connect;
+	ev_init_arg.on_message = conn_scale_serv_on_message;
+
+	if (muggle_socket_event_init(&ev_init_arg, &serv->ev) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init socket event");
+		return -1;
+	}
+
+	if (muggle_thread_create(&serv->thread, conn_scale_serv_run, serv) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed create server thread");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void conn_scale_serv_stop(struct conn_scale_serv *serv)
+{
+	muggle_socket_event_loop_exit(&serv->ev);
+	muggle_thread_join(&serv->thread);
+}
+
+/****************** client ******************/
+static int conn_scale_recv_all(muggle_socket_t fd, void *buf, size_t len)
+{
+	size_t offset = 0;
+	while (offset < len)
+	{
+		int n = muggle_socket_recv(fd, (char*)buf + offset, len - offset, 0);
+		if (n <= 0)
+		{
+			if (n < 0 && MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_INTR)
+			{
+				continue;
+			}
+			return -1;
+		}
+		offset += (size_t)n;
+	}
+
+	return 0;
+}
+
+static muggle_thread_ret_t conn_scale_client_run(void *arg)
+{
+	struct conn_scale_client *client = (struct conn_scale_client*)arg;
+
+	struct pkg msg;
+	memset(&msg, 0, sizeof(msg));
+	genPkgHeader(&msg.header);
+	size_t len_msg = sizeof(struct pkg_header) + (size_t)msg.header.data_len;
+
+	struct pkg reply;
+
+	// every round, send pkg on all connections, then wait all replies, so
+	// the number of in-flight requests equal to the number of connections
+	uint32_t idx = 0;
+	for (int r = 0; r < CONN_SCALE_ROUND; r++)
+	{
+		for (int i = 0; i < client->cnt_fd; i++)
+		{
+			muggle_benchmark_block_t *block = &client->blocks[idx];
+			genPkgData((struct pkg_data*)msg.placeholder, idx++);
+			timespec_get(&block->ts[0], TIME_UTC);
+			if (muggle_socket_send(client->fds[i], &msg, len_msg, 0) != (int)len_msg)
+			{
+				client->ret = -1;
+				return 0;
+			}
+		}
+
+		for (int i = 0; i < client->cnt_fd; i++)
+		{
+			if (conn_scale_recv_all(client->fds[i], &reply, len_msg) != 0)
+			{
+				client->ret = -1;
+				return 0;
+			}
+
+			struct pkg_data *data = (struct pkg_data*)reply.placeholder;
+			if (data->idx >= (uint32_t)(client->cnt_fd * CONN_SCALE_ROUND))
+			{
+				client->ret = -1;
+				return 0;
+			}
+			timespec_get(&client->blocks[data->idx].ts[1], TIME_UTC);
+		}
+	}
+
+	return 0;
+}
+
+static void conn_scale_gen_report(
+	const char *name, muggle_benchmark_block_t *blocks, int cnt, int cnt_conn)
+{
+	muggle_benchmark_config_t config;
+	memset(&config, 0, sizeof(config));
+	strncpy(config.name, name, sizeof(config.name)-1);
+	config.loop = CONN_SCALE_ROUND;
+	config.cnt_per_loop = cnt_conn;
+	config.loop_interval_ms = 0;
+	config.report_step = 10;
+	config.elapsed_unit = MUGGLE_BENCHMARK_ELAPSED_UNIT_NS;
+
+	char file_name[128];
+	snprintf(file_name, sizeof(file_name)-1, "benchmark_%s.csv", config.name);
+	FILE *fp = fopen(file_name, "wb");
+	if (fp == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed open file: %s", file_name);
+		return;
+	}
+
+	muggle_benchmark_gen_reports_head(fp, &config);
+	muggle_benchmark_gen_reports_body(fp, &config, blocks, "sort by elapsed", cnt, 0, 1, 1);
+
+	fclose(fp);
+}
+
+/**
+ * run one case
+ *
+ * @return 0 - success, otherwise failed
+ */
+static int conn_scale_run_case(
+	const char *host, const char *port, int ev_loop_type,
+	int cnt_conn, int num_client, FILE *fp_throughput)
+{
+	struct conn_scale_serv serv;
+	memset(&serv, 0, sizeof(serv));
+	if (conn_scale_serv_start(&serv, host, port, ev_loop_type, cnt_conn) != 0)
+	{
+		return -1;
+	}
+
+	int ret = 0;
+	int cnt_block = cnt_conn * CONN_SCALE_ROUND;
+	muggle_socket_t *fds = (muggle_socket_t*)malloc(sizeof(muggle_socket_t) * cnt_conn);
+	muggle_benchmark_block_t *blocks =
+		(muggle_benchmark_block_t*)malloc(sizeof(muggle_benchmark_block_t) * cnt_block);
+	struct conn_scale_client *clients =
+		(struct conn_scale_client*)malloc(sizeof(struct conn_scale_client) * num_client);
+	for (int i = 0; i < cnt_conn; i++)
+	{
+		fds[i] = MUGGLE_INVALID_SOCKET;
+	}
+	memset(blocks, 0, sizeof(muggle_benchmark_block_t) * cnt_block);
+
+	// connect
+	for (int i = 0; i < cnt_conn; i++)
+	{
+		fds[i] = muggle_tcp_connect(host, port, 3, NULL);
+		if (fds[i] == MUGGLE_INVALID_SOCKET)
+		{
+			MUGGLE_LOG_ERROR("failed connect %s:%s, connection idx: %d", host, port, i);
+			ret = -1;
+			goto conn_scale_case_exit;
+		}
+
+		int enable = 1;
+		setsockopt(fds[i], IPPROTO_TCP, TCP_NODELAY, (char*)&enable, sizeof(enable));
+	}
+
+	// split connections between client threads
+	int offset = 0;
+	for (int i = 0; i < num_client; i++)
+	{
+		int cnt = cnt_conn / num_client + (i < cnt_conn % num_client ? 1 : 0);
+		clients[i].host = host;
+		clients[i].port = port;
+		clients[i].fds = fds + offset;
+		clients[i].cnt_fd = cnt;
+		clients[i].blocks = blocks + offset * CONN_SCALE_ROUND;
+		clients[i].ret = 0;
+		offset += cnt;
+	}
+
+	struct timespec ts_start, ts_end;
+	timespec_get(&ts_start, TIME_UTC);
+
+	for (int i = 0; i < num_client; i++)
+	{
+		muggle_thread_create(&clients[i].thread, conn_scale_client_run, &clients[i]);
+	}
+	for (int i = 0; i < num_client; i++)
+	{
+		muggle_thread_join(&clients[i].thread);
+		if (clients[i].ret != 0)
+		{
+			ret = -1;
+		}
+	}
+
+	timespec_get(&ts_end, TIME_UTC);
+
+	if (ret != 0)
+	{
+		MUGGLE_LOG_ERROR("client failed, event loop: %s, connections: %d",
+			conn_scale_loop_name(ev_loop_type), cnt_conn);
+		goto conn_scale_case_exit;
+	}
+
+	uint64_t elapsed_ns = (uint64_t)(ts_end.tv_sec - ts_start.tv_sec) * 1000000000 +
+		ts_end.tv_nsec - ts_start.tv_nsec;
+	double msg_per_sec = elapsed_ns > 0 ? (double)cnt_block * 1000000000.0 / (double)elapsed_ns : 0.0;
+	MUGGLE_LOG_INFO("event loop: %s, connections: %d, messages: %d, elapsed: %llu ns, %.2f msg/s",
+		conn_scale_loop_name(ev_loop_type), cnt_conn, cnt_block,
+		(unsigned long long)elapsed_ns, msg_per_sec);
+	fprintf(fp_throughput, "%s,%d,%d,%llu,%.2f\n",
+		conn_scale_loop_name(ev_loop_type), cnt_conn, cnt_block,
+		(unsigned long long)elapsed_ns, msg_per_sec);
+
+	char name[64];
+	snprintf(name, sizeof(name), "conn_scale_%s_%d", conn_scale_loop_name(ev_loop_type), cnt_conn);
+	conn_scale_gen_report(name, blocks, cnt_block, cnt_conn);
+
+conn_scale_case_exit:
+	for (int i = 0; i < cnt_conn; i++)
+	{
+		if (fds[i] != MUGGLE_INVALID_SOCKET)
+		{
+			muggle_socket_close(fds[i]);
+		}
+	}
+	free(clients);
+	free(blocks);
+	free(fds);
+
+	conn_scale_serv_stop(&serv);
+
+	return ret;
+}
+
+void run_conn_scale(const char *host, const char *port, int max_conn)
+{
+	if (max_conn < CONN_SCALE_MIN_CONN)
+	{
+		max_conn = CONN_SCALE_MIN_CONN;
+	}
+
+	int num_client = muggle_thread_hardware_concurrency();
+	if (num_client <= 0)
+	{
+		num_client = 1;
+	}
+
+	FILE *fp = fopen("benchmark_conn_scale_throughput.csv", "wb");
+	if (fp == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed open file: benchmark_conn_scale_throughput.csv");
+		exit(EXIT_FAILURE);
+	}
+	fprintf(fp, "event_loop,connections,messages,elapsed_ns,msg_per_sec\n");
+
+	int ev_loop_types[] = {
+		MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL,
+		MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD,
+		MUGGLE_SOCKET_EVENT_LOOP_TYPE_IO_URING,
+	};
+	for (int i = 0; i < (int)(sizeof(ev_loop_types) / sizeof(ev_loop_types[0])); i++)
+	{
+		for (int cnt_conn = CONN_SCALE_MIN_CONN; cnt_conn <= max_conn; cnt_conn *= 2)
+		{
+			int cnt_thread = num_client < cnt_conn ? num_client : cnt_conn;
+			if (conn_scale_run_case(host, port, ev_loop_types[i], cnt_conn, cnt_thread, fp) != 0)
+			{
+				break;
+			}
+		}
+	}
+
+	fclose(fp);
+}
@@ -0,0 +1,24 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#ifndef CONN_SCALE_H_
+#define CONN_SCALE_H_
+
+#include "trans_message.h"
+
+/**
+ * run connection scaling benchmark, echo server with epoll, multhread and
+ * io_uring event loop in this process, client threads ping-pong pkg on every
+ * connection, number of connections is doubled every case
+ *
+ * @param host       server host
+ * @param port       server port
+ * @param max_conn   max number of connections
+ */
+void run_conn_scale(const char *host, const char *port, int max_conn);
+
+#endif
@@ -135,7 +135,7 @@ static void tcp_client_on_error(struct muggle_socket_event *ev, struct muggle_so
 	muggle_socket_event_loop_exit(ev);
 }
 
-void run_tcp_client(const char *host, const char *port)
+void run_tcp_client(const char *host, const char *port, int ev_loop_type)
 {
 	// init bytes buffer
 	muggle_bytes_buffer_t bytes_buf;
@@ -162,7 +162,7 @@ void run_tcp_client(const char *host, const char *port)
 	// fill up event loop input arguments
 	muggle_socket_event_init_arg_t ev_init_arg;
 	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
-	ev_init_arg.ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_NULL;
+	ev_init_arg.ev_loop_type = ev_loop_type;
 	ev_init_arg.cnt_peer = 1;
 	ev_init_arg.peers = &tcp_peer;
 	ev_init_arg.timeout_ms = -1;
@@ -190,3 +190,78 @@ void run_tcp_client(const char *host, const char *port)
 	// generate benchmark report
 	gen_report("tcp_latency");
 }
+
+static void tcp_frame_client_on_frame(
+	muggle_socket_event_t *ev, muggle_socket_peer_t *peer, void *frame, int len)
+{
+	(void)ev;
+
+	// frame is pkg header with data, never larger than pkg
+	if (len < (int)sizeof(struct pkg_header) || len > (int)sizeof(struct pkg))
+	{
+		MUGGLE_LOG_ERROR("size of frame was wrong! len=%d", len);
+		muggle_socket_peer_close(peer);
+		return;
+	}
+
+	// frame point to receive buffer of peer, no copy
+	if (on_msg(peer, (struct pkg*)frame) != 0)
+	{
+		muggle_socket_peer_close(peer);
+		MUGGLE_LOG_INFO("close peer");
+	}
+}
+
+void run_tcp_frame_client(const char *host, const char *port, int ev_loop_type)
+{
+	// create tcp connect socket
+	muggle_socket_peer_t tcp_peer;
+	tcp_peer.fd = muggle_tcp_connect(host, port, 3, &tcp_peer);
+	if (tcp_peer.fd == MUGGLE_INVALID_SOCKET)
+	{
+		MUGGLE_LOG_ERROR("failed connect %s:%s", host, port);
+		exit(EXIT_FAILURE);
+	}
+
+	// set TCP_NODELAY
+	int enable = 1;
+	setsockopt(tcp_peer.fd, IPPROTO_TCP, TCP_NODELAY, (char*)&enable, sizeof(enable));
+
+	// fill up event loop input arguments, pkg_header.data_len is the
+	// length field, in host byte order
+	struct pkg_header header;
+	genPkgHeader(&header);
+
+	muggle_socket_event_init_arg_t ev_init_arg;
+	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+	ev_init_arg.ev_loop_type = ev_loop_type;
+	ev_init_arg.cnt_peer = 1;
+	ev_init_arg.peers = &tcp_peer;
+	ev_init_arg.timeout_ms = -1;
+	ev_init_arg.recv_buf_capacity = 1024 * 1024;
+	ev_init_arg.length_field.offset = (int)offsetof(struct pkg_header, data_len);
+	ev_init_arg.length_field.size = (int)sizeof(header.data_len);
+	ev_init_arg.length_field.big_endian = header.little_endian ? 0 : 1;
+	ev_init_arg.length_field.adjust = (int)sizeof(struct pkg_header);
+	ev_init_arg.length_field.max_frame = (int)sizeof(struct pkg);
+	ev_init_arg.on_frame = tcp_frame_client_on_frame;
+	ev_init_arg.on_error = tcp_client_on_error;
+
+	// init benchmark report
+	init_report();
+
+	// register callbacks
+	register_callbacks();
+
+	// event loop
+	muggle_socket_event_t ev;
+	if (muggle_socket_event_init(&ev_init_arg, &ev) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init socket event");
+		exit(EXIT_FAILURE);
+	}
+	muggle_socket_event_loop(&ev);
+
+	// generate benchmark report
+	gen_report("tcp_frame_latency");
+}
@@ -10,6 +10,8 @@
 
 #include "trans_message.h"
 
-void run_tcp_client(const char *host, const char *port);
+void run_tcp_client(const char *host, const char *port, int ev_loop_type);
+
+void run_tcp_frame_client(const char *host, const char *port, int ev_loop_type);
 
 #endif
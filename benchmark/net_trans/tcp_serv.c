@@ -18,7 +18,7 @@ static void tcp_serv_on_error(struct muggle_socket_event *ev, struct muggle_sock
 	muggle_socket_event_loop_exit(ev);
 }
 
-void run_tcp_serv(const char *host, const char *port)
+void run_tcp_serv(const char *host, const char *port, int ev_loop_type)
 {
 	muggle_socket_peer_t tcp_peer;
 
@@ -36,7 +36,7 @@ void run_tcp_serv(const char *host, const char *port)
 	// fill up event loop input arguments
 	muggle_socket_event_init_arg_t ev_init_arg;
 	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
-	ev_init_arg.ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_NULL;
+	ev_init_arg.ev_loop_type = ev_loop_type;
 	ev_init_arg.cnt_peer = 1;
 	ev_init_arg.peers = &tcp_peer;
 	ev_init_arg.timeout_ms = -1;
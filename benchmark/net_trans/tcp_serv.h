@@ -10,6 +10,6 @@
 
 #include "trans_message.h"
 
-void run_tcp_serv(const char *host, const char *port);
+void run_tcp_serv(const char *host, const char *port, int ev_loop_type);
 
 #endif
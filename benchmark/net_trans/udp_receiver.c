@@ -8,7 +8,45 @@
 #include "udp_receiver.h"
 #include "utils.h"
 
-void run_udp_receiver(const char *host, const char *port)
+static void udp_receiver_on_message(muggle_socket_event_t *ev, muggle_socket_peer_t *peer)
+{
+	char buf[65536];
+	while (1)
+	{
+		int n = muggle_socket_peer_recvfrom(peer, buf, sizeof(buf), 0, NULL, NULL);
+		if (n <= 0)
+		{
+			break;
+		}
+
+		if (on_msg(NULL, (struct pkg*)buf) != 0)
+		{
+			muggle_socket_event_loop_exit(ev);
+			break;
+		}
+	}
+}
+
+static void udp_receiver_event_loop(muggle_socket_peer_t *udp_peer, int ev_loop_type)
+{
+	muggle_socket_event_init_arg_t ev_init_arg;
+	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+	ev_init_arg.ev_loop_type = ev_loop_type;
+	ev_init_arg.cnt_peer = 1;
+	ev_init_arg.peers = udp_peer;
+	ev_init_arg.timeout_ms = -1;
+	ev_init_arg.on_message = udp_receiver_on_message;
+
+	muggle_socket_event_t ev;
+	if (muggle_socket_event_init(&ev_init_arg, &ev) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init socket event");
+		exit(EXIT_FAILURE);
+	}
+	muggle_socket_event_loop(&ev);
+}
+
+void run_udp_receiver(const char *host, const char *port, int ev_loop_type)
 {
 	// init benchmark report
 	init_report();
@@ -24,6 +62,13 @@ void run_udp_receiver(const char *host, const char *port)
 		exit(EXIT_FAILURE);
 	}
 
+	if (ev_loop_type != MUGGLE_SOCKET_EVENT_LOOP_TYPE_NULL)
+	{
+		udp_receiver_event_loop(&udp_peer, ev_loop_type);
+		gen_report("udp_latency");
+		return;
+	}
+
 	char buf[65536];
 	while (1)
 	{
@@ -10,6 +10,6 @@
 
 #include "trans_message.h"
 
-void run_udp_receiver(const char *host, const char *port);
+void run_udp_receiver(const char *host, const char *port, int ev_loop_type);
 
 #endif
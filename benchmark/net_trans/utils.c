@@ -54,6 +54,34 @@ void gen_benchmark_report(const char *name, muggle_benchmark_block_t *blocks, in
 	fclose(fp);
 }
 
+/****************** event loop ******************/
+int get_event_loop_type(const char *str_loop_type)
+{
+	if (strcmp(str_loop_type, "thread") == 0)
+	{
+		return MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD;
+	}
+	else if (strcmp(str_loop_type, "select") == 0)
+	{
+		return MUGGLE_SOCKET_EVENT_LOOP_TYPE_SELECT;
+	}
+	else if (strcmp(str_loop_type, "poll") == 0)
+	{
+		return MUGGLE_SOCKET_EVENT_LOOP_TYPE_POLL;
+	}
+	else if (strcmp(str_loop_type, "epoll") == 0)
+	{
+		return MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL;
+	}
+	else if (strcmp(str_loop_type, "io_uring") == 0)
+	{
+		return MUGGLE_SOCKET_EVENT_LOOP_TYPE_IO_URING;
+	}
+
+	MUGGLE_LOG_ERROR("invalid socket event loop type: %s", str_loop_type);
+	exit(EXIT_FAILURE);
+}
+
 /****************** message callbacks ******************/
 void register_callbacks()
 {
@@ -23,6 +23,9 @@ void init_report();
 void gen_report(const char *name);
 void gen_benchmark_report(const char *name, muggle_benchmark_block_t *block, int cnt);
 
+/****************** event loop ******************/
+int get_event_loop_type(const char *str_loop_type);
+
 /****************** message callbacks ******************/
 void register_callbacks();
 
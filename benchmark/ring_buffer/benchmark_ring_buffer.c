@@ -5,10 +5,46 @@
  *	found in the LICENSE file.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	#define _GNU_SOURCE // for RUSAGE_THREAD
+#endif
+
 #include "muggle_benchmark/muggle_benchmark.h"
 
+#if MUGGLE_PLATFORM_LINUX
+	#include <sys/resource.h>
+#endif
+
 uint64_t *consumer_read_num = NULL;
 
+/*
+ * kernel usage of producer thread
+ *
+ * there is no portable way to count syscalls of a thread, use kernel time and
+ * context switches of producer threads as a proxy: every futex wake that
+ * enter the kernel adds system time even if no one is parked on the futex
+ */
+struct producer_kernel_usage
+{
+	uint64_t sys_ns;
+	uint64_t nvcsw;
+	uint64_t nivcsw;
+};
+
+static void get_thread_kernel_usage(struct producer_kernel_usage *usage)
+{
+	memset(usage, 0, sizeof(*usage));
+#if MUGGLE_PLATFORM_LINUX
+	struct rusage ru;
+	if (getrusage(RUSAGE_THREAD, &ru) == 0)
+	{
+		usage->sys_ns = (uint64_t)ru.ru_stime.tv_sec * 1000000000 + (uint64_t)ru.ru_stime.tv_usec * 1000;
+		usage->nvcsw = (uint64_t)ru.ru_nvcsw;
+		usage->nivcsw = (uint64_t)ru.ru_nivcsw;
+	}
+#endif
+}
+
 struct consumer_thread_args
 {
 	muggle_ring_buffer_t *ring;
@@ -25,8 +61,27 @@ struct producer_thread_args
 	int cnt_consumer;
 	uint64_t start_idx;
 	uint64_t end_idx;
+	int always_wake;
+	struct producer_kernel_usage *usage;
 };
 
+/*
+ * before waiter-aware wake, writer entered kernel to wake readers after
+ * every write unless readers busy loop, reproduce it for comparison
+ */
+static void ring_buffer_always_wake(muggle_ring_buffer_t *ring)
+{
+	// read mode: 0 - wait, 1 - single wait, 2 - busy loop, 3 - lock
+	if (ring->read_mode == 0)
+	{
+		muggle_futex_wake_all(&ring->cursor);
+	}
+	else if (ring->read_mode != 2)
+	{
+		muggle_futex_wake_one(&ring->cursor);
+	}
+}
+
 muggle_thread_ret_t consumer_thread(void *void_arg)
 {
 	struct consumer_thread_args *arg = (struct consumer_thread_args*)void_arg;
@@ -58,6 +113,9 @@ muggle_thread_ret_t producer_thread(void *void_arg)
 
 	while (muggle_atomic_load(arg->consumer_ready, muggle_memory_order_relaxed) != arg->cnt_consumer);
 
+	struct producer_kernel_usage usage_begin, usage_end;
+	get_thread_kernel_usage(&usage_begin);
+
 	for (uint64_t i = 0; i < arg->config->loop; ++i)
 	{
 		for (uint64_t j = arg->start_idx; j < arg->end_idx; ++j)
@@ -68,6 +126,10 @@ muggle_thread_ret_t producer_thread(void *void_arg)
 
 			timespec_get(&arg->blocks[idx].ts[0], TIME_UTC);
 			muggle_ring_buffer_write(arg->ring, &arg->blocks[idx]);
+			if (arg->always_wake)
+			{
+				ring_buffer_always_wake(arg->ring);
+			}
 			timespec_get(&arg->blocks[idx].ts[1], TIME_UTC);
 		}
 		if (arg->config->loop_interval_ms > 0)
@@ -76,6 +138,11 @@ muggle_thread_ret_t producer_thread(void *void_arg)
 		}
 	}
 
+	get_thread_kernel_usage(&usage_end);
+	arg->usage->sys_ns = usage_end.sys_ns - usage_begin.sys_ns;
+	arg->usage->nvcsw = usage_end.nvcsw - usage_begin.nvcsw;
+	arg->usage->nivcsw = usage_end.nivcsw - usage_begin.nivcsw;
+
 	free(arg);
 
 	return 0;
@@ -100,7 +167,48 @@ void get_case_name(char *buf, size_t max_len, int cnt_producer, int cnt_consumer
 		cnt_consumer, str_r_mode[r_mode]);
 }
 
-void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer, int cnt_consumer, int flag)
+static int compare_uint64(const void *a, const void *b)
+{
+	const uint64_t arg1 = *(const uint64_t*)a;
+	const uint64_t arg2 = *(const uint64_t*)b;
+
+	if (arg1 < arg2) return -1;
+	if (arg1 > arg2) return 1;
+	return 0;
+}
+
+uint64_t get_percentile_elapsed_ns(muggle_benchmark_block_t *blocks, uint64_t cnt, int begin, int end, double percentile)
+{
+	uint64_t *elapseds = (uint64_t*)malloc(cnt * sizeof(uint64_t));
+	uint64_t n = 0;
+	for (uint64_t i = 0; i < cnt; ++i)
+	{
+		if (blocks[i].ts[begin].tv_sec == 0 || blocks[i].ts[end].tv_sec == 0)
+		{
+			continue;
+		}
+		elapseds[n++] = get_elapsed_ns(&blocks[i], begin, end);
+	}
+
+	uint64_t ret = 0;
+	if (n > 0)
+	{
+		qsort(elapseds, n, sizeof(uint64_t), compare_uint64);
+		uint64_t idx = (uint64_t)(percentile / 100.0 * n);
+		if (idx >= n)
+		{
+			idx = n - 1;
+		}
+		ret = elapseds[idx];
+	}
+	free(elapseds);
+
+	return ret;
+}
+
+void Benchmark_wr(
+	FILE *fp, FILE *fp_summary, muggle_benchmark_config_t *config,
+	int cnt_producer, int cnt_consumer, int flag, int always_wake)
 {
 	uint64_t cnt = config->loop * config->cnt_per_loop;
 	muggle_benchmark_block_t *blocks = (muggle_benchmark_block_t*)malloc(cnt * sizeof(muggle_benchmark_block_t));
@@ -110,8 +218,13 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 
 	muggle_ring_buffer_t ring;
 	muggle_ring_buffer_init(&ring, 1024 * 16, flag);
-	char case_name[1024];
+	char case_name[64];
 	get_case_name(case_name, sizeof(case_name)-1, cnt_producer, cnt_consumer, ring.write_mode, ring.read_mode);
+	if (always_wake)
+	{
+		size_t len = strlen(case_name);
+		snprintf(case_name + len, sizeof(case_name) - len, "-always_wake");
+	}
 
 	printf("launch %s\n", case_name);
 
@@ -128,6 +241,8 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 
 	// producer
 	muggle_thread_t *producers = (muggle_thread_t*)malloc(cnt_producer * sizeof(muggle_thread_t));
+	struct producer_kernel_usage *usages =
+		(struct producer_kernel_usage*)malloc(cnt_producer * sizeof(struct producer_kernel_usage));
 	for (int i = 0; i < cnt_producer; ++i)
 	{
 		struct producer_thread_args *producer_args = (struct producer_thread_args*)malloc(sizeof(struct producer_thread_args));
@@ -136,6 +251,8 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 		producer_args->blocks = blocks;
 		producer_args->consumer_ready = &consumer_ready;
 		producer_args->cnt_consumer = cnt_consumer;
+		producer_args->always_wake = always_wake;
+		producer_args->usage = &usages[i];
 		producer_args->start_idx = i * (config->cnt_per_loop / cnt_producer);
 		producer_args->end_idx = (i + 1) * (config->cnt_per_loop / cnt_producer);
 		if (i == cnt_producer - 1)
@@ -198,6 +315,29 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 	}
 	free(consumer_read_num);
 
+	// kernel usage and tail latency summary
+	struct producer_kernel_usage total_usage;
+	memset(&total_usage, 0, sizeof(total_usage));
+	for (int i = 0; i < cnt_producer; ++i)
+	{
+		total_usage.sys_ns += usages[i].sys_ns;
+		total_usage.nvcsw += usages[i].nvcsw;
+		total_usage.nivcsw += usages[i].nivcsw;
+	}
+	free(usages);
+
+	double sys_ns_per_msg = (double)total_usage.sys_ns / cnt;
+	double csw_per_msg = (double)(total_usage.nvcsw + total_usage.nivcsw) / cnt;
+	uint64_t p99_w = get_percentile_elapsed_ns(blocks, cnt, 0, 1, 99.0);
+	uint64_t p99_wr = get_percentile_elapsed_ns(blocks, cnt, 0, 2, 99.0);
+	printf("%s producer sys_ns/msg: %.3f, csw/msg: %.6f, w p99: %llu ns, wr p99: %llu ns\n",
+		case_name, sys_ns_per_msg, csw_per_msg,
+		(unsigned long long)p99_w, (unsigned long long)p99_wr);
+	fprintf(fp_summary, "%s,%s,%llu,%.3f,%.6f,%llu,%llu\n",
+		case_name, always_wake ? "before" : "after",
+		(unsigned long long)cnt, sys_ns_per_msg, csw_per_msg,
+		(unsigned long long)p99_w, (unsigned long long)p99_wr);
+
 	snprintf(buf, sizeof(buf) - 1, "%s-w", case_name);
 	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 1, 0);
 
@@ -234,6 +374,15 @@ int main()
 
 	muggle_benchmark_gen_reports_head(fp, &config);
 
+	snprintf(file_name, sizeof(file_name)-1, "benchmark_%s_summary.csv", config.name);
+	FILE *fp_summary = fopen(file_name, "wb");
+	if (fp_summary == NULL)
+	{
+		printf("failed open file: %s\n", file_name);
+		exit(1);
+	}
+	fprintf(fp_summary, "case_name,wake,msg_cnt,producer_sys_ns_per_msg,producer_csw_per_msg,w_p99_ns,wr_p99_ns\n");
+
 	int hc = (int)muggle_thread_hardware_concurrency();
 	if (hc <= 0)
 	{
@@ -266,25 +415,30 @@ int main()
 		{
 			flag = w_flags[w_flag] | r_flags[r_flag];
 
-			Benchmark_wr(fp, &config, 1, 1, flag);
+			Benchmark_wr(fp, fp_summary, &config, 1, 1, flag, 0);
+			Benchmark_wr(fp, fp_summary, &config, 1, 1, flag, 1);
 
 			if (!(flag & MUGGLE_RING_BUFFER_FLAG_SINGLE_READER))
 			{
-				Benchmark_wr(fp, &config, 1, hc_half, flag);
+				Benchmark_wr(fp, fp_summary, &config, 1, hc_half, flag, 0);
+				Benchmark_wr(fp, fp_summary, &config, 1, hc_half, flag, 1);
 			}
 
 			if (!(flag & MUGGLE_RING_BUFFER_FLAG_SINGLE_WRITER))
 			{
-				Benchmark_wr(fp, &config, hc_half, 1, flag);
+				Benchmark_wr(fp, fp_summary, &config, hc_half, 1, flag, 0);
+				Benchmark_wr(fp, fp_summary, &config, hc_half, 1, flag, 1);
 			}
 
 			if (!(flag & MUGGLE_RING_BUFFER_FLAG_SINGLE_WRITER) &&
 				!(flag & MUGGLE_RING_BUFFER_FLAG_SINGLE_READER))
 			{
-				Benchmark_wr(fp, &config, hc_half, hc_half, flag);
+				Benchmark_wr(fp, fp_summary, &config, hc_half, hc_half, flag, 0);
+				Benchmark_wr(fp, fp_summary, &config, hc_half, hc_half, flag, 1);
 			}
 		}
 	}
 
+	fclose(fp_summary);
 	fclose(fp);
 }
@@ -61,3 +61,104 @@ void run_array_blocking_queue(
 
 	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
 }
+
+void run_array_blocking_queue_mpmc(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_writer,
+	int num_reader,
+	muggle_benchmark_block_t *blocks)
+{
+	(void)flags;
+
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	init_blocks(args, blocks, num_writer);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = num_writer * (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
+	muggle_array_blocking_queue_t queue;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_array_blocking_queue_init(&queue, capacity))
+	{
+		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init %s ok", name);
+
+	for (int i = 0; i < num_writer; i++)
+	{
+		args[i].fn = array_blocking_queue_write;
+		args[i].trans_obj = (void*)&queue;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark %s", name);
+
+	run_thread_trans_mpmc_benchmark(args, num_writer, num_reader, array_blocking_queue_read);
+
+	MUGGLE_LOG_INFO("benchmark %s completed", name);
+
+	muggle_array_blocking_queue_destroy(&queue);
+
+	MUGGLE_LOG_INFO("gen report for benchmark %s", name);
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
+}
+
+int array_blocking_queue_read_timeout(void *trans_obj, void **data, const struct timespec *timeout)
+{
+	muggle_array_blocking_queue_t *queue = (muggle_array_blocking_queue_t*)trans_obj;
+	return muggle_array_blocking_queue_take_timeout(queue, data, timeout);
+}
+void run_array_blocking_queue_idle(
+	const char *name,
+	int flags,
+	int timeout_ms,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks)
+{
+	(void)flags;
+
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	init_blocks(args, blocks, num_thread);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = num_thread * (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
+	muggle_array_blocking_queue_t queue;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_array_blocking_queue_init(&queue, capacity) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init %s ok", name);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].fn = array_blocking_queue_write;
+		args[i].trans_obj = (void*)&queue;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark %s", name);
+
+	run_thread_trans_idle_benchmark(args, num_thread, array_blocking_queue_read_timeout, timeout_ms);
+
+	MUGGLE_LOG_INFO("benchmark %s completed", name);
+
+	muggle_array_blocking_queue_destroy(&queue);
+
+	MUGGLE_LOG_INFO("gen report for benchmark %s", name);
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
+}
@@ -18,5 +18,20 @@ void run_array_blocking_queue(
 	struct write_thread_args *args,
 	int num_thread,
 	muggle_benchmark_block_t *blocks);
+void run_array_blocking_queue_mpmc(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_writer,
+	int num_reader,
+	muggle_benchmark_block_t *blocks);
+int array_blocking_queue_read_timeout(void *trans_obj, void **data, const struct timespec *timeout);
+void run_array_blocking_queue_idle(
+	const char *name,
+	int flags,
+	int timeout_ms,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks);
 
 #endif
@@ -61,3 +61,158 @@ void run_channel(
 
 	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
 }
+
+int channel_write_batch(void *trans_obj, void **datas, int n)
+{
+	muggle_channel_t *chan = (muggle_channel_t*)trans_obj;
+	return muggle_channel_write_batch(chan, datas, n);
+}
+int channel_read_batch(void *trans_obj, void **datas, int n)
+{
+	muggle_channel_t *chan = (muggle_channel_t*)trans_obj;
+	return muggle_channel_read_batch(chan, datas, n);
+}
+void run_channel_batch(
+	const char *name,
+	int flags,
+	int batch_size,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks)
+{
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	init_blocks(args, blocks, num_thread);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = (int)(num_thread * args->cfg->loop * args->cfg->cnt_per_loop);
+	muggle_channel_t chan;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_channel_init(&chan, capacity, flags) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init %s ok", name);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].fn_batch = channel_write_batch;
+		args[i].batch_size = batch_size;
+		args[i].trans_obj = (void*)&chan;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark %s", name);
+
+	run_thread_trans_batch_benchmark(args, num_thread, channel_read_batch);
+
+	MUGGLE_LOG_INFO("benchmark %s completed", name);
+
+	muggle_channel_destroy(&chan);
+
+	MUGGLE_LOG_INFO("gen report for benchmark %s", name);
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
+}
+
+void run_channel_mpmc(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_writer,
+	int num_reader,
+	muggle_benchmark_block_t *blocks)
+{
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	init_blocks(args, blocks, num_writer);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = (int)(num_writer * args->cfg->loop * args->cfg->cnt_per_loop);
+	muggle_channel_t chan;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_channel_init(&chan, capacity, flags | MUGGLE_CHANNEL_FLAG_MULTI_READER) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init %s ok", name);
+
+	for (int i = 0; i < num_writer; i++)
+	{
+		args[i].fn = channel_write;
+		args[i].trans_obj = (void*)&chan;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark %s", name);
+
+	run_thread_trans_mpmc_benchmark(args, num_writer, num_reader, channel_read);
+
+	MUGGLE_LOG_INFO("benchmark %s completed", name);
+
+	muggle_channel_destroy(&chan);
+
+	MUGGLE_LOG_INFO("gen report for benchmark %s", name);
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
+}
+
+int channel_read_timeout(void *trans_obj, void **data, const struct timespec *timeout)
+{
+	muggle_channel_t *chan = (muggle_channel_t*)trans_obj;
+	return muggle_channel_read_timeout(chan, data, timeout);
+}
+void run_channel_idle(
+	const char *name,
+	int flags,
+	int timeout_ms,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks)
+{
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+
+	init_blocks(args, blocks, num_thread);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = num_thread * (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
+	muggle_channel_t chan;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_channel_init(&chan, capacity, flags) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init %s ok", name);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].fn = channel_write;
+		args[i].trans_obj = (void*)&chan;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark %s", name);
+
+	run_thread_trans_idle_benchmark(args, num_thread, channel_read_timeout, timeout_ms);
+
+	MUGGLE_LOG_INFO("benchmark %s completed", name);
+
+	muggle_channel_destroy(&chan);
+
+	MUGGLE_LOG_INFO("gen report for benchmark %s", name);
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
+}
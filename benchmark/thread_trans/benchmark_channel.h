@@ -18,5 +18,29 @@ void run_channel(
 	struct write_thread_args *args,
 	int num_thread,
 	muggle_benchmark_block_t *blocks);
+void run_channel_mpmc(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_writer,
+	int num_reader,
+	muggle_benchmark_block_t *blocks);
+int channel_write_batch(void *trans_obj, void **datas, int n);
+int channel_read_batch(void *trans_obj, void **datas, int n);
+void run_channel_batch(
+	const char *name,
+	int flags,
+	int batch_size,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks);
+int channel_read_timeout(void *trans_obj, void **data, const struct timespec *timeout);
+void run_channel_idle(
+	const char *name,
+	int flags,
+	int timeout_ms,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks);
 
 #endif
@@ -0,0 +1,184 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "benchmark_ipc_ring_buffer.h"
+
+#if !MUGGLE_PLATFORM_WINDOWS
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+#define IPC_RING_BUFFER_NAME "/muggle_benchmark_ipc_ring"
+
+int ipc_ring_buffer_write(void *trans_obj, void *data)
+{
+	muggle_ipc_ring_buffer_t *r = (muggle_ipc_ring_buffer_t*)trans_obj;
+	int idx = -1;
+	if (data == NULL)
+	{
+		// end message must not be lost
+		while (muggle_ipc_ring_buffer_write(r, &idx, sizeof(idx)) != MUGGLE_OK)
+		{
+			muggle_thread_yield();
+		}
+		return 0;
+	}
+
+	idx = (int)((muggle_benchmark_block_t*)data)->idx;
+	return muggle_ipc_ring_buffer_write(r, &idx, sizeof(idx));
+}
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+void run_ipc_ring_buffer(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks)
+{
+	(void)flags;
+	(void)args;
+	(void)num_thread;
+	(void)blocks;
+	MUGGLE_LOG_WARNING("benchmark %s need fork, skip it on windows", name);
+}
+
+#else
+
+static void ipc_ring_buffer_reader(int num_thread, struct timespec *recv_ts, int total_msg_num)
+{
+	muggle_ipc_ring_buffer_t r;
+	if (muggle_ipc_ring_buffer_attach(&r, IPC_RING_BUFFER_NAME) != MUGGLE_OK)
+	{
+		_exit(EXIT_FAILURE);
+	}
+
+	int recv_null = 0;
+	while (recv_null < num_thread)
+	{
+		int idx = -1;
+		int num_bytes = 0;
+		if (muggle_ipc_ring_buffer_read(&r, &idx, &num_bytes) != MUGGLE_OK)
+		{
+			_exit(EXIT_FAILURE);
+		}
+
+		if (idx < 0)
+		{
+			recv_null++;
+		}
+		else if (idx < total_msg_num)
+		{
+			timespec_get(&recv_ts[idx], TIME_UTC);
+		}
+	}
+
+	muggle_ipc_ring_buffer_detach(&r);
+	_exit(EXIT_SUCCESS);
+}
+
+void run_ipc_ring_buffer(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks)
+{
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	init_blocks(args, blocks, num_thread);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = num_thread * (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
+	muggle_ipc_ring_buffer_t r;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	muggle_ipc_ring_buffer_unlink(IPC_RING_BUFFER_NAME);
+	if (muggle_ipc_ring_buffer_create(&r, IPC_RING_BUFFER_NAME, capacity, sizeof(int), flags) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed create ipc ring buffer with capacity: %d", (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	// receive timestamp written by reader process
+	size_t ts_size = sizeof(struct timespec) * (size_t)total_msg_num;
+	struct timespec *recv_ts = (struct timespec*)mmap(
+		NULL, ts_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (recv_ts == MAP_FAILED)
+	{
+		MUGGLE_LOG_ERROR("failed mmap receive timestamp");
+		exit(EXIT_FAILURE);
+	}
+	memset(recv_ts, 0, ts_size);
+
+	MUGGLE_LOG_INFO("init ipc ring buffer ok");
+
+	pid_t pid = fork();
+	if (pid == -1)
+	{
+		MUGGLE_LOG_ERROR("failed fork reader process");
+		exit(EXIT_FAILURE);
+	}
+	if (pid == 0)
+	{
+		ipc_ring_buffer_reader(num_thread, recv_ts, total_msg_num);
+	}
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].fn = ipc_ring_buffer_write;
+		args[i].trans_obj = (void*)&r;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark ipc ring buffer");
+
+	muggle_thread_t *threads = (muggle_thread_t*)malloc(num_thread * sizeof(muggle_thread_t));
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_create(&threads[i], write_thread, &args[i]);
+	}
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_join(&threads[i]);
+	}
+	free(threads);
+
+	int status = 0;
+	waitpid(pid, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+	{
+		MUGGLE_LOG_ERROR("reader process exit abnormally");
+	}
+
+	int total_recv = 0;
+	for (int i = 0; i < total_msg_num; i++)
+	{
+		if (recv_ts[i].tv_sec != 0 || recv_ts[i].tv_nsec != 0)
+		{
+			blocks[i].ts[2] = recv_ts[i];
+			total_recv++;
+		}
+	}
+	MUGGLE_LOG_INFO("total send message: %d, total recv message %d, lost message: %d",
+		total_msg_num, total_recv, total_msg_num - total_recv);
+
+	MUGGLE_LOG_INFO("benchmark ipc ring buffer completed");
+
+	munmap(recv_ts, ts_size);
+	muggle_ipc_ring_buffer_detach(&r);
+	muggle_ipc_ring_buffer_unlink(IPC_RING_BUFFER_NAME);
+
+	MUGGLE_LOG_INFO("gen report for benchmark ipc ring buffer");
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark ipc ring buffer complete");
+}
+
+#endif
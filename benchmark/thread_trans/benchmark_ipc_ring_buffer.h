@@ -0,0 +1,26 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#ifndef BENCHMARK_IPC_RING_BUFFER_H_
+#define BENCHMARK_IPC_RING_BUFFER_H_
+
+#include "trans_runner.h"
+
+int ipc_ring_buffer_write(void *trans_obj, void *data);
+
+/**
+ * writers run in current process, reader runs in a forked process, reader
+ * store receive timestamp in anonymous shared memory
+ */
+void run_ipc_ring_buffer(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks);
+
+#endif
@@ -65,3 +65,130 @@ void run_ringbuffer(
 
 	MUGGLE_LOG_INFO("report for benchmark ring buffer complete");
 }
+
+int ringbuffer_write_batch(void *trans_obj, void **datas, int n)
+{
+	muggle_ring_buffer_t *ringbuf = (muggle_ring_buffer_t*)trans_obj;
+	if (n >= ringbuf->capacity)
+	{
+		n = ringbuf->capacity - 1;
+	}
+	if (muggle_ring_buffer_write_batch(ringbuf, datas, n) != MUGGLE_OK)
+	{
+		return 0;
+	}
+	return n;
+}
+int ringbuffer_read_batch(void *trans_obj, void **datas, int n)
+{
+	muggle_ring_buffer_t *ringbuf = (muggle_ring_buffer_t*)trans_obj;
+	muggle_atomic_int cnt = muggle_ring_buffer_read_batch(ringbuf, ringbuf_read_idx, datas, n);
+	ringbuf_read_idx += cnt;
+	return (int)cnt;
+}
+void run_ringbuffer_batch(
+	const char *name,
+	int flags,
+	int batch_size,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks)
+{
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	ringbuf_read_idx = 0;
+
+	init_blocks(args, blocks, num_thread);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = num_thread * (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
+	muggle_ring_buffer_t ringbuf;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_ring_buffer_init(&ringbuf, capacity, flags) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init ring buffer with capacity: %d", (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init ring buffer ok");
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].fn_batch = ringbuffer_write_batch;
+		args[i].batch_size = batch_size;
+		args[i].trans_obj = (void*)&ringbuf;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark ring buffer");
+
+	run_thread_trans_batch_benchmark(args, num_thread, ringbuffer_read_batch);
+
+	MUGGLE_LOG_INFO("benchmark ring buffer completed");
+
+	muggle_ring_buffer_destroy(&ringbuf);
+
+	MUGGLE_LOG_INFO("gen report for benchmark ring buffer");
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark ring buffer complete");
+}
+
+int ringbuffer_read_timeout(void *trans_obj, void **data, const struct timespec *timeout)
+{
+	muggle_ring_buffer_t *ringbuf = (muggle_ring_buffer_t*)trans_obj;
+	int ret = muggle_ring_buffer_read_timeout(ringbuf, ringbuf_read_idx, data, timeout);
+	if (ret == 0)
+	{
+		ringbuf_read_idx++;
+	}
+	return ret;
+}
+void run_ringbuffer_idle(
+	const char *name,
+	int flags,
+	int timeout_ms,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks)
+{
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	ringbuf_read_idx = 0;
+
+	init_blocks(args, blocks, num_thread);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = num_thread * (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
+	muggle_ring_buffer_t ringbuf;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_ring_buffer_init(&ringbuf, capacity, flags) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init %s ok", name);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].fn = ringbuffer_write;
+		args[i].trans_obj = (void*)&ringbuf;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark %s", name);
+
+	run_thread_trans_idle_benchmark(args, num_thread, ringbuffer_read_timeout, timeout_ms);
+
+	MUGGLE_LOG_INFO("benchmark %s completed", name);
+
+	muggle_ring_buffer_destroy(&ringbuf);
+
+	MUGGLE_LOG_INFO("gen report for benchmark %s", name);
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
+}
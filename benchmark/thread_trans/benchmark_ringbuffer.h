@@ -18,6 +18,23 @@ void run_ringbuffer(
 	struct write_thread_args *args,
 	int num_thread,
 	muggle_benchmark_block_t *blocks);
+int ringbuffer_write_batch(void *trans_obj, void **datas, int n);
+int ringbuffer_read_batch(void *trans_obj, void **datas, int n);
+void run_ringbuffer_batch(
+	const char *name,
+	int flags,
+	int batch_size,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks);
 
+int ringbuffer_read_timeout(void *trans_obj, void **data, const struct timespec *timeout);
+void run_ringbuffer_idle(
+	const char *name,
+	int flags,
+	int timeout_ms,
+	struct write_thread_args *args,
+	int num_thread,
+	muggle_benchmark_block_t *blocks);
 
 #endif
@@ -9,8 +9,9 @@
 #include "benchmark_channel.h"
 #include "benchmark_ringbuffer.h"
 #include "benchmark_array_blocking_queue.h"
+#include "benchmark_ipc_ring_buffer.h"
 
-#define PARAM_NUM 5
+#define PARAM_NUM 6
 
 int get_argv(int argc, int idx, char **argv, const char *name, int default_val)
 {
@@ -36,7 +37,7 @@ int main(int argc, char *argv[])
 	// convert input arguments
 	if (argc < PARAM_NUM)
 	{
-		MUGGLE_LOG_WARNING("usage: %s <num-thread> <rounds> <round-interval-ms> <msg-per-round>", argv[0]);
+		MUGGLE_LOG_WARNING("usage: %s <num-thread> <rounds> <round-interval-ms> <msg-per-round> <num-reader>", argv[0]);
 		MUGGLE_LOG_WARNING("missing arguments will use default value");
 	}
 
@@ -44,11 +45,13 @@ int main(int argc, char *argv[])
 	int rounds = get_argv(argc, 2, argv, "rounds", 10);
 	int round_interval = get_argv(argc, 3, argv, "round-interval-ms", 1);
 	int msg_per_round = get_argv(argc, 4, argv, "msg-per-round", 10000);
+	int num_reader = get_argv(argc, 5, argv, "num-reader", 2);
 
 	MUGGLE_LOG_INFO("num_thread: %d", num_thread);
 	MUGGLE_LOG_INFO("rounds: %d", rounds);
 	MUGGLE_LOG_INFO("round_interval: %d", round_interval);
 	MUGGLE_LOG_INFO("msg_per_round: %d", msg_per_round);
+	MUGGLE_LOG_INFO("num_reader: %d", num_reader);
 
 	muggle_benchmark_config_t benchmark_cfg;
 	memset(&benchmark_cfg, 0, sizeof(benchmark_cfg));
@@ -118,6 +121,89 @@ int main(int argc, char *argv[])
 	snprintf(name, sizeof(name), "array_blocking_queue_%dw_1r", num_thread);
 	run_array_blocking_queue(name, flags, args, num_thread, blocks);
 
+	// ipc ring buffer, reader in another process
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = num_thread == 1 ? MUGGLE_IPC_RING_BUFFER_FLAG_SINGLE_WRITER : MUGGLE_IPC_RING_BUFFER_FLAG_MULTI_WRITER;
+	snprintf(name, sizeof(name), "ipc_ring_buffer_%dw_1r_process", num_thread);
+	run_ipc_ring_buffer(name, flags, args, num_thread, blocks);
+
+	// multiple writer and multiple reader
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = 0;
+	snprintf(name, sizeof(name), "channel_%dw_mpmc_%dr", num_thread, num_reader);
+	run_channel_mpmc(name, flags, args, num_thread, num_reader, blocks);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP;
+	snprintf(name, sizeof(name), "channel_%dw_mpmc_%dr_busyloop", num_thread, num_reader);
+	run_channel_mpmc(name, flags, args, num_thread, num_reader, blocks);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = 0;
+	snprintf(name, sizeof(name), "array_blocking_queue_%dw_%dr", num_thread, num_reader);
+	run_array_blocking_queue_mpmc(name, flags, args, num_thread, num_reader, blocks);
+
+	// batch size sweep
+	int batch_sizes[] = { 1, 8, 32, 128 };
+	for (int i = 0; i < (int)(sizeof(batch_sizes) / sizeof(batch_sizes[0])); i++)
+	{
+		int batch_size = batch_sizes[i];
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = 0;
+		snprintf(name, sizeof(name), "channel_%dw_mutex_1r_batch%d", num_thread, batch_size);
+		run_channel_batch(name, flags, batch_size, args, num_thread, blocks);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = MUGGLE_CHANNEL_FLAG_WRITE_FUTEX;
+		snprintf(name, sizeof(name), "channel_%dw_futex_1r_batch%d", num_thread, batch_size);
+		run_channel_batch(name, flags, batch_size, args, num_thread, blocks);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = MUGGLE_RING_BUFFER_FLAG_WRITE_LOCK | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER;
+		snprintf(name, sizeof(name), "ringbuffer_%dw_lock_1r_single_batch%d", num_thread, batch_size);
+		run_ringbuffer_batch(name, flags, batch_size, args, num_thread, blocks);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = MUGGLE_RING_BUFFER_FLAG_WRITE_BUSY_LOOP | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER;
+		snprintf(name, sizeof(name), "ringbuffer_%dw_busyloop_1r_single_batch%d", num_thread, batch_size);
+		run_ringbuffer_batch(name, flags, batch_size, args, num_thread, blocks);
+	}
+
+	// idle reader: compare timed read with busy loop, writers are idle most of the time
+	muggle_benchmark_config_t idle_cfg;
+	memcpy(&idle_cfg, &benchmark_cfg, sizeof(idle_cfg));
+	idle_cfg.loop_interval_ms = 10;
+	if (idle_cfg.cnt_per_loop > 100)
+	{
+		idle_cfg.cnt_per_loop = 100;
+	}
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].cfg = &idle_cfg;
+	}
+
+	int timeouts[] = { 0, 1, 10 };
+	for (int i = 0; i < (int)(sizeof(timeouts) / sizeof(timeouts[0])); i++)
+	{
+		int timeout_ms = timeouts[i];
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = MUGGLE_CHANNEL_FLAG_WRITE_FUTEX;
+		snprintf(name, sizeof(name), "channel_%dw_futex_1r_idle_timeout%dms", num_thread, timeout_ms);
+		run_channel_idle(name, flags, timeout_ms, args, num_thread, blocks);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = MUGGLE_RING_BUFFER_FLAG_WRITE_LOCK | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER;
+		snprintf(name, sizeof(name), "ringbuffer_%dw_lock_1r_single_idle_timeout%dms", num_thread, timeout_ms);
+		run_ringbuffer_idle(name, flags, timeout_ms, args, num_thread, blocks);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = 0;
+		snprintf(name, sizeof(name), "array_blocking_queue_%dw_1r_idle_timeout%dms", num_thread, timeout_ms);
+		run_array_blocking_queue_idle(name, flags, timeout_ms, args, num_thread, blocks);
+	}
+
 	// free memory
 	free(args);
 	free(blocks);
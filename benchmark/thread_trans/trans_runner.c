@@ -47,6 +47,74 @@ muggle_thread_ret_t write_thread(void *p_arg)
 	return 0;
 }
 
+muggle_thread_ret_t write_batch_thread(void *p_arg)
+{
+	struct write_thread_args *arg = (struct write_thread_args*)p_arg;
+
+	muggle_msleep(1);
+
+	fn_trans_write_batch trans_fn = arg->fn_batch;
+	void *trans_obj = arg->trans_obj;
+	int batch_size = arg->batch_size;
+	void **datas = (void**)malloc(sizeof(void*) * batch_size);
+
+	int idx = 0;
+	for (uint64_t i = 0; i < arg->cfg->loop; i++)
+	{
+		uint64_t j = 0;
+		while (j < arg->cfg->cnt_per_loop)
+		{
+			int n = batch_size;
+			if ((uint64_t)n > arg->cfg->cnt_per_loop - j)
+			{
+				n = (int)(arg->cfg->cnt_per_loop - j);
+			}
+
+			struct timespec ts;
+			timespec_get(&ts, TIME_UTC);
+			for (int k = 0; k < n; k++)
+			{
+				arg->blocks[idx + k].ts[0] = ts;
+				datas[k] = &arg->blocks[idx + k];
+			}
+
+			int n_written = 0;
+			while (n_written < n)
+			{
+				n_written += trans_fn(trans_obj, datas + n_written, n - n_written);
+			}
+
+			timespec_get(&ts, TIME_UTC);
+			for (int k = 0; k < n; k++)
+			{
+				arg->blocks[idx + k].ts[1] = ts;
+			}
+
+			idx += n;
+			j += (uint64_t)n;
+		}
+
+		if (arg->cfg->loop_interval_ms > 0)
+		{
+			muggle_msleep((unsigned long)arg->cfg->loop_interval_ms);
+		}
+	}
+
+	MUGGLE_LOG_INFO("write thread exit");
+
+	// for wait all thread write data completed
+	muggle_msleep(100);
+	datas[0] = NULL;
+	while (trans_fn(trans_obj, datas, 1) != 1)
+	{
+		continue;
+	}
+
+	free(datas);
+
+	return 0;
+}
+
 void init_blocks(struct write_thread_args *args, muggle_benchmark_block_t *blocks, int num_thread)
 {
 	int msg_per_thread = (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
@@ -118,6 +186,272 @@ void run_thread_trans_benchmark(struct write_thread_args *args, int num_thread,
 	free(threads);
 }
 
+void run_thread_trans_batch_benchmark(struct write_thread_args *args, int num_thread, fn_trans_read_batch fn_read_batch)
+{
+	struct timespec ts_begin, ts_end;
+	timespec_get(&ts_begin, TIME_UTC);
+
+	muggle_thread_t *threads = (muggle_thread_t*)malloc(num_thread * sizeof(muggle_thread_t));
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_create(&threads[i], write_batch_thread, &args[i]);
+	}
+
+	int recv_null = 0;
+	void *trans_obj = args[0].trans_obj;
+	int batch_size = args[0].batch_size;
+	void **datas = (void**)malloc(sizeof(void*) * batch_size);
+
+	int total_recv = 0;
+	while (recv_null < num_thread)
+	{
+		int n = fn_read_batch(trans_obj, datas, batch_size);
+
+		struct timespec ts;
+		timespec_get(&ts, TIME_UTC);
+		for (int i = 0; i < n; i++)
+		{
+			if (datas[i])
+			{
+				muggle_benchmark_block_t *block = (muggle_benchmark_block_t*)datas[i];
+				block->ts[2] = ts;
+				total_recv++;
+			}
+			else
+			{
+				recv_null++;
+				MUGGLE_LOG_INFO("recv thread end");
+			}
+		}
+	}
+
+	// writer threads sleep 100ms before send NULL, exclude it from throughput
+	timespec_get(&ts_end, TIME_UTC);
+	double elapsed_ms =
+		(ts_end.tv_sec - ts_begin.tv_sec) * 1000.0 + (ts_end.tv_nsec - ts_begin.tv_nsec) / 1000000.0 - 100.0;
+	if (elapsed_ms > 0)
+	{
+		MUGGLE_LOG_INFO("batch size: %d, elapsed: %.3f ms, throughput: %.0f msg/s",
+			batch_size, elapsed_ms, total_recv / elapsed_ms * 1000.0);
+	}
+
+	int total_msg_num = num_thread * (int)args[0].cfg->loop * (int)args[0].cfg->cnt_per_loop;
+	if (total_recv != total_msg_num)
+	{
+		MUGGLE_LOG_WARNING("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, total_recv, total_msg_num - total_recv);
+	}
+	else
+	{
+		MUGGLE_LOG_INFO("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, total_recv, total_msg_num - total_recv);
+	}
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_join(&threads[i]);
+	}
+
+	free(datas);
+	free(threads);
+}
+
+struct read_thread_args
+{
+	void              *trans_obj;
+	fn_trans_read     fn;
+	void              *exit_data;
+	muggle_atomic_int *total_recv;
+};
+
+static muggle_thread_ret_t read_thread(void *p_arg)
+{
+	struct read_thread_args *arg = (struct read_thread_args*)p_arg;
+
+	int recv_cnt = 0;
+	while (1)
+	{
+		void *data = arg->fn(arg->trans_obj);
+		if (data == arg->exit_data)
+		{
+			break;
+		}
+
+		// NULL is end message of each writer, readers exit with exit_data
+		if (data)
+		{
+			muggle_benchmark_block_t *block = (muggle_benchmark_block_t*)data;
+			timespec_get(&block->ts[2], TIME_UTC);
+			recv_cnt++;
+		}
+	}
+
+	muggle_atomic_fetch_add(arg->total_recv, recv_cnt, muggle_memory_order_relaxed);
+
+	return 0;
+}
+
+void run_thread_trans_mpmc_benchmark(struct write_thread_args *args, int num_writer, int num_reader, fn_trans_read fn_read)
+{
+	void *trans_obj = args[0].trans_obj;
+	int exit_data = 0;
+	muggle_atomic_int total_recv = 0;
+
+	struct read_thread_args read_args;
+	read_args.trans_obj = trans_obj;
+	read_args.fn = fn_read;
+	read_args.exit_data = &exit_data;
+	read_args.total_recv = &total_recv;
+
+	muggle_thread_t *readers = (muggle_thread_t*)malloc(num_reader * sizeof(muggle_thread_t));
+	for (int i = 0; i < num_reader; i++)
+	{
+		muggle_thread_create(&readers[i], read_thread, &read_args);
+	}
+
+	muggle_thread_t *writers = (muggle_thread_t*)malloc(num_writer * sizeof(muggle_thread_t));
+	for (int i = 0; i < num_writer; i++)
+	{
+		muggle_thread_create(&writers[i], write_thread, &args[i]);
+	}
+
+	for (int i = 0; i < num_writer; i++)
+	{
+		muggle_thread_join(&writers[i]);
+	}
+
+	for (int i = 0; i < num_reader; i++)
+	{
+		while (args[0].fn(trans_obj, &exit_data) != 0)
+		{
+			continue;
+		}
+	}
+
+	for (int i = 0; i < num_reader; i++)
+	{
+		muggle_thread_join(&readers[i]);
+	}
+
+	int total_msg_num = num_writer * (int)args[0].cfg->loop * (int)args[0].cfg->cnt_per_loop;
+	if (total_recv != total_msg_num)
+	{
+		MUGGLE_LOG_WARNING("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, (int)total_recv, total_msg_num - (int)total_recv);
+	}
+	else
+	{
+		MUGGLE_LOG_INFO("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, (int)total_recv, total_msg_num - (int)total_recv);
+	}
+
+	free(writers);
+	free(readers);
+}
+
+static double get_thread_cpu_ms()
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+	{
+		return 0.0;
+	}
+	ULARGE_INTEGER k, u;
+	k.LowPart = kernel_time.dwLowDateTime;
+	k.HighPart = kernel_time.dwHighDateTime;
+	u.LowPart = user_time.dwLowDateTime;
+	u.HighPart = user_time.dwHighDateTime;
+	return (double)(k.QuadPart + u.QuadPart) / 10000.0;
+#else
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+	{
+		return 0.0;
+	}
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+void run_thread_trans_idle_benchmark(
+	struct write_thread_args *args, int num_thread, fn_trans_read_timeout fn_read_timeout, int timeout_ms)
+{
+	muggle_thread_t *threads = (muggle_thread_t*)malloc(num_thread * sizeof(muggle_thread_t));
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_create(&threads[i], write_thread, &args[i]);
+	}
+
+	void *trans_obj = args[0].trans_obj;
+	struct timespec timeout;
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+
+	struct timespec ts_begin, ts_end;
+	timespec_get(&ts_begin, TIME_UTC);
+	double cpu_begin = get_thread_cpu_ms();
+
+	int recv_null = 0;
+	int total_recv = 0;
+	int64_t loop_cnt = 0;
+	int64_t timeout_cnt = 0;
+	while (recv_null < num_thread)
+	{
+		loop_cnt++;
+
+		void *data = NULL;
+		if (fn_read_timeout(trans_obj, &data, &timeout) != 0)
+		{
+			// here event loop could handle timers
+			timeout_cnt++;
+			if (timeout_ms == 0)
+			{
+				muggle_thread_yield();
+			}
+			continue;
+		}
+
+		if (data)
+		{
+			muggle_benchmark_block_t *block = (muggle_benchmark_block_t*)data;
+			timespec_get(&block->ts[2], TIME_UTC);
+			total_recv++;
+		}
+		else
+		{
+			recv_null++;
+			MUGGLE_LOG_INFO("recv thread end");
+		}
+	}
+
+	double cpu_ms = get_thread_cpu_ms() - cpu_begin;
+	timespec_get(&ts_end, TIME_UTC);
+	double elapsed_ms =
+		(ts_end.tv_sec - ts_begin.tv_sec) * 1000.0 + (ts_end.tv_nsec - ts_begin.tv_nsec) / 1000000.0;
+	MUGGLE_LOG_INFO("reader timeout: %d ms, elapsed: %.3f ms, reader cpu: %.3f ms, cpu usage: %.2f%%, "
+		"loop: %lld, timeout: %lld",
+		timeout_ms, elapsed_ms, cpu_ms, elapsed_ms > 0 ? cpu_ms / elapsed_ms * 100.0 : 0.0,
+		(long long)loop_cnt, (long long)timeout_cnt);
+
+	int total_msg_num = num_thread * (int)args[0].cfg->loop * (int)args[0].cfg->cnt_per_loop;
+	if (total_recv != total_msg_num)
+	{
+		MUGGLE_LOG_WARNING("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, total_recv, total_msg_num - total_recv);
+	}
+	else
+	{
+		MUGGLE_LOG_INFO("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, total_recv, total_msg_num - total_recv);
+	}
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_join(&threads[i]);
+	}
+
+	free(threads);
+}
 
 /****************** report ******************/
 void gen_benchmark_report(const char *name, muggle_benchmark_block_t *blocks, muggle_benchmark_config_t *cfg, int cnt)
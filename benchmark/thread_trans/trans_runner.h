@@ -13,11 +13,16 @@
 
 typedef int (*fn_trans_write)(void *trans_obj, void *data);
 typedef void* (*fn_trans_read)(void *trans_obj);
+typedef int (*fn_trans_write_batch)(void *trans_obj, void **datas, int n);
+typedef int (*fn_trans_read_batch)(void *trans_obj, void **datas, int n);
+typedef int (*fn_trans_read_timeout)(void *trans_obj, void **data, const struct timespec *timeout);
 
 struct write_thread_args
 {
 	void                      *trans_obj;
 	fn_trans_write            fn;
+	fn_trans_write_batch      fn_batch;
+	int                       batch_size;
 	muggle_benchmark_block_t  *blocks;
 	muggle_benchmark_config_t *cfg;
 };
@@ -25,10 +30,23 @@ struct write_thread_args
 /****************** run thread ******************/
 muggle_thread_ret_t write_thread(void *p_arg);
 
+muggle_thread_ret_t write_batch_thread(void *p_arg);
+
 void init_blocks(struct write_thread_args *args, muggle_benchmark_block_t *blocks, int num_thread);
 
 void run_thread_trans_benchmark(struct write_thread_args *args, int num_thread, fn_trans_read fn_read);
 
+void run_thread_trans_batch_benchmark(struct write_thread_args *args, int num_thread, fn_trans_read_batch fn_read_batch);
+
+void run_thread_trans_mpmc_benchmark(struct write_thread_args *args, int num_writer, int num_reader, fn_trans_read fn_read);
+
+/**
+ * reader loop like a event loop thread, wait message at most timeout_ms in
+ * every iteration; timeout_ms == 0 means busy loop with non-blocking read
+ */
+void run_thread_trans_idle_benchmark(
+	struct write_thread_args *args, int num_thread, fn_trans_read_timeout fn_read_timeout, int timeout_ms);
+
 /****************** report ******************/
 void gen_benchmark_report(const char *name, muggle_benchmark_block_t *blocks, muggle_benchmark_config_t *cfg, int cnt);
 
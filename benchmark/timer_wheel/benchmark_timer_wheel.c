@@ -0,0 +1,266 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "muggle_benchmark/muggle_benchmark.h"
+
+#define PARAM_NUM 3
+
+// delay of timers in millisecond, like heartbeat and idle timeout
+#define TIMER_MIN_DELAY_MS 1000
+#define TIMER_MAX_DELAY_MS 60000
+
+enum
+{
+	TIMER_WHEEL_OP_ADD,
+	TIMER_WHEEL_OP_RESET,
+	TIMER_WHEEL_OP_CANCEL,
+};
+
+static const char *s_op_names[] = {
+	"add",
+	"reset",
+	"cancel",
+};
+
+static uint64_t s_now_ms = 0;
+static uint64_t s_cnt_expired = 0;
+
+int get_argv(int argc, int idx, char **argv, const char *name, int default_val)
+{
+	int val;
+	if (idx >= PARAM_NUM || idx >= argc || !muggle_str_toi(argv[idx], &val, 10))
+	{
+		MUGGLE_LOG_WARNING("failed get value of %s, use default val: %d", name, default_val);
+		val = default_val;
+	}
+
+	return val;
+}
+
+static uint64_t rand_delay(uint64_t *seed)
+{
+	// xorshift64
+	uint64_t x = *seed;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	*seed = x;
+
+	return TIMER_MIN_DELAY_MS + x % (TIMER_MAX_DELAY_MS - TIMER_MIN_DELAY_MS);
+}
+
+static void on_expire(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	(void)wheel;
+	(void)timer;
+
+	++s_cnt_expired;
+}
+
+static void log_elapsed(const char *name, uint64_t total, struct timespec *ts_begin, struct timespec *ts_end)
+{
+	uint64_t elapsed_ns =
+		(uint64_t)(ts_end->tv_sec - ts_begin->tv_sec) * 1000000000 +
+		ts_end->tv_nsec - ts_begin->tv_nsec;
+	MUGGLE_LOG_INFO("%s: %llu ops, elapsed %.3f ms, %.1f ns/op (include timestamps)",
+		name, (unsigned long long)total,
+		(double)elapsed_ns / 1000000.0, (double)elapsed_ns / (double)total);
+}
+
+/**
+ * add, reset or cancel cnt_per_loop timers while wheel hold active timers
+ */
+void run_op(
+	int op, muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timers,
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks, FILE *fp)
+{
+	uint64_t seed = 0x9e3779b97f4a7c15ULL;
+	uint64_t total = cfg->loop * cfg->cnt_per_loop;
+
+	struct timespec ts_begin, ts_end;
+	timespec_get(&ts_begin, TIME_UTC);
+
+	uint64_t idx = 0;
+	for (uint64_t i = 0; i < cfg->loop; i++)
+	{
+		if (op != TIMER_WHEEL_OP_ADD)
+		{
+			for (uint64_t j = 0; j < cfg->cnt_per_loop; j++)
+			{
+				muggle_timer_wheel_add(wheel, &timers[j], rand_delay(&seed), 0);
+			}
+		}
+
+		for (uint64_t j = 0; j < cfg->cnt_per_loop; j++)
+		{
+			memset(&blocks[idx], 0, sizeof(blocks[idx]));
+			blocks[idx].idx = idx;
+
+			uint64_t delay = rand_delay(&seed);
+			muggle_timer_wheel_timer_t *timer = &timers[(j * 7919) % cfg->cnt_per_loop];
+
+			timespec_get(&blocks[idx].ts[0], TIME_UTC);
+			switch (op)
+			{
+			case TIMER_WHEEL_OP_ADD:
+			case TIMER_WHEEL_OP_RESET:
+				{
+					muggle_timer_wheel_add(wheel, timer, delay, 0);
+				}break;
+			case TIMER_WHEEL_OP_CANCEL:
+				{
+					muggle_timer_wheel_cancel(wheel, timer);
+				}break;
+			}
+			timespec_get(&blocks[idx].ts[1], TIME_UTC);
+
+			idx++;
+		}
+
+		if (op != TIMER_WHEEL_OP_CANCEL)
+		{
+			for (uint64_t j = 0; j < cfg->cnt_per_loop; j++)
+			{
+				muggle_timer_wheel_cancel(wheel, &timers[j]);
+			}
+		}
+	}
+
+	timespec_get(&ts_end, TIME_UTC);
+	log_elapsed(s_op_names[op], total, &ts_begin, &ts_end);
+
+	char report_name[128];
+	snprintf(report_name, sizeof(report_name), "%s", s_op_names[op]);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, report_name, total, 0, 1, 0);
+
+	snprintf(report_name, sizeof(report_name), "%s-sorted", s_op_names[op]);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, report_name, total, 0, 1, 1);
+}
+
+/**
+ * drive wheel like event loop, every step get next timeout then advance
+ * 1 millisecond, periodic active timers keep expiring
+ */
+void run_advance(
+	muggle_timer_wheel_t *wheel,
+	muggle_benchmark_config_t *cfg, muggle_benchmark_block_t *blocks, FILE *fp)
+{
+	uint64_t total = cfg->loop * cfg->cnt_per_loop;
+	s_cnt_expired = 0;
+
+	struct timespec ts_begin, ts_end;
+	timespec_get(&ts_begin, TIME_UTC);
+
+	for (uint64_t idx = 0; idx < total; idx++)
+	{
+		memset(&blocks[idx], 0, sizeof(blocks[idx]));
+		blocks[idx].idx = idx;
+
+		s_now_ms++;
+
+		timespec_get(&blocks[idx].ts[0], TIME_UTC);
+		muggle_timer_wheel_next_timeout(wheel, s_now_ms);
+		timespec_get(&blocks[idx].ts[1], TIME_UTC);
+		muggle_timer_wheel_advance(wheel, s_now_ms);
+		timespec_get(&blocks[idx].ts[2], TIME_UTC);
+	}
+
+	timespec_get(&ts_end, TIME_UTC);
+	log_elapsed("advance", total, &ts_begin, &ts_end);
+	MUGGLE_LOG_INFO("advance: %llu ms, %llu timers expired",
+		(unsigned long long)total, (unsigned long long)s_cnt_expired);
+
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, "next_timeout", total, 0, 1, 0);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, "next_timeout-sorted", total, 0, 1, 1);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, "advance", total, 1, 2, 0);
+	muggle_benchmark_gen_reports_body(fp, cfg, blocks, "advance-sorted", total, 1, 2, 1);
+}
+
+int main(int argc, char *argv[])
+{
+	// init log
+	if (muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed initalize log");
+		exit(EXIT_FAILURE);
+	}
+
+	// convert input arguments
+	if (argc < PARAM_NUM)
+	{
+		MUGGLE_LOG_WARNING("usage: %s <rounds> <active-timers>", argv[0]);
+		MUGGLE_LOG_WARNING("missing arguments will use default value");
+	}
+
+	int rounds = get_argv(argc, 1, argv, "rounds", 5);
+	int num_timer = get_argv(argc, 2, argv, "active-timers", 100000);
+
+	MUGGLE_LOG_INFO("rounds: %d", rounds);
+	MUGGLE_LOG_INFO("active_timers: %d", num_timer);
+
+	muggle_benchmark_config_t benchmark_cfg;
+	memset(&benchmark_cfg, 0, sizeof(benchmark_cfg));
+	strncpy(benchmark_cfg.name, "timer_wheel", sizeof(benchmark_cfg.name) - 1);
+	benchmark_cfg.loop = rounds;
+	benchmark_cfg.loop_interval_ms = 0;
+	benchmark_cfg.cnt_per_loop = num_timer;
+	benchmark_cfg.report_step = 10;
+	benchmark_cfg.elapsed_unit = MUGGLE_BENCHMARK_ELAPSED_UNIT_NS;
+
+	char file_name[128];
+	snprintf(file_name, sizeof(file_name)-1, "benchmark_%s.csv", benchmark_cfg.name);
+	FILE *fp = fopen(file_name, "wb");
+	if (fp == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed open file: %s", file_name);
+		exit(EXIT_FAILURE);
+	}
+	muggle_benchmark_gen_reports_head(fp, &benchmark_cfg);
+
+	// allocate memory
+	uint64_t total_op_num = (uint64_t)rounds * num_timer;
+	muggle_benchmark_block_t *blocks =
+		(muggle_benchmark_block_t*)malloc(sizeof(muggle_benchmark_block_t) * total_op_num);
+	muggle_timer_wheel_timer_t *active_timers =
+		(muggle_timer_wheel_timer_t*)malloc(sizeof(muggle_timer_wheel_timer_t) * num_timer);
+	muggle_timer_wheel_timer_t *timers =
+		(muggle_timer_wheel_timer_t*)malloc(sizeof(muggle_timer_wheel_timer_t) * num_timer);
+
+	// active periodic timers, e.g. heartbeat of connections
+	muggle_timer_wheel_t wheel;
+	muggle_timer_wheel_init(&wheel, 1, s_now_ms);
+
+	uint64_t seed = 0x2545f4914f6cdd1dULL;
+	for (int i = 0; i < num_timer; i++)
+	{
+		uint64_t interval = rand_delay(&seed);
+		muggle_timer_wheel_timer_init(&active_timers[i], on_expire, NULL);
+		muggle_timer_wheel_add(&wheel, &active_timers[i], rand_delay(&seed), interval);
+		muggle_timer_wheel_timer_init(&timers[i], on_expire, NULL);
+	}
+
+	MUGGLE_LOG_INFO("=======================================================");
+	run_op(TIMER_WHEEL_OP_ADD, &wheel, timers, &benchmark_cfg, blocks, fp);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	run_op(TIMER_WHEEL_OP_RESET, &wheel, timers, &benchmark_cfg, blocks, fp);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	run_op(TIMER_WHEEL_OP_CANCEL, &wheel, timers, &benchmark_cfg, blocks, fp);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	run_advance(&wheel, &benchmark_cfg, blocks, fp);
+
+	// free memory
+	free(timers);
+	free(active_timers);
+	free(blocks);
+
+	fclose(fp);
+
+	return 0;
+}
@@ -20,6 +20,10 @@ int get_event_loop_type(const char *str_loop_type)
 	{
 		event_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL;
 	}
+	else if (strcmp(str_loop_type, "io_uring") == 0)
+	{
+		event_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_IO_URING;
+	}
 	else if (strcmp(str_loop_type, "iocp") == 0)
 	{
 		event_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_IOCP;
@@ -53,7 +57,7 @@ int main(int argc, char *argv[])
 
 	if (argc < 3)
 	{
-		MUGGLE_LOG_ERROR("usage: %s <IP> <Port> [thread|select|poll|epoll|iocp|kqueue]", argv[0]);
+		MUGGLE_LOG_ERROR("usage: %s <IP> <Port> [thread|select|poll|epoll|io_uring|iocp|kqueue]", argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
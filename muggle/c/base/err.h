@@ -29,6 +29,8 @@ enum
 	MUGGLE_ERR_INTERRUPT,
 	MUGGLE_ERR_BEYOND_RANGE,
 	MUGGLE_ERR_FULL,
+	MUGGLE_ERR_EMPTY,
+	MUGGLE_ERR_TIMEOUT,
 
 	MUGGLE_ERR_CRYPT_PLAINTEXT_SIZE, // invalid plaintext size
 	MUGGLE_ERR_CRYPT_KEY_SIZE,       // invalid key size
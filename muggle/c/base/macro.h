@@ -152,6 +152,13 @@
 
 #endif // MUGGLE_PLATFORM_WINDOWS
 
+// thread local storage
+#if MUGGLE_PLATFORM_WINDOWS
+	#define MUGGLE_THREAD_LOCAL __declspec(thread)
+#else
+	#define MUGGLE_THREAD_LOCAL __thread
+#endif
+
 // cache line padding in structure
 #define MUGGLE_CACHE_LINE_SIZE 64
 #define MUGGLE_STRUCT_CACHE_LINE_PADDING(idx) char cache_line_padding_##idx[MUGGLE_CACHE_LINE_SIZE]
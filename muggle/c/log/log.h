@@ -17,31 +17,89 @@
 
 EXTERN_C_BEGIN
 
-#define MUGGLE_LOG_DEFAULT(level, format, ...) \
+/**
+ * @brief compile time log level
+ *
+ * MUGGLE_LOG_* calls lower than MUGGLE_LOG_ACTIVE_LEVEL are removed at
+ * compile time and their arguments are never evaluated, e.g. compile with
+ * -DMUGGLE_LOG_ACTIVE_LEVEL=MUGGLE_LOG_ACTIVE_INFO to drop trace and debug
+ */
+#define MUGGLE_LOG_ACTIVE_TRACE   0
+#define MUGGLE_LOG_ACTIVE_DEBUG   1
+#define MUGGLE_LOG_ACTIVE_INFO    2
+#define MUGGLE_LOG_ACTIVE_WARNING 3
+#define MUGGLE_LOG_ACTIVE_ERROR   4
+#define MUGGLE_LOG_ACTIVE_FATAL   5
+#define MUGGLE_LOG_ACTIVE_OFF     6
+
+#ifndef MUGGLE_LOG_ACTIVE_LEVEL
+	#define MUGGLE_LOG_ACTIVE_LEVEL MUGGLE_LOG_ACTIVE_TRACE
+#endif
+
+// whether MUGGLE_LOG_LEVEL_* is active at compile time
+#define MUGGLE_LOG_LEVEL_IS_ACTIVE(level) \
+	((level) >= (MUGGLE_LOG_ACTIVE_LEVEL << MUGGLE_LOG_LEVEL_OFFSET))
+
+/**
+ * @brief check level before source location and arguments are touched,
+ * source location is static, so nothing is built per call
+ */
+#define MUGGLE_LOG_IMPL(p_logger, level, format, ...) \
 do \
 { \
-	muggle_log_src_loc_t loc_arg##__LINE__ = { \
-		__FILE__, __LINE__, __FUNCTION__ \
-	}; \
-	muggle_logger_t *logger = muggle_logger_default(); \
-	logger->log(logger, level, &loc_arg##__LINE__, format, ##__VA_ARGS__); \
+	muggle_logger_t *muggle_log_logger = (p_logger); \
+	if (MUGGLE_LOG_LEVEL_IS_ACTIVE(level) && muggle_log_logger->lowest_log_level <= (level)) \
+	{ \
+		static const muggle_log_src_loc_t muggle_log_loc = { \
+			__FILE__, __LINE__, __FUNCTION__ \
+		}; \
+		muggle_log_logger->log(muggle_log_logger, level, &muggle_log_loc, format, ##__VA_ARGS__); \
+	} \
 } while (0)
 
+#define MUGGLE_LOG_DEFAULT(level, format, ...) \
+	MUGGLE_LOG_IMPL(muggle_logger_default(), level, format, ##__VA_ARGS__)
+
 #define MUGGLE_LOG(logger, level, format, ...) \
-do \
-{ \
-	muggle_log_src_loc_t loc_arg##__LINE__ = { \
-		__FILE__, __LINE__, __FUNCTION__ \
-	}; \
-	logger->log(logger, level, &loc_arg##__LINE__, format, ##__VA_ARGS__); \
-} while (0)
+	MUGGLE_LOG_IMPL(logger, level, format, ##__VA_ARGS__)
 
-#define MUGGLE_LOG_TRACE(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_TRACE, format, ##__VA_ARGS__)
-#define MUGGLE_LOG_DEBUG(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
-#define MUGGLE_LOG_INFO(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
-#define MUGGLE_LOG_WARNING(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
-#define MUGGLE_LOG_ERROR(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
-#define MUGGLE_LOG_FATAL(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_FATAL, format, ##__VA_ARGS__)
+#define MUGGLE_LOG_DISABLED(format, ...) do {} while (0)
+
+#if MUGGLE_LOG_ACTIVE_LEVEL <= MUGGLE_LOG_ACTIVE_TRACE
+	#define MUGGLE_LOG_TRACE(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_TRACE, format, ##__VA_ARGS__)
+#else
+	#define MUGGLE_LOG_TRACE(format, ...) MUGGLE_LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if MUGGLE_LOG_ACTIVE_LEVEL <= MUGGLE_LOG_ACTIVE_DEBUG
+	#define MUGGLE_LOG_DEBUG(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+	#define MUGGLE_LOG_DEBUG(format, ...) MUGGLE_LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if MUGGLE_LOG_ACTIVE_LEVEL <= MUGGLE_LOG_ACTIVE_INFO
+	#define MUGGLE_LOG_INFO(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+	#define MUGGLE_LOG_INFO(format, ...) MUGGLE_LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if MUGGLE_LOG_ACTIVE_LEVEL <= MUGGLE_LOG_ACTIVE_WARNING
+	#define MUGGLE_LOG_WARNING(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#else
+	#define MUGGLE_LOG_WARNING(format, ...) MUGGLE_LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if MUGGLE_LOG_ACTIVE_LEVEL <= MUGGLE_LOG_ACTIVE_ERROR
+	#define MUGGLE_LOG_ERROR(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+	#define MUGGLE_LOG_ERROR(format, ...) MUGGLE_LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if MUGGLE_LOG_ACTIVE_LEVEL <= MUGGLE_LOG_ACTIVE_FATAL
+	#define MUGGLE_LOG_FATAL(format, ...) MUGGLE_LOG_DEFAULT(MUGGLE_LOG_LEVEL_FATAL, format, ##__VA_ARGS__)
+#else
+	#define MUGGLE_LOG_FATAL(format, ...) MUGGLE_LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
 
 
 #if MUGGLE_RELEASE
@@ -63,7 +121,7 @@ do \
 { \
 	if (!(x)) \
 	{ \
-		muggle_log_src_loc_t loc_arg##__LINE__ = { \
+		static const muggle_log_src_loc_t loc_arg##__LINE__ = { \
 			__FILE__, __LINE__, __FUNCTION__ \
 		}; \
 		muggle_logger_t *logger = muggle_logger_default(); \
@@ -76,7 +134,7 @@ do \
 { \
 	if (!(x)) \
 	{ \
-		muggle_log_src_loc_t loc_arg##__LINE__ = { \
+		static const muggle_log_src_loc_t loc_arg##__LINE__ = { \
 			__FILE__, __LINE__, __FUNCTION__ \
 		}; \
 		muggle_logger_t *logger = muggle_logger_default(); \
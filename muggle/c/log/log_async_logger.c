@@ -3,64 +3,600 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include "muggle/c/os/stacktrace.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/log/log_level.h"
 #include "muggle/c/base/err.h"
 #include "muggle/c/sync/channel.h"
+#include "muggle/c/sync/futex.h"
+#include "muggle/c/memory/threadsafe_memory_pool.h"
+#include "muggle/c/log/log_deferred.h"
+
+enum
+{
+	MUGGLE_ASYNC_LOGGER_SLOT_TEXT = 0,  //!< payload is formatted text
+	MUGGLE_ASYNC_LOGGER_SLOT_DEFERRED,  //!< payload is binary record of muggle_log_deferred_encode
+	MUGGLE_ASYNC_LOGGER_SLOT_FLUSH,     //!< flush request, payload is pointer of done flag
+};
+
+/**
+ * @brief async logger message slot, payload or deferred record follow it
+ */
+typedef struct muggle_async_logger_slot
+{
+	muggle_log_msg_t  msg;
+	uint32_t          kind;        //!< MUGGLE_ASYNC_LOGGER_SLOT_*
+	uint32_t          record_len;  //!< bytes of deferred record
+	muggle_atomic_int ref;         //!< number of handler workers hold the slot
+}muggle_async_logger_slot_t;
+
+/**
+ * @brief output buffered records of handlers in logger thread, handlers
+ * with worker are flushed by their worker
+ */
+static void muggle_async_logger_flush_output(muggle_async_logger_t *logger)
+{
+	if (logger->workers == NULL)
+	{
+		muggle_logger_flush_handlers((muggle_logger_t*)logger);
+	}
+}
+
+/**
+ * @brief release reference of slot, the last one recycle it
+ */
+static void muggle_async_logger_slot_release(muggle_async_logger_slot_t *slot)
+{
+	if (muggle_atomic_fetch_sub(&slot->ref, 1, muggle_memory_order_acq_rel) != 1)
+	{
+		return;
+	}
+
+	if (slot->kind == MUGGLE_ASYNC_LOGGER_SLOT_FLUSH)
+	{
+		muggle_atomic_int *done = NULL;
+		memcpy(&done, slot + 1, sizeof(done));
+		muggle_ts_memory_pool_free(slot);
+		muggle_atomic_store(done, 1, muggle_memory_order_release);
+	}
+	else
+	{
+		muggle_ts_memory_pool_free(slot);
+	}
+}
+
+/**
+ * @brief handler worker, write messages of its ring into handler
+ */
+static muggle_thread_ret_t muggle_async_logger_worker_run(void *arg)
+{
+	muggle_async_logger_worker_t *worker = (muggle_async_logger_worker_t*)arg;
+	muggle_log_handler_t *handler = worker->handler;
+	bool dirty = false;
+	while (1)
+	{
+		muggle_async_logger_slot_t *slot = NULL;
+		if (muggle_channel_try_read(&worker->channel, (void**)&slot) != MUGGLE_OK)
+		{
+			// ring drained, output buffered records before wait
+			if (dirty)
+			{
+				muggle_log_handler_flush(handler);
+				dirty = false;
+			}
+			slot = muggle_channel_read(&worker->channel);
+		}
+
+		if (slot == NULL)
+		{
+			break;
+		}
+
+		if (slot->kind == MUGGLE_ASYNC_LOGGER_SLOT_FLUSH)
+		{
+			muggle_log_handler_flush(handler);
+			dirty = false;
+		}
+		else
+		{
+			handler->write(handler, &slot->msg);
+			dirty = true;
+			muggle_atomic_fetch_add64(&worker->cnt_write, 1, muggle_memory_order_release);
+		}
+
+		muggle_async_logger_slot_release(slot);
+	}
+
+	muggle_log_handler_flush(handler);
+
+	return 0;
+}
+
+/**
+ * @brief share slot to workers of handlers accept it
+ */
+static void muggle_async_logger_dispatch(muggle_async_logger_t *logger, muggle_async_logger_slot_t *slot)
+{
+	bool is_flush = slot->kind == MUGGLE_ASYNC_LOGGER_SLOT_FLUSH;
+
+	// decide targets before slot is visible to any worker
+	int targets[MUGGLE_LOGGER_MAX_HANDLER];
+	int cnt = 0;
+	for (int i = 0; i < logger->num_worker; i++)
+	{
+		if (is_flush || muggle_log_handler_should_write(logger->workers[i].handler, slot->msg.level))
+		{
+			targets[cnt++] = i;
+		}
+	}
+
+	muggle_atomic_store(&slot->ref, cnt + 1, muggle_memory_order_relaxed);
+
+	for (int i = 0; i < cnt; i++)
+	{
+		muggle_async_logger_worker_t *worker = &logger->workers[targets[i]];
+		if (is_flush)
+		{
+			// flush request never dropped
+			while (muggle_channel_write(&worker->channel, slot) != 0)
+			{
+				muggle_thread_yield();
+			}
+			continue;
+		}
+
+		if (muggle_channel_write(&worker->channel, slot) == 0)
+		{
+			int64_t cnt_push = muggle_atomic_fetch_add64(&worker->cnt_push, 1, muggle_memory_order_relaxed) + 1;
+			int64_t lag = cnt_push - muggle_atomic_fetch_add64(&worker->cnt_write, 0, muggle_memory_order_acquire);
+			if (lag > worker->max_lag)
+			{
+				muggle_atomic_exchange64(&worker->max_lag, lag, muggle_memory_order_relaxed);
+			}
+		}
+		else
+		{
+			muggle_atomic_fetch_add64(&worker->cnt_drop, 1, muggle_memory_order_relaxed);
+			muggle_async_logger_slot_release(slot);
+		}
+	}
+
+	// reference of logger thread
+	muggle_async_logger_slot_release(slot);
+}
+
+/**
+ * @brief handle message slot in logger thread and recycle it
+ */
+static void muggle_async_logger_handle_slot(
+	muggle_async_logger_t *logger, muggle_async_logger_slot_t *slot, bool *dirty)
+{
+	if (slot->kind == MUGGLE_ASYNC_LOGGER_SLOT_DEFERRED)
+	{
+		int n = muggle_log_deferred_decode((const char*)(slot + 1), slot->record_len,
+			logger->decode_buf, MUGGLE_LOG_MSG_MAX_LEN);
+		slot->msg.payload = logger->decode_buf;
+
+		if (logger->workers)
+		{
+			// workers format it later, move text into slot, record is useless now
+			if (n < 0)
+			{
+				n = 0;
+			}
+			if ((size_t)n >= logger->payload_size)
+			{
+				n = (int)logger->payload_size - 1;
+			}
+			memcpy(slot + 1, logger->decode_buf, (size_t)n);
+			((char*)(slot + 1))[n] = '\0';
+			slot->msg.payload = (const char*)(slot + 1);
+		}
+	}
+
+	if (logger->workers)
+	{
+		muggle_async_logger_dispatch(logger, slot);
+		return;
+	}
+
+	if (slot->kind == MUGGLE_ASYNC_LOGGER_SLOT_FLUSH)
+	{
+		muggle_logger_flush_handlers((muggle_logger_t*)logger);
+		*dirty = false;
+
+		muggle_atomic_int *done = NULL;
+		memcpy(&done, slot + 1, sizeof(done));
+		muggle_ts_memory_pool_free(slot);
+		muggle_atomic_store(done, 1, muggle_memory_order_release);
+		return;
+	}
+
+	muggle_logger_write((muggle_logger_t*)logger, &slot->msg);
+	*dirty = true;
+
+	muggle_ts_memory_pool_free(slot);
+}
 
 static muggle_thread_ret_t muggle_async_logger_run(void *arg)
 {
 	muggle_async_logger_t *logger = (muggle_async_logger_t*)arg;
+	bool dirty = false;
+	while (1)
+	{
+		muggle_async_logger_slot_t *slot = NULL;
+		if (muggle_channel_try_read(&logger->channel, (void**)&slot) != MUGGLE_OK)
+		{
+			// channel drained, output buffered records before wait
+			if (dirty)
+			{
+				muggle_async_logger_flush_output(logger);
+				dirty = false;
+			}
+			slot = muggle_channel_read(&logger->channel);
+		}
+
+		if (slot == NULL)
+		{
+			break;
+		}
+
+		muggle_async_logger_handle_slot(logger, slot, &dirty);
+	}
+
+	muggle_async_logger_flush_output(logger);
+
+	return 0;
+}
+
+/**
+ * @brief fill empty heads of lanes and shared channel
+ *
+ * heads[max_lane] is head of shared channel, stop is set when read NULL
+ * from shared channel
+ *
+ * @return number of non-empty heads
+ */
+static int muggle_async_logger_refill(
+	muggle_async_logger_t *logger, muggle_async_logger_slot_t **heads, bool *stop)
+{
+	int cnt = 0;
+
+	int num_lane = (int)muggle_atomic_load(&logger->num_lane, muggle_memory_order_acquire);
+	if (num_lane > logger->max_lane)
+	{
+		num_lane = logger->max_lane;
+	}
+
+	for (int i = 0; i < num_lane; i++)
+	{
+		if (heads[i] == NULL)
+		{
+			muggle_async_logger_lane_t *lane = &logger->lanes[i];
+			if (muggle_atomic_load(&lane->ready, muggle_memory_order_acquire) == 0 ||
+				muggle_channel_try_read(&lane->channel, (void**)&heads[i]) != MUGGLE_OK)
+			{
+				heads[i] = NULL;
+				continue;
+			}
+		}
+		cnt++;
+	}
+
+	muggle_async_logger_slot_t **shared_head = &heads[logger->max_lane];
+	if (*shared_head == NULL && !*stop)
+	{
+		void *data = NULL;
+		if (muggle_channel_try_read(&logger->channel, &data) == MUGGLE_OK)
+		{
+			if (data == NULL)
+			{
+				*stop = true;
+			}
+			*shared_head = (muggle_async_logger_slot_t*)data;
+		}
+	}
+	if (*shared_head)
+	{
+		cnt++;
+	}
+
+	return cnt;
+}
+
+/**
+ * @brief write available messages of all lanes in timestamp order
+ *
+ * @return number of handled messages
+ */
+static int muggle_async_logger_merge(
+	muggle_async_logger_t *logger, muggle_async_logger_slot_t **heads, bool *stop, bool *dirty)
+{
+	int cnt = 0;
+	while (muggle_async_logger_refill(logger, heads, stop) > 0)
+	{
+		int min_idx = -1;
+		for (int i = 0; i <= logger->max_lane; i++)
+		{
+			if (heads[i] == NULL)
+			{
+				continue;
+			}
+
+			if (min_idx == -1)
+			{
+				min_idx = i;
+				continue;
+			}
+
+			const struct timespec *ts = &heads[i]->msg.ts;
+			const struct timespec *min_ts = &heads[min_idx]->msg.ts;
+			if (ts->tv_sec < min_ts->tv_sec ||
+				(ts->tv_sec == min_ts->tv_sec && ts->tv_nsec < min_ts->tv_nsec))
+			{
+				min_idx = i;
+			}
+		}
+
+		muggle_async_logger_slot_t *slot = heads[min_idx];
+		heads[min_idx] = NULL;
+		muggle_async_logger_handle_slot(logger, slot, dirty);
+		cnt++;
+	}
+
+	return cnt;
+}
+
+static muggle_thread_ret_t muggle_async_logger_run_lanes(void *arg)
+{
+	muggle_async_logger_t *logger = (muggle_async_logger_t*)arg;
+
+	muggle_async_logger_slot_t **heads = (muggle_async_logger_slot_t**)
+		calloc((size_t)logger->max_lane + 1, sizeof(muggle_async_logger_slot_t*));
+	if (heads == NULL)
+	{
+		fprintf(stderr, "async logger failed allocate lane heads\n");
+		return 0;
+	}
+
+	bool dirty = false;
+	bool stop = false;
 	while (1)
 	{
-		muggle_log_msg_t *msg = muggle_channel_read(&logger->channel);
-		if (msg == NULL)
+		if (muggle_async_logger_merge(logger, heads, &stop, &dirty) > 0)
+		{
+			continue;
+		}
+
+		if (stop)
 		{
 			break;
 		}
 
-		muggle_logger_write((muggle_logger_t*)logger, msg);
+		// lanes drained, output buffered records before wait
+		if (dirty)
+		{
+			muggle_async_logger_flush_output(logger);
+			dirty = false;
+			continue;
+		}
 
-		free((void*)msg->payload);
-		logger->p_free(msg);
+		// park until producer ring, recheck lanes after announce sleeping
+		muggle_atomic_int seq = muggle_atomic_load(&logger->wake_seq, muggle_memory_order_acquire);
+		muggle_atomic_store(&logger->sleeping, 1, muggle_memory_order_relaxed);
+		muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+		if (muggle_async_logger_refill(logger, heads, &stop) == 0 && !stop)
+		{
+			muggle_futex_wait(&logger->wake_seq, seq, NULL);
+		}
+		muggle_atomic_store(&logger->sleeping, 0, muggle_memory_order_relaxed);
 	}
 
+	muggle_async_logger_flush_output(logger);
+	free(heads);
+
 	return 0;
 }
 
-int muggle_async_logger_init(muggle_async_logger_t *logger, int channel_capacity)
+/**
+ * @brief wake logger thread of lane mode if it's parking
+ */
+static void muggle_async_logger_wake(muggle_async_logger_t *logger)
 {
-	memset(logger, 0, sizeof(*logger));
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&logger->sleeping, muggle_memory_order_relaxed) != 0)
+	{
+		muggle_atomic_fetch_add(&logger->wake_seq, 1, muggle_memory_order_release);
+		muggle_futex_wake_one(&logger->wake_seq);
+	}
+}
+
+/**
+ * @brief write slot into shared channel, ring logger thread in lane mode
+ */
+static int muggle_async_logger_write_shared(muggle_async_logger_t *logger, void *data)
+{
+	int ret = muggle_channel_write(&logger->channel, data);
+	if (logger->lanes)
+	{
+		muggle_async_logger_wake(logger);
+	}
+	return ret;
+}
+
+static muggle_atomic_int s_async_logger_id = 0;
+
+static MUGGLE_THREAD_LOCAL muggle_atomic_int s_async_logger_lane_owner = 0;
+static MUGGLE_THREAD_LOCAL muggle_async_logger_lane_t *s_async_logger_lane = NULL;
+
+/**
+ * @brief get lane of current thread, claim one at first call
+ *
+ * @return lane of current thread, NULL if all lanes are claimed
+ */
+static muggle_async_logger_lane_t* muggle_async_logger_get_lane(muggle_async_logger_t *logger)
+{
+	if (s_async_logger_lane_owner == logger->id)
+	{
+		return s_async_logger_lane;
+	}
+
+	// cache miss, thread may log to more than one async logger
+	muggle_async_logger_lane_t *lane = NULL;
+	muggle_thread_id tid = muggle_thread_current_id();
+
+	int num_lane = (int)muggle_atomic_load(&logger->num_lane, muggle_memory_order_acquire);
+	if (num_lane > logger->max_lane)
+	{
+		num_lane = logger->max_lane;
+	}
+	for (int i = 0; i < num_lane; i++)
+	{
+		if (muggle_atomic_load(&logger->lanes[i].ready, muggle_memory_order_acquire) &&
+			logger->lanes[i].tid == tid)
+		{
+			lane = &logger->lanes[i];
+			break;
+		}
+	}
+
+	if (lane == NULL)
+	{
+		int idx = (int)muggle_atomic_fetch_add(&logger->num_lane, 1, muggle_memory_order_acq_rel);
+		if (idx < logger->max_lane)
+		{
+			lane = &logger->lanes[idx];
+			lane->tid = tid;
+			// logger thread never block on lane, it parks on wake_seq
+			int ret = muggle_channel_init(&lane->channel, logger->lane_capacity,
+				MUGGLE_CHANNEL_FLAG_SINGLE_WRITER |
+				MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP |
+				MUGGLE_CHANNEL_FLAG_WRITE_BLOCK);
+			if (ret == 0)
+			{
+				muggle_atomic_store(&lane->ready, 1, muggle_memory_order_release);
+			}
+			else
+			{
+				fprintf(stderr, "failed initialize async logger lane\n");
+				lane = NULL;
+			}
+		}
+	}
+
+	s_async_logger_lane_owner = logger->id;
+	s_async_logger_lane = lane;
+
+	return lane;
+}
 
+/**
+ * @brief initialize slots, channel and start logger thread
+ */
+static int muggle_async_logger_init_inner(
+	muggle_async_logger_t *logger, int channel_capacity, int channel_flags,
+	muggle_thread_routine routine)
+{
 	muggle_logger_t *base_logger = (muggle_logger_t*)&logger->logger;
 	base_logger->log = muggle_async_logger_log;
 	base_logger->add_handler = muggle_async_logger_add_handler;
 	base_logger->destroy = muggle_async_logger_destroy;
+	base_logger->flush = muggle_async_logger_flush;
 	base_logger->lowest_log_level = MUGGLE_LOG_LEVEL_FATAL;
 
-	logger->p_alloc = malloc;
-	logger->p_free = free;
-	int ret = muggle_channel_init(&logger->channel, channel_capacity, 0);
+	logger->id = muggle_atomic_fetch_add(&s_async_logger_id, 1, muggle_memory_order_relaxed) + 1;
+
+	// every slot is [pool block head | msg | payload]
+	int ret = muggle_ts_memory_pool_init(&logger->slot_pool, channel_capacity,
+		(muggle_atomic_int)(MUGGLE_ASYNC_LOGGER_SLOT_SIZE - sizeof(muggle_ts_memory_pool_head_t)));
+	if (ret != 0)
+	{
+		fprintf(stderr, "failed initialize async logger slots\n");
+		return ret;
+	}
+	logger->payload_size = (size_t)logger->slot_pool.block_size
+		- sizeof(muggle_ts_memory_pool_head_t) - sizeof(muggle_async_logger_slot_t);
+
+	// deferred records are formatted into it in logger thread
+	logger->decode_buf = (char*)malloc(MUGGLE_LOG_MSG_MAX_LEN);
+	if (logger->decode_buf == NULL)
+	{
+		muggle_ts_memory_pool_destroy(&logger->slot_pool);
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	ret = muggle_channel_init(&logger->channel, channel_capacity, channel_flags);
 	if (ret != 0)
 	{
 		fprintf(stderr, "failed initialize async logger channel\n");
+		free(logger->decode_buf);
+		muggle_ts_memory_pool_destroy(&logger->slot_pool);
 		return ret;
 	}
 
-	ret = muggle_thread_create(&logger->thread, muggle_async_logger_run, logger);
+	ret = muggle_thread_create(&logger->thread, routine, logger);
 	if (ret != 0)
 	{
 		fprintf(stderr, "failed initialize async logger thread\n");
+		muggle_channel_destroy(&logger->channel);
+		free(logger->decode_buf);
+		muggle_ts_memory_pool_destroy(&logger->slot_pool);
 		return ret;
 	}
 
 	return 0;
 }
 
+int muggle_async_logger_init(muggle_async_logger_t *logger, int channel_capacity)
+{
+	memset(logger, 0, sizeof(*logger));
+
+	// block producer when channel full, otherwise message will be lost
+	return muggle_async_logger_init_inner(logger, channel_capacity,
+		MUGGLE_CHANNEL_FLAG_WRITE_BLOCK, muggle_async_logger_run);
+}
+
+int muggle_async_logger_init_lanes(
+	muggle_async_logger_t *logger, int channel_capacity, int max_lane, int lane_capacity)
+{
+	memset(logger, 0, sizeof(*logger));
+
+	if (max_lane <= 0 || lane_capacity <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	// lane channels are initialized lazily by producer threads
+	logger->lanes = (muggle_async_logger_lane_t*)calloc((size_t)max_lane, sizeof(muggle_async_logger_lane_t));
+	if (logger->lanes == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	logger->max_lane = max_lane;
+	logger->lane_capacity = lane_capacity;
+
+	int ret = muggle_async_logger_init_inner(logger, channel_capacity,
+		MUGGLE_CHANNEL_FLAG_WRITE_BLOCK | MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP,
+		muggle_async_logger_run_lanes);
+	if (ret != 0)
+	{
+		free(logger->lanes);
+		logger->lanes = NULL;
+	}
+
+	return ret;
+}
+
 int muggle_async_logger_add_handler(muggle_logger_t *logger, muggle_log_handler_t *handler)
 {
-	if (logger->cnt >= (sizeof(logger->handlers) / sizeof(logger->handlers[0])))
+	if (((muggle_async_logger_t*)logger)->workers)
+	{
+		// handler workers already started
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	if (logger->cnt >= (int)(sizeof(logger->handlers) / sizeof(logger->handlers[0])))
 	{
 		return MUGGLE_ERR_BEYOND_RANGE;
 	}
@@ -87,36 +623,197 @@ void muggle_async_logger_destroy(muggle_logger_t *logger)
 {
 	muggle_async_logger_t *async_logger = (muggle_async_logger_t*)logger;
 
-	muggle_channel_write(&async_logger->channel, NULL);
+	muggle_async_logger_write_shared(async_logger, NULL);
 	muggle_thread_join(&async_logger->thread);
 
+	if (async_logger->workers)
+	{
+		// logger thread exited, current thread is the only writer of rings
+		for (int i = 0; i < async_logger->num_worker; i++)
+		{
+			muggle_async_logger_worker_t *worker = &async_logger->workers[i];
+			while (muggle_channel_write(&worker->channel, NULL) != 0)
+			{
+				muggle_thread_yield();
+			}
+			muggle_thread_join(&worker->thread);
+			muggle_channel_destroy(&worker->channel);
+		}
+		free(async_logger->workers);
+		async_logger->workers = NULL;
+		async_logger->num_worker = 0;
+	}
+
+	if (async_logger->lanes)
+	{
+		int num_lane = (int)async_logger->num_lane;
+		if (num_lane > async_logger->max_lane)
+		{
+			num_lane = async_logger->max_lane;
+		}
+		for (int i = 0; i < num_lane; i++)
+		{
+			if (async_logger->lanes[i].ready)
+			{
+				muggle_channel_destroy(&async_logger->lanes[i].channel);
+			}
+		}
+		free(async_logger->lanes);
+		async_logger->lanes = NULL;
+	}
+
 	muggle_channel_destroy(&async_logger->channel);
+	muggle_ts_memory_pool_destroy(&async_logger->slot_pool);
+	free(async_logger->decode_buf);
+	async_logger->decode_buf = NULL;
 }
 
-void muggle_async_logger_log(
-	struct muggle_logger *logger,
-	int level,
-	muggle_log_src_loc_t *src_loc,
-	const char *format,
-	...)
+void muggle_async_logger_flush(muggle_logger_t *logger)
 {
-	if (logger->lowest_log_level > level)
+	muggle_async_logger_t *async_logger = (muggle_async_logger_t*)logger;
+
+	muggle_async_logger_slot_t *slot = NULL;
+	while ((slot = (muggle_async_logger_slot_t*)muggle_ts_memory_pool_alloc(&async_logger->slot_pool)) == NULL)
 	{
-		return;
+		muggle_thread_yield();
 	}
 
-	muggle_async_logger_t *async_logger = (muggle_async_logger_t*)logger;
-	muggle_log_msg_t *msg = (muggle_log_msg_t*)async_logger->p_alloc(sizeof(muggle_log_msg_t));
-	if (msg == NULL)
+	muggle_atomic_int done = 0;
+	muggle_atomic_int *p_done = &done;
+	memset(&slot->msg, 0, sizeof(slot->msg));
+	slot->kind = MUGGLE_ASYNC_LOGGER_SLOT_FLUSH;
+	slot->record_len = (uint32_t)sizeof(p_done);
+	memcpy(slot + 1, &p_done, sizeof(p_done));
+	if (async_logger->lanes)
+	{
+		// merged after messages logged before it
+		timespec_get(&slot->msg.ts, TIME_UTC);
+	}
+
+	if (muggle_async_logger_write_shared(async_logger, slot) != 0)
 	{
+		muggle_ts_memory_pool_free(slot);
 		return;
 	}
 
+	while (muggle_atomic_load(&done, muggle_memory_order_acquire) == 0)
+	{
+		muggle_thread_yield();
+	}
+}
+
+int muggle_async_logger_start_workers(muggle_async_logger_t *logger, int ring_capacity, const int *flags)
+{
+	if (logger->workers)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	int cnt = logger->logger.cnt;
+	if (cnt <= 0 || ring_capacity <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_async_logger_worker_t *workers = (muggle_async_logger_worker_t*)
+		calloc((size_t)cnt, sizeof(muggle_async_logger_worker_t));
+	if (workers == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	int ret = 0;
+	int i = 0;
+	for (i = 0; i < cnt; i++)
+	{
+		muggle_async_logger_worker_t *worker = &workers[i];
+		worker->handler = logger->logger.handlers[i];
+
+		// only logger thread write ring, block it or drop message when ring full
+		int chan_flags = MUGGLE_CHANNEL_FLAG_SINGLE_WRITER;
+		if (flags == NULL || !(flags[i] & MUGGLE_ASYNC_LOGGER_WORKER_FLAG_DROP))
+		{
+			chan_flags |= MUGGLE_CHANNEL_FLAG_WRITE_BLOCK;
+		}
+
+		ret = muggle_channel_init(&worker->channel, ring_capacity, chan_flags);
+		if (ret != 0)
+		{
+			break;
+		}
+
+		ret = muggle_thread_create(&worker->thread, muggle_async_logger_worker_run, worker);
+		if (ret != 0)
+		{
+			muggle_channel_destroy(&worker->channel);
+			break;
+		}
+	}
+
+	if (ret != 0)
+	{
+		fprintf(stderr, "failed start async logger handler workers\n");
+		for (int j = 0; j < i; j++)
+		{
+			muggle_channel_write(&workers[j].channel, NULL);
+			muggle_thread_join(&workers[j].thread);
+			muggle_channel_destroy(&workers[j].channel);
+		}
+		free(workers);
+		return ret;
+	}
+
+	logger->num_worker = cnt;
+	logger->workers = workers;
+
+	return MUGGLE_OK;
+}
+
+int muggle_async_logger_get_worker_stats(
+	muggle_async_logger_t *logger, int idx, muggle_async_logger_worker_stats_t *stats)
+{
+	if (logger->workers == NULL || idx < 0 || idx >= logger->num_worker)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_async_logger_worker_t *worker = &logger->workers[idx];
+	memset(stats, 0, sizeof(*stats));
+	stats->cnt_write = (uint64_t)muggle_atomic_fetch_add64(&worker->cnt_write, 0, muggle_memory_order_acquire);
+	stats->cnt_push = (uint64_t)muggle_atomic_fetch_add64(&worker->cnt_push, 0, muggle_memory_order_relaxed);
+	stats->cnt_drop = (uint64_t)muggle_atomic_fetch_add64(&worker->cnt_drop, 0, muggle_memory_order_relaxed);
+	stats->lag = stats->cnt_push > stats->cnt_write ? stats->cnt_push - stats->cnt_write : 0;
+	stats->max_lag = (uint64_t)muggle_atomic_fetch_add64(&worker->max_lag, 0, muggle_memory_order_relaxed);
+
+	return MUGGLE_OK;
+}
+
+void muggle_async_logger_set_deferred(muggle_async_logger_t *logger, bool enable)
+{
+	logger->logger.log = enable ? muggle_async_logger_log_deferred : muggle_async_logger_log;
+}
+
+/**
+ * @brief fetch slot and fill message head
+ */
+static muggle_async_logger_slot_t* muggle_async_logger_fetch_slot(
+	muggle_async_logger_t *async_logger, int level, const muggle_log_src_loc_t *src_loc)
+{
+	muggle_logger_t *logger = (muggle_logger_t*)async_logger;
+	muggle_async_logger_slot_t *slot = NULL;
+	while ((slot = (muggle_async_logger_slot_t*)muggle_ts_memory_pool_alloc(&async_logger->slot_pool)) == NULL)
+	{
+		// all slots in flight, wait logger thread recycle
+		muggle_thread_yield();
+	}
+
+	muggle_log_msg_t *msg = &slot->msg;
+
 	// level
 	msg->level = level;
 
-	// timestamp
-	if (logger->fmt_hint & MUGGLE_LOG_FMT_TIME)
+	// timestamp, lanes are merged by it
+	if ((logger->fmt_hint & MUGGLE_LOG_FMT_TIME) || async_logger->lanes)
 	{
 		timespec_get(&msg->ts, TIME_UTC);
 	}
@@ -130,22 +827,36 @@ void muggle_async_logger_log(
 	// source location
 	memcpy(&msg->src_loc, src_loc, sizeof(msg->src_loc));
 
-	// payload
-	char *payload = (char*)malloc(MUGGLE_LOG_MSG_MAX_LEN);
-	va_list args;
-
-	va_start(args, format);
-	vsnprintf(payload, MUGGLE_LOG_MSG_MAX_LEN, format, args);
-	va_end(args);
+	return slot;
+}
 
-	msg->payload = payload;
+/**
+ * @brief send slot to logger thread
+ */
+static void muggle_async_logger_send_slot(
+	muggle_async_logger_t *async_logger, muggle_async_logger_slot_t *slot, int level)
+{
+	int ret = 0;
+	muggle_async_logger_lane_t *lane = NULL;
+	if (async_logger->lanes && (lane = muggle_async_logger_get_lane(async_logger)) != NULL)
+	{
+		ret = muggle_channel_write(&lane->channel, slot);
+		muggle_async_logger_wake(async_logger);
+	}
+	else
+	{
+		ret = muggle_async_logger_write_shared(async_logger, slot);
+	}
 
-	// write
-	muggle_channel_write(&async_logger->channel, msg);
+	if (ret != 0)
+	{
+		muggle_ts_memory_pool_free(slot);
+	}
 
 #if MUGGLE_DEBUG
 	if (level >= MUGGLE_LOG_LEVEL_FATAL)
 	{
+		muggle_async_logger_flush((muggle_logger_t*)async_logger);
 		muggle_print_stacktrace();
 #if MUGGLE_PLATFORM_WINDOWS
 		__debugbreak();
@@ -154,3 +865,74 @@ void muggle_async_logger_log(
 	}
 #endif
 }
+
+void muggle_async_logger_log(
+	struct muggle_logger *logger,
+	int level,
+	const muggle_log_src_loc_t *src_loc,
+	const char *format,
+	...)
+{
+	if (logger->lowest_log_level > level)
+	{
+		return;
+	}
+
+	muggle_async_logger_t *async_logger = (muggle_async_logger_t*)logger;
+	muggle_async_logger_slot_t *slot = muggle_async_logger_fetch_slot(async_logger, level, src_loc);
+
+	// payload, format directly into slot
+	char *payload = (char*)(slot + 1);
+	va_list args;
+
+	va_start(args, format);
+	vsnprintf(payload, async_logger->payload_size, format, args);
+	va_end(args);
+
+	slot->msg.payload = payload;
+	slot->kind = MUGGLE_ASYNC_LOGGER_SLOT_TEXT;
+	slot->record_len = 0;
+
+	muggle_async_logger_send_slot(async_logger, slot, level);
+}
+
+void muggle_async_logger_log_deferred(
+	struct muggle_logger *logger,
+	int level,
+	const muggle_log_src_loc_t *src_loc,
+	const char *format,
+	...)
+{
+	if (logger->lowest_log_level > level)
+	{
+		return;
+	}
+
+	muggle_async_logger_t *async_logger = (muggle_async_logger_t*)logger;
+	muggle_async_logger_slot_t *slot = muggle_async_logger_fetch_slot(async_logger, level, src_loc);
+
+	// copy format pointer and raw arguments, logger thread format it
+	va_list args;
+
+	va_start(args, format);
+	size_t record_len = muggle_log_deferred_encode(
+		(char*)(slot + 1), async_logger->payload_size, format, args);
+	if (record_len > 0)
+	{
+		slot->msg.payload = NULL;
+		slot->kind = MUGGLE_ASYNC_LOGGER_SLOT_DEFERRED;
+		slot->record_len = (uint32_t)record_len;
+	}
+	else
+	{
+		// format can't be deferred, fallback to eager format
+		char *payload = (char*)(slot + 1);
+		vsnprintf(payload, async_logger->payload_size, format, args);
+		slot->msg.payload = payload;
+		slot->kind = MUGGLE_ASYNC_LOGGER_SLOT_TEXT;
+		slot->record_len = 0;
+	}
+	va_end(args);
+
+	muggle_async_logger_send_slot(async_logger, slot, level);
+}
@@ -12,31 +12,107 @@
 #define MUGGLE_C_LOG_ASYNC_LOGGER_H_
 
 #include "muggle/c/base/macro.h"
+#include <stdint.h>
 #include "muggle/c/log/log_logger.h"
+#include "muggle/c/base/thread.h"
 #include "muggle/c/sync/channel.h"
+#include "muggle/c/memory/threadsafe_memory_pool.h"
 
 EXTERN_C_BEGIN
 
-typedef void* (*muggle_log_async_logger_alloc)(size_t size);
-typedef void (*muggle_log_async_logger_free)(void *ptr);
+/**
+ * @brief bytes of every preallocated message slot
+ *
+ * slot holds pool block head, log message and payload, so payload of async
+ * logger is a little shorter than MUGGLE_LOG_MSG_MAX_LEN
+ */
+#define MUGGLE_ASYNC_LOGGER_SLOT_SIZE MUGGLE_LOG_MSG_MAX_LEN
+
+/**
+ * @brief single writer channel owned by one producer thread
+ */
+typedef struct muggle_async_logger_lane
+{
+	muggle_atomic_int ready;    //!< channel is initialized and readable
+	muggle_thread_id  tid;      //!< owner thread
+	muggle_channel_t  channel;
+}muggle_async_logger_lane_t;
+
+enum
+{
+	MUGGLE_ASYNC_LOGGER_WORKER_FLAG_DROP = 0x01, //!< drop message when ring of handler worker is full, otherwise block logger thread
+};
+
+/**
+ * @brief worker thread owns a handler, logger thread share message to it
+ * through single writer ring
+ */
+typedef struct muggle_async_logger_worker
+{
+	muggle_log_handler_t *handler;
+	muggle_channel_t     channel;
+	muggle_thread_t      thread;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int64  cnt_push;  //!< messages pushed into ring, update by logger thread
+	muggle_atomic_int64  cnt_drop;  //!< messages dropped for ring full, update by logger thread
+	muggle_atomic_int64  max_lag;   //!< max number of messages in ring observed by logger thread
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int64  cnt_write; //!< messages written, update by worker
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+}muggle_async_logger_worker_t;
+
+/**
+ * @brief statistics of handler worker
+ */
+typedef struct muggle_async_logger_worker_stats
+{
+	uint64_t cnt_push;  //!< messages pushed into ring
+	uint64_t cnt_write; //!< messages written by handler
+	uint64_t cnt_drop;  //!< messages dropped for ring full
+	uint64_t lag;       //!< messages in ring, not written yet
+	uint64_t max_lag;   //!< max lag observed
+}muggle_async_logger_worker_stats_t;
 
 /**
  * @brief muggle async logger
+ *
+ * messages are formatted directly into slots preallocated at initialize,
+ * producer never call malloc/free; when all slots are in use, producer
+ * wait until logger thread recycle one
+ *
+ * when initialized with muggle_async_logger_init_lanes, every producer
+ * thread lazily get its own single writer lane, so producers never contend
+ * on channel write lock, and logger thread merge lanes in timestamp order
  */
 typedef struct muggle_async_logger
 {
 	muggle_logger_t logger;
-	muggle_log_async_logger_alloc p_alloc;
-	muggle_log_async_logger_free p_free;
-	muggle_channel_t channel;
+	muggle_ts_memory_pool_t slot_pool; //!< preallocated message slots
+	size_t payload_size;               //!< bytes of payload in slot
+	char *decode_buf;                  //!< buffer for format deferred message
+	muggle_channel_t channel;          //!< in lane mode, only for control messages and producers without lane
 	muggle_thread_t thread;
+
+	muggle_async_logger_lane_t *lanes; //!< per thread lanes, NULL when lane mode disabled
+	int max_lane;                      //!< number of lanes
+	int lane_capacity;                 //!< capacity of every lane
+	muggle_atomic_int id;              //!< unique id of logger, key of thread local lane cache
+	muggle_atomic_int num_lane;        //!< number of claimed lanes
+
+	muggle_async_logger_worker_t *workers; //!< per handler workers, NULL when all handlers write in logger thread
+	int num_worker;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int wake_seq;        //!< futex of logger thread in lane mode
+	muggle_atomic_int sleeping;        //!< logger thread is parking on wake_seq
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
 }muggle_async_logger_t;
 
 /**
  * @brief initialize async logger
  *
  * @param logger            async logger pointer
- * @param cahnnel_capacity  async logger's channel capacity
+ * @param cahnnel_capacity  async logger's channel capacity, also the number
+ *                          of preallocated message slots
  *
  * @return 
  *     - success returns 0
@@ -45,6 +121,64 @@ typedef struct muggle_async_logger
 MUGGLE_C_EXPORT
 int muggle_async_logger_init(muggle_async_logger_t *logger, int channel_capacity);
 
+/**
+ * @brief initialize async logger with per thread lanes
+ *
+ * the first log call of every thread claim a lane and initialize it, lanes
+ * are never released, when all lanes are claimed, the rest threads share
+ * the logger's channel. merge is best effort, messages available to logger
+ * thread at the same time are written in timestamp order
+ *
+ * @param logger            async logger pointer
+ * @param channel_capacity  capacity of shared channel, also the number
+ *                          of preallocated message slots
+ * @param max_lane          max number of producer threads own lane
+ * @param lane_capacity     capacity of every lane
+ *
+ * @return 
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_async_logger_init_lanes(
+	muggle_async_logger_t *logger, int channel_capacity, int max_lane, int lane_capacity);
+
+/**
+ * @brief start a worker thread for every handler
+ *
+ * logger thread only share message to rings of handler workers, message is
+ * reference counted and recycled after all handlers accept it written, so
+ * a slow handler never delay others. must be invoked after all handlers
+ * added and before first log
+ *
+ * @param logger         async logger pointer
+ * @param ring_capacity  capacity of ring of every handler worker
+ * @param flags          flags of every handler in the order of added, bitwise
+ *                       or of MUGGLE_ASYNC_LOGGER_WORKER_FLAG_*, NULL means
+ *                       all handlers block logger thread when ring full
+ *
+ * @return 
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_async_logger_start_workers(muggle_async_logger_t *logger, int ring_capacity, const int *flags);
+
+/**
+ * @brief get statistics of handler worker
+ *
+ * @param logger  async logger pointer
+ * @param idx     index of handler, in the order of added
+ * @param stats   store statistics
+ *
+ * @return 
+ *     - success returns 0
+ *     - return MUGGLE_ERR_INVALID_PARAM if workers not started or idx is invalid
+ */
+MUGGLE_C_EXPORT
+int muggle_async_logger_get_worker_stats(
+	muggle_async_logger_t *logger, int idx, muggle_async_logger_worker_stats_t *stats);
+
 /**
  * @brief async logger add log handler
  *
@@ -66,6 +200,30 @@ int muggle_async_logger_add_handler(muggle_logger_t *logger, muggle_log_handler_
 MUGGLE_C_EXPORT
 void muggle_async_logger_destroy(muggle_logger_t *logger);
 
+/**
+ * @brief async logger flush
+ *
+ * wait until all messages logged before this call are written, and
+ * flush all handlers. must not be invoked in handler
+ *
+ * @param logger  logger pointer
+ */
+MUGGLE_C_EXPORT
+void muggle_async_logger_flush(muggle_logger_t *logger);
+
+/**
+ * @brief enable or disable deferred format
+ *
+ * in deferred mode, caller only copy format pointer and raw arguments into
+ * message slot, and logger thread format it, see log_deferred.h for format
+ * string limitation
+ *
+ * @param logger  async logger pointer
+ * @param enable  enable deferred format or not
+ */
+MUGGLE_C_EXPORT
+void muggle_async_logger_set_deferred(muggle_async_logger_t *logger, bool enable);
+
 /**
  * @brief prototype of logger output function
  *
@@ -79,7 +237,24 @@ MUGGLE_C_EXPORT
 void muggle_async_logger_log(
 	struct muggle_logger *logger,
 	int level,
-	muggle_log_src_loc_t *src_loc,
+	const muggle_log_src_loc_t *src_loc,
+	const char *format,
+	...);
+
+/**
+ * @brief logger output function of deferred format mode
+ *
+ * @param logger   logger pointer
+ * @param level    log level
+ * @param src_loc  source location info
+ * @param format   format string, must outlive the message, usually string literal
+ * @param ...      input arguments for format string
+ */
+MUGGLE_C_EXPORT
+void muggle_async_logger_log_deferred(
+	struct muggle_logger *logger,
+	int level,
+	const muggle_log_src_loc_t *src_loc,
 	const char *format,
 	...);
 
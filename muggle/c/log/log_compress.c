@@ -0,0 +1,423 @@
+#include "log_compress.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/os/os.h"
+
+#define MUGGLE_LOG_LZ_MIN_MATCH 4
+#define MUGGLE_LOG_LZ_MAX_OFFSET 65535
+#define MUGGLE_LOG_LZ_HASH_BITS 12
+
+static const char s_log_lz_magic[4] = { 'M', 'L', 'Z', '1' };
+
+static uint32_t muggle_log_lz_read32(const char *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint32_t muggle_log_lz_hash(uint32_t v)
+{
+	return (v * 2654435761u) >> (32 - MUGGLE_LOG_LZ_HASH_BITS);
+}
+
+static void muggle_log_lz_put_u32(unsigned char *p, uint32_t v)
+{
+	p[0] = (unsigned char)(v);
+	p[1] = (unsigned char)(v >> 8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+}
+
+static uint32_t muggle_log_lz_get_u32(const unsigned char *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief write length extension of token nibble
+ *
+ * @return next output position, NULL if out of space
+ */
+static unsigned char* muggle_log_lz_put_len(unsigned char *op, const unsigned char *oend, size_t len)
+{
+	while (len >= 255)
+	{
+		if (op >= oend)
+		{
+			return NULL;
+		}
+		*op++ = 255;
+		len -= 255;
+	}
+	if (op >= oend)
+	{
+		return NULL;
+	}
+	*op++ = (unsigned char)len;
+	return op;
+}
+
+/**
+ * @brief emit one sequence, match_len 0 means literals only
+ */
+static unsigned char* muggle_log_lz_put_seq(
+	unsigned char *op, const unsigned char *oend,
+	const char *literals, size_t literal_len, size_t offset, size_t match_len)
+{
+	if (op >= oend)
+	{
+		return NULL;
+	}
+
+	unsigned char *token = op++;
+	size_t ml = match_len ? match_len - MUGGLE_LOG_LZ_MIN_MATCH : 0;
+	*token = (unsigned char)(((literal_len < 15 ? literal_len : 15) << 4) | (ml < 15 ? ml : 15));
+
+	if (literal_len >= 15)
+	{
+		op = muggle_log_lz_put_len(op, oend, literal_len - 15);
+		if (op == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	if ((size_t)(oend - op) < literal_len)
+	{
+		return NULL;
+	}
+	memcpy(op, literals, literal_len);
+	op += literal_len;
+
+	if (match_len == 0)
+	{
+		return op;
+	}
+
+	if (oend - op < 2)
+	{
+		return NULL;
+	}
+	*op++ = (unsigned char)(offset);
+	*op++ = (unsigned char)(offset >> 8);
+
+	if (ml >= 15)
+	{
+		op = muggle_log_lz_put_len(op, oend, ml - 15);
+	}
+
+	return op;
+}
+
+size_t muggle_log_lz_compress(const char *src, size_t src_len, char *dst, size_t dst_cap)
+{
+	int32_t table[1 << MUGGLE_LOG_LZ_HASH_BITS];
+	memset(table, 0xff, sizeof(table));
+
+	unsigned char *op = (unsigned char*)dst;
+	const unsigned char *oend = op + dst_cap;
+
+	size_t anchor = 0;
+	size_t ip = 0;
+	while (ip + MUGGLE_LOG_LZ_MIN_MATCH <= src_len)
+	{
+		uint32_t seq = muggle_log_lz_read32(src + ip);
+		uint32_t h = muggle_log_lz_hash(seq);
+		int32_t ref = table[h];
+		table[h] = (int32_t)ip;
+
+		if (ref < 0 || ip - (size_t)ref > MUGGLE_LOG_LZ_MAX_OFFSET ||
+			muggle_log_lz_read32(src + ref) != seq)
+		{
+			ip++;
+			continue;
+		}
+
+		size_t match_len = MUGGLE_LOG_LZ_MIN_MATCH;
+		while (ip + match_len < src_len && src[ref + match_len] == src[ip + match_len])
+		{
+			match_len++;
+		}
+
+		op = muggle_log_lz_put_seq(op, oend, src + anchor, ip - anchor, ip - (size_t)ref, match_len);
+		if (op == NULL)
+		{
+			return 0;
+		}
+
+		ip += match_len;
+		anchor = ip;
+
+		// keep table fresh for position inside long match
+		if (ip >= 2 && ip - 2 + MUGGLE_LOG_LZ_MIN_MATCH <= src_len)
+		{
+			table[muggle_log_lz_hash(muggle_log_lz_read32(src + ip - 2))] = (int32_t)(ip - 2);
+		}
+	}
+
+	op = muggle_log_lz_put_seq(op, oend, src + anchor, src_len - anchor, 0, 0);
+	if (op == NULL)
+	{
+		return 0;
+	}
+
+	return (size_t)(op - (unsigned char*)dst);
+}
+
+/**
+ * @brief read length extension of token nibble
+ *
+ * @return false if input exhausted
+ */
+static bool muggle_log_lz_get_len(const unsigned char **ip, const unsigned char *iend, size_t *len)
+{
+	const unsigned char *p = *ip;
+	unsigned char c = 0;
+	do {
+		if (p >= iend)
+		{
+			return false;
+		}
+		c = *p++;
+		*len += c;
+	} while (c == 255);
+	*ip = p;
+	return true;
+}
+
+int muggle_log_lz_decompress(const char *src, size_t src_len, char *dst, size_t dst_cap)
+{
+	const unsigned char *ip = (const unsigned char*)src;
+	const unsigned char *iend = ip + src_len;
+	size_t op = 0;
+
+	while (ip < iend)
+	{
+		unsigned char token = *ip++;
+
+		size_t literal_len = token >> 4;
+		if (literal_len == 15 && !muggle_log_lz_get_len(&ip, iend, &literal_len))
+		{
+			return -1;
+		}
+		if ((size_t)(iend - ip) < literal_len || dst_cap - op < literal_len)
+		{
+			return -1;
+		}
+		memcpy(dst + op, ip, literal_len);
+		ip += literal_len;
+		op += literal_len;
+
+		if (ip == iend)
+		{
+			break;
+		}
+
+		if (iend - ip < 2)
+		{
+			return -1;
+		}
+		size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+
+		size_t match_len = token & 0x0f;
+		if (match_len == 15 && !muggle_log_lz_get_len(&ip, iend, &match_len))
+		{
+			return -1;
+		}
+		match_len += MUGGLE_LOG_LZ_MIN_MATCH;
+
+		if (offset == 0 || offset > op || dst_cap - op < match_len)
+		{
+			return -1;
+		}
+
+		// match may overlap output, copy byte by byte
+		const char *ref = dst + op - offset;
+		for (size_t i = 0; i < match_len; i++)
+		{
+			dst[op + i] = ref[i];
+		}
+		op += match_len;
+	}
+
+	if (op > (size_t)INT32_MAX)
+	{
+		return -1;
+	}
+
+	return (int)op;
+}
+
+int muggle_log_lz_compress_file(const char *src_path, const char *dst_path)
+{
+	FILE *fp_src = fopen(src_path, "rb");
+	if (fp_src == NULL)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	FILE *fp_dst = fopen(dst_path, "wb");
+	if (fp_dst == NULL)
+	{
+		fclose(fp_src);
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	char *raw = (char*)malloc(MUGGLE_LOG_LZ_BLOCK_SIZE);
+	char *comp = (char*)malloc(MUGGLE_LOG_LZ_COMPRESS_BOUND(MUGGLE_LOG_LZ_BLOCK_SIZE));
+	if (raw == NULL || comp == NULL)
+	{
+		free(raw);
+		free(comp);
+		fclose(fp_src);
+		fclose(fp_dst);
+		muggle_os_remove(dst_path);
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	int ret = MUGGLE_OK;
+	if (fwrite(s_log_lz_magic, 1, sizeof(s_log_lz_magic), fp_dst) != sizeof(s_log_lz_magic))
+	{
+		ret = MUGGLE_ERR_SYS_CALL;
+	}
+
+	while (ret == MUGGLE_OK)
+	{
+		size_t n = fread(raw, 1, MUGGLE_LOG_LZ_BLOCK_SIZE, fp_src);
+		if (n == 0)
+		{
+			if (ferror(fp_src))
+			{
+				ret = MUGGLE_ERR_SYS_CALL;
+			}
+			break;
+		}
+
+		size_t comp_len = muggle_log_lz_compress(raw, n, comp,
+			MUGGLE_LOG_LZ_COMPRESS_BOUND(MUGGLE_LOG_LZ_BLOCK_SIZE));
+		const char *data = comp;
+		if (comp_len == 0 || comp_len >= n)
+		{
+			// incompressible, store raw
+			comp_len = n;
+			data = raw;
+		}
+
+		unsigned char head[8];
+		muggle_log_lz_put_u32(head, (uint32_t)n);
+		muggle_log_lz_put_u32(head + 4, (uint32_t)comp_len);
+		if (fwrite(head, 1, sizeof(head), fp_dst) != sizeof(head) ||
+			fwrite(data, 1, comp_len, fp_dst) != comp_len)
+		{
+			ret = MUGGLE_ERR_SYS_CALL;
+		}
+	}
+
+	free(raw);
+	free(comp);
+	fclose(fp_src);
+	if (fclose(fp_dst) != 0 && ret == MUGGLE_OK)
+	{
+		ret = MUGGLE_ERR_SYS_CALL;
+	}
+
+	if (ret != MUGGLE_OK)
+	{
+		muggle_os_remove(dst_path);
+	}
+
+	return ret;
+}
+
+int muggle_log_lz_decompress_file(const char *src_path, const char *dst_path)
+{
+	FILE *fp_src = fopen(src_path, "rb");
+	if (fp_src == NULL)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	char magic[sizeof(s_log_lz_magic)];
+	if (fread(magic, 1, sizeof(magic), fp_src) != sizeof(magic) ||
+		memcmp(magic, s_log_lz_magic, sizeof(magic)) != 0)
+	{
+		fclose(fp_src);
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	FILE *fp_dst = fopen(dst_path, "wb");
+	if (fp_dst == NULL)
+	{
+		fclose(fp_src);
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	char *raw = (char*)malloc(MUGGLE_LOG_LZ_BLOCK_SIZE);
+	char *comp = (char*)malloc(MUGGLE_LOG_LZ_COMPRESS_BOUND(MUGGLE_LOG_LZ_BLOCK_SIZE));
+	int ret = MUGGLE_OK;
+	if (raw == NULL || comp == NULL)
+	{
+		ret = MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	while (ret == MUGGLE_OK)
+	{
+		unsigned char head[8];
+		size_t n = fread(head, 1, sizeof(head), fp_src);
+		if (n == 0 && feof(fp_src))
+		{
+			break;
+		}
+		if (n != sizeof(head))
+		{
+			ret = MUGGLE_ERR_INVALID_PARAM;
+			break;
+		}
+
+		uint32_t raw_len = muggle_log_lz_get_u32(head);
+		uint32_t comp_len = muggle_log_lz_get_u32(head + 4);
+		if (raw_len > MUGGLE_LOG_LZ_BLOCK_SIZE || comp_len > raw_len ||
+			fread(comp, 1, comp_len, fp_src) != comp_len)
+		{
+			ret = MUGGLE_ERR_INVALID_PARAM;
+			break;
+		}
+
+		const char *data = comp;
+		if (comp_len != raw_len)
+		{
+			if (muggle_log_lz_decompress(comp, comp_len, raw, MUGGLE_LOG_LZ_BLOCK_SIZE) != (int)raw_len)
+			{
+				ret = MUGGLE_ERR_INVALID_PARAM;
+				break;
+			}
+			data = raw;
+		}
+
+		if (fwrite(data, 1, raw_len, fp_dst) != raw_len)
+		{
+			ret = MUGGLE_ERR_SYS_CALL;
+		}
+	}
+
+	free(raw);
+	free(comp);
+	fclose(fp_src);
+	if (fclose(fp_dst) != 0 && ret == MUGGLE_OK)
+	{
+		ret = MUGGLE_ERR_SYS_CALL;
+	}
+
+	if (ret != MUGGLE_OK)
+	{
+		muggle_os_remove(dst_path);
+	}
+
+	return ret;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *  @file         log_compress.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec log rotated file compressor
+ *
+ * Built-in LZ77 block compressor, no external dependency. Every sequence is
+ *   token: 4 bits literal length | 4 bits (match length - 4)
+ *   [literal length extension, 255 chained]
+ *   literals
+ *   offset: 2 bytes little endian
+ *   [match length extension, 255 chained]
+ * the last sequence of block only contain literals
+ *
+ * compressed file layout: magic "MLZ1", then blocks of
+ *   raw length(4 bytes LE) | compressed length(4 bytes LE) | data
+ * when compressed length equal to raw length, data is stored uncompressed
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_LOG_COMPRESS_H_
+#define MUGGLE_C_LOG_COMPRESS_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_LOG_LZ_BLOCK_SIZE (64 * 1024) //!< raw bytes per block of compressed file
+#define MUGGLE_LOG_LZ_FILE_EXT ".lz"         //!< extension of compressed rotated file
+
+/**
+ * @brief max bytes of compressed block
+ *
+ * @param src_len  raw bytes
+ */
+#define MUGGLE_LOG_LZ_COMPRESS_BOUND(src_len) ((src_len) + (src_len) / 255 + 16)
+
+/**
+ * @brief compress block
+ *
+ * @param src      raw data
+ * @param src_len  bytes of raw data
+ * @param dst      output buffer
+ * @param dst_cap  size of dst
+ *
+ * @return bytes of compressed data, 0 if dst is too small
+ */
+MUGGLE_C_EXPORT
+size_t muggle_log_lz_compress(const char *src, size_t src_len, char *dst, size_t dst_cap);
+
+/**
+ * @brief decompress block
+ *
+ * @param src      compressed data
+ * @param src_len  bytes of compressed data
+ * @param dst      output buffer
+ * @param dst_cap  size of dst
+ *
+ * @return bytes of raw data, negative represent corrupted input or dst
+ *         is too small
+ */
+MUGGLE_C_EXPORT
+int muggle_log_lz_decompress(const char *src, size_t src_len, char *dst, size_t dst_cap);
+
+/**
+ * @brief compress file
+ *
+ * @param src_path  raw file path
+ * @param dst_path  compressed file path, overwritten if exists
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_lz_compress_file(const char *src_path, const char *dst_path);
+
+/**
+ * @brief decompress file compressed by muggle_log_lz_compress_file
+ *
+ * @param src_path  compressed file path
+ * @param dst_path  raw file path, overwritten if exists
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_lz_decompress_file(const char *src_path, const char *dst_path);
+
+EXTERN_C_END
+
+#endif /* ifndef MUGGLE_C_LOG_COMPRESS_H_ */
@@ -55,6 +55,12 @@ static int muggle_log_console_handler_write(
 		muggle_mutex_lock(&base_handler->mtx);
 	}
 
+	// only records of stdout are buffered, output them before stderr keep order
+	if (fp == stderr && base_handler->buf_len > 0)
+	{
+		muggle_log_handler_flush_fp(base_handler, stdout);
+	}
+
 	if (handler->enable_color && msg->level >= MUGGLE_LOG_LEVEL_WARNING)
 	{
 #if MUGGLE_PLATFORM_WINDOWS
@@ -100,6 +106,10 @@ static int muggle_log_console_handler_write(
 		fflush(fp);
 #endif
 	}
+	else if (fp == stdout)
+	{
+		ret = muggle_log_handler_write_fp(base_handler, fp, buf, (size_t)ret, msg->level);
+	}
 	else
 	{
 		ret = (int)fwrite(buf, 1, ret, fp);
@@ -114,6 +124,21 @@ static int muggle_log_console_handler_write(
 	return ret;
 }
 
+/**
+ * @brief output buffered records of console log handler
+ *
+ * @param handler  log handler pointer
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_console_handler_flush(
+	muggle_log_handler_t *base_handler)
+{
+	return muggle_log_handler_flush_fp(base_handler, stdout);
+}
+
 /**
  * @brief destroy console log handler
  *
@@ -126,6 +151,7 @@ static int muggle_log_console_handler_write(
 static int muggle_log_console_handler_destroy(
 	muggle_log_handler_t *base_handler)
 {
+	muggle_log_handler_flush_fp(base_handler, stdout);
 	return muggle_log_handler_destroy_default(base_handler);
 }
 
@@ -141,6 +167,7 @@ int muggle_log_console_handler_init(
 
 	handler->handler.write = muggle_log_console_handler_write;
 	handler->handler.destroy = muggle_log_console_handler_destroy;
+	handler->handler.flush = muggle_log_console_handler_flush;
 
 	handler->enable_color = enable_color;
 
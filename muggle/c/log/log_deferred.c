@@ -0,0 +1,560 @@
+#include "log_deferred.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#define MUGGLE_LOG_DEFERRED_SPEC_MAX_LEN 32
+
+enum
+{
+	MUGGLE_LOG_DEFERRED_LEN_NONE = 0,
+	MUGGLE_LOG_DEFERRED_LEN_HH,
+	MUGGLE_LOG_DEFERRED_LEN_H,
+	MUGGLE_LOG_DEFERRED_LEN_L,
+	MUGGLE_LOG_DEFERRED_LEN_LL,
+	MUGGLE_LOG_DEFERRED_LEN_J,
+	MUGGLE_LOG_DEFERRED_LEN_Z,
+	MUGGLE_LOG_DEFERRED_LEN_T,
+	MUGGLE_LOG_DEFERRED_LEN_BIG_L,
+};
+
+enum
+{
+	MUGGLE_LOG_DEFERRED_ARG_NONE = 0,    //!< %%
+	MUGGLE_LOG_DEFERRED_ARG_SIGNED,
+	MUGGLE_LOG_DEFERRED_ARG_UNSIGNED,
+	MUGGLE_LOG_DEFERRED_ARG_DOUBLE,
+	MUGGLE_LOG_DEFERRED_ARG_LONG_DOUBLE,
+	MUGGLE_LOG_DEFERRED_ARG_STRING,
+	MUGGLE_LOG_DEFERRED_ARG_POINTER,
+	MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED,
+};
+
+typedef struct muggle_log_deferred_spec
+{
+	const char *begin;  //!< begin of conversion spec, point to '%'
+	size_t     len;     //!< length of conversion spec
+	int        n_star;  //!< number of '*' in width and precision
+	int        precision; //!< precision, -1 means no precision, -2 means '*'
+	int        length;  //!< length modifier
+	int        arg;     //!< argument type
+}muggle_log_deferred_spec_t;
+
+/**
+ * @brief parse conversion spec begin with '%'
+ */
+static void muggle_log_deferred_parse_spec(const char *p, muggle_log_deferred_spec_t *spec)
+{
+	const char *begin = p;
+	memset(spec, 0, sizeof(*spec));
+	spec->begin = begin;
+	spec->precision = -1;
+
+	p++;
+
+	// flags
+	while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+	{
+		p++;
+	}
+
+	// width
+	if (*p == '*')
+	{
+		spec->n_star++;
+		p++;
+	}
+	else
+	{
+		while (*p >= '0' && *p <= '9')
+		{
+			p++;
+		}
+	}
+
+	// precision
+	if (*p == '.')
+	{
+		p++;
+		if (*p == '*')
+		{
+			spec->n_star++;
+			spec->precision = -2;
+			p++;
+		}
+		else
+		{
+			spec->precision = 0;
+			while (*p >= '0' && *p <= '9')
+			{
+				if (spec->precision < INT_MAX / 10)
+				{
+					spec->precision = spec->precision * 10 + (*p - '0');
+				}
+				p++;
+			}
+		}
+	}
+
+	// length modifier
+	switch (*p)
+	{
+		case 'h':
+		{
+			p++;
+			if (*p == 'h')
+			{
+				spec->length = MUGGLE_LOG_DEFERRED_LEN_HH;
+				p++;
+			}
+			else
+			{
+				spec->length = MUGGLE_LOG_DEFERRED_LEN_H;
+			}
+		}break;
+		case 'l':
+		{
+			p++;
+			if (*p == 'l')
+			{
+				spec->length = MUGGLE_LOG_DEFERRED_LEN_LL;
+				p++;
+			}
+			else
+			{
+				spec->length = MUGGLE_LOG_DEFERRED_LEN_L;
+			}
+		}break;
+		case 'j': spec->length = MUGGLE_LOG_DEFERRED_LEN_J; p++; break;
+		case 'z': spec->length = MUGGLE_LOG_DEFERRED_LEN_Z; p++; break;
+		case 't': spec->length = MUGGLE_LOG_DEFERRED_LEN_T; p++; break;
+		case 'L': spec->length = MUGGLE_LOG_DEFERRED_LEN_BIG_L; p++; break;
+		default: break;
+	}
+
+	// conversion
+	switch (*p)
+	{
+		case 'd': case 'i':
+		{
+			spec->arg = MUGGLE_LOG_DEFERRED_ARG_SIGNED;
+		}break;
+		case 'o': case 'u': case 'x': case 'X':
+		{
+			spec->arg = MUGGLE_LOG_DEFERRED_ARG_UNSIGNED;
+		}break;
+		case 'c':
+		{
+			// wide char is not supported
+			spec->arg = spec->length == MUGGLE_LOG_DEFERRED_LEN_NONE ?
+				MUGGLE_LOG_DEFERRED_ARG_SIGNED : MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED;
+		}break;
+		case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+		{
+			spec->arg = spec->length == MUGGLE_LOG_DEFERRED_LEN_BIG_L ?
+				MUGGLE_LOG_DEFERRED_ARG_LONG_DOUBLE : MUGGLE_LOG_DEFERRED_ARG_DOUBLE;
+		}break;
+		case 's':
+		{
+			// wide string is not supported
+			spec->arg = spec->length == MUGGLE_LOG_DEFERRED_LEN_NONE ?
+				MUGGLE_LOG_DEFERRED_ARG_STRING : MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED;
+		}break;
+		case 'p':
+		{
+			spec->arg = MUGGLE_LOG_DEFERRED_ARG_POINTER;
+		}break;
+		case '%':
+		{
+			spec->arg = (p == begin + 1) ?
+				MUGGLE_LOG_DEFERRED_ARG_NONE : MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED;
+		}break;
+		default:
+		{
+			// include %n and end of string
+			spec->arg = MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED;
+		}break;
+	}
+
+	if (*p != '\0')
+	{
+		p++;
+	}
+	spec->len = (size_t)(p - begin);
+	if (spec->len >= MUGGLE_LOG_DEFERRED_SPEC_MAX_LEN)
+	{
+		spec->arg = MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED;
+	}
+}
+
+static uint64_t muggle_log_deferred_va_signed(int length, va_list *args)
+{
+	switch (length)
+	{
+		case MUGGLE_LOG_DEFERRED_LEN_L: return (uint64_t)va_arg(*args, long);
+		case MUGGLE_LOG_DEFERRED_LEN_LL: return (uint64_t)va_arg(*args, long long);
+		case MUGGLE_LOG_DEFERRED_LEN_J: return (uint64_t)va_arg(*args, intmax_t);
+		case MUGGLE_LOG_DEFERRED_LEN_Z: return (uint64_t)va_arg(*args, size_t);
+		case MUGGLE_LOG_DEFERRED_LEN_T: return (uint64_t)va_arg(*args, ptrdiff_t);
+		default: return (uint64_t)va_arg(*args, int);
+	}
+}
+
+static uint64_t muggle_log_deferred_va_unsigned(int length, va_list *args)
+{
+	switch (length)
+	{
+		case MUGGLE_LOG_DEFERRED_LEN_L: return (uint64_t)va_arg(*args, unsigned long);
+		case MUGGLE_LOG_DEFERRED_LEN_LL: return (uint64_t)va_arg(*args, unsigned long long);
+		case MUGGLE_LOG_DEFERRED_LEN_J: return (uint64_t)va_arg(*args, uintmax_t);
+		case MUGGLE_LOG_DEFERRED_LEN_Z: return (uint64_t)va_arg(*args, size_t);
+		case MUGGLE_LOG_DEFERRED_LEN_T: return (uint64_t)va_arg(*args, ptrdiff_t);
+		default: return (uint64_t)va_arg(*args, unsigned int);
+	}
+}
+
+size_t muggle_log_deferred_encode(char *buf, size_t bufsize, const char *format, va_list args)
+{
+	if (bufsize < sizeof(const char*))
+	{
+		return 0;
+	}
+
+	va_list ap;
+	va_copy(ap, args);
+
+	char *pos = buf;
+	char *end = buf + bufsize;
+
+	memcpy(pos, &format, sizeof(format));
+	pos += sizeof(format);
+
+	muggle_log_deferred_spec_t spec;
+	const char *p = format;
+	while (*p)
+	{
+		if (*p != '%')
+		{
+			p++;
+			continue;
+		}
+
+		muggle_log_deferred_parse_spec(p, &spec);
+		if (spec.arg == MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED)
+		{
+			// caller format it eagerly
+			pos = buf;
+			goto encode_end;
+		}
+		p += spec.len;
+
+		for (int i = 0; i < spec.n_star; i++)
+		{
+			if ((size_t)(end - pos) < sizeof(uint64_t))
+			{
+				goto encode_end;
+			}
+			int star = va_arg(ap, int);
+			uint64_t v = (uint64_t)(int64_t)star;
+			memcpy(pos, &v, sizeof(v));
+			pos += sizeof(v);
+
+			// '*' of precision is always the last one, negative means none
+			if (spec.precision == -2 && i == spec.n_star - 1)
+			{
+				spec.precision = star >= 0 ? star : -1;
+			}
+		}
+
+		switch (spec.arg)
+		{
+			case MUGGLE_LOG_DEFERRED_ARG_SIGNED:
+			case MUGGLE_LOG_DEFERRED_ARG_UNSIGNED:
+			{
+				if ((size_t)(end - pos) < sizeof(uint64_t))
+				{
+					goto encode_end;
+				}
+				uint64_t v = spec.arg == MUGGLE_LOG_DEFERRED_ARG_SIGNED ?
+					muggle_log_deferred_va_signed(spec.length, &ap) :
+					muggle_log_deferred_va_unsigned(spec.length, &ap);
+				memcpy(pos, &v, sizeof(v));
+				pos += sizeof(v);
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_DOUBLE:
+			{
+				if ((size_t)(end - pos) < sizeof(double))
+				{
+					goto encode_end;
+				}
+				double v = va_arg(ap, double);
+				memcpy(pos, &v, sizeof(v));
+				pos += sizeof(v);
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_LONG_DOUBLE:
+			{
+				if ((size_t)(end - pos) < sizeof(long double))
+				{
+					goto encode_end;
+				}
+				long double v = va_arg(ap, long double);
+				memcpy(pos, &v, sizeof(v));
+				pos += sizeof(v);
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_POINTER:
+			{
+				if ((size_t)(end - pos) < sizeof(void*))
+				{
+					goto encode_end;
+				}
+				void *v = va_arg(ap, void*);
+				memcpy(pos, &v, sizeof(v));
+				pos += sizeof(v);
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_STRING:
+			{
+				if ((size_t)(end - pos) < sizeof(uint32_t))
+				{
+					goto encode_end;
+				}
+				const char *s = va_arg(ap, const char*);
+				if (s == NULL)
+				{
+					s = "(null)";
+				}
+
+				// copy string with '\0', truncate if space not enough; with
+				// precision, s is not required to be null-terminated
+				size_t n = spec.precision >= 0 ?
+					strnlen(s, (size_t)spec.precision) : strlen(s);
+				size_t remain = (size_t)(end - pos) - sizeof(uint32_t);
+				if (remain == 0)
+				{
+					goto encode_end;
+				}
+				if (n > remain - 1)
+				{
+					n = remain - 1;
+				}
+				uint32_t n32 = (uint32_t)n;
+				memcpy(pos, &n32, sizeof(n32));
+				pos += sizeof(n32);
+				memcpy(pos, s, n);
+				pos[n] = '\0';
+				pos += n + 1;
+			}break;
+			default:
+			{
+				// %%
+			}break;
+		}
+	}
+
+encode_end:
+	va_end(ap);
+	return (size_t)(pos - buf);
+}
+
+#define MUGGLE_LOG_DEFERRED_SNPRINTF(buf, bufsize, spec_str, n_star, stars, v) \
+	((n_star) == 0 ? snprintf(buf, bufsize, spec_str, v) : \
+	 (n_star) == 1 ? snprintf(buf, bufsize, spec_str, stars[0], v) : \
+	 snprintf(buf, bufsize, spec_str, stars[0], stars[1], v))
+
+int muggle_log_deferred_decode(const char *record, size_t record_len, char *buf, size_t bufsize)
+{
+	if (bufsize == 0)
+	{
+		return -1;
+	}
+	buf[0] = '\0';
+
+	if (record_len < sizeof(const char*))
+	{
+		return -1;
+	}
+
+	const char *format = NULL;
+	memcpy(&format, record, sizeof(format));
+	const char *rpos = record + sizeof(format);
+	const char *rend = record + record_len;
+
+	size_t offset = 0;
+	char spec_str[MUGGLE_LOG_DEFERRED_SPEC_MAX_LEN];
+	muggle_log_deferred_spec_t spec;
+	const char *p = format;
+	while (*p && offset < bufsize - 1)
+	{
+		if (*p != '%')
+		{
+			// copy literal text
+			const char *literal_end = strchr(p, '%');
+			size_t n = literal_end ? (size_t)(literal_end - p) : strlen(p);
+			if (n > bufsize - 1 - offset)
+			{
+				n = bufsize - 1 - offset;
+			}
+			memcpy(buf + offset, p, n);
+			offset += n;
+			p += n;
+			continue;
+		}
+
+		muggle_log_deferred_parse_spec(p, &spec);
+		if (spec.arg == MUGGLE_LOG_DEFERRED_ARG_UNSUPPORTED)
+		{
+			break;
+		}
+		p += spec.len;
+
+		if (spec.arg == MUGGLE_LOG_DEFERRED_ARG_NONE)
+		{
+			buf[offset++] = '%';
+			continue;
+		}
+
+		memcpy(spec_str, spec.begin, spec.len);
+		spec_str[spec.len] = '\0';
+
+		int stars[2] = {0, 0};
+		for (int i = 0; i < spec.n_star; i++)
+		{
+			if ((size_t)(rend - rpos) < sizeof(uint64_t))
+			{
+				goto decode_end;
+			}
+			uint64_t v = 0;
+			memcpy(&v, rpos, sizeof(v));
+			rpos += sizeof(v);
+			stars[i] = (int)(int64_t)v;
+		}
+
+		char *out = buf + offset;
+		size_t out_size = bufsize - offset;
+		int n = 0;
+		switch (spec.arg)
+		{
+			case MUGGLE_LOG_DEFERRED_ARG_SIGNED:
+			case MUGGLE_LOG_DEFERRED_ARG_UNSIGNED:
+			{
+				if ((size_t)(rend - rpos) < sizeof(uint64_t))
+				{
+					goto decode_end;
+				}
+				uint64_t v = 0;
+				memcpy(&v, rpos, sizeof(v));
+				rpos += sizeof(v);
+
+				// cast back to the type in format, keep printf's promotion rules
+				int is_signed = spec.arg == MUGGLE_LOG_DEFERRED_ARG_SIGNED;
+				switch (spec.length)
+				{
+					case MUGGLE_LOG_DEFERRED_LEN_L:
+					{
+						if (is_signed)
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (long)v);
+						else
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (unsigned long)v);
+					}break;
+					case MUGGLE_LOG_DEFERRED_LEN_LL:
+					{
+						if (is_signed)
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (long long)v);
+						else
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (unsigned long long)v);
+					}break;
+					case MUGGLE_LOG_DEFERRED_LEN_J:
+					{
+						if (is_signed)
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (intmax_t)v);
+						else
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (uintmax_t)v);
+					}break;
+					case MUGGLE_LOG_DEFERRED_LEN_Z:
+					{
+						n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (size_t)v);
+					}break;
+					case MUGGLE_LOG_DEFERRED_LEN_T:
+					{
+						n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (ptrdiff_t)v);
+					}break;
+					default:
+					{
+						// hh and h are promoted to int, printf convert it back
+						if (is_signed)
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (int)v);
+						else
+							n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, (unsigned int)v);
+					}break;
+				}
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_DOUBLE:
+			{
+				if ((size_t)(rend - rpos) < sizeof(double))
+				{
+					goto decode_end;
+				}
+				double v = 0;
+				memcpy(&v, rpos, sizeof(v));
+				rpos += sizeof(v);
+				n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, v);
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_LONG_DOUBLE:
+			{
+				if ((size_t)(rend - rpos) < sizeof(long double))
+				{
+					goto decode_end;
+				}
+				long double v = 0;
+				memcpy(&v, rpos, sizeof(v));
+				rpos += sizeof(v);
+				n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, v);
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_POINTER:
+			{
+				if ((size_t)(rend - rpos) < sizeof(void*))
+				{
+					goto decode_end;
+				}
+				void *v = NULL;
+				memcpy(&v, rpos, sizeof(v));
+				rpos += sizeof(v);
+				n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, v);
+			}break;
+			case MUGGLE_LOG_DEFERRED_ARG_STRING:
+			{
+				if ((size_t)(rend - rpos) < sizeof(uint32_t))
+				{
+					goto decode_end;
+				}
+				uint32_t len = 0;
+				memcpy(&len, rpos, sizeof(len));
+				rpos += sizeof(len);
+				if ((size_t)(rend - rpos) < (size_t)len + 1)
+				{
+					goto decode_end;
+				}
+				n = MUGGLE_LOG_DEFERRED_SNPRINTF(out, out_size, spec_str, spec.n_star, stars, rpos);
+				rpos += len + 1;
+			}break;
+			default:
+			{
+			}break;
+		}
+
+		if (n < 0)
+		{
+			break;
+		}
+		offset += (size_t)n;
+		if (offset >= bufsize - 1)
+		{
+			offset = bufsize - 1;
+			break;
+		}
+	}
+
+decode_end:
+	buf[offset] = '\0';
+	return (int)offset;
+}
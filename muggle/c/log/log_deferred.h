@@ -0,0 +1,71 @@
+/******************************************************************************
+ *  @file         log_deferred.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec log deferred format
+ *
+ * Encode format pointer and raw arguments into compact binary record, and
+ * format the record later in another thread
+ *
+ * record layout: [format pointer][arg 0][arg 1]...
+ *   - integer:     8 bytes
+ *   - double:      sizeof(double)
+ *   - long double: sizeof(long double)
+ *   - pointer:     sizeof(void*)
+ *   - string:      4 bytes length + bytes + '\0', string is copied, so caller's
+ *                  buffer can be released right after log call
+ *   - '*' width or precision: 8 bytes
+ *
+ * format string is stored as pointer, it must be string literal or live
+ * as long as the record. decoding must happen in the same process
+ *
+ * supported conversions: d i o u x X c e E f F g G a A s p %, with flags,
+ * width, precision and length modifiers hh h l ll j z t L. format with
+ * unsupported conversion (such as %n or %ls) can't be encoded, caller
+ * should format it eagerly
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_LOG_DEFERRED_H_
+#define MUGGLE_C_LOG_DEFERRED_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+#include <stdarg.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief encode format and arguments into binary record
+ *
+ * @param buf      record buffer
+ * @param bufsize  size of buf
+ * @param format   format string
+ * @param args     arguments of format
+ *
+ * @return bytes of record, 0 if buf can't hold format pointer or format
+ *         has unsupported conversion; when buf is too small, arguments
+ *         that don't fit are dropped and string argument may be truncated
+ */
+MUGGLE_C_EXPORT
+size_t muggle_log_deferred_encode(char *buf, size_t bufsize, const char *format, va_list args);
+
+/**
+ * @brief format binary record into text
+ *
+ * @param record      binary record encoded by muggle_log_deferred_encode
+ * @param record_len  bytes of record
+ * @param buf         output buffer
+ * @param bufsize     size of buf
+ *
+ * @return length of formatted text (without '\0', not more than
+ *         bufsize - 1), negative represent failed
+ */
+MUGGLE_C_EXPORT
+int muggle_log_deferred_decode(const char *record, size_t record_len, char *buf, size_t bufsize);
+
+EXTERN_C_END
+
+#endif /* ifndef MUGGLE_C_LOG_DEFERRED_H_ */
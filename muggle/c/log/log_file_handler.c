@@ -39,8 +39,7 @@ static int muggle_log_file_handler_write(
 
 	if (handler->fp)
 	{
-		ret = (int)fwrite(buf, 1, ret, handler->fp);
-		fflush(handler->fp);
+		ret = muggle_log_handler_write_fp(base_handler, handler->fp, buf, (size_t)ret, msg->level);
 	}
 
 	if (base_handler->need_mutex)
@@ -51,6 +50,27 @@ static int muggle_log_file_handler_write(
 	return ret;
 }
 
+/**
+ * @brief output buffered records of file log handler
+ *
+ * @param handler  log handler pointer
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_file_handler_flush(
+	muggle_log_handler_t *base_handler)
+{
+	muggle_log_file_handler_t *handler = (muggle_log_file_handler_t*)base_handler;
+	if (handler->fp == NULL)
+	{
+		return MUGGLE_OK;
+	}
+
+	return muggle_log_handler_flush_fp(base_handler, handler->fp);
+}
+
 /**
  * @brief destroy file log handler
  *
@@ -66,6 +86,7 @@ static int muggle_log_file_handler_destroy(
 	muggle_log_file_handler_t *handler = (muggle_log_file_handler_t*)base_handler;
 	if (handler->fp != NULL)
 	{
+		muggle_log_handler_flush_fp(base_handler, handler->fp);
 		fclose(handler->fp);
 		handler->fp = NULL;
 	}
@@ -86,6 +107,7 @@ int muggle_log_file_handler_init(
 
 	handler->handler.write = muggle_log_file_handler_write;
 	handler->handler.destroy = muggle_log_file_handler_destroy;
+	handler->handler.flush = muggle_log_file_handler_flush;
 
 	const char* abs_filepath = NULL;
 	char log_path[MUGGLE_MAX_PATH];
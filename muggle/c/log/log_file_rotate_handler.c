@@ -7,6 +7,27 @@
 #include "muggle/c/time/win_gmtime.h"
 #endif
 
+void muggle_log_file_rotate_backups(const char *filepath, unsigned int backup_count)
+{
+	char buf[MUGGLE_MAX_PATH];
+	snprintf(buf, sizeof(buf)-1, "%s.%d", filepath, backup_count);
+	if (muggle_path_exists(buf))
+	{
+		muggle_os_remove(buf);
+	}
+
+	char src[MUGGLE_MAX_PATH], dst[MUGGLE_MAX_PATH];
+	for (int i = (int)backup_count - 1; i > 0; i--)
+	{
+		snprintf(src, sizeof(src), "%s.%d", filepath, i);
+		snprintf(dst, sizeof(dst), "%s.%d", filepath, i+1);
+		muggle_os_rename(src, dst);
+	}
+
+	snprintf(dst, sizeof(dst), "%s.1", filepath);
+	muggle_os_rename(filepath, dst);
+}
+
 /**
  * @brief rotate file rotate handler
  *
@@ -20,29 +41,26 @@ static int muggle_log_file_rotate_handler_rotate(muggle_log_file_rotate_handler_
 {
 	if (handler->fp)
 	{
+		muggle_log_handler_flush_fp((muggle_log_handler_t*)handler, handler->fp);
 		fclose(handler->fp);
 		handler->fp = NULL;
 	}
 
-	char buf[MUGGLE_MAX_PATH];
-	snprintf(buf, sizeof(buf)-1, "%s.%d",
-		handler->filepath, handler->backup_count);
-	if (muggle_path_exists(buf))
+	if (handler->rotate_worker)
 	{
-		muggle_os_remove(buf);
+		// never shift backups here, worker may be shifting the same files;
+		// when failed, file is kept in place and records continue append
+		// into it until next rotate
+		if (muggle_log_rotate_worker_backups(handler->rotate_worker, handler->filepath, handler->backup_count) != 0)
+		{
+			fprintf(stderr, "failed queue log rotate backups: %s\n", handler->filepath);
+		}
 	}
-
-	char src[MUGGLE_MAX_PATH], dst[MUGGLE_MAX_PATH];
-	for (int i = (int)handler->backup_count - 1; i > 0; i--)
+	else
 	{
-		snprintf(src, sizeof(src), "%s.%d", handler->filepath, i);
-		snprintf(dst, sizeof(dst), "%s.%d", handler->filepath, i+1);
-		muggle_os_rename(src, dst);
+		muggle_log_file_rotate_backups(handler->filepath, handler->backup_count);
 	}
 
-	snprintf(dst, sizeof(dst), "%s.1", handler->filepath);
-	muggle_os_rename(handler->filepath, dst);
-
 	handler->fp = fopen(handler->filepath, "ab+");
 	if (handler->fp == NULL)
 	{
@@ -89,8 +107,7 @@ static int muggle_log_file_rotate_handler_write(
 
 	if (handler->fp)
 	{
-		ret = (int)fwrite(buf, 1, ret, handler->fp);
-		fflush(handler->fp);
+		ret = muggle_log_handler_write_fp(base_handler, handler->fp, buf, (size_t)ret, msg->level);
 
 		handler->offset += (long)ret;
 		if (handler->offset >= handler->max_bytes)
@@ -110,6 +127,27 @@ static int muggle_log_file_rotate_handler_write(
 	return ret;
 }
 
+/**
+ * @brief output buffered records of file rotate log handler
+ *
+ * @param handler  log handler pointer
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_file_rotate_handler_flush(
+	muggle_log_handler_t *base_handler)
+{
+	muggle_log_file_rotate_handler_t *handler = (muggle_log_file_rotate_handler_t*)base_handler;
+	if (handler->fp == NULL)
+	{
+		return MUGGLE_OK;
+	}
+
+	return muggle_log_handler_flush_fp(base_handler, handler->fp);
+}
+
 /**
  * @brief destroy file log handler
  *
@@ -125,13 +163,37 @@ static int muggle_log_file_rotate_handler_destroy(
 	muggle_log_file_rotate_handler_t *handler = (muggle_log_file_rotate_handler_t*)base_handler;
 	if (handler->fp != NULL)
 	{
+		muggle_log_handler_flush_fp(base_handler, handler->fp);
 		fclose(handler->fp);
 		handler->fp = NULL;
 	}
 
+	muggle_log_rotate_worker_destroy(handler->rotate_worker);
+	handler->rotate_worker = NULL;
+
 	return muggle_log_handler_destroy_default(base_handler);
 }
 
+int muggle_log_file_rotate_handler_set_rotate_flags(
+	muggle_log_file_rotate_handler_t *handler, int flags)
+{
+	muggle_log_rotate_worker_destroy(handler->rotate_worker);
+	handler->rotate_worker = NULL;
+
+	if (flags == 0)
+	{
+		return MUGGLE_OK;
+	}
+
+	handler->rotate_worker = muggle_log_rotate_worker_create(flags);
+	if (handler->rotate_worker == NULL)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	return MUGGLE_OK;
+}
+
 int muggle_log_file_rotate_handler_init(
 	muggle_log_file_rotate_handler_t *handler,
 	const char *filepath,
@@ -146,6 +208,8 @@ int muggle_log_file_rotate_handler_init(
 
 	handler->handler.write = muggle_log_file_rotate_handler_write;
 	handler->handler.destroy = muggle_log_file_rotate_handler_destroy;
+	handler->handler.flush = muggle_log_file_rotate_handler_flush;
+	handler->rotate_worker = NULL;
 
 	const char* abs_filepath = NULL;
 	char log_path[MUGGLE_MAX_PATH];
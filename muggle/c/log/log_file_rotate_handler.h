@@ -14,6 +14,7 @@
 #include "muggle/c/base/macro.h"
 #include <stdio.h>
 #include "muggle/c/log/log_handler.h"
+#include "muggle/c/log/log_rotate_worker.h"
 
 EXTERN_C_BEGIN
 
@@ -28,6 +29,7 @@ typedef struct muggle_log_file_rotate_handler
 	unsigned int         max_bytes;
 	unsigned int         backup_count;
 	long                 offset;
+	muggle_log_rotate_worker_t *rotate_worker; //!< background rotate worker, NULL means rotate in writer thread
 }muggle_log_file_rotate_handler_t;
 
 /**
@@ -49,6 +51,38 @@ int muggle_log_file_rotate_handler_init(
 	unsigned int max_bytes,
 	unsigned int backup_count);
 
+/**
+ * @brief set rotate flags of file rotate log handler
+ *
+ * with MUGGLE_LOG_ROTATE_FLAG_BACKGROUND, writer thread only rename full
+ * file aside, backups are shifted in worker thread; with
+ * MUGGLE_LOG_ROTATE_FLAG_COMPRESS, backups are compressed and named
+ * filepath.{i}.lz. invoke it before handler added into logger
+ *
+ * @param handler  file rotate log handler pointer
+ * @param flags    bitwise or of MUGGLE_LOG_ROTATE_FLAG_*, 0 means rotate in
+ *                 writer thread
+ *
+ * @return 
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_file_rotate_handler_set_rotate_flags(
+	muggle_log_file_rotate_handler_t *handler, int flags);
+
+/**
+ * @brief shift backups of log file
+ *
+ * remove filepath.{backup_count}, rename filepath.{i} to filepath.{i+1},
+ * then rename filepath to filepath.1
+ *
+ * @param filepath      file path
+ * @param backup_count  max backup file count
+ */
+MUGGLE_C_EXPORT
+void muggle_log_file_rotate_backups(const char *filepath, unsigned int backup_count);
+
 EXTERN_C_END
 
 #endif /* ifndef MUGGLE_C_FILE_ROTATE_HANDLER_H_ */
@@ -107,6 +107,7 @@ static int muggle_log_file_time_rot_handler_rotate(
 {
 	if (handler->fp)
 	{
+		muggle_log_handler_flush_fp((muggle_log_handler_t*)handler, handler->fp);
 		fclose(handler->fp);
 		handler->fp = NULL;
 	}
@@ -155,11 +156,22 @@ static int muggle_log_file_time_rot_handler_rotate(
 		}break;
 	}
 
+	// file of last period is complete
+	if (handler->rotate_worker &&
+		(handler->rotate_worker->flags & MUGGLE_LOG_ROTATE_FLAG_COMPRESS) &&
+		handler->curr_filepath[0] != '\0' &&
+		strcmp(handler->curr_filepath, buf) != 0)
+	{
+		muggle_log_rotate_worker_compress(handler->rotate_worker, handler->curr_filepath);
+	}
+
 	handler->fp = fopen(buf, "ab+");
 	if (handler->fp == NULL)
 	{
+		handler->curr_filepath[0] = '\0';
 		return MUGGLE_ERR_SYS_CALL;
 	}
+	strncpy(handler->curr_filepath, buf, sizeof(handler->curr_filepath)-1);
 
 	return MUGGLE_OK;
 }
@@ -199,8 +211,7 @@ static int muggle_log_file_time_rot_handler_write(
 
 	if (handler->fp)
 	{
-		ret = (int)fwrite(buf, 1, ret, handler->fp);
-		fflush(handler->fp);
+		ret = muggle_log_handler_write_fp(base_handler, handler->fp, buf, (size_t)ret, msg->level);
 
 		if (muggle_log_file_time_rot_handler_detect(handler, msg))
 		{
@@ -219,6 +230,27 @@ static int muggle_log_file_time_rot_handler_write(
 	return ret;
 }
 
+/**
+ * @brief output buffered records of file time rotate log handler
+ *
+ * @param handler  log handler pointer
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_file_time_rot_handler_flush(
+	muggle_log_handler_t *base_handler)
+{
+	muggle_log_file_time_rot_handler_t *handler = (muggle_log_file_time_rot_handler_t*)base_handler;
+	if (handler->fp == NULL)
+	{
+		return MUGGLE_OK;
+	}
+
+	return muggle_log_handler_flush_fp(base_handler, handler->fp);
+}
+
 /**
  * @brief destroy file log handler
  *
@@ -234,13 +266,37 @@ static int muggle_log_file_time_rot_handler_destroy(
 	muggle_log_file_time_rot_handler_t *handler = (muggle_log_file_time_rot_handler_t*)base_handler;
 	if (handler->fp != NULL)
 	{
+		muggle_log_handler_flush_fp(base_handler, handler->fp);
 		fclose(handler->fp);
 		handler->fp = NULL;
 	}
 
+	muggle_log_rotate_worker_destroy(handler->rotate_worker);
+	handler->rotate_worker = NULL;
+
 	return muggle_log_handler_destroy_default(base_handler);
 }
 
+int muggle_log_file_time_rot_handler_set_rotate_flags(
+	muggle_log_file_time_rot_handler_t *handler, int flags)
+{
+	muggle_log_rotate_worker_destroy(handler->rotate_worker);
+	handler->rotate_worker = NULL;
+
+	if (flags == 0)
+	{
+		return MUGGLE_OK;
+	}
+
+	handler->rotate_worker = muggle_log_rotate_worker_create(flags);
+	if (handler->rotate_worker == NULL)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	return MUGGLE_OK;
+}
+
 int muggle_log_file_time_rot_handler_init(
 	muggle_log_file_time_rot_handler_t *handler,
 	const char *filepath,
@@ -256,6 +312,10 @@ int muggle_log_file_time_rot_handler_init(
 
 	handler->handler.write = muggle_log_file_time_rot_handler_write;
 	handler->handler.destroy = muggle_log_file_time_rot_handler_destroy;
+	handler->handler.flush = muggle_log_file_time_rot_handler_flush;
+	handler->fp = NULL;
+	handler->curr_filepath[0] = '\0';
+	handler->rotate_worker = NULL;
 
 	const char* abs_filepath = NULL;
 	char log_path[MUGGLE_MAX_PATH];
@@ -14,6 +14,7 @@
 #include "muggle/c/base/macro.h"
 #include <stdio.h>
 #include "muggle/c/log/log_handler.h"
+#include "muggle/c/log/log_rotate_worker.h"
 
 EXTERN_C_BEGIN
 
@@ -32,6 +33,8 @@ typedef struct muggle_log_file_time_rot_handler
 	time_t               last_sec;
 	struct tm            last_tm;
 	bool                 use_local_time;
+	char                 curr_filepath[MUGGLE_MAX_PATH]; //!< path of file being written
+	muggle_log_rotate_worker_t *rotate_worker; //!< background compress worker, NULL means keep raw files
 }muggle_log_file_time_rot_handler_t;
 
 /**
@@ -55,6 +58,24 @@ int muggle_log_file_time_rot_handler_init(
 	unsigned int rotate_mod,
 	bool use_local_time);
 
+/**
+ * @brief set rotate flags of file time rotate log handler
+ *
+ * with MUGGLE_LOG_ROTATE_FLAG_COMPRESS, file of last period is compressed
+ * into {file}.lz in worker thread after rotate. invoke it before handler
+ * added into logger
+ *
+ * @param handler  file time rotate log handler pointer
+ * @param flags    bitwise or of MUGGLE_LOG_ROTATE_FLAG_*
+ *
+ * @return 
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_file_time_rot_handler_set_rotate_flags(
+	muggle_log_file_time_rot_handler_t *handler, int flags);
+
 EXTERN_C_END
 
 #endif /* ifndef MUGGLE_C_LOG_FILE_TIME_ROTATE_HANDLER_H_ */
@@ -10,8 +10,10 @@
  
 #include "log_fmt.h"
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 #include "muggle/c/os/path.h"
+#include "muggle/c/base/atomic.h"
 #include "log_level.h"
 #if MUGGLE_PLATFORM_WINDOWS
 #include "muggle/c/time/win_gmtime.h"
@@ -83,6 +85,279 @@ static int muggle_log_fmt_complicated(const muggle_log_msg_t *msg, char *buf, si
 		payload);
 }
 
+/**
+ * @brief date time of second cached by muggle_log_fmt_cached,
+ * text is "YYYY-MM-DDThh:mm:ss.", protected by seqlock, seq is odd while
+ * some thread is rewriting it
+ */
+#define MUGGLE_LOG_FMT_CACHED_TIME_LEN 20
+typedef struct muggle_log_fmt_time_cache
+{
+	muggle_atomic_int seq;
+	time_t            sec;
+	char              text[MUGGLE_LOG_FMT_CACHED_TIME_LEN];
+}muggle_log_fmt_time_cache_t;
+
+static muggle_log_fmt_time_cache_t s_log_fmt_time_cache = { 0, 0, { 0 } };
+
+/**
+ * @brief basename memo entry, entry is immutable after state becomes READY,
+ * basename is always suffix of file, so only offset is recorded
+ */
+#define MUGGLE_LOG_FMT_BASENAME_CACHE_SIZE 256 // must be power of 2
+#define MUGGLE_LOG_FMT_BASENAME_CACHE_PROBE 8
+enum
+{
+	MUGGLE_LOG_FMT_BASENAME_EMPTY = 0,
+	MUGGLE_LOG_FMT_BASENAME_WRITING,
+	MUGGLE_LOG_FMT_BASENAME_READY,
+};
+typedef struct muggle_log_fmt_basename_entry
+{
+	muggle_atomic_int state;
+	unsigned int      offset;
+	const char        *file;
+}muggle_log_fmt_basename_entry_t;
+
+static muggle_log_fmt_basename_entry_t s_log_fmt_basename_cache[MUGGLE_LOG_FMT_BASENAME_CACHE_SIZE];
+
+static const char s_log_fmt_digits2[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static inline char* muggle_log_fmt_put_2digits(char *p, unsigned int v)
+{
+	memcpy(p, &s_log_fmt_digits2[v * 2], 2);
+	return p + 2;
+}
+
+/**
+ * @brief write unsigned integer in decimal
+ *
+ * @return number of characters
+ */
+static inline size_t muggle_log_fmt_u64toa(unsigned long long v, char *buf)
+{
+	char tmp[24];
+	char *p = tmp + sizeof(tmp);
+	while (v >= 100)
+	{
+		unsigned int r = (unsigned int)(v % 100);
+		v /= 100;
+		p -= 2;
+		memcpy(p, &s_log_fmt_digits2[r * 2], 2);
+	}
+	if (v >= 10)
+	{
+		p -= 2;
+		memcpy(p, &s_log_fmt_digits2[v * 2], 2);
+	}
+	else
+	{
+		*--p = (char)('0' + v);
+	}
+
+	size_t len = (size_t)(tmp + sizeof(tmp) - p);
+	memcpy(buf, p, len);
+	return len;
+}
+
+/**
+ * @brief render "YYYY-MM-DDThh:mm:ss." of second
+ */
+static void muggle_log_fmt_render_sec(time_t sec, char *text)
+{
+	struct tm t;
+	gmtime_r(&sec, &t);
+
+	char *p = text;
+	unsigned int year = (unsigned int)(t.tm_year + 1900);
+	p = muggle_log_fmt_put_2digits(p, (year / 100) % 100);
+	p = muggle_log_fmt_put_2digits(p, year % 100);
+	*p++ = '-';
+	p = muggle_log_fmt_put_2digits(p, (unsigned int)t.tm_mon + 1);
+	*p++ = '-';
+	p = muggle_log_fmt_put_2digits(p, (unsigned int)t.tm_mday);
+	*p++ = 'T';
+	p = muggle_log_fmt_put_2digits(p, (unsigned int)t.tm_hour);
+	*p++ = ':';
+	p = muggle_log_fmt_put_2digits(p, (unsigned int)t.tm_min);
+	*p++ = ':';
+	p = muggle_log_fmt_put_2digits(p, (unsigned int)t.tm_sec);
+	*p++ = '.';
+}
+
+/**
+ * @brief get "YYYY-MM-DDThh:mm:ss." of second, gmtime_r only invoked when
+ * second changed
+ */
+static void muggle_log_fmt_cached_sec(time_t sec, char *text)
+{
+	muggle_log_fmt_time_cache_t *cache = &s_log_fmt_time_cache;
+
+	muggle_atomic_int seq = muggle_atomic_load(&cache->seq, muggle_memory_order_acquire);
+	if (!(seq & 1) && seq != 0 && cache->sec == sec)
+	{
+		memcpy(text, cache->text, MUGGLE_LOG_FMT_CACHED_TIME_LEN);
+		muggle_atomic_thread_fence(muggle_memory_order_acquire);
+		if (muggle_atomic_load(&cache->seq, muggle_memory_order_relaxed) == seq)
+		{
+			return;
+		}
+	}
+
+	muggle_log_fmt_render_sec(sec, text);
+
+	// try to publish, give up if other thread is writing
+	if (!(seq & 1) &&
+		muggle_atomic_cmp_exch_strong(&cache->seq, &seq, seq + 1, muggle_memory_order_acquire))
+	{
+		cache->sec = sec;
+		memcpy(cache->text, text, MUGGLE_LOG_FMT_CACHED_TIME_LEN);
+		muggle_atomic_store(&cache->seq, seq + 2, muggle_memory_order_release);
+	}
+}
+
+/**
+ * @brief get basename of file, memoised by file pointer
+ *
+ * @return pointer to basename, it's a suffix of file
+ */
+static const char* muggle_log_fmt_cached_basename(const char *file)
+{
+	uintptr_t h = (uintptr_t)file;
+	h = (h >> 3) ^ (h >> 11);
+	h *= 0x9E3779B1u;
+
+	muggle_log_fmt_basename_entry_t *entry = NULL;
+	for (int i = 0; i < MUGGLE_LOG_FMT_BASENAME_CACHE_PROBE; i++)
+	{
+		muggle_log_fmt_basename_entry_t *e =
+			&s_log_fmt_basename_cache[(h + i) & (MUGGLE_LOG_FMT_BASENAME_CACHE_SIZE - 1)];
+		muggle_atomic_int state = muggle_atomic_load(&e->state, muggle_memory_order_acquire);
+		if (state == MUGGLE_LOG_FMT_BASENAME_READY)
+		{
+			if (e->file == file)
+			{
+				return file + e->offset;
+			}
+		}
+		else if (state == MUGGLE_LOG_FMT_BASENAME_EMPTY)
+		{
+			entry = e;
+			break;
+		}
+	}
+
+	const char *basename = file;
+	for (const char *p = file; *p; p++)
+	{
+		if (*p == '/' || *p == '\\')
+		{
+			basename = p + 1;
+		}
+	}
+
+	if (entry)
+	{
+		muggle_atomic_int expected = MUGGLE_LOG_FMT_BASENAME_EMPTY;
+		if (muggle_atomic_cmp_exch_strong(&entry->state, &expected,
+				MUGGLE_LOG_FMT_BASENAME_WRITING, muggle_memory_order_acquire))
+		{
+			entry->file = file;
+			entry->offset = (unsigned int)(basename - file);
+			muggle_atomic_store(&entry->state, MUGGLE_LOG_FMT_BASENAME_READY, muggle_memory_order_release);
+		}
+	}
+
+	return basename;
+}
+
+static inline char* muggle_log_fmt_put_str(char *p, char *end, const char *s, size_t len)
+{
+	if (len > (size_t)(end - p))
+	{
+		len = (size_t)(end - p);
+	}
+	memcpy(p, s, len);
+	return p + len;
+}
+
+/**
+ * @brief same output as muggle_log_fmt_complicated, with cached date time
+ * and basename, fields are written without snprintf
+ *
+ * @param msg      log message
+ * @param buf      the formated message output buffer
+ * @param bufsize  the size of buf
+ *
+ * @return the len of formated message, negative represent failed
+ */
+static int muggle_log_fmt_cached(const muggle_log_msg_t *msg, char *buf, size_t bufsize)
+{
+	if (bufsize == 0)
+	{
+		return -1;
+	}
+
+	char tmp[64];
+	size_t n = 0;
+	char *p = buf;
+	char *end = buf + bufsize - 1;
+
+	// level
+	const char *level = muggle_log_level_to_str(msg->level);
+	p = muggle_log_fmt_put_str(p, end, level, strlen(level));
+
+	// time
+	tmp[0] = '|';
+	muggle_log_fmt_cached_sec(msg->ts.tv_sec, tmp + 1);
+	n = 1 + MUGGLE_LOG_FMT_CACHED_TIME_LEN;
+	unsigned int ms = (unsigned int)(msg->ts.tv_nsec / 1000000) % 1000;
+	tmp[n++] = (char)('0' + ms / 100);
+	muggle_log_fmt_put_2digits(tmp + n, ms % 100);
+	n += 2;
+	tmp[n++] = '|';
+	p = muggle_log_fmt_put_str(p, end, tmp, n);
+
+	// file:line
+	const char *filename = muggle_log_fmt_cached_basename(msg->src_loc.file);
+	p = muggle_log_fmt_put_str(p, end, filename, strlen(filename));
+	tmp[0] = ':';
+	n = 1 + muggle_log_fmt_u64toa((unsigned long long)msg->src_loc.line, tmp + 1);
+	tmp[n++] = '|';
+	p = muggle_log_fmt_put_str(p, end, tmp, n);
+
+	// func
+	p = muggle_log_fmt_put_str(p, end, msg->src_loc.func, strlen(msg->src_loc.func));
+
+	// thread id
+	tmp[0] = '|';
+	n = 1 + muggle_log_fmt_u64toa((unsigned long long)msg->tid, tmp + 1);
+	memcpy(tmp + n, " - ", 3);
+	n += 3;
+	p = muggle_log_fmt_put_str(p, end, tmp, n);
+
+	// payload
+	if (msg->payload)
+	{
+		p = muggle_log_fmt_put_str(p, end, msg->payload, strlen(msg->payload));
+	}
+
+	p = muggle_log_fmt_put_str(p, end, "\n", 1);
+	*p = '\0';
+
+	return (int)(p - buf);
+}
+
 void init_fmt(muggle_log_fmt_t *p_fmt, int hint, func_muggle_log_fmt func)
 {
 	memset(p_fmt, 0, sizeof(*p_fmt));
@@ -107,3 +382,12 @@ muggle_log_fmt_t* muggle_log_fmt_get_complicated()
 	};
 	return &fmt;
 }
+
+muggle_log_fmt_t* muggle_log_fmt_get_cached()
+{
+	static muggle_log_fmt_t fmt = {
+		MUGGLE_LOG_FMT_ALL,
+		muggle_log_fmt_cached
+	};
+	return &fmt;
+}
@@ -77,6 +77,20 @@ muggle_log_fmt_t* muggle_log_fmt_get_simple();
 MUGGLE_C_EXPORT
 muggle_log_fmt_t* muggle_log_fmt_get_complicated();
 
+/**
+ * @brief get muggle log formatter with the same output as
+ * muggle_log_fmt_get_complicated, date time is rendered once per second,
+ * basenames are memoised by source file pointer and fields are written
+ * without snprintf
+ *
+ * @note output is truncated to bufsize - 1 and the returned length never
+ * exceed it
+ *
+ * @return muggle log formatter
+ */
+MUGGLE_C_EXPORT
+muggle_log_fmt_t* muggle_log_fmt_get_cached();
+
 EXTERN_C_END
 
 #endif
@@ -1,4 +1,6 @@
 #include "log_handler.h"
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include "muggle/c/log/log_level.h"
 #include "muggle/c/base/err.h"
@@ -56,9 +58,140 @@ int muggle_log_handler_init_default(muggle_log_handler_t *handler)
 	return 0;
 }
 
+int muggle_log_handler_set_buffer(muggle_log_handler_t *handler, size_t buf_size, int flush_interval_ms)
+{
+	if (flush_interval_ms < 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	if (handler->buf)
+	{
+		free(handler->buf);
+		handler->buf = NULL;
+	}
+	handler->buf_size = 0;
+	handler->buf_len = 0;
+	handler->flush_interval_ms = flush_interval_ms;
+
+	if (buf_size > 0)
+	{
+		handler->buf = (char*)malloc(buf_size);
+		if (handler->buf == NULL)
+		{
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		handler->buf_size = buf_size;
+	}
+	timespec_get(&handler->last_flush_ts, TIME_UTC);
+
+	return MUGGLE_OK;
+}
+
+int muggle_log_handler_flush(muggle_log_handler_t *handler)
+{
+	if (handler->flush == NULL)
+	{
+		return MUGGLE_OK;
+	}
+
+	if (handler->need_mutex)
+	{
+		muggle_mutex_lock(&handler->mtx);
+	}
+
+	int ret = handler->flush(handler);
+
+	if (handler->need_mutex)
+	{
+		muggle_mutex_unlock(&handler->mtx);
+	}
+
+	return ret;
+}
+
+int muggle_log_handler_write_fp(
+	muggle_log_handler_t *handler, FILE *fp, const char *data, size_t len, int level)
+{
+	if (handler->buf == NULL)
+	{
+		int ret = (int)fwrite(data, 1, len, fp);
+		fflush(fp);
+		return ret;
+	}
+
+	if (len > handler->buf_size - handler->buf_len)
+	{
+		muggle_log_handler_flush_fp(handler, fp);
+	}
+
+	if (len > handler->buf_size)
+	{
+		// record larger than buffer, output directly
+		int ret = (int)fwrite(data, 1, len, fp);
+		fflush(fp);
+		return ret;
+	}
+
+	memcpy(handler->buf + handler->buf_len, data, len);
+	handler->buf_len += len;
+
+	if (level >= MUGGLE_LOG_LEVEL_ERROR || handler->buf_len == handler->buf_size)
+	{
+		muggle_log_handler_flush_fp(handler, fp);
+	}
+	else if (handler->flush_interval_ms > 0)
+	{
+		struct timespec ts;
+		timespec_get(&ts, TIME_UTC);
+		int64_t elapsed_ms =
+			(int64_t)(ts.tv_sec - handler->last_flush_ts.tv_sec) * 1000 +
+			(ts.tv_nsec - handler->last_flush_ts.tv_nsec) / 1000000;
+		if (elapsed_ms >= handler->flush_interval_ms)
+		{
+			muggle_log_handler_flush_fp(handler, fp);
+		}
+	}
+
+	return (int)len;
+}
+
+int muggle_log_handler_flush_fp(muggle_log_handler_t *handler, FILE *fp)
+{
+	int ret = MUGGLE_OK;
+	if (handler->buf_len > 0)
+	{
+		if (fwrite(handler->buf, 1, handler->buf_len, fp) != handler->buf_len)
+		{
+			ret = MUGGLE_ERR_SYS_CALL;
+		}
+		handler->buf_len = 0;
+	}
+
+	if (fflush(fp) != 0)
+	{
+		ret = MUGGLE_ERR_SYS_CALL;
+	}
+
+	if (handler->flush_interval_ms > 0)
+	{
+		timespec_get(&handler->last_flush_ts, TIME_UTC);
+	}
+
+	return ret;
+}
+
 int muggle_log_handler_destroy_default(muggle_log_handler_t *handler)
 {
 	muggle_mutex_destroy(&handler->mtx);
 
+	if (handler->buf)
+	{
+		free(handler->buf);
+		handler->buf = NULL;
+	}
+	handler->buf_size = 0;
+	handler->buf_len = 0;
+
 	return 0;
 }
@@ -13,6 +13,8 @@
 
 #include "muggle/c/base/macro.h"
 #include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/log/log_msg.h"
 #include "muggle/c/log/log_fmt.h"
@@ -28,6 +30,9 @@ typedef int (*func_muggle_log_handler_write)(
 typedef int (*func_muggle_log_handler_destroy)(
 	struct muggle_log_handler *handler);
 
+typedef int (*func_muggle_log_handler_flush)(
+	struct muggle_log_handler *handler);
+
 /**
  * @brief muggle log handler
  */
@@ -35,11 +40,18 @@ typedef struct muggle_log_handler
 {
 	func_muggle_log_handler_write   write;
 	func_muggle_log_handler_destroy destroy;
+	func_muggle_log_handler_flush   flush;   //!< optional, output buffered records
 
 	int              level;
 	muggle_log_fmt_t *fmt;
 	bool             need_mutex;
 	muggle_mutex_t   mtx;          //!< mutex
+
+	char             *buf;              //!< buffered records, NULL means flush every record
+	size_t           buf_size;          //!< byte threshold of buffer
+	size_t           buf_len;           //!< bytes of buffered records
+	int              flush_interval_ms; //!< time threshold of buffer, 0 means no time threshold
+	struct timespec  last_flush_ts;     //!< timestamp of last flush
 }muggle_log_handler_t;
 
 /**
@@ -97,6 +109,76 @@ bool muggle_log_handler_should_write(muggle_log_handler_t *handler, int level);
 MUGGLE_C_EXPORT
 void muggle_log_handler_set_mutex(muggle_log_handler_t *handler, bool flag);
 
+/**
+ * @brief enable buffered mode of handler
+ *
+ * in buffered mode, records are accumulated in handler and output together
+ * when any of the following is reached
+ *     - buffer can't hold new record
+ *     - time from last flush reach flush_interval_ms, checked when write
+ *     - record level is MUGGLE_LOG_LEVEL_ERROR or higher
+ *     - async logger's channel is drained
+ *     - muggle_log_handler_flush or muggle_logger_flush be invoked
+ *
+ * must be invoked before handler is used, only handlers that support flush
+ * (built-in console and file handlers) respect it
+ *
+ * @param handler            log handler pointer
+ * @param buf_size           bytes of buffer, 0 means disable buffered mode
+ * @param flush_interval_ms  time threshold in milliseconds, 0 means no time threshold
+ *
+ * @return
+ *     - on success, return 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handler_set_buffer(muggle_log_handler_t *handler, size_t buf_size, int flush_interval_ms);
+
+/**
+ * @brief output buffered records of handler
+ *
+ * @param handler  log handler pointer
+ *
+ * @return
+ *     - on success, return 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handler_flush(muggle_log_handler_t *handler);
+
+/**
+ * @brief output record into file stream, for handler implementation
+ *
+ * when handler not in buffered mode, write and flush immediately, otherwise
+ * buffer record and flush when reach threshold. caller must hold the
+ * handler's mutex if need
+ *
+ * @param handler  log handler pointer
+ * @param fp       file stream
+ * @param data     formatted record
+ * @param len      length of data
+ * @param level    level of record
+ *
+ * @return number of bytes accepted
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handler_write_fp(
+	muggle_log_handler_t *handler, FILE *fp, const char *data, size_t len, int level);
+
+/**
+ * @brief output buffered records into file stream and flush it, for
+ * handler implementation. caller must hold the handler's mutex if need
+ *
+ * @param handler  log handler pointer
+ * @param fp       file stream
+ *
+ * @return
+ *     - on success, return 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handler_flush_fp(muggle_log_handler_t *handler, FILE *fp);
+
 /**
  * @brief intialize base log handler
  *
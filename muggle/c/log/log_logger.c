@@ -17,6 +17,22 @@ void muggle_logger_write(muggle_logger_t *logger, muggle_log_msg_t *msg)
 	}
 }
 
+void muggle_logger_flush(muggle_logger_t *logger)
+{
+	if (logger->flush)
+	{
+		logger->flush(logger);
+	}
+}
+
+void muggle_logger_flush_handlers(muggle_logger_t *logger)
+{
+	for (int i = 0; i < logger->cnt; i++)
+	{
+		muggle_log_handler_flush(logger->handlers[i]);
+	}
+}
+
 muggle_logger_t* muggle_logger_default()
 {
 	static muggle_sync_logger_t logger =
@@ -25,6 +41,7 @@ muggle_logger_t* muggle_logger_default()
 			muggle_sync_logger_log,
 			muggle_sync_logger_add_handler,
 			muggle_sync_logger_destroy,
+			muggle_sync_logger_flush,
 			{NULL}, 0, 0, MUGGLE_LOG_LEVEL_FATAL
 		}
 	};
@@ -35,7 +35,7 @@ struct muggle_logger;
 typedef void (*func_muggle_logger_log)(
 	struct muggle_logger *logger,
 	int level,
-	muggle_log_src_loc_t *src_loc,
+	const muggle_log_src_loc_t *src_loc,
 	const char *format,
 	...);
 
@@ -58,6 +58,13 @@ typedef int (*func_muggle_logger_add_handler)(struct muggle_logger *logger, mugg
  */
 typedef void (*func_muggle_logger_destroy)(struct muggle_logger *logger);
 
+/**
+ * @brief prototype of flush logger
+ *
+ * @param logger logger pointer
+ */
+typedef void (*func_muggle_logger_flush)(struct muggle_logger *logger);
+
 
 /**
  * @brief muggle logger
@@ -67,6 +74,7 @@ typedef struct muggle_logger
 	func_muggle_logger_log         log;
 	func_muggle_logger_add_handler add_handler;
 	func_muggle_logger_destroy     destroy;
+	func_muggle_logger_flush       flush;
 
 	muggle_log_handler_t *handlers[MUGGLE_LOGGER_MAX_HANDLER];
 	int cnt;
@@ -83,6 +91,25 @@ typedef struct muggle_logger
 MUGGLE_C_EXPORT
 void muggle_logger_write(muggle_logger_t *logger, muggle_log_msg_t *msg);
 
+/**
+ * @brief output all buffered records of logger
+ *
+ * for async logger, wait until all messages logged before this call
+ * are written and flushed
+ *
+ * @param logger  logger pointer
+ */
+MUGGLE_C_EXPORT
+void muggle_logger_flush(muggle_logger_t *logger);
+
+/**
+ * @brief flush all handlers of logger
+ *
+ * @param logger  logger pointer
+ */
+MUGGLE_C_EXPORT
+void muggle_logger_flush_handlers(muggle_logger_t *logger);
+
 /**
  * @brief get default logger
  *
@@ -0,0 +1,411 @@
+#include "log_mmap_handler.h"
+#include <stdio.h>
+#include <string.h>
+#include "muggle/c/log/log_level.h"
+#include "muggle/c/log/log_file_rotate_handler.h"
+#include "muggle/c/base/err.h"
+#include "muggle/c/os/os.h"
+#include "muggle/c/os/path.h"
+
+#if !MUGGLE_PLATFORM_WINDOWS
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static size_t muggle_log_mmap_page_size()
+{
+	long page_size = sysconf(_SC_PAGESIZE);
+	return page_size > 0 ? (size_t)page_size : 4096;
+}
+
+/**
+ * @brief msync records written after last sync
+ */
+static void muggle_log_mmap_handler_sync(muggle_log_mmap_handler_t *handler)
+{
+	if (handler->window == NULL || handler->pos <= handler->sync_pos)
+	{
+		return;
+	}
+
+	size_t page_size = muggle_log_mmap_page_size();
+	size_t begin = handler->sync_pos - handler->sync_pos % page_size;
+	msync(handler->window + begin, handler->pos - begin, MS_SYNC);
+	handler->sync_pos = handler->pos;
+}
+
+/**
+ * @brief preallocate and map window at offset of file
+ *
+ * @param handler  memory mapped file log handler pointer
+ * @param offset   file offset, multiple of page size
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_mmap_handler_map(muggle_log_mmap_handler_t *handler, size_t offset)
+{
+	// fallocate on linux, reserve disk blocks and extend file size
+	if (posix_fallocate(handler->fd, (off_t)offset, (off_t)handler->window_size) != 0)
+	{
+		fprintf(stderr, "failed preallocate log file: %s\n", handler->filepath);
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	void *p = mmap(NULL, handler->window_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED, handler->fd, (off_t)offset);
+	if (p == MAP_FAILED)
+	{
+		fprintf(stderr, "failed mmap log file: %s\n", handler->filepath);
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	handler->window = (char*)p;
+	handler->window_offset = offset;
+	handler->pos = 0;
+	handler->sync_pos = 0;
+
+	return MUGGLE_OK;
+}
+
+/**
+ * @brief release current window
+ */
+static void muggle_log_mmap_handler_unmap(muggle_log_mmap_handler_t *handler, bool shutdown)
+{
+	if (handler->window == NULL)
+	{
+		return;
+	}
+
+	if (shutdown && (handler->flags & MUGGLE_LOG_MMAP_FLAG_SYNC_SHUTDOWN))
+	{
+		muggle_log_mmap_handler_sync(handler);
+	}
+
+	munmap(handler->window, handler->window_size);
+	handler->window = NULL;
+}
+
+/**
+ * @brief open file and map the window contains end of file
+ */
+static int muggle_log_mmap_handler_open(muggle_log_mmap_handler_t *handler)
+{
+	handler->fd = open(handler->filepath, O_RDWR | O_CREAT, 0664);
+	if (handler->fd == -1)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	struct stat st;
+	if (fstat(handler->fd, &st) != 0)
+	{
+		close(handler->fd);
+		handler->fd = -1;
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	size_t size = (size_t)st.st_size;
+	size_t page_size = muggle_log_mmap_page_size();
+	int ret = muggle_log_mmap_handler_map(handler, size - size % page_size);
+	if (ret != 0)
+	{
+		close(handler->fd);
+		handler->fd = -1;
+		return ret;
+	}
+	handler->pos = size % page_size;
+	handler->sync_pos = handler->pos;
+
+	return MUGGLE_OK;
+}
+
+/**
+ * @brief release window and truncate preallocated tail of file
+ */
+static void muggle_log_mmap_handler_close(muggle_log_mmap_handler_t *handler)
+{
+	if (handler->fd == -1)
+	{
+		return;
+	}
+
+	size_t size = handler->window_offset + handler->pos;
+	muggle_log_mmap_handler_unmap(handler, true);
+
+	if (ftruncate(handler->fd, (off_t)size) != 0)
+	{
+		fprintf(stderr, "failed truncate log file: %s\n", handler->filepath);
+	}
+	close(handler->fd);
+	handler->fd = -1;
+}
+
+/**
+ * @brief rotate memory mapped file log handler
+ *
+ * @param handler memory mapped file log handler pointer
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_mmap_handler_rotate(muggle_log_mmap_handler_t *handler)
+{
+	muggle_log_mmap_handler_close(handler);
+	muggle_log_file_rotate_backups(handler->filepath, handler->backup_count);
+	return muggle_log_mmap_handler_open(handler);
+}
+
+/**
+ * @brief copy record into mapping, move to next window when current is full
+ *
+ * @param handler  memory mapped file log handler pointer
+ * @param data     formatted record
+ * @param len      bytes of record
+ * @param sync     msync the part of record in current window before it's
+ *                 released
+ *
+ * @return number of bytes copied, less than len when failed map next window,
+ * the map will be retried by next copy
+ */
+static size_t muggle_log_mmap_handler_copy(
+	muggle_log_mmap_handler_t *handler, const char *data, size_t len, bool sync)
+{
+	size_t copied = 0;
+	while (copied < len)
+	{
+		if (handler->window == NULL || handler->pos == handler->window_size)
+		{
+			if (handler->window && sync)
+			{
+				muggle_log_mmap_handler_sync(handler);
+			}
+
+			// window already released if previous map failed
+			size_t next_offset = handler->window_offset + handler->window_size;
+			muggle_log_mmap_handler_unmap(handler, false);
+			if (muggle_log_mmap_handler_map(handler, next_offset) != 0)
+			{
+				break;
+			}
+		}
+
+		size_t n = handler->window_size - handler->pos;
+		if (n > len - copied)
+		{
+			n = len - copied;
+		}
+		memcpy(handler->window + handler->pos, data + copied, n);
+		handler->pos += n;
+		copied += n;
+	}
+
+	return copied;
+}
+
+/**
+ * @brief write log
+ *
+ * @param handler  log handler pointer
+ * @param msg      muggle log msg
+ *
+ * @return
+ *     - on success, return number of bytes be writed
+ *     - otherwise return negative number
+ */
+static int muggle_log_mmap_handler_write(
+	struct muggle_log_handler *base_handler, const muggle_log_msg_t *msg)
+{
+	char buf[MUGGLE_LOG_MSG_MAX_LEN];
+	muggle_log_fmt_t *fmt = muggle_log_handler_get_fmt(base_handler);
+	if (fmt == NULL)
+	{
+		return -1;
+	}
+
+	int ret = fmt->fmt_func(msg, buf, sizeof(buf));
+	if (ret < 0)
+	{
+		return -2;
+	}
+	if ((size_t)ret >= sizeof(buf))
+	{
+		ret = (int)sizeof(buf) - 1;
+	}
+
+	muggle_log_mmap_handler_t *handler = (muggle_log_mmap_handler_t*)base_handler;
+
+	if (base_handler->need_mutex)
+	{
+		muggle_mutex_lock(&base_handler->mtx);
+	}
+
+	// reopen file if previous rotate failed
+	if (handler->fd == -1 && muggle_log_mmap_handler_open(handler) != 0)
+	{
+		ret = -3;
+	}
+	else
+	{
+		bool sync = msg->level >= MUGGLE_LOG_LEVEL_ERROR &&
+			(handler->flags & MUGGLE_LOG_MMAP_FLAG_SYNC_ERROR);
+
+		size_t len = (size_t)ret;
+		size_t copied = muggle_log_mmap_handler_copy(handler, buf, len, sync);
+		ret = (copied == 0 && len > 0) ? -3 : (int)copied;
+
+		if (sync)
+		{
+			muggle_log_mmap_handler_sync(handler);
+		}
+
+		if (handler->max_bytes > 0 &&
+			handler->window_offset + handler->pos >= handler->max_bytes)
+		{
+			if (muggle_log_mmap_handler_rotate(handler) != 0)
+			{
+				fprintf(stderr, "failed rotate log handler");
+			}
+		}
+	}
+
+	if (base_handler->need_mutex)
+	{
+		muggle_mutex_unlock(&base_handler->mtx);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief destroy memory mapped file log handler
+ *
+ * @param handler  log handler pointer
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_mmap_handler_destroy(
+	muggle_log_handler_t *base_handler)
+{
+	muggle_log_mmap_handler_t *handler = (muggle_log_mmap_handler_t*)base_handler;
+	muggle_log_mmap_handler_close(handler);
+
+	return muggle_log_handler_destroy_default(base_handler);
+}
+
+int muggle_log_mmap_handler_init(
+	muggle_log_mmap_handler_t *handler,
+	const char *filepath,
+	size_t window_size,
+	size_t max_bytes,
+	unsigned int backup_count,
+	int flags)
+{
+	int ret = muggle_log_handler_init_default((muggle_log_handler_t*)handler);
+	if (ret != 0)
+	{
+		return ret;
+	}
+
+	handler->handler.write = muggle_log_mmap_handler_write;
+	handler->handler.destroy = muggle_log_mmap_handler_destroy;
+	handler->fd = -1;
+	handler->window = NULL;
+
+	const char* abs_filepath = NULL;
+	char log_path[MUGGLE_MAX_PATH];
+	if (muggle_path_isabs(filepath))
+	{
+		abs_filepath = filepath;
+	}
+	else
+	{
+		char cur_path[MUGGLE_MAX_PATH];
+		ret = muggle_os_curdir(cur_path, sizeof(cur_path));
+		if (ret != 0)
+		{
+			return ret;
+		}
+
+		ret = muggle_path_join(cur_path, filepath, log_path, sizeof(log_path));
+		if (ret != 0)
+		{
+			return ret;
+		}
+
+		char log_dir[MUGGLE_MAX_PATH];
+		ret = muggle_path_dirname(log_path, log_dir, sizeof(log_dir));
+		if (ret != 0)
+		{
+			return ret;
+		}
+
+		if (!muggle_path_exists(log_dir))
+		{
+			ret = muggle_os_mkdir(log_dir);
+			if (ret != 0)
+			{
+				return ret;
+			}
+		}
+
+		abs_filepath = log_path;
+	}
+
+	// window is multiple of page size
+	if (window_size == 0)
+	{
+		window_size = MUGGLE_LOG_MMAP_DEFAULT_WINDOW_SIZE;
+	}
+	size_t page_size = muggle_log_mmap_page_size();
+	window_size = (window_size + page_size - 1) / page_size * page_size;
+
+	strncpy(handler->filepath, abs_filepath, sizeof(handler->filepath)-1);
+	handler->flags = flags;
+	handler->window_size = window_size;
+	handler->max_bytes = max_bytes;
+	handler->backup_count = backup_count;
+
+	ret = muggle_log_mmap_handler_open(handler);
+	if (ret != 0)
+	{
+		return ret;
+	}
+
+	if (handler->max_bytes > 0 &&
+		handler->window_offset + handler->pos >= handler->max_bytes)
+	{
+		muggle_log_mmap_handler_rotate(handler);
+	}
+
+	return MUGGLE_OK;
+}
+
+#else
+
+int muggle_log_mmap_handler_init(
+	muggle_log_mmap_handler_t *handler,
+	const char *filepath,
+	size_t window_size,
+	size_t max_bytes,
+	unsigned int backup_count,
+	int flags)
+{
+	(void)handler;
+	(void)filepath;
+	(void)window_size;
+	(void)max_bytes;
+	(void)backup_count;
+	(void)flags;
+	fprintf(stderr, "log mmap handler is not supported on windows\n");
+	return MUGGLE_ERR_TODO;
+}
+
+#endif
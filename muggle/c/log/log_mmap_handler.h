@@ -0,0 +1,82 @@
+/******************************************************************************
+ *  @file         log_mmap_handler.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec log memory mapped file handler
+ *
+ * File is preallocated and mapped window by window, formatted records are
+ * copied into mapping directly, no stdio write and flush per message.
+ * When file size reach max_bytes, file is rotated like
+ * muggle_log_file_rotate_handler_t
+ *
+ * file is truncated to real size when window is released, if process
+ * crashed, the tail of file may be padded with '\0'
+ *
+ * only support posix platform now
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_LOG_MMAP_HANDLER_H_
+#define MUGGLE_C_LOG_MMAP_HANDLER_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+#include "muggle/c/log/log_handler.h"
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_LOG_MMAP_DEFAULT_WINDOW_SIZE (8 * 1024 * 1024)
+
+enum
+{
+	MUGGLE_LOG_MMAP_FLAG_SYNC_ERROR    = 0x01, //!< msync after record with level >= ERROR
+	MUGGLE_LOG_MMAP_FLAG_SYNC_SHUTDOWN = 0x02, //!< msync when window released and handler destroyed
+};
+
+/**
+ * @brief muggle log memory mapped file handler
+ */
+typedef struct muggle_log_mmap_handler
+{
+	muggle_log_handler_t handler;
+	char                 filepath[MUGGLE_MAX_PATH];
+	int                  fd;
+	int                  flags;         //!< bitwise or of MUGGLE_LOG_MMAP_FLAG_*
+	char                 *window;       //!< current mapping
+	size_t               window_size;   //!< bytes of mapping, multiple of page size
+	size_t               window_offset; //!< file offset of mapping
+	size_t               pos;           //!< write position in mapping
+	size_t               sync_pos;      //!< records before it in mapping are synced
+	size_t               max_bytes;     //!< rotate when file size reach it, 0 means never rotate
+	unsigned int         backup_count;
+}muggle_log_mmap_handler_t;
+
+/**
+ * @brief initialize memory mapped file log handler
+ *
+ * @param handler       memory mapped file log handler pointer
+ * @param filepath      file path, records are appended if file exists
+ * @param window_size   bytes of every mapping, 0 means
+ *                      MUGGLE_LOG_MMAP_DEFAULT_WINDOW_SIZE
+ * @param max_bytes     max bytes per file, 0 means never rotate
+ * @param backup_count  max backup file count
+ * @param flags         bitwise or of MUGGLE_LOG_MMAP_FLAG_*
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_mmap_handler_init(
+	muggle_log_mmap_handler_t *handler,
+	const char *filepath,
+	size_t window_size,
+	size_t max_bytes,
+	unsigned int backup_count,
+	int flags);
+
+EXTERN_C_END
+
+#endif /* ifndef MUGGLE_C_LOG_MMAP_HANDLER_H_ */
@@ -0,0 +1,261 @@
+#include "log_rotate_worker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/os/os.h"
+#include "muggle/c/os/path.h"
+#include "muggle/c/log/log_compress.h"
+
+enum
+{
+	MUGGLE_LOG_ROTATE_TASK_BACKUPS = 0,
+	MUGGLE_LOG_ROTATE_TASK_COMPRESS,
+};
+
+typedef struct muggle_log_rotate_task
+{
+	int          type;         //!< MUGGLE_LOG_ROTATE_TASK_*
+	unsigned int backup_count;
+	char         filepath[MUGGLE_MAX_PATH];
+	char         staging[MUGGLE_MAX_PATH];
+}muggle_log_rotate_task_t;
+
+/**
+ * @brief compress src into dst, keep src when failed
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+static int muggle_log_rotate_worker_compress_file(const char *src, const char *dst)
+{
+	int ret = muggle_log_lz_compress_file(src, dst);
+	if (ret != 0)
+	{
+		fprintf(stderr, "failed compress rotated log file: %s\n", src);
+		return ret;
+	}
+
+	muggle_os_remove(src);
+	return MUGGLE_OK;
+}
+
+/**
+ * @brief generate path of backup file: <filepath>.<idx><ext>
+ *
+ * @return
+ *     - success returns 0
+ *     - path is truncated returns MUGGLE_ERR_BEYOND_RANGE
+ */
+static int muggle_log_rotate_worker_backup_path(
+	char *buf, size_t bufsize, const char *filepath, int idx, const char *ext)
+{
+	int n = snprintf(buf, bufsize, "%s.%d%s", filepath, idx, ext);
+	if (n < 0 || (size_t)n >= bufsize)
+	{
+		fprintf(stderr, "log rotate backup path too long: %s\n", filepath);
+		return MUGGLE_ERR_BEYOND_RANGE;
+	}
+	return MUGGLE_OK;
+}
+
+/**
+ * @brief shift backups then move staging file to filepath.1
+ *
+ * raw file is kept when compression failed, so raw and compressed names
+ * may both exist, both of them are shifted and removed
+ */
+static void muggle_log_rotate_worker_run_backups(muggle_log_rotate_worker_t *worker, muggle_log_rotate_task_t *task)
+{
+	const char *exts[] = { "", MUGGLE_LOG_LZ_FILE_EXT };
+	const int cnt_ext = (int)(sizeof(exts) / sizeof(exts[0]));
+
+	char src[MUGGLE_MAX_PATH], dst[MUGGLE_MAX_PATH];
+	for (int k = 0; k < cnt_ext; k++)
+	{
+		if (muggle_log_rotate_worker_backup_path(dst, sizeof(dst), task->filepath, (int)task->backup_count, exts[k]) != 0)
+		{
+			return;
+		}
+		if (muggle_path_exists(dst))
+		{
+			muggle_os_remove(dst);
+		}
+	}
+
+	for (int i = (int)task->backup_count - 1; i > 0; i--)
+	{
+		for (int k = 0; k < cnt_ext; k++)
+		{
+			if (muggle_log_rotate_worker_backup_path(src, sizeof(src), task->filepath, i, exts[k]) != 0 ||
+				muggle_log_rotate_worker_backup_path(dst, sizeof(dst), task->filepath, i+1, exts[k]) != 0)
+			{
+				return;
+			}
+			if (muggle_path_exists(src))
+			{
+				muggle_os_rename(src, dst);
+			}
+		}
+	}
+
+	if (worker->flags & MUGGLE_LOG_ROTATE_FLAG_COMPRESS)
+	{
+		if (muggle_log_rotate_worker_backup_path(dst, sizeof(dst), task->filepath, 1, MUGGLE_LOG_LZ_FILE_EXT) == 0 &&
+			muggle_log_rotate_worker_compress_file(task->staging, dst) == 0)
+		{
+			return;
+		}
+	}
+
+	// keep raw file when compress disabled or failed
+	if (muggle_log_rotate_worker_backup_path(dst, sizeof(dst), task->filepath, 1, "") != 0)
+	{
+		return;
+	}
+	muggle_os_rename(task->staging, dst);
+}
+
+static muggle_thread_ret_t muggle_log_rotate_worker_run(void *arg)
+{
+	muggle_log_rotate_worker_t *worker = (muggle_log_rotate_worker_t*)arg;
+	while (1)
+	{
+		muggle_log_rotate_task_t *task = (muggle_log_rotate_task_t*)muggle_channel_read(&worker->channel);
+		if (task == NULL)
+		{
+			break;
+		}
+
+		switch (task->type)
+		{
+			case MUGGLE_LOG_ROTATE_TASK_BACKUPS:
+			{
+				muggle_log_rotate_worker_run_backups(worker, task);
+			}break;
+			case MUGGLE_LOG_ROTATE_TASK_COMPRESS:
+			{
+				char dst[MUGGLE_MAX_PATH];
+				int n = snprintf(dst, sizeof(dst), "%s%s", task->filepath, MUGGLE_LOG_LZ_FILE_EXT);
+				if (n < 0 || (size_t)n >= sizeof(dst))
+				{
+					fprintf(stderr, "log rotate compress path too long: %s\n", task->filepath);
+					break;
+				}
+				muggle_log_rotate_worker_compress_file(task->filepath, dst);
+			}break;
+		}
+
+		free(task);
+	}
+
+	return 0;
+}
+
+muggle_log_rotate_worker_t* muggle_log_rotate_worker_create(int flags)
+{
+	muggle_log_rotate_worker_t *worker =
+		(muggle_log_rotate_worker_t*)malloc(sizeof(muggle_log_rotate_worker_t));
+	if (worker == NULL)
+	{
+		return NULL;
+	}
+	memset(worker, 0, sizeof(*worker));
+
+	if (flags & MUGGLE_LOG_ROTATE_FLAG_COMPRESS)
+	{
+		flags |= MUGGLE_LOG_ROTATE_FLAG_BACKGROUND;
+	}
+	worker->flags = flags;
+
+	if (muggle_channel_init(&worker->channel, MUGGLE_LOG_ROTATE_WORKER_CAPACITY, MUGGLE_CHANNEL_FLAG_WRITE_BLOCK) != 0)
+	{
+		free(worker);
+		return NULL;
+	}
+
+	if (muggle_thread_create(&worker->thread, muggle_log_rotate_worker_run, worker) != 0)
+	{
+		muggle_channel_destroy(&worker->channel);
+		free(worker);
+		return NULL;
+	}
+
+	return worker;
+}
+
+void muggle_log_rotate_worker_destroy(muggle_log_rotate_worker_t *worker)
+{
+	if (worker == NULL)
+	{
+		return;
+	}
+
+	muggle_channel_write(&worker->channel, NULL);
+	muggle_thread_join(&worker->thread);
+	muggle_channel_destroy(&worker->channel);
+	free(worker);
+}
+
+int muggle_log_rotate_worker_backups(
+	muggle_log_rotate_worker_t *worker, const char *filepath, unsigned int backup_count)
+{
+	muggle_log_rotate_task_t *task = (muggle_log_rotate_task_t*)malloc(sizeof(muggle_log_rotate_task_t));
+	if (task == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	task->type = MUGGLE_LOG_ROTATE_TASK_BACKUPS;
+	task->backup_count = backup_count;
+	strncpy(task->filepath, filepath, sizeof(task->filepath)-1);
+	task->filepath[sizeof(task->filepath)-1] = '\0';
+	int n = snprintf(task->staging, sizeof(task->staging), "%s.%llu.rotating",
+		filepath, worker->staging_id++);
+	if (n < 0 || (size_t)n >= sizeof(task->staging))
+	{
+		free(task);
+		return MUGGLE_ERR_BEYOND_RANGE;
+	}
+
+	int ret = muggle_os_rename(filepath, task->staging);
+	if (ret != 0)
+	{
+		free(task);
+		return ret;
+	}
+
+	if (muggle_channel_write(&worker->channel, task) != 0)
+	{
+		// move back, records continue append into it
+		muggle_os_rename(task->staging, filepath);
+		free(task);
+		return MUGGLE_ERR_FULL;
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_log_rotate_worker_compress(muggle_log_rotate_worker_t *worker, const char *filepath)
+{
+	muggle_log_rotate_task_t *task = (muggle_log_rotate_task_t*)malloc(sizeof(muggle_log_rotate_task_t));
+	if (task == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	task->type = MUGGLE_LOG_ROTATE_TASK_COMPRESS;
+	task->backup_count = 0;
+	strncpy(task->filepath, filepath, sizeof(task->filepath)-1);
+	task->filepath[sizeof(task->filepath)-1] = '\0';
+	task->staging[0] = '\0';
+
+	if (muggle_channel_write(&worker->channel, task) != 0)
+	{
+		free(task);
+		return MUGGLE_ERR_FULL;
+	}
+
+	return MUGGLE_OK;
+}
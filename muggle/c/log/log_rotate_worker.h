@@ -0,0 +1,98 @@
+/******************************************************************************
+ *  @file         log_rotate_worker.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec log rotate background worker
+ *
+ * File handlers only close the full file and move it aside with a single
+ * rename, the backup rename cascade and compression run in worker thread,
+ * so rotation never stall the thread that write log.
+ * Tasks are handled in order, destroy worker wait all queued tasks done
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_LOG_ROTATE_WORKER_H_
+#define MUGGLE_C_LOG_ROTATE_WORKER_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/channel.h"
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_LOG_ROTATE_WORKER_CAPACITY 64
+
+enum
+{
+	MUGGLE_LOG_ROTATE_FLAG_BACKGROUND = 0x01, //!< rename cascade of backups run in worker thread
+	MUGGLE_LOG_ROTATE_FLAG_COMPRESS   = 0x02, //!< compress rotated files in worker thread, imply MUGGLE_LOG_ROTATE_FLAG_BACKGROUND
+};
+
+/**
+ * @brief log rotate background worker
+ */
+typedef struct muggle_log_rotate_worker
+{
+	muggle_channel_t   channel;
+	muggle_thread_t    thread;
+	int                flags;      //!< bitwise or of MUGGLE_LOG_ROTATE_FLAG_*
+	unsigned long long staging_id; //!< sequence of staging file name, only used by writer
+}muggle_log_rotate_worker_t;
+
+/**
+ * @brief create log rotate worker
+ *
+ * @param flags  bitwise or of MUGGLE_LOG_ROTATE_FLAG_*
+ *
+ * @return worker pointer, NULL represent failed
+ */
+MUGGLE_C_EXPORT
+muggle_log_rotate_worker_t* muggle_log_rotate_worker_create(int flags);
+
+/**
+ * @brief wait all queued tasks done, then stop and free worker
+ *
+ * @param worker  log rotate worker pointer
+ */
+MUGGLE_C_EXPORT
+void muggle_log_rotate_worker_destroy(muggle_log_rotate_worker_t *worker);
+
+/**
+ * @brief move closed file aside and queue backups shift
+ *
+ * rename filepath to a staging file in caller thread, worker thread shift
+ * both raw and compressed backups then move staging file to filepath.1
+ * (filepath.1.lz when compress enabled). when failed, filepath is kept in
+ * place
+ *
+ * @param worker        log rotate worker pointer
+ * @param filepath      file path, file must be closed
+ * @param backup_count  max backup file count
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_rotate_worker_backups(
+	muggle_log_rotate_worker_t *worker, const char *filepath, unsigned int backup_count);
+
+/**
+ * @brief queue compression of closed file into filepath.lz, raw file is
+ * removed after compressed
+ *
+ * @param worker    log rotate worker pointer
+ * @param filepath  file path, file must be closed
+ *
+ * @return
+ *     - success returns 0
+ *     - otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_rotate_worker_compress(muggle_log_rotate_worker_t *worker, const char *filepath);
+
+EXTERN_C_END
+
+#endif /* ifndef MUGGLE_C_LOG_ROTATE_WORKER_H_ */
@@ -16,6 +16,7 @@ int muggle_sync_logger_init(muggle_sync_logger_t *logger)
 	base_logger->log = muggle_sync_logger_log;
 	base_logger->add_handler = muggle_sync_logger_add_handler;
 	base_logger->destroy = muggle_sync_logger_destroy;
+	base_logger->flush = muggle_sync_logger_flush;
 	base_logger->lowest_log_level = MUGGLE_LOG_LEVEL_FATAL;
 
 	return MUGGLE_OK;
@@ -48,10 +49,15 @@ void muggle_sync_logger_destroy(muggle_logger_t *logger)
 	// do nothing
 }
 
+void muggle_sync_logger_flush(muggle_logger_t *logger)
+{
+	muggle_logger_flush_handlers(logger);
+}
+
 void muggle_sync_logger_log(
 	struct muggle_logger *logger,
 	int level,
-	muggle_log_src_loc_t *src_loc,
+	const muggle_log_src_loc_t *src_loc,
 	const char *format,
 	...)
 {
@@ -97,6 +103,7 @@ void muggle_sync_logger_log(
 #if MUGGLE_DEBUG
 	if (level >= MUGGLE_LOG_LEVEL_FATAL)
 	{
+		muggle_sync_logger_flush(logger);
 		muggle_print_stacktrace();
 #if MUGGLE_PLATFORM_WINDOWS
 		__debugbreak();
@@ -57,6 +57,14 @@ int muggle_sync_logger_add_handler(muggle_logger_t *logger, muggle_log_handler_t
 MUGGLE_C_EXPORT
 void muggle_sync_logger_destroy(muggle_logger_t *logger);
 
+/**
+ * @brief sync logger flush
+ *
+ * @param logger  logger pointer
+ */
+MUGGLE_C_EXPORT
+void muggle_sync_logger_flush(muggle_logger_t *logger);
+
 /**
  * @brief prototype of logger output function
  *
@@ -70,7 +78,7 @@ MUGGLE_C_EXPORT
 void muggle_sync_logger_log(
 	struct muggle_logger *logger,
 	int level,
-	muggle_log_src_loc_t *src_loc,
+	const muggle_log_src_loc_t *src_loc,
 	const char *format,
 	...);
 
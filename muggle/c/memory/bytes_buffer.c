@@ -324,6 +324,38 @@ bool muggle_bytes_buffer_writer_move(muggle_bytes_buffer_t *bytes_buf, int num_b
 	}
 }
 
+bool muggle_bytes_buffer_writer_move_fc(muggle_bytes_buffer_t *bytes_buf, void *p, int num_bytes)
+{
+	if ((char*)p == bytes_buf->buffer + bytes_buf->w)
+	{
+		int cw = muggle_bytes_buffer_contiguous_writable(bytes_buf);
+		if (cw < num_bytes)
+		{
+			return false;
+		}
+		return muggle_bytes_buffer_writer_move(bytes_buf, num_bytes);
+	}
+	else if ((char*)p == bytes_buf->buffer)
+	{
+		// writer_fc jumped to the head
+		int jw = muggle_bytes_buffer_jump_writable(bytes_buf);
+		if (jw < num_bytes)
+		{
+			return false;
+		}
+		if (num_bytes > 0)
+		{
+			bytes_buf->t = bytes_buf->w;
+			bytes_buf->w = num_bytes;
+		}
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
 void* muggle_bytes_buffer_reader_fc(muggle_bytes_buffer_t *bytes_buf, int num_bytes)
 {
 	int cr = muggle_bytes_buffer_contiguous_readable(bytes_buf);
@@ -343,6 +375,10 @@ bool muggle_bytes_buffer_reader_move(muggle_bytes_buffer_t *bytes_buf, int num_b
 	if (cr >= num_bytes)
 	{
 		bytes_buf->r += num_bytes;
+		if (bytes_buf->r == bytes_buf->t && bytes_buf->r != bytes_buf->w)
+		{
+			bytes_buf->r = 0;
+		}
 		muggle_bytes_buffer_refresh(bytes_buf);
 		return true;
 	}
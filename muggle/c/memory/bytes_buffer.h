@@ -146,6 +146,25 @@ void* muggle_bytes_buffer_writer_fc(muggle_bytes_buffer_t *bytes_buf, int num_by
 MUGGLE_C_EXPORT
 bool muggle_bytes_buffer_writer_move(muggle_bytes_buffer_t *bytes_buf, int num_bytes);
 
+/**
+ * @brief move writer forward after bytes written into memory returned by
+ * muggle_bytes_buffer_writer_fc
+ *
+ * NOTE: num_bytes could be less than bytes requested in
+ * muggle_bytes_buffer_writer_fc, e.g. short read of socket, p is used to
+ * know whether writer jumped to the head of buffer
+ *
+ * @param bytes_buf  pointer to bytes buffer
+ * @param p          memory returned by muggle_bytes_buffer_writer_fc
+ * @param num_bytes  number of bytes written into p
+ *
+ * @return
+ *     if p is writer memory and has enough contiguous memory for writer
+ *     move forward, return true, otherwise return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_bytes_buffer_writer_move_fc(muggle_bytes_buffer_t *bytes_buf, void *p, int num_bytes);
+
 /**
  * @brief find contiguous memory for read without move reader
  *
@@ -0,0 +1,250 @@
+/******************************************************************************
+ *  @file         slab_allocator.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec slab allocator
+ *****************************************************************************/
+
+#include "slab_allocator.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+
+#define MUGGLE_SLAB_ALLOCATOR_DEFAULT_CLASS_BYTES (1024 * 1024)
+
+enum
+{
+	MUGGLE_SLAB_SOURCE_POOL = 0,
+	MUGGLE_SLAB_SOURCE_MALLOC = 1,
+};
+
+/**
+ * @brief head of every allocation, keep user data 16 bytes aligned
+ * relative to block
+ */
+typedef struct muggle_slab_head
+{
+	int32_t  class_idx;
+	int32_t  source;
+	uint64_t size;
+}muggle_slab_head_t;
+
+#define MUGGLE_SLAB_CLASS_SIZE(idx) ((size_t)MUGGLE_SLAB_ALLOCATOR_MIN_SIZE << (idx))
+
+int muggle_slab_allocator_size_class(size_t size)
+{
+	if (size <= MUGGLE_SLAB_ALLOCATOR_MIN_SIZE)
+	{
+		return 0;
+	}
+	if (size > MUGGLE_SLAB_ALLOCATOR_MAX_SIZE)
+	{
+		return MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS;
+	}
+
+	int idx = 0;
+	size_t v = (size - 1) / MUGGLE_SLAB_ALLOCATOR_MIN_SIZE;
+	while (v)
+	{
+		v >>= 1;
+		idx++;
+	}
+	return idx;
+}
+
+int muggle_slab_allocator_init(muggle_slab_allocator_t *allocator, int flags, size_t class_bytes)
+{
+	memset(allocator, 0, sizeof(*allocator));
+
+	if (class_bytes == 0)
+	{
+		class_bytes = MUGGLE_SLAB_ALLOCATOR_DEFAULT_CLASS_BYTES;
+	}
+	allocator->flags = flags;
+	allocator->class_bytes = class_bytes;
+
+	for (int i = 0; i < MUGGLE_SLAB_ALLOCATOR_NUM_CLASS; i++)
+	{
+		size_t block_size = sizeof(muggle_slab_head_t) + MUGGLE_SLAB_CLASS_SIZE(i);
+		size_t capacity = class_bytes / block_size;
+		if (capacity < 8)
+		{
+			capacity = 8;
+		}
+
+		int ret = MUGGLE_OK;
+		if (flags & MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE)
+		{
+			ret = muggle_ts_memory_pool_init(&allocator->ts_pools[i],
+				(muggle_atomic_int)capacity, (muggle_atomic_int)block_size);
+		}
+		else
+		{
+			if (!muggle_memory_pool_init(&allocator->pools[i], (unsigned int)capacity, (unsigned int)block_size))
+			{
+				ret = MUGGLE_ERR_MEM_ALLOC;
+			}
+		}
+
+		if (ret != MUGGLE_OK)
+		{
+			for (int j = 0; j < i; j++)
+			{
+				if (flags & MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE)
+				{
+					muggle_ts_memory_pool_destroy(&allocator->ts_pools[j]);
+				}
+				else
+				{
+					muggle_memory_pool_destroy(&allocator->pools[j]);
+				}
+			}
+			return ret;
+		}
+	}
+
+	return MUGGLE_OK;
+}
+
+void muggle_slab_allocator_destroy(muggle_slab_allocator_t *allocator)
+{
+	for (int i = 0; i < MUGGLE_SLAB_ALLOCATOR_NUM_CLASS; i++)
+	{
+		if (allocator->flags & MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE)
+		{
+			muggle_ts_memory_pool_destroy(&allocator->ts_pools[i]);
+		}
+		else
+		{
+			muggle_memory_pool_destroy(&allocator->pools[i]);
+		}
+	}
+}
+
+void* muggle_slab_allocator_alloc(muggle_slab_allocator_t *allocator, size_t size)
+{
+	int class_idx = muggle_slab_allocator_size_class(size);
+	int record = allocator->flags & MUGGLE_SLAB_ALLOCATOR_FLAG_STATS;
+	muggle_slab_head_t *head = NULL;
+	int source = MUGGLE_SLAB_SOURCE_POOL;
+
+	if (class_idx < MUGGLE_SLAB_ALLOCATOR_NUM_CLASS)
+	{
+		if (allocator->flags & MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE)
+		{
+			head = (muggle_slab_head_t*)muggle_ts_memory_pool_alloc(&allocator->ts_pools[class_idx]);
+		}
+		else
+		{
+			head = (muggle_slab_head_t*)muggle_memory_pool_alloc(&allocator->pools[class_idx]);
+		}
+
+		if (head == NULL)
+		{
+			// class exhausted
+			head = (muggle_slab_head_t*)malloc(sizeof(muggle_slab_head_t) + MUGGLE_SLAB_CLASS_SIZE(class_idx));
+			source = MUGGLE_SLAB_SOURCE_MALLOC;
+			if (head && record)
+			{
+				muggle_atomic_fetch_add64(&allocator->counters[class_idx].cnt_fallback, 1, muggle_memory_order_relaxed);
+			}
+		}
+	}
+	else
+	{
+		if (size > SIZE_MAX - sizeof(muggle_slab_head_t))
+		{
+			return NULL;
+		}
+		head = (muggle_slab_head_t*)malloc(sizeof(muggle_slab_head_t) + size);
+		source = MUGGLE_SLAB_SOURCE_MALLOC;
+	}
+
+	if (head == NULL)
+	{
+		return NULL;
+	}
+
+	head->class_idx = (int32_t)class_idx;
+	head->source = (int32_t)source;
+	head->size = (uint64_t)size;
+
+	if (record)
+	{
+		muggle_atomic_fetch_add64(&allocator->counters[class_idx].cnt_alloc, 1, muggle_memory_order_relaxed);
+	}
+
+	return (void*)(head + 1);
+}
+
+void muggle_slab_allocator_free(muggle_slab_allocator_t *allocator, void *data)
+{
+	if (data == NULL)
+	{
+		return;
+	}
+
+	muggle_slab_head_t *head = (muggle_slab_head_t*)data - 1;
+	int class_idx = (int)head->class_idx;
+
+	if (allocator->flags & MUGGLE_SLAB_ALLOCATOR_FLAG_STATS)
+	{
+		muggle_atomic_fetch_add64(&allocator->counters[class_idx].cnt_free, 1, muggle_memory_order_relaxed);
+	}
+
+	if (head->source == MUGGLE_SLAB_SOURCE_MALLOC)
+	{
+		free(head);
+	}
+	else if (allocator->flags & MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE)
+	{
+		muggle_ts_memory_pool_free(head);
+	}
+	else
+	{
+		muggle_memory_pool_free(&allocator->pools[class_idx], head);
+	}
+}
+
+size_t muggle_slab_allocator_usable_size(void *data)
+{
+	muggle_slab_head_t *head = (muggle_slab_head_t*)data - 1;
+	if (head->class_idx == MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS)
+	{
+		return (size_t)head->size;
+	}
+	return MUGGLE_SLAB_CLASS_SIZE(head->class_idx);
+}
+
+int muggle_slab_allocator_get_stats(
+	muggle_slab_allocator_t *allocator, int class_idx, muggle_slab_class_stats_t *stats)
+{
+	if (class_idx < 0 || class_idx > MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	memset(stats, 0, sizeof(*stats));
+	if (class_idx < MUGGLE_SLAB_ALLOCATOR_NUM_CLASS)
+	{
+		stats->size = MUGGLE_SLAB_CLASS_SIZE(class_idx);
+		if (allocator->flags & MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE)
+		{
+			stats->capacity = (size_t)allocator->ts_pools[class_idx].capacity;
+		}
+		else
+		{
+			stats->capacity = (size_t)allocator->pools[class_idx].capacity;
+		}
+	}
+
+	muggle_slab_class_counter_t *counter = &allocator->counters[class_idx];
+	stats->cnt_alloc = (uint64_t)muggle_atomic_fetch_add64(&counter->cnt_alloc, 0, muggle_memory_order_relaxed);
+	stats->cnt_free = (uint64_t)muggle_atomic_fetch_add64(&counter->cnt_free, 0, muggle_memory_order_relaxed);
+	stats->cnt_fallback = (uint64_t)muggle_atomic_fetch_add64(&counter->cnt_fallback, 0, muggle_memory_order_relaxed);
+
+	return MUGGLE_OK;
+}
@@ -0,0 +1,164 @@
+/******************************************************************************
+ *  @file         slab_allocator.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec slab allocator
+ *
+ * Variable size allocator with power of 2 size classes from 16 bytes to
+ * 64 KiB, every class is backed by a fixed block size memory pool
+ *
+ * - default, classes use muggle_memory_pool_t, not thread safe and pools
+ *   grow on demand
+ * - with MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE, classes use
+ *   muggle_ts_memory_pool_t with fixed capacity, when a class is exhausted,
+ *   allocation fallback to malloc
+ *
+ * allocation larger than 64 KiB always use malloc
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SLAB_ALLOCATOR_H_
+#define MUGGLE_C_SLAB_ALLOCATOR_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+#include <stdint.h>
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/memory/memory_pool.h"
+#include "muggle/c/memory/threadsafe_memory_pool.h"
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_SLAB_ALLOCATOR_MIN_SIZE 16
+#define MUGGLE_SLAB_ALLOCATOR_MAX_SIZE (64 * 1024)
+#define MUGGLE_SLAB_ALLOCATOR_NUM_CLASS 13 // 16, 32, ..., 64K
+#define MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS MUGGLE_SLAB_ALLOCATOR_NUM_CLASS // class index of large object
+
+enum
+{
+	MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE = 0x01, //!< allocate and free from any thread
+	MUGGLE_SLAB_ALLOCATOR_FLAG_STATS       = 0x02, //!< record per class statistics
+};
+
+/**
+ * @brief statistics of slab class
+ */
+typedef struct muggle_slab_class_stats
+{
+	size_t   size;         //!< max user data size of class, 0 for large object
+	size_t   capacity;     //!< number of blocks in pool, 0 for large object
+	uint64_t cnt_alloc;    //!< number of allocate
+	uint64_t cnt_free;     //!< number of free
+	uint64_t cnt_fallback; //!< number of allocate fallback to malloc
+}muggle_slab_class_stats_t;
+
+/**
+ * @brief slab class counters
+ */
+typedef struct muggle_slab_class_counter
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int64 cnt_alloc;
+	muggle_atomic_int64 cnt_free;
+	muggle_atomic_int64 cnt_fallback;
+}muggle_slab_class_counter_t;
+
+/**
+ * @brief slab allocator
+ */
+typedef struct muggle_slab_allocator
+{
+	int    flags;
+	size_t class_bytes; //!< initialize bytes of every class
+	muggle_memory_pool_t        pools[MUGGLE_SLAB_ALLOCATOR_NUM_CLASS];
+	muggle_ts_memory_pool_t     ts_pools[MUGGLE_SLAB_ALLOCATOR_NUM_CLASS];
+	muggle_slab_class_counter_t counters[MUGGLE_SLAB_ALLOCATOR_NUM_CLASS + 1];
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+}muggle_slab_allocator_t;
+
+/**
+ * @brief init slab allocator
+ *
+ * @param allocator    pointer to slab allocator
+ * @param flags        bit OR operation of MUGGLE_SLAB_ALLOCATOR_FLAG_*
+ * @param class_bytes  bytes of memory reserved for every class, 0 means 1 MiB;
+ *                     with MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE, it's the
+ *                     fixed size of pool
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise failed and return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_slab_allocator_init(muggle_slab_allocator_t *allocator, int flags, size_t class_bytes);
+
+/**
+ * @brief destroy slab allocator
+ *
+ * @param allocator  pointer to slab allocator
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_destroy(muggle_slab_allocator_t *allocator);
+
+/**
+ * @brief allocate memory
+ *
+ * @param allocator  pointer to slab allocator
+ * @param size       bytes of memory
+ *
+ * @return on success return memory, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_slab_allocator_alloc(muggle_slab_allocator_t *allocator, size_t size);
+
+/**
+ * @brief free memory
+ *
+ * @param allocator  pointer to slab allocator
+ * @param data       memory allocated by slab allocator
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_free(muggle_slab_allocator_t *allocator, void *data);
+
+/**
+ * @brief get usable size of memory, not less than size passed to allocate
+ *
+ * @param data  memory allocated by slab allocator
+ *
+ * @return usable size
+ */
+MUGGLE_C_EXPORT
+size_t muggle_slab_allocator_usable_size(void *data);
+
+/**
+ * @brief get class index of size
+ *
+ * @param size  bytes of memory
+ *
+ * @return class index, MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS for large object
+ */
+MUGGLE_C_EXPORT
+int muggle_slab_allocator_size_class(size_t size);
+
+/**
+ * @brief get statistics of class
+ *
+ * counters are 0 unless allocator initialized with MUGGLE_SLAB_ALLOCATOR_FLAG_STATS
+ *
+ * @param allocator  pointer to slab allocator
+ * @param class_idx  0 ~ MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS
+ * @param stats      store statistics
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_INVALID_PARAM if class_idx is invalid
+ */
+MUGGLE_C_EXPORT
+int muggle_slab_allocator_get_stats(
+	muggle_slab_allocator_t *allocator, int class_idx, muggle_slab_class_stats_t *stats);
+
+EXTERN_C_END
+
+#endif
@@ -0,0 +1,246 @@
+/******************************************************************************
+ *  @file         thread_cache_memory_pool.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec thread cache memory pool
+ *****************************************************************************/
+
+#include "thread_cache_memory_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+
+#define MUGGLE_TC_MEMORY_POOL_DEFAULT_BATCH_SIZE 64
+
+#define MUGGLE_TC_DEPOT_IDX(v) ((muggle_atomic_int)((uint64_t)(v) & 0xffffffff))
+#define MUGGLE_TC_DEPOT_TAG(v) ((uint64_t)(v) >> 32)
+#define MUGGLE_TC_DEPOT_MAKE(tag, idx) \
+	((muggle_atomic_int64)(((uint64_t)(tag) << 32) | (uint64_t)(uint32_t)(idx)))
+
+static muggle_tc_memory_pool_head_t* muggle_tc_memory_pool_block(muggle_tc_memory_pool_t *pool, muggle_atomic_int idx)
+{
+	return (muggle_tc_memory_pool_head_t*)((char*)pool->data + (size_t)pool->block_size * (size_t)idx);
+}
+
+/***************** global depot *****************/
+/*
+ * depot is a lock-free stack of batches, stack node is the first block of
+ * batch. blocks are never returned to system while pool alive, so reading
+ * next_batch of a popped block is safe, and the ABA tag reject stale head
+ */
+static void muggle_tc_memory_pool_depot_push(
+	muggle_tc_memory_pool_t *pool, muggle_tc_memory_pool_head_t *batch, int cnt)
+{
+	batch->batch_cnt = cnt;
+
+	muggle_atomic_int64 head = muggle_atomic_fetch_add64(&pool->depot, 0, muggle_memory_order_relaxed);
+	muggle_atomic_int64 new_head = 0;
+	do {
+		muggle_atomic_store(&batch->next_batch, MUGGLE_TC_DEPOT_IDX(head), muggle_memory_order_relaxed);
+		new_head = MUGGLE_TC_DEPOT_MAKE(MUGGLE_TC_DEPOT_TAG(head) + 1, batch->idx + 1);
+	} while (!muggle_atomic_cmp_exch_weak64(&pool->depot, &head, new_head, muggle_memory_order_release));
+}
+
+static muggle_tc_memory_pool_head_t* muggle_tc_memory_pool_depot_pop(muggle_tc_memory_pool_t *pool, int *cnt)
+{
+	muggle_atomic_int64 head = muggle_atomic_fetch_add64(&pool->depot, 0, muggle_memory_order_acquire);
+	muggle_tc_memory_pool_head_t *batch = NULL;
+	while (1)
+	{
+		muggle_atomic_int top = MUGGLE_TC_DEPOT_IDX(head);
+		if (top == 0)
+		{
+			return NULL;
+		}
+
+		batch = muggle_tc_memory_pool_block(pool, top - 1);
+		muggle_atomic_int next = muggle_atomic_load(&batch->next_batch, muggle_memory_order_relaxed);
+		muggle_atomic_int64 new_head = MUGGLE_TC_DEPOT_MAKE(MUGGLE_TC_DEPOT_TAG(head) + 1, next);
+		if (muggle_atomic_cmp_exch_weak64(&pool->depot, &head, new_head, muggle_memory_order_acquire))
+		{
+			break;
+		}
+	}
+
+	*cnt = batch->batch_cnt;
+	return batch;
+}
+
+/***************** pool *****************/
+int muggle_tc_memory_pool_init(
+	muggle_tc_memory_pool_t *pool, muggle_atomic_int capacity,
+	muggle_atomic_int data_size, muggle_atomic_int batch_size)
+{
+	memset(pool, 0, sizeof(*pool));
+
+	if (capacity <= 0 || data_size <= 0 || batch_size < 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	if (batch_size == 0)
+	{
+		batch_size = MUGGLE_TC_MEMORY_POOL_DEFAULT_BATCH_SIZE;
+	}
+
+	// align block to cache line, blocks owned by different threads never
+	// share cache line
+	size_t block_size = sizeof(muggle_tc_memory_pool_head_t) + (size_t)data_size;
+	block_size = (block_size + MUGGLE_CACHE_LINE_SIZE - 1) / MUGGLE_CACHE_LINE_SIZE * MUGGLE_CACHE_LINE_SIZE;
+	if (block_size > 0x7fffffff)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	pool->capacity = capacity;
+	pool->block_size = (muggle_atomic_int)block_size;
+	pool->batch_size = batch_size;
+	pool->data = malloc((size_t)capacity * block_size);
+	if (pool->data == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	// link blocks into batches and push into depot
+	muggle_tc_memory_pool_head_t *prev_block = NULL;
+	for (muggle_atomic_int i = capacity - 1; i >= 0; i--)
+	{
+		muggle_tc_memory_pool_head_t *block = muggle_tc_memory_pool_block(pool, i);
+		block->pool = pool;
+		block->idx = i;
+		block->next_batch = 0;
+		block->batch_cnt = 0;
+		block->reserved = 0;
+
+		if (i % batch_size == batch_size - 1 || i == capacity - 1)
+		{
+			prev_block = NULL;
+		}
+		block->next = prev_block;
+		prev_block = block;
+
+		if (i % batch_size == 0)
+		{
+			int cnt = (capacity - i < batch_size) ? (int)(capacity - i) : (int)batch_size;
+			muggle_tc_memory_pool_depot_push(pool, block, cnt);
+		}
+	}
+
+	return MUGGLE_OK;
+}
+
+void muggle_tc_memory_pool_destroy(muggle_tc_memory_pool_t *pool)
+{
+	if (pool->data)
+	{
+		free(pool->data);
+		pool->data = NULL;
+	}
+}
+
+/***************** cache *****************/
+void muggle_tc_memory_pool_cache_init(muggle_tc_memory_pool_cache_t *cache, muggle_tc_memory_pool_t *pool)
+{
+	memset(cache, 0, sizeof(*cache));
+	cache->pool = pool;
+}
+
+void muggle_tc_memory_pool_cache_destroy(muggle_tc_memory_pool_cache_t *cache)
+{
+	if (cache->loaded_cnt > 0)
+	{
+		muggle_tc_memory_pool_depot_push(cache->pool, cache->loaded, cache->loaded_cnt);
+		cache->cnt_flush++;
+	}
+	if (cache->prev_cnt > 0)
+	{
+		muggle_tc_memory_pool_depot_push(cache->pool, cache->prev, cache->prev_cnt);
+		cache->cnt_flush++;
+	}
+	cache->loaded = NULL;
+	cache->loaded_cnt = 0;
+	cache->prev = NULL;
+	cache->prev_cnt = 0;
+}
+
+static void muggle_tc_memory_pool_cache_swap(muggle_tc_memory_pool_cache_t *cache)
+{
+	muggle_tc_memory_pool_head_t *tmp = cache->loaded;
+	int tmp_cnt = cache->loaded_cnt;
+	cache->loaded = cache->prev;
+	cache->loaded_cnt = cache->prev_cnt;
+	cache->prev = tmp;
+	cache->prev_cnt = tmp_cnt;
+}
+
+void* muggle_tc_memory_pool_alloc(muggle_tc_memory_pool_cache_t *cache)
+{
+	cache->cnt_alloc++;
+
+	if (cache->loaded_cnt > 0)
+	{
+		cache->cnt_alloc_hit++;
+	}
+	else if (cache->prev_cnt > 0)
+	{
+		muggle_tc_memory_pool_cache_swap(cache);
+		cache->cnt_alloc_hit++;
+	}
+	else
+	{
+		int cnt = 0;
+		muggle_tc_memory_pool_head_t *batch = muggle_tc_memory_pool_depot_pop(cache->pool, &cnt);
+		if (batch == NULL)
+		{
+			return NULL;
+		}
+		cache->loaded = batch;
+		cache->loaded_cnt = cnt;
+		cache->cnt_refill++;
+	}
+
+	muggle_tc_memory_pool_head_t *block = cache->loaded;
+	cache->loaded = block->next;
+	cache->loaded_cnt--;
+
+	return (void*)(block + 1);
+}
+
+void muggle_tc_memory_pool_free(muggle_tc_memory_pool_cache_t *cache, void *data)
+{
+	muggle_tc_memory_pool_head_t *block = (muggle_tc_memory_pool_head_t*)data - 1;
+	int batch_size = (int)cache->pool->batch_size;
+
+	cache->cnt_free++;
+
+	if (cache->loaded_cnt >= batch_size)
+	{
+		if (cache->prev_cnt == 0)
+		{
+			muggle_tc_memory_pool_cache_swap(cache);
+			cache->cnt_free_hit++;
+		}
+		else
+		{
+			// both magazines are full, flush the previous one
+			muggle_tc_memory_pool_depot_push(cache->pool, cache->prev, cache->prev_cnt);
+			cache->cnt_flush++;
+
+			cache->prev = cache->loaded;
+			cache->prev_cnt = cache->loaded_cnt;
+			cache->loaded = NULL;
+			cache->loaded_cnt = 0;
+		}
+	}
+	else
+	{
+		cache->cnt_free_hit++;
+	}
+
+	block->next = cache->loaded;
+	cache->loaded = block;
+	cache->loaded_cnt++;
+}
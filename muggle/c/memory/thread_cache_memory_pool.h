@@ -0,0 +1,146 @@
+/******************************************************************************
+ *  @file         thread_cache_memory_pool.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec thread cache memory pool
+ *
+ * Fixed size block pool with per thread cache, every thread that allocate or
+ * free blocks owns a muggle_tc_memory_pool_cache_t
+ *
+ * cache holds two magazines (block lists), most allocate and free only touch
+ * magazines of current thread. when both magazines are empty, cache refill a
+ * batch of blocks from global depot; when both are full, cache flush a batch
+ * into global depot. global depot is a lock-free stack of batches, so unlike
+ * muggle_ts_memory_pool_t, free never take a lock
+ *
+ * block can be freed in any thread's cache, not only the allocate one
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_THREAD_CACHE_MEMORY_POOL_H_
+#define MUGGLE_C_THREAD_CACHE_MEMORY_POOL_H_
+
+#include "muggle/c/base/macro.h"
+#include <stdint.h>
+#include "muggle/c/base/atomic.h"
+
+EXTERN_C_BEGIN
+
+struct muggle_tc_memory_pool;
+
+/**
+ * @brief thread cache memory pool block head
+ */
+typedef struct muggle_tc_memory_pool_head
+{
+	struct muggle_tc_memory_pool *pool;
+	struct muggle_tc_memory_pool_head *next; //!< next block in magazine or batch
+	muggle_atomic_int idx;                   //!< index of block in pool
+	muggle_atomic_int next_batch;            //!< index + 1 of next batch in depot, 0 means end
+	muggle_atomic_int batch_cnt;             //!< number of blocks in batch, only valid for first block
+	muggle_atomic_int reserved;
+}muggle_tc_memory_pool_head_t;
+
+/**
+ * @brief thread cache memory pool
+ */
+typedef struct muggle_tc_memory_pool
+{
+	muggle_atomic_int capacity;
+	muggle_atomic_int block_size;
+	muggle_atomic_int batch_size;
+	void              *data;
+
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int64 depot;      //!< high 32 bits: ABA tag, low 32 bits: index + 1 of top batch
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+}muggle_tc_memory_pool_t;
+
+/**
+ * @brief per thread cache of thread cache memory pool
+ */
+typedef struct muggle_tc_memory_pool_cache
+{
+	muggle_tc_memory_pool_t      *pool;
+	muggle_tc_memory_pool_head_t *loaded;     //!< magazine for allocate and free
+	muggle_tc_memory_pool_head_t *prev;       //!< full or empty magazine
+	int                          loaded_cnt;
+	int                          prev_cnt;
+
+	uint64_t cnt_alloc;      //!< number of allocate
+	uint64_t cnt_alloc_hit;  //!< number of allocate without touch global depot
+	uint64_t cnt_free;       //!< number of free
+	uint64_t cnt_free_hit;   //!< number of free without touch global depot
+	uint64_t cnt_refill;     //!< number of batch refilled from global depot
+	uint64_t cnt_flush;      //!< number of batch flushed into global depot
+}muggle_tc_memory_pool_cache_t;
+
+/**
+ * @brief init thread cache memory pool
+ *
+ * @param pool        pointer to tc_memory_pool
+ * @param capacity    number of blocks
+ * @param data_size   user data size
+ * @param batch_size  number of blocks in magazine and in batch of refill/flush,
+ *                    0 means use default value 64
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise failed and return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_tc_memory_pool_init(
+	muggle_tc_memory_pool_t *pool, muggle_atomic_int capacity,
+	muggle_atomic_int data_size, muggle_atomic_int batch_size);
+
+/**
+ * @brief destroy thread cache memory pool
+ *
+ * user must destroy all caches before destroy pool
+ *
+ * @param pool  pointer to tc_memory_pool
+ */
+MUGGLE_C_EXPORT
+void muggle_tc_memory_pool_destroy(muggle_tc_memory_pool_t *pool);
+
+/**
+ * @brief init per thread cache
+ *
+ * @param cache  pointer to cache
+ * @param pool   pointer to tc_memory_pool
+ */
+MUGGLE_C_EXPORT
+void muggle_tc_memory_pool_cache_init(muggle_tc_memory_pool_cache_t *cache, muggle_tc_memory_pool_t *pool);
+
+/**
+ * @brief flush all cached blocks into global depot
+ *
+ * @param cache  pointer to cache
+ */
+MUGGLE_C_EXPORT
+void muggle_tc_memory_pool_cache_destroy(muggle_tc_memory_pool_cache_t *cache);
+
+/**
+ * @brief allocate data
+ *
+ * @param cache  cache of current thread
+ *
+ * @return on success return data that allocated, if pool exhausted, return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_tc_memory_pool_alloc(muggle_tc_memory_pool_cache_t *cache);
+
+/**
+ * @brief recycle data
+ *
+ * @param cache  cache of current thread, need not be the cache that allocate data
+ * @param data   data allocated by thread cache memory pool
+ */
+MUGGLE_C_EXPORT
+void muggle_tc_memory_pool_free(muggle_tc_memory_pool_cache_t *cache, void *data);
+
+EXTERN_C_END
+
+#endif
@@ -34,12 +34,16 @@
 #include "muggle/c/memory/memory_detect.h"
 #include "muggle/c/memory/bytes_buffer.h"
 #include "muggle/c/memory/threadsafe_memory_pool.h"
+#include "muggle/c/memory/thread_cache_memory_pool.h"
+#include "muggle/c/memory/slab_allocator.h"
 #include "muggle/c/memory/pointer_slot.h"
 
 // time
 #include "muggle/c/time/win_gettimeofday.h"
 #include "muggle/c/time/win_gmtime.h"
 #include "muggle/c/time/cpu_cycle.h"
+#include "muggle/c/time/deadline.h"
+#include "muggle/c/time/timer_wheel.h"
 
 // os
 #include "muggle/c/os/os.h"
@@ -51,10 +55,13 @@
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/condition_variable.h"
 #include "muggle/c/sync/futex.h"
+#include "muggle/c/sync/wait_strategy.h"
 #include "muggle/c/sync/ring_buffer.h"
 #include "muggle/c/sync/array_blocking_queue.h"
 #include "muggle/c/sync/double_buffer.h"
 #include "muggle/c/sync/channel.h"
+#include "muggle/c/sync/byte_ring.h"
+#include "muggle/c/sync/ipc_ring_buffer.h"
 
 // log
 #include "muggle/c/log/log_level.h"
@@ -65,8 +72,12 @@
 #include "muggle/c/log/log_file_handler.h"
 #include "muggle/c/log/log_file_rotate_handler.h"
 #include "muggle/c/log/log_file_time_rot_handler.h"
+#include "muggle/c/log/log_mmap_handler.h"
+#include "muggle/c/log/log_compress.h"
+#include "muggle/c/log/log_rotate_worker.h"
 #include "muggle/c/log/log_logger.h"
 #include "muggle/c/log/log_sync_logger.h"
+#include "muggle/c/log/log_deferred.h"
 #include "muggle/c/log/log_async_logger.h"
 #include "muggle/c/log/log.h"
 
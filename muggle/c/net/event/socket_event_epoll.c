@@ -14,9 +14,99 @@
 #include "muggle/c/log/log.h"
 #include "socket_event_utils.h"
 #include "socket_event_memmgr.h"
+#include "socket_event_timer.h"
 
 #if MUGGLE_PLATFORM_LINUX
 
+int muggle_socket_event_epoll_add(muggle_socket_t epfd, muggle_socket_peer_list_node_t *node)
+{
+	struct epoll_event epev;
+	memset(&epev, 0, sizeof(epev));
+	epev.data.ptr = node;
+	epev.events = EPOLLIN | EPOLLET;
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, node->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
+	{
+		char err_msg[1024] = {0};
+		muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
+		MUGGLE_LOG_ERROR("failed epoll_ctl EPOLL_CTL_ADD - %s", err_msg);
+		return -1;
+	}
+
+	return 0;
+}
+
+int muggle_socket_event_epoll_watch_write(muggle_socket_t epfd, muggle_socket_peer_list_node_t *node, int enable)
+{
+	struct epoll_event epev;
+	memset(&epev, 0, sizeof(epev));
+	epev.data.ptr = node;
+	epev.events = EPOLLIN | EPOLLET;
+	if (enable)
+	{
+		epev.events |= EPOLLOUT;
+	}
+	if (epoll_ctl(epfd, EPOLL_CTL_MOD, node->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
+	{
+		char err_msg[1024] = {0};
+		muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
+		MUGGLE_LOG_ERROR("failed epoll_ctl EPOLL_CTL_MOD - %s", err_msg);
+		return -1;
+	}
+
+	return 0;
+}
+
+void muggle_socket_event_epoll_handle_peer(
+	muggle_socket_event_t *ev,
+	muggle_socket_event_memmgr_t *mem_mgr,
+	muggle_socket_t epfd,
+	muggle_socket_peer_list_node_t *node,
+	uint32_t events,
+	int *cnt_fd)
+{
+	muggle_socket_peer_t *peer = &node->peer;
+
+	if ((events & EPOLLOUT) && peer->status == MUGGLE_SOCKET_PEER_STATUS_ACTIVE)
+	{
+		muggle_socket_peer_flush(peer);
+	}
+
+	if (events & EPOLLIN)
+	{
+		switch (peer->peer_type)
+		{
+		case MUGGLE_SOCKET_PEER_TYPE_TCP_PEER:
+		case MUGGLE_SOCKET_PEER_TYPE_UDP_PEER:
+			{
+				muggle_socket_event_on_message(ev, peer);
+			}break;
+		default:
+			{
+				MUGGLE_LOG_ERROR("invalid peer type: %d", peer->peer_type);
+			}break;
+		}
+	}
+	else if (events & (EPOLLERR | EPOLLHUP))
+	{
+		muggle_socket_peer_close(peer);
+	}
+
+	if (peer->status == MUGGLE_SOCKET_PEER_STATUS_CLOSED)
+	{
+		if (ev->on_error)
+		{
+			ev->on_error(ev, peer);
+		}
+
+		struct epoll_event epev;
+		memset(&epev, 0, sizeof(epev));
+		epoll_ctl(epfd, EPOLL_CTL_DEL, peer->fd, &epev);
+
+		muggle_socket_event_memmgr_recycle(mem_mgr, node);
+		--(*cnt_fd);
+	}
+}
+
 static void muggle_socket_event_epoll_listen(
 	muggle_socket_event_t *ev,
 	muggle_socket_peer_t *listen_peer,
@@ -50,16 +140,8 @@ static void muggle_socket_event_epoll_listen(
 		}
 
 		// add new connection socket into epoll
-		struct epoll_event epev;
-		memset(&epev, 0, sizeof(epev));
-		epev.data.ptr = node;
-		epev.events = EPOLLIN | EPOLLET;
-		if (epoll_ctl(*epfd, EPOLL_CTL_ADD, node->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
+		if (muggle_socket_event_epoll_add(*epfd, node) != 0)
 		{
-			char err_msg[1024] = {0};
-			muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
-			MUGGLE_LOG_ERROR("failed epoll_ctl EPOLL_CTL_ADD - %s", err_msg);
-
 			muggle_socket_event_memmgr_recycle(mem_mgr, node);
 			continue;
 		}
@@ -115,22 +197,14 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 		muggle_socket_event_memmgr_destroy(p_mem_mgr);
 		return;
 	}
+	ev->loop_fd = epfd;
 
-	int cnt_fd;
-	struct epoll_event epev;
+	int cnt_fd = 0;
 	muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_get_node(p_mem_mgr);
 	while (node)
 	{
-		memset(&epev, 0, sizeof(epev));
-		epev.data.ptr = node;
-		epev.events = EPOLLIN | EPOLLET;
-
-		if (epoll_ctl(epfd, EPOLL_CTL_ADD, node->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
+		if (muggle_socket_event_epoll_add(epfd, node) != 0)
 		{
-			char err_msg[1024] = {0};
-			muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
-			MUGGLE_LOG_ERROR("failed epoll_ctl EPOLL_CTL_ADD - %s", err_msg);
-
 			muggle_socket_peer_list_node_t *next_node = node->next;
 			muggle_socket_event_memmgr_recycle(p_mem_mgr, node);
 			node = next_node;
@@ -142,16 +216,18 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 	}
 
 	// timer
-	int timeout = ev->timeout_ms;
-
-	struct timespec t1, t2;
-	if (ev->timeout_ms > 0)
+	if (muggle_socket_event_timer_init(ev) != 0)
 	{
-		timespec_get(&t1, TIME_UTC);
+		ev->loop_fd = MUGGLE_INVALID_SOCKET;
+		close(epfd);
+		free(ret_epevs);
+		muggle_socket_event_memmgr_destroy(p_mem_mgr);
+		return;
 	}
 
 	while (1)
 	{
+		int timeout = muggle_socket_event_timer_timeout(ev);
 		int n = epoll_wait(epfd, ret_epevs, ev->capacity, timeout); 
 		if (n > 0)
 		{
@@ -160,54 +236,26 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 				muggle_socket_peer_list_node_t *node = (muggle_socket_peer_list_node_t*)ret_epevs[i].data.ptr;
 				muggle_socket_peer_t *peer = &node->peer;
 
-				if (ret_epevs[i].events & EPOLLIN)
-				{
-					switch (peer->peer_type)
-					{
-					case MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN:
-						{
-							muggle_socket_event_epoll_listen(ev, peer, p_mem_mgr, &epfd, ev->capacity, &cnt_fd);
-						}break;
-					case MUGGLE_SOCKET_PEER_TYPE_TCP_PEER:
-					case MUGGLE_SOCKET_PEER_TYPE_UDP_PEER:
-						{
-							muggle_socket_event_on_message(ev, peer);
-						}break;
-					default:
-						{
-							MUGGLE_LOG_ERROR("invalid peer type: %d", peer->peer_type);
-						}break;
-					}
-				}
-				else if (ret_epevs[i].events & (EPOLLERR | EPOLLHUP))
-				{
-					muggle_socket_peer_close(peer);
-				}
-
-				if (peer->status == MUGGLE_SOCKET_PEER_STATUS_CLOSED)
+				if ((ret_epevs[i].events & EPOLLIN) &&
+					peer->peer_type == MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN)
 				{
-					if (ev->on_error)
-					{
-						ev->on_error(ev, peer);
-					}
+					muggle_socket_event_epoll_listen(ev, peer, p_mem_mgr, &epfd, ev->capacity, &cnt_fd);
 
-					epoll_ctl(epfd, EPOLL_CTL_DEL, peer->fd, &ret_epevs[i]);
-
-					muggle_socket_event_memmgr_recycle(p_mem_mgr, node);
-					--cnt_fd;
+					// listen peer closed when failed accept
+					muggle_socket_event_epoll_handle_peer(ev, p_mem_mgr, epfd, node, 0, &cnt_fd);
+					continue;
 				}
-			}
 
-			// when loop is busy, timeout will not trigger, use
-			// customize timer handle avoid that
-			if (ev->timeout_ms > 0)
-			{
-				muggle_socket_event_timer_handle(ev, &t1, &t2);
+				muggle_socket_event_epoll_handle_peer(ev, p_mem_mgr, epfd, node, ret_epevs[i].events, &cnt_fd);
 			}
+
+			// when loop is busy, timeout will not trigger, so always
+			// check timers after events handled
+			muggle_socket_event_timer_update(ev, n);
 		}
 		else if (n == 0)
 		{
-			muggle_socket_event_timer_handle(ev, &t1, &t2);
+			muggle_socket_event_timer_update(ev, n);
 		}
 		else
 		{
@@ -235,6 +283,9 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 	}
 
 	// free memory
+	muggle_socket_event_timer_destroy(ev);
+	ev->loop_fd = MUGGLE_INVALID_SOCKET;
+	close(epfd);
 	free(ret_epevs);
 }
 
@@ -12,11 +12,54 @@
 #define MUGGLE_C_SOCKET_EVENT_EPOLL_H_
 
 #include "muggle/c/net/socket_event.h"
+#include "muggle/c/net/event/socket_event_memmgr.h"
 
 #if MUGGLE_PLATFORM_LINUX
 
+#include <stdint.h>
+
 EXTERN_C_BEGIN
 
+/**
+ * @brief add peer into epoll, edge triggered input
+ *
+ * @param epfd  epoll file descriptor
+ * @param node  socket peer list node
+ *
+ * @return 0 - success, otherwise failed
+ */
+int muggle_socket_event_epoll_add(muggle_socket_t epfd, muggle_socket_peer_list_node_t *node);
+
+/**
+ * @brief modify events of peer in epoll, edge triggered input and
+ * optional output
+ *
+ * @param epfd    epoll file descriptor
+ * @param node    socket peer list node
+ * @param enable  1 - watch EPOLLOUT, 0 - only EPOLLIN
+ *
+ * @return 0 - success, otherwise failed
+ */
+int muggle_socket_event_epoll_watch_write(muggle_socket_t epfd, muggle_socket_peer_list_node_t *node, int enable);
+
+/**
+ * @brief handle epoll events of non listen peer, recycle peer if it closed
+ *
+ * @param ev       socket event
+ * @param mem_mgr  socket event memory manager that peer belong to
+ * @param epfd     epoll file descriptor
+ * @param node     socket peer list node
+ * @param events   epoll events
+ * @param cnt_fd   number of peers in epoll, decrease when peer recycled
+ */
+void muggle_socket_event_epoll_handle_peer(
+	muggle_socket_event_t *ev,
+	muggle_socket_event_memmgr_t *mem_mgr,
+	muggle_socket_t epfd,
+	muggle_socket_peer_list_node_t *node,
+	uint32_t events,
+	int *cnt_fd);
+
 /**
  * @brief socket event - epoll
  *
@@ -0,0 +1,236 @@
+/******************************************************************************
+ *  @file         socket_event_frame.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - receive buffer and framing
+ *****************************************************************************/
+
+#include "socket_event_frame.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include "muggle/c/log/log.h"
+
+/**
+ * @brief move readable bytes to the head of receive buffer
+ *
+ * after writer jumped to the head, memory after end mark is not used until
+ * reader jump, an incomplete frame may not fit in the remaining memory
+ *
+ * @return 0 - success, otherwise failed allocate memory
+ */
+static int muggle_socket_event_frame_compact(muggle_bytes_buffer_t *bytes_buf)
+{
+	int readable = muggle_bytes_buffer_readable(bytes_buf);
+	if (readable == 0)
+	{
+		muggle_bytes_buffer_clear(bytes_buf);
+		return 0;
+	}
+
+	void *tmp = malloc(readable);
+	if (tmp == NULL)
+	{
+		return -1;
+	}
+	muggle_bytes_buffer_read(bytes_buf, readable, tmp);
+	muggle_bytes_buffer_clear(bytes_buf);
+	muggle_bytes_buffer_write(bytes_buf, readable, tmp);
+	free(tmp);
+
+	return 0;
+}
+
+/**
+ * @brief built-in length prefix frame decoder, use ev->length_field
+ */
+static int muggle_socket_event_frame_decode_length_field(
+	muggle_socket_event_t *ev, muggle_socket_peer_t *peer, muggle_bytes_buffer_t *bytes_buf)
+{
+	(void)peer;
+
+	const muggle_socket_event_length_field_t *field = &ev->length_field;
+	int end = field->offset + field->size;
+	if (muggle_bytes_buffer_readable(bytes_buf) < end)
+	{
+		return 0;
+	}
+
+	unsigned char head[MUGGLE_SOCKET_EVENT_LENGTH_FIELD_MAX_END];
+	const unsigned char *p = (const unsigned char*)muggle_bytes_buffer_reader_fc(bytes_buf, end);
+	if (p == NULL)
+	{
+		muggle_bytes_buffer_fetch(bytes_buf, end, head);
+		p = head;
+	}
+	p += field->offset;
+
+	uint64_t value = 0;
+	for (int i = 0; i < field->size; i++)
+	{
+		int idx = field->big_endian ? i : field->size - 1 - i;
+		value = (value << 8) | p[idx];
+	}
+
+	int64_t len = (int64_t)value + field->adjust;
+	if (value > (uint64_t)field->max_frame || len < end || len > field->max_frame)
+	{
+		MUGGLE_LOG_ERROR("invalid frame length: %llu", (unsigned long long)value);
+		return -1;
+	}
+
+	return (int)len;
+}
+
+/**
+ * @brief deliver complete frames in receive buffer
+ *
+ * @return number of delivered frames, -1 represent invalid frame or user
+ *         closed peer in on_frame
+ */
+static int muggle_socket_event_frame_dispatch(muggle_socket_event_t *ev, muggle_socket_peer_t *peer)
+{
+	muggle_bytes_buffer_t *bytes_buf = peer->recv_buf;
+	muggle_socket_event_frame_decode decode = ev->frame_decode;
+	if (decode == NULL)
+	{
+		decode = muggle_socket_event_frame_decode_length_field;
+	}
+
+	// frames received before peer closed by remote are still delivered
+	int active = peer->status == MUGGLE_SOCKET_PEER_STATUS_ACTIVE;
+
+	int cnt = 0;
+	while (1)
+	{
+		int readable = muggle_bytes_buffer_readable(bytes_buf);
+		if (readable == 0)
+		{
+			break;
+		}
+
+		int len = decode(ev, peer, bytes_buf);
+		if (len == 0)
+		{
+			break;
+		}
+		if (len < 0 || len > ev->recv_buf_capacity)
+		{
+			MUGGLE_LOG_ERROR("failed decode frame, close peer: len=%d", len);
+			muggle_socket_peer_close(peer);
+			return -1;
+		}
+		if (readable < len)
+		{
+			break;
+		}
+
+		void *frame = muggle_bytes_buffer_reader_fc(bytes_buf, len);
+		if (frame)
+		{
+			ev->on_frame(ev, peer, frame, len);
+			muggle_bytes_buffer_reader_move(bytes_buf, len);
+		}
+		else
+		{
+			// frame wrapped around the end of buffer
+			frame = malloc(len);
+			if (frame == NULL)
+			{
+				MUGGLE_LOG_ERROR("failed allocate memory for frame, close peer: len=%d", len);
+				muggle_socket_peer_close(peer);
+				return -1;
+			}
+			muggle_bytes_buffer_read(bytes_buf, len, frame);
+			ev->on_frame(ev, peer, frame, len);
+			free(frame);
+		}
+		++cnt;
+
+		if (active && peer->status == MUGGLE_SOCKET_PEER_STATUS_CLOSED)
+		{
+			return -1;
+		}
+	}
+
+	return cnt;
+}
+
+void muggle_socket_event_frame_recv(muggle_socket_event_t *ev, muggle_socket_peer_t *peer)
+{
+	if (peer->recv_buf == NULL)
+	{
+		muggle_bytes_buffer_t *recv_buf = (muggle_bytes_buffer_t*)malloc(sizeof(muggle_bytes_buffer_t));
+		if (recv_buf == NULL)
+		{
+			MUGGLE_LOG_ERROR("failed allocate peer receive buffer");
+			muggle_socket_peer_close(peer);
+			return;
+		}
+
+		// one byte of bytes buffer is always kept empty
+		if (!muggle_bytes_buffer_init(recv_buf, ev->recv_buf_capacity + 1))
+		{
+			MUGGLE_LOG_ERROR("failed init peer receive buffer");
+			free(recv_buf);
+			muggle_socket_peer_close(peer);
+			return;
+		}
+		peer->recv_buf = recv_buf;
+	}
+
+	muggle_bytes_buffer_t *bytes_buf = peer->recv_buf;
+	while (peer->status == MUGGLE_SOCKET_PEER_STATUS_ACTIVE)
+	{
+		int num_bytes = MUGGLE_SOCKET_EVENT_FRAME_READ_BYTES;
+		void *p = muggle_bytes_buffer_writer_fc(bytes_buf, num_bytes);
+		if (p == NULL)
+		{
+			// make room by deliver frames, then shrink read size until
+			// contiguous memory is found
+			if (muggle_socket_event_frame_dispatch(ev, peer) < 0)
+			{
+				return;
+			}
+
+			p = muggle_bytes_buffer_writer_fc(bytes_buf, num_bytes);
+			while (p == NULL && num_bytes > 1)
+			{
+				num_bytes /= 2;
+				p = muggle_bytes_buffer_writer_fc(bytes_buf, num_bytes);
+			}
+
+			if (p == NULL &&
+				muggle_bytes_buffer_readable(bytes_buf) < ev->recv_buf_capacity &&
+				muggle_socket_event_frame_compact(bytes_buf) == 0)
+			{
+				num_bytes = muggle_bytes_buffer_writable(bytes_buf);
+				p = muggle_bytes_buffer_writer_fc(bytes_buf, num_bytes);
+			}
+
+			if (p == NULL)
+			{
+				MUGGLE_LOG_ERROR("frame exceed receive buffer, close peer: capacity=%d",
+					ev->recv_buf_capacity);
+				muggle_socket_peer_close(peer);
+				return;
+			}
+		}
+
+		int n = muggle_socket_peer_recv(peer, p, num_bytes, 0);
+		if (n <= 0)
+		{
+			break;
+		}
+		// short read may happen after writer jumped to the head
+		muggle_bytes_buffer_writer_move_fc(bytes_buf, p, n);
+
+		// don't stop at short read, FIN may arrive with the last bytes and
+		// edge triggered loop will not report it again, read until would
+		// block or closed
+	}
+
+	muggle_socket_event_frame_dispatch(ev, peer);
+}
@@ -0,0 +1,36 @@
+/******************************************************************************
+ *  @file         socket_event_frame.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - receive buffer and framing
+ *
+ * When on_frame of event is set, readable tcp peer is read greedily into
+ * its receive buffer until would block, then complete frames are found by
+ * frame_decode (or built-in length prefix decoder) and delivered to
+ * on_frame. Frame is passed by muggle_bytes_buffer_reader_fc without copy,
+ * except the one wrapped around the end of buffer
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_NET_SOCKET_EVENT_FRAME_H_
+#define MUGGLE_C_NET_SOCKET_EVENT_FRAME_H_
+
+#include "muggle/c/net/socket_event.h"
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_SOCKET_EVENT_FRAME_READ_BYTES (16 * 1024) //!< bytes of one recv
+
+/**
+ * @brief read bytes of peer into receive buffer and deliver frames
+ *
+ * @param ev    socket event
+ * @param peer  tcp peer
+ */
+void muggle_socket_event_frame_recv(muggle_socket_event_t *ev, muggle_socket_peer_t *peer);
+
+EXTERN_C_END
+
+#endif
@@ -0,0 +1,916 @@
+/******************************************************************************
+ *  @file         socket_event_io_uring.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - io_uring
+ *****************************************************************************/
+
+#include "socket_event_io_uring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/log/log.h"
+#include "muggle/c/base/atomic.h"
+#include "socket_event_utils.h"
+#include "socket_event_memmgr.h"
+#include "socket_event_timer.h"
+
+#if MUGGLE_SOCKET_EVENT_HAS_IO_URING
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifndef __NR_io_uring_setup
+	#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+	#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+	#define __NR_io_uring_register 427
+#endif
+
+#define MUGGLE_IO_URING_SQ_ENTRIES 256
+#define MUGGLE_IO_URING_CQ_ENTRIES 4096
+#define MUGGLE_IO_URING_BUF_COUNT  1024 //!< number of provided buffers, must be power of 2
+#define MUGGLE_IO_URING_BUF_SIZE   4096 //!< bytes of provided buffer
+#define MUGGLE_IO_URING_BGID       0    //!< provided buffer group id
+
+/**
+ * @brief tag in low bits of sqe user_data, high bits is peer list node
+ */
+enum
+{
+	MUGGLE_IO_URING_TAG_PEER   = 0,
+	MUGGLE_IO_URING_TAG_CANCEL = 1,
+	MUGGLE_IO_URING_TAG_MASK   = 0x07,
+};
+
+/**
+ * @brief node io_flags
+ */
+enum
+{
+	MUGGLE_IO_URING_FLAG_ARMED    = 0x01, //!< multishot request of peer in flight
+	MUGGLE_IO_URING_FLAG_CANCELED = 0x02, //!< cancel request was submitted
+};
+
+/**
+ * @brief io_uring instance
+ */
+typedef struct muggle_io_uring
+{
+	int fd;
+
+	// submission queue
+	unsigned            *sq_head;
+	unsigned            *sq_tail;
+	unsigned            *sq_array;
+	unsigned            sq_mask;
+	unsigned            sq_entries;
+	unsigned            sq_local_tail; //!< tail of prepared sqe, published before enter
+	struct io_uring_sqe *sqes;
+
+	// completion queue
+	unsigned            *cq_head;
+	unsigned            *cq_tail;
+	unsigned            cq_mask;
+	struct io_uring_cqe *cqes;
+
+	void   *sq_ptr;
+	size_t sq_ptr_size;
+	void   *cq_ptr;
+	size_t cq_ptr_size;
+	size_t sqes_size;
+
+	// provided buffer ring
+	struct io_uring_buf_ring *buf_ring;
+	size_t                   buf_ring_size;
+	char                     *bufs;
+	unsigned short           buf_local_tail; //!< tail of returned buffers, published before enter
+
+	int recv_single; //!< kernel not support multishot recv, use single shot
+}muggle_io_uring_t;
+
+/**
+ * @brief io_uring event loop context
+ */
+typedef struct muggle_socket_event_io_uring_ctx
+{
+	muggle_socket_event_t        *ev;
+	muggle_socket_event_memmgr_t *mem_mgr;
+	muggle_io_uring_t            ring;
+	int                          cnt_fd;
+	int                          exiting; //!< event loop exiting, only wait requests terminated
+}muggle_socket_event_io_uring_ctx_t;
+
+// recv_data of tcp peer never be NULL in io_uring event loop
+static const char s_muggle_io_uring_empty[1] = {0};
+
+static int muggle_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+	return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static int muggle_io_uring_setup(muggle_io_uring_t *ring, unsigned cq_entries)
+{
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	params.flags =
+		IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP |
+		IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SINGLE_ISSUER;
+	params.cq_entries = cq_entries;
+
+	int fd = (int)syscall(__NR_io_uring_setup, MUGGLE_IO_URING_SQ_ENTRIES, &params);
+	if (fd < 0 && errno == EINVAL)
+	{
+		// old kernel without task run flags
+		memset(&params, 0, sizeof(params));
+		params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+		params.cq_entries = cq_entries;
+		fd = (int)syscall(__NR_io_uring_setup, MUGGLE_IO_URING_SQ_ENTRIES, &params);
+	}
+	if (fd < 0)
+	{
+		char err_msg[1024] = {0};
+		muggle_socket_strerror(errno, err_msg, sizeof(err_msg));
+		MUGGLE_LOG_WARNING("failed io_uring_setup - %s", err_msg);
+		return -1;
+	}
+	ring->fd = fd;
+
+	if (!(params.features & IORING_FEAT_EXT_ARG))
+	{
+		MUGGLE_LOG_WARNING("io_uring not support IORING_FEAT_EXT_ARG");
+		return -1;
+	}
+
+	ring->sq_ptr_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->cq_ptr_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ring->cq_ptr_size > ring->sq_ptr_size)
+		{
+			ring->sq_ptr_size = ring->cq_ptr_size;
+		}
+		ring->cq_ptr_size = ring->sq_ptr_size;
+	}
+
+	ring->sq_ptr = mmap(NULL, ring->sq_ptr_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (ring->sq_ptr == MAP_FAILED)
+	{
+		ring->sq_ptr = NULL;
+		MUGGLE_LOG_WARNING("failed mmap io_uring submission queue");
+		return -1;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		ring->cq_ptr = ring->sq_ptr;
+	}
+	else
+	{
+		ring->cq_ptr = mmap(NULL, ring->cq_ptr_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (ring->cq_ptr == MAP_FAILED)
+		{
+			ring->cq_ptr = NULL;
+			MUGGLE_LOG_WARNING("failed mmap io_uring completion queue");
+			return -1;
+		}
+	}
+
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED)
+	{
+		ring->sqes = NULL;
+		MUGGLE_LOG_WARNING("failed mmap io_uring sqes");
+		return -1;
+	}
+
+	char *sq = (char*)ring->sq_ptr;
+	ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+	ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+	ring->sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+	ring->sq_entries = *(unsigned*)(sq + params.sq_off.ring_entries);
+	ring->sq_local_tail = *ring->sq_tail;
+
+	char *cq = (char*)ring->cq_ptr;
+	ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+	ring->cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	return 0;
+}
+
+static void muggle_io_uring_buf_ring_add(muggle_io_uring_t *ring, unsigned short bid)
+{
+	struct io_uring_buf *buf =
+		&ring->buf_ring->bufs[ring->buf_local_tail & (MUGGLE_IO_URING_BUF_COUNT - 1)];
+	buf->addr = (uint64_t)(uintptr_t)(ring->bufs + (size_t)bid * MUGGLE_IO_URING_BUF_SIZE);
+	buf->len = MUGGLE_IO_URING_BUF_SIZE;
+	buf->bid = bid;
+	ring->buf_local_tail++;
+}
+
+static int muggle_io_uring_setup_buf_ring(muggle_io_uring_t *ring)
+{
+	ring->buf_ring_size = MUGGLE_IO_URING_BUF_COUNT * sizeof(struct io_uring_buf);
+	void *p = mmap(NULL, ring->buf_ring_size, PROT_READ | PROT_WRITE,
+		MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	if (p == MAP_FAILED)
+	{
+		MUGGLE_LOG_WARNING("failed mmap provided buffer ring");
+		return -1;
+	}
+	ring->buf_ring = (struct io_uring_buf_ring*)p;
+
+	ring->bufs = (char*)malloc((size_t)MUGGLE_IO_URING_BUF_COUNT * MUGGLE_IO_URING_BUF_SIZE);
+	if (ring->bufs == NULL)
+	{
+		MUGGLE_LOG_WARNING("failed allocate provided buffers");
+		return -1;
+	}
+
+	struct io_uring_buf_reg reg;
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = (uint64_t)(uintptr_t)ring->buf_ring;
+	reg.ring_entries = MUGGLE_IO_URING_BUF_COUNT;
+	reg.bgid = MUGGLE_IO_URING_BGID;
+	if (muggle_io_uring_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+	{
+		char err_msg[1024] = {0};
+		muggle_socket_strerror(errno, err_msg, sizeof(err_msg));
+		MUGGLE_LOG_WARNING("failed register provided buffer ring - %s", err_msg);
+		munmap(ring->buf_ring, ring->buf_ring_size);
+		ring->buf_ring = NULL;
+		return -1;
+	}
+
+	ring->buf_local_tail = 0;
+	for (unsigned i = 0; i < MUGGLE_IO_URING_BUF_COUNT; i++)
+	{
+		muggle_io_uring_buf_ring_add(ring, (unsigned short)i);
+	}
+	muggle_atomic_store(&ring->buf_ring->tail, ring->buf_local_tail, muggle_memory_order_release);
+
+	return 0;
+}
+
+static void muggle_io_uring_destroy(muggle_io_uring_t *ring)
+{
+	if (ring->buf_ring)
+	{
+		struct io_uring_buf_reg reg;
+		memset(&reg, 0, sizeof(reg));
+		reg.bgid = MUGGLE_IO_URING_BGID;
+		muggle_io_uring_register(ring->fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+		munmap(ring->buf_ring, ring->buf_ring_size);
+		ring->buf_ring = NULL;
+	}
+
+	if (ring->sqes)
+	{
+		munmap(ring->sqes, ring->sqes_size);
+		ring->sqes = NULL;
+	}
+	if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr)
+	{
+		munmap(ring->cq_ptr, ring->cq_ptr_size);
+	}
+	ring->cq_ptr = NULL;
+	if (ring->sq_ptr)
+	{
+		munmap(ring->sq_ptr, ring->sq_ptr_size);
+		ring->sq_ptr = NULL;
+	}
+
+	if (ring->fd != -1)
+	{
+		close(ring->fd);
+		ring->fd = -1;
+	}
+
+	// requests were canceled when ring closed
+	free(ring->bufs);
+	ring->bufs = NULL;
+}
+
+/**
+ * @brief submit prepared sqes and wait completions
+ *
+ * @param ring          io_uring
+ * @param min_complete  number of completions to wait
+ * @param timeout_ms    -1 means wait forever
+ *
+ * @return the same as io_uring_enter
+ */
+static int muggle_io_uring_enter(muggle_io_uring_t *ring, unsigned min_complete, int timeout_ms)
+{
+	// publish returned buffers and prepared sqes
+	if (ring->buf_ring)
+	{
+		muggle_atomic_store(&ring->buf_ring->tail, ring->buf_local_tail, muggle_memory_order_release);
+	}
+	muggle_atomic_store(ring->sq_tail, ring->sq_local_tail, muggle_memory_order_release);
+
+	unsigned to_submit =
+		ring->sq_local_tail - muggle_atomic_load(ring->sq_head, muggle_memory_order_acquire);
+
+	unsigned flags = 0;
+	struct __kernel_timespec ts;
+	struct io_uring_getevents_arg arg;
+	memset(&arg, 0, sizeof(arg));
+	arg.sigmask_sz = _NSIG / 8;
+	if (min_complete > 0)
+	{
+		flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+		if (timeout_ms >= 0)
+		{
+			ts.tv_sec = timeout_ms / 1000;
+			ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+			arg.ts = (uint64_t)(uintptr_t)&ts;
+		}
+	}
+
+	if (to_submit == 0 && flags == 0)
+	{
+		return 0;
+	}
+
+	return (int)syscall(__NR_io_uring_enter, ring->fd, to_submit, min_complete, flags, &arg, sizeof(arg));
+}
+
+/**
+ * @brief get sqe, submit prepared sqes if submission queue is full
+ *
+ * @return sqe or NULL if submission queue still full
+ */
+static struct io_uring_sqe* muggle_io_uring_get_sqe(muggle_io_uring_t *ring)
+{
+	unsigned head = muggle_atomic_load(ring->sq_head, muggle_memory_order_acquire);
+	if (ring->sq_local_tail - head >= ring->sq_entries)
+	{
+		muggle_io_uring_enter(ring, 0, 0);
+		head = muggle_atomic_load(ring->sq_head, muggle_memory_order_acquire);
+		if (ring->sq_local_tail - head >= ring->sq_entries)
+		{
+			return NULL;
+		}
+	}
+
+	unsigned idx = ring->sq_local_tail & ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	ring->sq_array[idx] = idx;
+	ring->sq_local_tail++;
+
+	return sqe;
+}
+
+/**
+ * @brief submit multishot request of peer
+ *
+ * @return 0 - success, otherwise failed
+ */
+static int muggle_socket_event_io_uring_arm(
+	muggle_socket_event_io_uring_ctx_t *ctx, muggle_socket_peer_list_node_t *node)
+{
+	muggle_io_uring_t *ring = &ctx->ring;
+	muggle_socket_peer_t *peer = &node->peer;
+
+	struct io_uring_sqe *sqe = muggle_io_uring_get_sqe(ring);
+	if (sqe == NULL)
+	{
+		MUGGLE_LOG_ERROR("io_uring submission queue full");
+		return -1;
+	}
+
+	sqe->fd = peer->fd;
+	sqe->user_data = (uint64_t)(uintptr_t)node | MUGGLE_IO_URING_TAG_PEER;
+	switch (peer->peer_type)
+	{
+	case MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN:
+		{
+			sqe->opcode = IORING_OP_ACCEPT;
+			sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+			sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+		}break;
+	case MUGGLE_SOCKET_PEER_TYPE_TCP_PEER:
+		{
+			sqe->opcode = IORING_OP_RECV;
+			sqe->flags = IOSQE_BUFFER_SELECT;
+			sqe->buf_group = MUGGLE_IO_URING_BGID;
+			sqe->ioprio = ring->recv_single ? 0 : IORING_RECV_MULTISHOT;
+		}break;
+	case MUGGLE_SOCKET_PEER_TYPE_UDP_PEER:
+		{
+			// udp peer need source address, let user recvfrom when readable
+			uint32_t poll_mask = POLLIN;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			poll_mask = (poll_mask << 16) | (poll_mask >> 16);
+#endif
+			sqe->opcode = IORING_OP_POLL_ADD;
+			sqe->poll32_events = poll_mask;
+			sqe->len = IORING_POLL_ADD_MULTI;
+		}break;
+	default:
+		{
+			// give back sqe as nop
+			sqe->opcode = IORING_OP_NOP;
+			sqe->fd = -1;
+			sqe->user_data = MUGGLE_IO_URING_TAG_CANCEL;
+			MUGGLE_LOG_ERROR("invalid peer type: %d", peer->peer_type);
+			return -1;
+		}break;
+	}
+
+	node->io_flags = MUGGLE_IO_URING_FLAG_ARMED;
+
+	return 0;
+}
+
+static void muggle_socket_event_io_uring_cancel(
+	muggle_socket_event_io_uring_ctx_t *ctx, muggle_socket_peer_list_node_t *node)
+{
+	struct io_uring_sqe *sqe = muggle_io_uring_get_sqe(&ctx->ring);
+	if (sqe == NULL)
+	{
+		// peer already shutdown, request will be terminated by kernel
+		return;
+	}
+
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = (uint64_t)(uintptr_t)node | MUGGLE_IO_URING_TAG_PEER;
+	sqe->user_data = (uint64_t)(uintptr_t)node | MUGGLE_IO_URING_TAG_CANCEL;
+	node->io_flags |= MUGGLE_IO_URING_FLAG_CANCELED;
+}
+
+static void muggle_socket_event_io_uring_release_stash(muggle_socket_peer_list_node_t *node)
+{
+	if (node->recv_stash)
+	{
+		free(node->recv_stash);
+		node->recv_stash = NULL;
+	}
+	node->recv_stash_cap = 0;
+
+	if (node->peer.recv_data)
+	{
+		node->peer.recv_data = s_muggle_io_uring_empty;
+		node->peer.recv_len = 0;
+	}
+}
+
+/**
+ * @brief after completion of peer, recycle closed peer or submit request
+ * again if multishot request was terminated
+ */
+static void muggle_socket_event_io_uring_settle(
+	muggle_socket_event_io_uring_ctx_t *ctx, muggle_socket_peer_list_node_t *node)
+{
+	muggle_socket_peer_t *peer = &node->peer;
+
+	if (peer->status == MUGGLE_SOCKET_PEER_STATUS_ACTIVE &&
+		!(node->io_flags & MUGGLE_IO_URING_FLAG_ARMED))
+	{
+		if (muggle_socket_event_io_uring_arm(ctx, node) != 0)
+		{
+			muggle_socket_peer_close(peer);
+		}
+	}
+
+	if (peer->status != MUGGLE_SOCKET_PEER_STATUS_CLOSED)
+	{
+		return;
+	}
+
+	if (node->io_flags & MUGGLE_IO_URING_FLAG_ARMED)
+	{
+		// wait the last completion of request, it still reference node
+		if (!(node->io_flags & MUGGLE_IO_URING_FLAG_CANCELED))
+		{
+			muggle_socket_event_io_uring_cancel(ctx, node);
+		}
+		return;
+	}
+
+	muggle_socket_event_t *ev = ctx->ev;
+	if (ev->on_error)
+	{
+		ev->on_error(ev, peer);
+	}
+
+	muggle_socket_event_io_uring_release_stash(node);
+	muggle_socket_event_memmgr_recycle(ctx->mem_mgr, node);
+	--ctx->cnt_fd;
+}
+
+/**
+ * @brief expose received bytes to user, keep bytes user not read
+ */
+static void muggle_socket_event_io_uring_deliver(
+	muggle_socket_event_io_uring_ctx_t *ctx, muggle_socket_peer_list_node_t *node,
+	const char *data, size_t len)
+{
+	muggle_socket_peer_t *peer = &node->peer;
+	if (peer->status != MUGGLE_SOCKET_PEER_STATUS_ACTIVE)
+	{
+		return;
+	}
+
+	if (peer->recv_len == 0)
+	{
+		// zero copy, user read from provided buffer directly
+		peer->recv_data = data;
+		peer->recv_len = len;
+	}
+	else
+	{
+		// bytes in stash begin at recv_stash
+		size_t need = peer->recv_len + len;
+		if (need > node->recv_stash_cap)
+		{
+			char *p = (char*)realloc(node->recv_stash, need);
+			if (p == NULL)
+			{
+				MUGGLE_LOG_ERROR("failed allocate receive stash");
+				muggle_socket_peer_close(peer);
+				return;
+			}
+			node->recv_stash = p;
+			node->recv_stash_cap = need;
+		}
+		memcpy(node->recv_stash + peer->recv_len, data, len);
+		peer->recv_data = node->recv_stash;
+		peer->recv_len = need;
+	}
+
+	muggle_socket_event_on_message(ctx->ev, peer);
+
+	if (peer->recv_len == 0 || peer->status != MUGGLE_SOCKET_PEER_STATUS_ACTIVE)
+	{
+		peer->recv_data = s_muggle_io_uring_empty;
+		peer->recv_len = 0;
+		return;
+	}
+
+	// provided buffer will be given back, move bytes not read into stash
+	if (peer->recv_data < node->recv_stash ||
+		peer->recv_data >= node->recv_stash + node->recv_stash_cap)
+	{
+		if (peer->recv_len > node->recv_stash_cap)
+		{
+			char *p = (char*)realloc(node->recv_stash, peer->recv_len);
+			if (p == NULL)
+			{
+				MUGGLE_LOG_ERROR("failed allocate receive stash");
+				muggle_socket_peer_close(peer);
+				return;
+			}
+			node->recv_stash = p;
+			node->recv_stash_cap = peer->recv_len;
+		}
+	}
+	memmove(node->recv_stash, peer->recv_data, peer->recv_len);
+	peer->recv_data = node->recv_stash;
+}
+
+static void muggle_socket_event_io_uring_on_accept(
+	muggle_socket_event_io_uring_ctx_t *ctx, muggle_socket_peer_t *listen_peer, int fd)
+{
+	muggle_socket_peer_list_node_t *node = NULL;
+	if (ctx->cnt_fd < ctx->ev->capacity)
+	{
+		node = muggle_socket_event_memmgr_allocate(ctx->mem_mgr);
+	}
+
+	struct sockaddr_storage addr;
+	muggle_socklen_t addr_len = sizeof(addr);
+	if (getpeername(fd, (struct sockaddr*)&addr, &addr_len) != 0)
+	{
+		addr_len = 0;
+	}
+
+	if (node == NULL)
+	{
+		char straddr[MUGGLE_SOCKET_ADDR_STRLEN];
+		if (addr_len == 0 ||
+			muggle_socket_ntop((struct sockaddr*)&addr, straddr, sizeof(straddr), 0) == NULL)
+		{
+			snprintf(straddr, sizeof(straddr), "unknown:unknown");
+		}
+		MUGGLE_LOG_WARNING("refuse connection %s - number of connection reached the upper limit", straddr);
+		muggle_socket_close(fd);
+		return;
+	}
+
+	muggle_socket_peer_t *peer = &node->peer;
+	peer->ref_cnt = 1;
+	peer->fd = fd;
+	peer->peer_type = MUGGLE_SOCKET_PEER_TYPE_TCP_PEER;
+	peer->status = MUGGLE_SOCKET_PEER_STATUS_ACTIVE;
+	memcpy(&peer->addr, &addr, addr_len);
+	peer->addr_len = addr_len;
+	peer->ev = ctx->ev;
+	peer->recv_data = s_muggle_io_uring_empty;
+	peer->recv_len = 0;
+
+	if (muggle_socket_event_io_uring_arm(ctx, node) != 0)
+	{
+		peer->recv_data = NULL;
+		muggle_socket_event_memmgr_recycle(ctx->mem_mgr, node);
+		return;
+	}
+	++ctx->cnt_fd;
+
+	muggle_socket_event_t *ev = ctx->ev;
+	if (ev->on_connect)
+	{
+		ev->on_connect(ev, listen_peer, peer);
+	}
+
+	muggle_socket_event_io_uring_settle(ctx, node);
+}
+
+static void muggle_socket_event_io_uring_handle_cqe(
+	muggle_socket_event_io_uring_ctx_t *ctx, uint64_t user_data, int res, uint32_t flags)
+{
+	if ((user_data & MUGGLE_IO_URING_TAG_MASK) != MUGGLE_IO_URING_TAG_PEER)
+	{
+		// completion of cancel request
+		return;
+	}
+
+	muggle_socket_peer_list_node_t *node =
+		(muggle_socket_peer_list_node_t*)(uintptr_t)(user_data & ~(uint64_t)MUGGLE_IO_URING_TAG_MASK);
+	muggle_socket_peer_t *peer = &node->peer;
+
+	if (!(flags & IORING_CQE_F_MORE))
+	{
+		node->io_flags &= ~MUGGLE_IO_URING_FLAG_ARMED;
+	}
+
+	if (ctx->exiting)
+	{
+		if (flags & IORING_CQE_F_BUFFER)
+		{
+			muggle_io_uring_buf_ring_add(&ctx->ring, (unsigned short)(flags >> IORING_CQE_BUFFER_SHIFT));
+		}
+		else if (peer->peer_type == MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN && res >= 0)
+		{
+			muggle_socket_close(res);
+		}
+		return;
+	}
+
+	switch (peer->peer_type)
+	{
+	case MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN:
+		{
+			if (res >= 0)
+			{
+				muggle_socket_event_io_uring_on_accept(ctx, peer, res);
+			}
+			else if (res != -ECANCELED && res != -EINTR && res != -EAGAIN)
+			{
+				char err_msg[1024];
+				muggle_socket_strerror(-res, err_msg, sizeof(err_msg));
+				MUGGLE_LOG_TRACE("failed accept - %s", err_msg);
+
+				// close listen socket
+				muggle_socket_peer_close(peer);
+			}
+		}break;
+	case MUGGLE_SOCKET_PEER_TYPE_TCP_PEER:
+		{
+			if (res > 0 && (flags & IORING_CQE_F_BUFFER))
+			{
+				unsigned short bid = (unsigned short)(flags >> IORING_CQE_BUFFER_SHIFT);
+				muggle_socket_event_io_uring_deliver(ctx, node,
+					ctx->ring.bufs + (size_t)bid * MUGGLE_IO_URING_BUF_SIZE, (size_t)res);
+				muggle_io_uring_buf_ring_add(&ctx->ring, bid);
+			}
+			else if (res == -ENOBUFS || res == -ECANCELED || res == -EINTR)
+			{
+				// all provided buffers in use, request again in settle
+			}
+			else if (res == -EINVAL && !ctx->ring.recv_single)
+			{
+				MUGGLE_LOG_WARNING("io_uring not support multishot recv, use single shot recv");
+				ctx->ring.recv_single = 1;
+			}
+			else
+			{
+				// 0: peer shutdown, otherwise: error
+				muggle_socket_peer_close(peer);
+			}
+		}break;
+	case MUGGLE_SOCKET_PEER_TYPE_UDP_PEER:
+		{
+			if (res > 0)
+			{
+				if (peer->status == MUGGLE_SOCKET_PEER_STATUS_ACTIVE)
+				{
+					muggle_socket_event_on_message(ctx->ev, peer);
+				}
+			}
+			else if (res != -ECANCELED)
+			{
+				muggle_socket_peer_close(peer);
+			}
+		}break;
+	default:
+		{
+			MUGGLE_LOG_ERROR("invalid peer type: %d", peer->peer_type);
+		}break;
+	}
+
+	muggle_socket_event_io_uring_settle(ctx, node);
+}
+
+/**
+ * @brief handle all completions in completion queue
+ *
+ * @return number of handled completions
+ */
+static int muggle_socket_event_io_uring_reap(muggle_socket_event_io_uring_ctx_t *ctx)
+{
+	muggle_io_uring_t *ring = &ctx->ring;
+	int cnt = 0;
+
+	unsigned head = *ring->cq_head;
+	unsigned tail = muggle_atomic_load(ring->cq_tail, muggle_memory_order_acquire);
+	while (head != tail)
+	{
+		for (; head != tail; head++)
+		{
+			struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+			uint64_t user_data = cqe->user_data;
+			int res = cqe->res;
+			uint32_t flags = cqe->flags;
+
+			// give back cqe slot before callbacks
+			muggle_atomic_store(ring->cq_head, head + 1, muggle_memory_order_release);
+
+			muggle_socket_event_io_uring_handle_cqe(ctx, user_data, res, flags);
+			++cnt;
+		}
+
+		tail = muggle_atomic_load(ring->cq_tail, muggle_memory_order_acquire);
+	}
+
+	return cnt;
+}
+
+/**
+ * @brief cancel all requests and wait them terminated, otherwise kernel
+ * release file of peers asynchronously after ring closed, e.g. listen
+ * address can't be bound again right after event loop exit
+ */
+static void muggle_socket_event_io_uring_drain(muggle_socket_event_io_uring_ctx_t *ctx)
+{
+	ctx->exiting = 1;
+
+	for (int retry = 0; retry < 100; retry++)
+	{
+		int cnt_armed = 0;
+		muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_get_node(ctx->mem_mgr);
+		while (node)
+		{
+			if (node->io_flags & MUGGLE_IO_URING_FLAG_ARMED)
+			{
+				++cnt_armed;
+				if (!(node->io_flags & MUGGLE_IO_URING_FLAG_CANCELED))
+				{
+					muggle_socket_event_io_uring_cancel(ctx, node);
+				}
+			}
+			node = node->next;
+		}
+
+		if (cnt_armed == 0)
+		{
+			break;
+		}
+
+		muggle_io_uring_enter(&ctx->ring, 1, 10);
+		muggle_socket_event_io_uring_reap(ctx);
+	}
+}
+
+int muggle_socket_event_io_uring(muggle_socket_event_t *ev)
+{
+	MUGGLE_LOG_TRACE("socket event io_uring run...");
+
+	muggle_socket_event_io_uring_ctx_t ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.ev = ev;
+	ctx.mem_mgr = (muggle_socket_event_memmgr_t*)ev->mem_mgr;
+
+	unsigned cq_entries = MUGGLE_IO_URING_CQ_ENTRIES;
+	if ((unsigned)ev->capacity * 2 > cq_entries)
+	{
+		cq_entries = (unsigned)ev->capacity * 2;
+	}
+	if (muggle_io_uring_setup(&ctx.ring, cq_entries) != 0 ||
+		muggle_io_uring_setup_buf_ring(&ctx.ring) != 0)
+	{
+		muggle_io_uring_destroy(&ctx.ring);
+		return -1;
+	}
+
+	// submit requests of input peers
+	muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_get_node(ctx.mem_mgr);
+	while (node)
+	{
+		muggle_socket_peer_list_node_t *next_node = node->next;
+
+		MUGGLE_ASSERT(((uintptr_t)node & MUGGLE_IO_URING_TAG_MASK) == 0);
+		node->peer.ev = ev;
+		node->recv_stash = NULL;
+		node->recv_stash_cap = 0;
+		node->io_flags = 0;
+		if (node->peer.peer_type == MUGGLE_SOCKET_PEER_TYPE_TCP_PEER)
+		{
+			node->peer.recv_data = s_muggle_io_uring_empty;
+			node->peer.recv_len = 0;
+		}
+
+		if (muggle_socket_event_io_uring_arm(&ctx, node) != 0)
+		{
+			node->peer.recv_data = NULL;
+			muggle_socket_event_memmgr_recycle(ctx.mem_mgr, node);
+		}
+		else
+		{
+			++ctx.cnt_fd;
+		}
+
+		node = next_node;
+	}
+
+	if (muggle_socket_event_timer_init(ev) != 0)
+	{
+		muggle_socket_event_io_uring_drain(&ctx);
+		muggle_io_uring_destroy(&ctx.ring);
+		return -1;
+	}
+
+	while (1)
+	{
+		int timeout = muggle_socket_event_timer_timeout(ev);
+		int ret = muggle_io_uring_enter(&ctx.ring, timeout == 0 ? 0 : 1, timeout);
+		if (ret < 0 && errno != ETIME && errno != EINTR && errno != EBUSY)
+		{
+			char err_msg[1024];
+			muggle_socket_strerror(errno, err_msg, sizeof(err_msg));
+			MUGGLE_LOG_ERROR("failed io_uring_enter - %s", err_msg);
+			break;
+		}
+
+		int n = muggle_socket_event_io_uring_reap(&ctx);
+		muggle_socket_event_timer_update(ev, n);
+
+		if (ev->to_exit)
+		{
+			MUGGLE_LOG_INFO("exit event loop");
+			break;
+		}
+
+		muggle_socket_event_memmgr_clear(ctx.mem_mgr);
+	}
+
+	muggle_socket_event_timer_destroy(ev);
+	muggle_socket_event_io_uring_drain(&ctx);
+	muggle_io_uring_destroy(&ctx.ring);
+
+	// peers are closed by caller
+	node = muggle_socket_event_memmgr_get_node(ctx.mem_mgr);
+	while (node)
+	{
+		muggle_socket_event_io_uring_release_stash(node);
+		node->peer.recv_data = NULL;
+		node = node->next;
+	}
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,61 @@
+/******************************************************************************
+ *  @file         socket_event_io_uring.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - io_uring
+ *
+ * Use io_uring system calls directly, without liburing.
+ *   - tcp listen peer: multishot accept
+ *   - tcp peer: multishot recv into provided buffer ring, received bytes are
+ *     exposed by peer->recv_data, user read them by muggle_socket_peer_recv
+ *     in on_message, bytes not read are kept for next on_message
+ *   - udp peer: multishot poll, user read it in on_message as usual
+ * Requests of one loop iteration are submitted together with waiting
+ * completions in a single io_uring_enter.
+ *
+ * require kernel >= 6.0, muggle_socket_event_io_uring return failed if
+ * io_uring or provided buffer ring is unavailable
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SOCKET_EVENT_IO_URING_H_
+#define MUGGLE_C_SOCKET_EVENT_IO_URING_H_
+
+#include "muggle/c/net/socket_event.h"
+
+#if MUGGLE_PLATFORM_LINUX && defined(__has_include)
+	#if __has_include(<linux/io_uring.h>)
+		#include <linux/io_uring.h>
+		#if defined(IORING_RECV_MULTISHOT)
+			#define MUGGLE_SOCKET_EVENT_HAS_IO_URING 1
+		#endif
+	#endif
+#endif
+
+#ifndef MUGGLE_SOCKET_EVENT_HAS_IO_URING
+	#define MUGGLE_SOCKET_EVENT_HAS_IO_URING 0
+#endif
+
+#if MUGGLE_SOCKET_EVENT_HAS_IO_URING
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief socket event - io_uring
+ *
+ * @param ev socket event
+ *
+ * @return
+ *     - 0: exit normally
+ *     - otherwise: failed setup io_uring, input peers are not touched, so
+ *       caller can run other event loop with ev
+ */
+int muggle_socket_event_io_uring(muggle_socket_event_t *ev);
+
+EXTERN_C_END
+
+#endif
+
+#endif
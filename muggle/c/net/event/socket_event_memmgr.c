@@ -12,6 +12,7 @@
 #include <string.h>
 #include "muggle/c/base/sleep.h"
 #include "muggle/c/log/log.h"
+#include "socket_event_timer.h"
 
 #if MUGGLE_ENABLE_TRACE
 
@@ -111,6 +112,16 @@ int muggle_socket_event_memmgr_init(
 		node->peer.ref_cnt = 1;
 		muggle_socket_set_nonblock(node->peer.fd, 1);
 		node->peer.status = MUGGLE_SOCKET_PEER_STATUS_ACTIVE;
+		node->peer.ev = ev;
+		node->peer.recv_data = NULL;
+		node->peer.recv_len = 0;
+		node->peer.send_buf = NULL;
+		node->peer.send_state = 0;
+		node->peer.recv_buf = NULL;
+		node->peer.timers = NULL;
+		node->recv_stash = NULL;
+		node->recv_stash_cap = 0;
+		node->io_flags = 0;
 
 		muggle_socket_event_memmgr_insert_node(&mgr->active_head, node);
 
@@ -153,6 +164,9 @@ void muggle_socket_event_memmgr_recycle(muggle_socket_event_memmgr_t *mgr, muggl
 
 	muggle_socket_event_memmgr_remove_node(node);
 
+	// timers are in wheel of event loop, remove them in loop thread
+	muggle_socket_event_peer_timer_clear(&node->peer);
+
 	int ref_cnt = muggle_socket_peer_release(&node->peer);
 	if (ref_cnt == 0)
 	{
@@ -11,6 +11,7 @@
 #ifndef MUGGLE_C_NET_SOCKET_EVENT_MEMMGR_H_
 #define MUGGLE_C_NET_SOCKET_EVENT_MEMMGR_H_
 
+#include <stddef.h>
 #include "muggle/c/net/socket_event.h"
 #include "muggle/c/memory/memory_pool.h"
 
@@ -25,8 +26,17 @@ typedef struct muggle_socket_peer_list_node
 	struct muggle_socket_peer_list_node *prev;
 	struct muggle_socket_peer_list_node *next;
 	muggle_socket_peer_t                peer;
+	char                                *recv_stash;    //!< io_uring: bytes user not read yet
+	size_t                              recv_stash_cap; //!< io_uring: capacity of recv_stash
+	int                                 io_flags;       //!< io_uring: state of request
 }muggle_socket_peer_list_node_t;
 
+/**
+ * @brief get list node of socket peer that allocated by memory manager
+ */
+#define MUGGLE_SOCKET_PEER_LIST_NODE(p) \
+	((muggle_socket_peer_list_node_t*)((char*)(p) - offsetof(muggle_socket_peer_list_node_t, peer)))
+
 /**
  * @brief socket event memory manager
  */
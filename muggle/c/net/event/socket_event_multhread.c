@@ -0,0 +1,624 @@
+/******************************************************************************
+ *  @file         socket_event_multhread.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - multiple reactor
+ *****************************************************************************/
+
+#include "socket_event_multhread.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/log/log.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/base/atomic.h"
+#include "socket_event_utils.h"
+#include "socket_event_memmgr.h"
+#include "socket_event_epoll.h"
+#include "socket_event_timer.h"
+
+#if MUGGLE_PLATFORM_LINUX
+
+#include <fcntl.h>
+
+/**
+ * @brief accepted socket handed off from acceptor to worker, write into
+ * pipe as a whole (smaller than PIPE_BUF, so it's atomic)
+ */
+typedef struct muggle_socket_event_handoff
+{
+	muggle_socket_t         fd;          //!< MUGGLE_INVALID_SOCKET means only wake up
+	muggle_socklen_t        addr_len;
+	struct sockaddr_storage addr;
+	muggle_socket_peer_t    listen_peer; //!< copy of listen peer, acceptor may recycle it before worker take over
+}muggle_socket_event_handoff_t;
+
+/**
+ * @brief epoll worker
+ */
+typedef struct muggle_socket_event_reactor
+{
+	muggle_socket_event_t        ev;          //!< event of worker, callbacks copied from main event
+	muggle_socket_event_memmgr_t mem_mgr;
+	muggle_thread_t              thread;
+	int                          pipe_fds[2]; //!< handoff pipe, acceptor write, worker read
+	int                          cnt_fd;      //!< peers in worker, only worker access
+}muggle_socket_event_reactor_t;
+
+/**
+ * @brief multiple reactor context, hang on main event
+ */
+typedef struct muggle_socket_event_multhread_ctx
+{
+	muggle_socket_event_reactor_t *workers;
+	int                           num_worker;
+	int                           next_worker; //!< round robin cursor, only acceptor access
+	int                           wake_fds[2]; //!< wake up acceptor
+}muggle_socket_event_multhread_ctx_t;
+
+static int muggle_socket_event_multhread_pipe(int fds[2])
+{
+	if (pipe(fds) != 0)
+	{
+		char err_msg[1024] = {0};
+		muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
+		MUGGLE_LOG_ERROR("failed create pipe - %s", err_msg);
+		return -1;
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL, 0) | O_NONBLOCK);
+		fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+	}
+
+	return 0;
+}
+
+static bool muggle_socket_event_multhread_to_exit(muggle_socket_event_t *ev)
+{
+	if (muggle_atomic_load(&ev->to_exit, muggle_memory_order_acquire))
+	{
+		return true;
+	}
+
+	return ev->main_ev && muggle_atomic_load(&ev->main_ev->to_exit, muggle_memory_order_acquire);
+}
+
+/**
+ * @brief worker take over accepted socket
+ */
+static void muggle_socket_event_multhread_take(
+	muggle_socket_event_reactor_t *reactor, muggle_socket_t epfd,
+	muggle_socket_event_handoff_t *handoff)
+{
+	muggle_socket_event_t *ev = &reactor->ev;
+
+	muggle_socket_peer_list_node_t *node = NULL;
+	if (reactor->cnt_fd < ev->capacity)
+	{
+		node = muggle_socket_event_memmgr_allocate(&reactor->mem_mgr);
+	}
+	if (node == NULL)
+	{
+		MUGGLE_LOG_WARNING("refuse connection - number of connection in worker reached the upper limit");
+		muggle_socket_close(handoff->fd);
+		return;
+	}
+
+	muggle_socket_peer_t *peer = &node->peer;
+	peer->ref_cnt = 1;
+	peer->fd = handoff->fd;
+	peer->peer_type = MUGGLE_SOCKET_PEER_TYPE_TCP_PEER;
+	peer->status = MUGGLE_SOCKET_PEER_STATUS_ACTIVE;
+	memcpy(&peer->addr, &handoff->addr, handoff->addr_len);
+	peer->addr_len = handoff->addr_len;
+
+	if (muggle_socket_event_epoll_add(epfd, node) != 0)
+	{
+		muggle_socket_event_memmgr_recycle(&reactor->mem_mgr, node);
+		return;
+	}
+	reactor->cnt_fd++;
+
+	peer->ev = ev;
+	if (ev->on_connect)
+	{
+		ev->on_connect(ev, &handoff->listen_peer, peer);
+	}
+}
+
+static void muggle_socket_event_multhread_drain_pipe(
+	muggle_socket_event_reactor_t *reactor, muggle_socket_t epfd)
+{
+	muggle_socket_event_handoff_t handoff;
+	while (1)
+	{
+		ssize_t n = read(reactor->pipe_fds[0], &handoff, sizeof(handoff));
+		if (n != (ssize_t)sizeof(handoff))
+		{
+			if (n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+
+		if (handoff.fd != MUGGLE_INVALID_SOCKET)
+		{
+			muggle_socket_event_multhread_take(reactor, epfd, &handoff);
+		}
+	}
+}
+
+static muggle_thread_ret_t muggle_socket_event_multhread_worker(void *arg)
+{
+	muggle_socket_event_reactor_t *reactor = (muggle_socket_event_reactor_t*)arg;
+	muggle_socket_event_t *ev = &reactor->ev;
+
+	struct epoll_event *ret_epevs = (struct epoll_event*)malloc(ev->capacity * sizeof(struct epoll_event));
+	muggle_socket_t epfd = epoll_create(ev->capacity);
+	if (ret_epevs == NULL || epfd == MUGGLE_INVALID_SOCKET)
+	{
+		MUGGLE_LOG_ERROR("failed init socket event worker");
+		if (epfd != MUGGLE_INVALID_SOCKET)
+		{
+			close(epfd);
+		}
+		free(ret_epevs);
+		muggle_socket_event_loop_exit(ev);
+		return 0;
+	}
+	ev->loop_fd = epfd;
+
+	// handoff pipe, data.ptr of epoll event is reactor
+	struct epoll_event epev;
+	memset(&epev, 0, sizeof(epev));
+	epev.data.ptr = reactor;
+	epev.events = EPOLLIN;
+	epoll_ctl(epfd, EPOLL_CTL_ADD, reactor->pipe_fds[0], &epev);
+
+	// every worker owns its timer wheel, peer timers run in the worker
+	// thread that serve the peer
+	if (muggle_socket_event_timer_init(ev) != 0)
+	{
+		close(epfd);
+		free(ret_epevs);
+		muggle_socket_event_loop_exit(ev);
+		return 0;
+	}
+
+	while (1)
+	{
+		int timeout = muggle_socket_event_timer_timeout(ev);
+		int n = epoll_wait(epfd, ret_epevs, ev->capacity, timeout);
+		if (n > 0)
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				if (ret_epevs[i].data.ptr == reactor)
+				{
+					muggle_socket_event_multhread_drain_pipe(reactor, epfd);
+					continue;
+				}
+
+				muggle_socket_event_epoll_handle_peer(
+					ev, &reactor->mem_mgr, epfd,
+					(muggle_socket_peer_list_node_t*)ret_epevs[i].data.ptr,
+					ret_epevs[i].events, &reactor->cnt_fd);
+			}
+
+			muggle_socket_event_timer_update(ev, n);
+		}
+		else if (n == 0)
+		{
+			muggle_socket_event_timer_update(ev, n);
+		}
+		else
+		{
+			if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_INTR)
+			{
+				continue;
+			}
+
+			char err_msg[1024];
+			muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
+			MUGGLE_LOG_ERROR("failed epoll loop - %s", err_msg);
+
+			muggle_socket_event_loop_exit(ev);
+		}
+
+		if (muggle_socket_event_multhread_to_exit(ev))
+		{
+			break;
+		}
+
+		muggle_socket_event_memmgr_clear(&reactor->mem_mgr);
+	}
+
+	muggle_socket_event_timer_destroy(ev);
+	close(epfd);
+	free(ret_epevs);
+
+	// close peers of this worker in worker thread
+	muggle_socket_event_memmgr_destroy(&reactor->mem_mgr);
+
+	return 0;
+}
+
+/**
+ * @brief acceptor hand off accepted sockets to workers
+ */
+static void muggle_socket_event_multhread_accept(
+	muggle_socket_event_multhread_ctx_t *ctx, muggle_socket_peer_t *listen_peer)
+{
+	muggle_socket_event_handoff_t handoff;
+	memset(&handoff, 0, sizeof(handoff));
+
+	// listen peer is owned by acceptor, workers only see the copy, buffers
+	// and timers of it are not shared
+	memcpy(&handoff.listen_peer, listen_peer, sizeof(muggle_socket_peer_t));
+	handoff.listen_peer.recv_data = NULL;
+	handoff.listen_peer.recv_len = 0;
+	handoff.listen_peer.send_buf = NULL;
+	handoff.listen_peer.recv_buf = NULL;
+	handoff.listen_peer.timers = NULL;
+
+	while (1)
+	{
+		handoff.addr_len = sizeof(handoff.addr);
+		handoff.fd = accept(listen_peer->fd, (struct sockaddr*)&handoff.addr, &handoff.addr_len);
+		if (handoff.fd == MUGGLE_INVALID_SOCKET)
+		{
+			if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_INTR)
+			{
+				continue;
+			}
+			else if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_WOULDBLOCK)
+			{
+				break;
+			}
+
+			char err_msg[1024];
+			muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
+			MUGGLE_LOG_TRACE("failed accept - %s", err_msg);
+
+			muggle_socket_peer_close(listen_peer);
+			break;
+		}
+
+		muggle_socket_set_nonblock(handoff.fd, 1);
+
+		// round robin, skip worker that pipe is full
+		bool handed = false;
+		for (int i = 0; i < ctx->num_worker; i++)
+		{
+			muggle_socket_event_reactor_t *reactor = &ctx->workers[ctx->next_worker];
+			ctx->next_worker = (ctx->next_worker + 1) % ctx->num_worker;
+
+			ssize_t n = write(reactor->pipe_fds[1], &handoff, sizeof(handoff));
+			if (n == (ssize_t)sizeof(handoff))
+			{
+				handed = true;
+				break;
+			}
+		}
+
+		if (!handed)
+		{
+			MUGGLE_LOG_WARNING("refuse connection - all workers are busy");
+			muggle_socket_close(handoff.fd);
+		}
+	}
+}
+
+/**
+ * @brief wake up all workers, only invoked by acceptor when it stops
+ */
+static void muggle_socket_event_multhread_wake_workers(muggle_socket_event_multhread_ctx_t *ctx)
+{
+	muggle_socket_event_handoff_t handoff;
+	memset(&handoff, 0, sizeof(handoff));
+	handoff.fd = MUGGLE_INVALID_SOCKET;
+
+	// pipe full also wake up reader, ignore result
+	for (int i = 0; i < ctx->num_worker; i++)
+	{
+		if (ctx->workers[i].pipe_fds[1] == -1)
+		{
+			continue;
+		}
+		if (write(ctx->workers[i].pipe_fds[1], &handoff, sizeof(handoff)) < 0)
+		{
+			continue;
+		}
+	}
+}
+
+void muggle_socket_event_multhread_wake(muggle_socket_event_t *ev)
+{
+	// hold reference, acceptor don't release context until no one is
+	// waking it up
+	muggle_atomic_fetch_add(&ev->wake_ref, 1, muggle_memory_order_seq_cst);
+
+	muggle_socket_event_multhread_ctx_t *ctx = (muggle_socket_event_multhread_ctx_t*)
+		muggle_atomic_load(&ev->reactor, muggle_memory_order_seq_cst);
+	if (ctx)
+	{
+		char c = 0;
+		if (write(ctx->wake_fds[1], &c, sizeof(c)) < 0)
+		{
+			// pipe full, acceptor already has been woken up
+		}
+	}
+
+	muggle_atomic_fetch_sub(&ev->wake_ref, 1, muggle_memory_order_seq_cst);
+}
+
+static void muggle_socket_event_multhread_close_pipe(int fds[2])
+{
+	for (int i = 0; i < 2; i++)
+	{
+		if (fds[i] != -1)
+		{
+			close(fds[i]);
+			fds[i] = -1;
+		}
+	}
+}
+
+/**
+ * @brief stop and release workers [0, cnt)
+ */
+static void muggle_socket_event_multhread_stop(
+	muggle_socket_event_t *ev, muggle_socket_event_multhread_ctx_t *ctx, int cnt)
+{
+	// unpublish context and wait for threads that still write wake pipe
+	muggle_atomic_store(&ev->reactor, NULL, muggle_memory_order_seq_cst);
+	while (muggle_atomic_load(&ev->wake_ref, muggle_memory_order_seq_cst) != 0)
+	{
+		muggle_thread_yield();
+	}
+
+	muggle_atomic_store(&ev->to_exit, 1, muggle_memory_order_release);
+	muggle_socket_event_multhread_wake_workers(ctx);
+
+	for (int i = 0; i < cnt; i++)
+	{
+		muggle_thread_join(&ctx->workers[i].thread);
+	}
+
+	for (int i = 0; i < ctx->num_worker; i++)
+	{
+		muggle_socket_event_reactor_t *reactor = &ctx->workers[i];
+
+		// close sockets still in pipe
+		if (reactor->pipe_fds[0] != -1)
+		{
+			muggle_socket_event_handoff_t handoff;
+			while (read(reactor->pipe_fds[0], &handoff, sizeof(handoff)) == (ssize_t)sizeof(handoff))
+			{
+				if (handoff.fd != MUGGLE_INVALID_SOCKET)
+				{
+					muggle_socket_close(handoff.fd);
+				}
+			}
+		}
+		muggle_socket_event_multhread_close_pipe(reactor->pipe_fds);
+	}
+
+	muggle_socket_event_multhread_close_pipe(ctx->wake_fds);
+	free(ctx->workers);
+	free(ctx);
+}
+
+/**
+ * @brief create context and start workers
+ */
+static muggle_socket_event_multhread_ctx_t* muggle_socket_event_multhread_start(muggle_socket_event_t *ev)
+{
+	muggle_socket_event_multhread_ctx_t *ctx =
+		(muggle_socket_event_multhread_ctx_t*)malloc(sizeof(muggle_socket_event_multhread_ctx_t));
+	if (ctx == NULL)
+	{
+		return NULL;
+	}
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->wake_fds[0] = ctx->wake_fds[1] = -1;
+
+	ctx->num_worker = ev->num_worker > 0 ? ev->num_worker : 1;
+	ctx->workers = (muggle_socket_event_reactor_t*)malloc(
+		sizeof(muggle_socket_event_reactor_t) * ctx->num_worker);
+	if (ctx->workers == NULL)
+	{
+		free(ctx);
+		return NULL;
+	}
+	for (int i = 0; i < ctx->num_worker; i++)
+	{
+		memset(&ctx->workers[i], 0, sizeof(muggle_socket_event_reactor_t));
+		ctx->workers[i].pipe_fds[0] = ctx->workers[i].pipe_fds[1] = -1;
+	}
+
+	if (muggle_socket_event_multhread_pipe(ctx->wake_fds) != 0)
+	{
+		muggle_socket_event_multhread_stop(ev, ctx, 0);
+		return NULL;
+	}
+
+	// publish context after wake pipe is ready
+	muggle_atomic_store(&ev->reactor, ctx, muggle_memory_order_seq_cst);
+
+	// workers don't own input peers
+	muggle_socket_event_init_arg_t worker_init_arg;
+	memset(&worker_init_arg, 0, sizeof(worker_init_arg));
+
+	for (int i = 0; i < ctx->num_worker; i++)
+	{
+		muggle_socket_event_reactor_t *reactor = &ctx->workers[i];
+
+		memcpy(&reactor->ev, ev, sizeof(muggle_socket_event_t));
+		reactor->ev.to_exit = 0;
+		reactor->ev.mem_mgr = &reactor->mem_mgr;
+		reactor->ev.main_ev = ev;
+		reactor->ev.reactor = NULL;
+		reactor->ev.wake_ref = 0;
+		reactor->ev.num_worker = 0;
+		reactor->ev.timers = NULL;
+
+		// on_timer only run in acceptor, workers block until events or
+		// peer timers expired
+		reactor->ev.on_timer = NULL;
+		reactor->ev.timeout_ms = -1;
+
+		if (muggle_socket_event_multhread_pipe(reactor->pipe_fds) != 0 ||
+			muggle_socket_event_memmgr_init(&reactor->ev, &worker_init_arg, &reactor->mem_mgr) != 0)
+		{
+			muggle_socket_event_multhread_stop(ev, ctx, i);
+			return NULL;
+		}
+
+		if (muggle_thread_create(&reactor->thread, muggle_socket_event_multhread_worker, reactor) != 0)
+		{
+			MUGGLE_LOG_ERROR("failed create socket event worker thread");
+			muggle_socket_event_memmgr_destroy(&reactor->mem_mgr);
+			muggle_socket_event_multhread_stop(ev, ctx, i);
+			return NULL;
+		}
+	}
+
+	return ctx;
+}
+
+int muggle_socket_event_multhread(muggle_socket_event_t *ev)
+{
+	MUGGLE_LOG_TRACE("socket event multhread run...");
+
+	muggle_socket_event_memmgr_t *p_mem_mgr = (muggle_socket_event_memmgr_t*)ev->mem_mgr;
+
+	struct epoll_event *ret_epevs = (struct epoll_event*)malloc(ev->capacity * sizeof(struct epoll_event));
+	if (ret_epevs == NULL)
+	{
+		return -1;
+	}
+
+	muggle_socket_t epfd = epoll_create(ev->capacity);
+	if (epfd == MUGGLE_INVALID_SOCKET)
+	{
+		char err_msg[1024] = {0};
+		muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
+		MUGGLE_LOG_ERROR("failed epoll_create - %s", err_msg);
+
+		free(ret_epevs);
+		return -1;
+	}
+
+	muggle_socket_event_multhread_ctx_t *ctx = muggle_socket_event_multhread_start(ev);
+	if (ctx == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed start socket event workers");
+		close(epfd);
+		free(ret_epevs);
+		return -1;
+	}
+	ev->loop_fd = epfd;
+
+	// wake pipe, data.ptr of epoll event is ctx
+	struct epoll_event epev;
+	memset(&epev, 0, sizeof(epev));
+	epev.data.ptr = ctx;
+	epev.events = EPOLLIN;
+	epoll_ctl(epfd, EPOLL_CTL_ADD, ctx->wake_fds[0], &epev);
+
+	// input peers served by acceptor
+	int cnt_fd = 0;
+	muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_get_node(p_mem_mgr);
+	while (node)
+	{
+		muggle_socket_peer_list_node_t *next_node = node->next;
+		if (muggle_socket_event_epoll_add(epfd, node) != 0)
+		{
+			muggle_socket_event_memmgr_recycle(p_mem_mgr, node);
+		}
+		else
+		{
+			node->peer.ev = ev;
+			++cnt_fd;
+		}
+		node = next_node;
+	}
+
+	if (muggle_socket_event_timer_init(ev) != 0)
+	{
+		muggle_socket_event_multhread_stop(ev, ctx, ctx->num_worker);
+		close(epfd);
+		free(ret_epevs);
+		return -1;
+	}
+
+	while (!muggle_socket_event_multhread_to_exit(ev))
+	{
+		int timeout = muggle_socket_event_timer_timeout(ev);
+		int n = epoll_wait(epfd, ret_epevs, ev->capacity, timeout);
+		if (n > 0)
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				if (ret_epevs[i].data.ptr == ctx)
+				{
+					char buf[64];
+					while (read(ctx->wake_fds[0], buf, sizeof(buf)) > 0);
+					continue;
+				}
+
+				muggle_socket_peer_list_node_t *node = (muggle_socket_peer_list_node_t*)ret_epevs[i].data.ptr;
+				if ((ret_epevs[i].events & EPOLLIN) &&
+					node->peer.peer_type == MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN)
+				{
+					muggle_socket_event_multhread_accept(ctx, &node->peer);
+
+					// listen peer closed when failed accept
+					muggle_socket_event_epoll_handle_peer(ev, p_mem_mgr, epfd, node, 0, &cnt_fd);
+					continue;
+				}
+
+				muggle_socket_event_epoll_handle_peer(ev, p_mem_mgr, epfd, node, ret_epevs[i].events, &cnt_fd);
+			}
+
+			muggle_socket_event_timer_update(ev, n);
+		}
+		else if (n == 0)
+		{
+			muggle_socket_event_timer_update(ev, n);
+		}
+		else
+		{
+			if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_INTR)
+			{
+				continue;
+			}
+
+			char err_msg[1024];
+			muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
+			MUGGLE_LOG_ERROR("failed epoll loop - %s", err_msg);
+
+			break;
+		}
+
+		muggle_socket_event_memmgr_clear(p_mem_mgr);
+	}
+
+	MUGGLE_LOG_INFO("exit event loop");
+
+	muggle_socket_event_multhread_stop(ev, ctx, ctx->num_worker);
+
+	muggle_socket_event_timer_destroy(ev);
+	close(epfd);
+	free(ret_epevs);
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,51 @@
+/******************************************************************************
+ *  @file         socket_event_multhread.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - multiple reactor
+ *
+ * Thread of event loop is the acceptor, it serve input peers (listen, udp
+ * and so on). Accepted peers are handed off round robin to N epoll worker
+ * threads through pipe, every worker owns its memory manager and peers,
+ * callbacks of peer are invoked in the worker with event of the worker, so
+ * one peer is always served by one thread.
+ * on_timer is invoked in acceptor and every worker.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SOCKET_EVENT_MULTHREAD_H_
+#define MUGGLE_C_SOCKET_EVENT_MULTHREAD_H_
+
+#include "muggle/c/net/socket_event.h"
+
+#if MUGGLE_PLATFORM_LINUX
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief socket event - multiple reactor
+ *
+ * @param ev socket event
+ *
+ * @return 0 - exit normally, otherwise failed start workers
+ */
+int muggle_socket_event_multhread(muggle_socket_event_t *ev);
+
+/**
+ * @brief wake acceptor, let it check exit flag, acceptor wake up
+ * workers when it stops
+ *
+ * @note safe to be invoked from any thread while loop is running or
+ * stopping, do nothing when workers context is released
+ *
+ * @param ev main socket event
+ */
+void muggle_socket_event_multhread_wake(muggle_socket_event_t *ev);
+
+EXTERN_C_END
+
+#endif
+
+#endif
@@ -14,6 +14,7 @@
 #include "muggle/c/log/log.h"
 #include "socket_event_utils.h"
 #include "socket_event_memmgr.h"
+#include "socket_event_timer.h"
 
 static void muggle_socket_event_poll_listen(
 	muggle_socket_event_t *ev,
@@ -119,17 +120,18 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 		node = node->next;
 	}
 
-	// set timeout
-	int timeout = ev->timeout_ms;
-
-	struct timespec t1, t2;
-	if (ev->timeout_ms > 0)
+	// timer
+	if (muggle_socket_event_timer_init(ev) != 0)
 	{
-		timespec_get(&t1, TIME_UTC);
+		free(fds);
+		free(p_nodes);
+		muggle_socket_event_memmgr_destroy(p_mem_mgr);
+		return;
 	}
 
 	while (1)
 	{
+		int timeout = muggle_socket_event_timer_timeout(ev);
 #if MUGGLE_PLATFORM_WINDOWS
 		int n = WSAPoll(fds, cnt_fd, timeout);
 #else
@@ -197,16 +199,13 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 				}
 			}
 
-			// when loop is busy, timeout will not trigger, use
-			// customize timer handle avoid that
-			if (ev->timeout_ms > 0)
-			{
-				muggle_socket_event_timer_handle(ev, &t1, &t2);
-			}
+			// when loop is busy, timeout will not trigger, so always
+			// check timers after events handled
+			muggle_socket_event_timer_update(ev, n);
 		}
 		else if (n == 0)
 		{
-			muggle_socket_event_timer_handle(ev, &t1, &t2);
+			muggle_socket_event_timer_update(ev, n);
 		}
 		else
 		{
@@ -234,6 +233,7 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 	}
 
 	// free memory
+	muggle_socket_event_timer_destroy(ev);
 	free(fds);
 	free(p_nodes);
 }
@@ -14,6 +14,7 @@
 #include "muggle/c/memory/memory_pool.h"
 #include "socket_event_utils.h"
 #include "socket_event_memmgr.h"
+#include "socket_event_timer.h"
 
 static void muggle_socket_event_select_listen(
 	muggle_socket_event_t *ev,
@@ -75,26 +76,13 @@ void muggle_socket_event_select(muggle_socket_event_t *ev)
 	// get memory manager
 	muggle_socket_event_memmgr_t *p_mem_mgr = (muggle_socket_event_memmgr_t*)ev->mem_mgr;
 
-	// set timeout
-	struct timeval timeout, save_timeout;
-	struct timeval *p_timeout = &timeout;
-	memset(&timeout, 0, sizeof(timeout));
-	if (ev->timeout_ms < 0)
+	// timer
+	if (muggle_socket_event_timer_init(ev) != 0)
 	{
-		p_timeout = NULL;
-	}
-	else if (ev->timeout_ms > 0)
-	{
-		timeout.tv_sec = ev->timeout_ms / 1000;
-		timeout.tv_usec = (ev->timeout_ms % 1000) * 1000;
-		memcpy(&save_timeout, &timeout, sizeof(struct timeval));
-	}
-
-	struct timespec t1, t2;
-	if (ev->timeout_ms > 0)
-	{
-		timespec_get(&t1, TIME_UTC);
+		muggle_socket_event_memmgr_destroy(p_mem_mgr);
+		return;
 	}
+	struct timeval timeout;
 
 	// set fds
 	int nfds = 0;
@@ -117,10 +105,14 @@ void muggle_socket_event_select(muggle_socket_event_t *ev)
 
 	while (1)
 	{
-		// reset timeout
-		if (p_timeout)
+		// set timeout
+		struct timeval *p_timeout = NULL;
+		int timeout_ms = muggle_socket_event_timer_timeout(ev);
+		if (timeout_ms >= 0)
 		{
-			memcpy(&timeout, &save_timeout, sizeof(struct timeval));
+			timeout.tv_sec = timeout_ms / 1000;
+			timeout.tv_usec = (timeout_ms % 1000) * 1000;
+			p_timeout = &timeout;
 		}
 
 		// select loop
@@ -179,16 +171,13 @@ void muggle_socket_event_select(muggle_socket_event_t *ev)
 				}
 			}
 
-			// when loop is busy, timeout will not trigger, use
-			// customize timer handle avoid that
-			if (ev->timeout_ms > 0)
-			{
-				muggle_socket_event_timer_handle(ev, &t1, &t2);
-			}
+			// when loop is busy, timeout will not trigger, so always
+			// check timers after events handled
+			muggle_socket_event_timer_update(ev, n);
 		}
 		else if (n == 0)
 		{
-			muggle_socket_event_timer_handle(ev, &t1, &t2);
+			muggle_socket_event_timer_update(ev, n);
 		}
 		else
 		{
@@ -214,4 +203,6 @@ void muggle_socket_event_select(muggle_socket_event_t *ev)
 		// recycle node
 		muggle_socket_event_memmgr_clear(p_mem_mgr);
 	}
+
+	muggle_socket_event_timer_destroy(ev);
 }
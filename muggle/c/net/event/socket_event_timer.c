@@ -0,0 +1,264 @@
+/******************************************************************************
+ *  @file         socket_event_timer.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - timers
+ *****************************************************************************/
+
+#include "socket_event_timer.h"
+#include <stdlib.h>
+#include <limits.h>
+#if !MUGGLE_PLATFORM_WINDOWS
+#include <time.h>
+#endif
+#include "muggle/c/log/log.h"
+
+/**
+ * @brief monotonic clock in millisecond
+ */
+static uint64_t muggle_socket_event_timer_now_ms()
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	return (uint64_t)GetTickCount64();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#endif
+}
+
+/**
+ * @brief get timers context of the loop that peer belongs to
+ */
+static muggle_socket_event_timer_ctx_t* muggle_socket_event_timer_ctx(muggle_socket_peer_t *peer)
+{
+	if (peer->ev == NULL || peer->ev->timers == NULL)
+	{
+		return NULL;
+	}
+
+	return (muggle_socket_event_timer_ctx_t*)peer->ev->timers;
+}
+
+/**
+ * @brief convert delay since now into delay since current time of wheel
+ *
+ * clock of wheel only move after events dispatched, timer added or reset
+ * in callbacks would expire early if delay is based on it
+ */
+static uint64_t muggle_socket_event_timer_delay(muggle_socket_event_timer_ctx_t *ctx, int delay_ms)
+{
+	uint64_t delay = delay_ms > 0 ? (uint64_t)delay_ms : 0;
+
+	ctx->now_ms = muggle_socket_event_timer_now_ms();
+	if (ctx->wheel.cnt == 0)
+	{
+		// wheel doesn't read clock when no timer, nothing expire in it
+		muggle_timer_wheel_advance(&ctx->wheel, ctx->now_ms);
+	}
+
+	uint64_t wheel_ms = ctx->wheel.current * ctx->wheel.tick_ms;
+	if (ctx->now_ms > wheel_ms)
+	{
+		delay += ctx->now_ms - wheel_ms;
+	}
+
+	return delay;
+}
+
+static void muggle_socket_event_timer_on_expire(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	(void)wheel;
+
+	muggle_socket_event_t *ev = (muggle_socket_event_t*)timer->data;
+	if (ev->on_timer)
+	{
+		ev->on_timer(ev);
+	}
+}
+
+static void muggle_socket_peer_timer_on_expire(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	muggle_socket_peer_timer_t *peer_timer = (muggle_socket_peer_timer_t*)timer;
+	muggle_socket_peer_t *peer = peer_timer->peer;
+	if (peer->status != MUGGLE_SOCKET_PEER_STATUS_ACTIVE)
+	{
+		// stop periodic timer, peer will be removed soon
+		muggle_timer_wheel_cancel(wheel, timer);
+		return;
+	}
+
+	peer_timer->cb(peer->ev, peer, peer_timer);
+}
+
+int muggle_socket_event_timer_init(muggle_socket_event_t *ev)
+{
+	muggle_socket_event_timer_ctx_t *ctx =
+		(muggle_socket_event_timer_ctx_t*)malloc(sizeof(muggle_socket_event_timer_ctx_t));
+	if (ctx == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed allocate memory for socket event timer wheel");
+		ev->timers = NULL;
+		return -1;
+	}
+
+	ctx->now_ms = muggle_socket_event_timer_now_ms();
+	muggle_timer_wheel_init(&ctx->wheel, 1, ctx->now_ms);
+
+	muggle_timer_wheel_timer_init(&ctx->ev_timer, muggle_socket_event_timer_on_expire, ev);
+	if (ev->timeout_ms > 0)
+	{
+		muggle_timer_wheel_add(&ctx->wheel, &ctx->ev_timer, ev->timeout_ms, ev->timeout_ms);
+	}
+
+	ev->timers = ctx;
+
+	return 0;
+}
+
+void muggle_socket_event_timer_destroy(muggle_socket_event_t *ev)
+{
+	if (ev->timers)
+	{
+		free(ev->timers);
+		ev->timers = NULL;
+	}
+}
+
+int muggle_socket_event_timer_timeout(muggle_socket_event_t *ev)
+{
+	if (ev->timeout_ms == 0)
+	{
+		return 0;
+	}
+
+	muggle_socket_event_timer_ctx_t *ctx = (muggle_socket_event_timer_ctx_t*)ev->timers;
+	int64_t timeout = muggle_timer_wheel_next_timeout(&ctx->wheel, ctx->now_ms);
+	if (timeout > INT_MAX)
+	{
+		timeout = INT_MAX;
+	}
+
+	return (int)timeout;
+}
+
+void muggle_socket_event_timer_update(muggle_socket_event_t *ev, int n)
+{
+	// never block, invoke on_timer when no event
+	if (ev->timeout_ms == 0 && n == 0 && ev->on_timer)
+	{
+		ev->on_timer(ev);
+	}
+
+	muggle_socket_event_timer_ctx_t *ctx = (muggle_socket_event_timer_ctx_t*)ev->timers;
+	if (ctx->wheel.cnt == 0)
+	{
+		return;
+	}
+
+	ctx->now_ms = muggle_socket_event_timer_now_ms();
+	muggle_timer_wheel_advance(&ctx->wheel, ctx->now_ms);
+}
+
+void muggle_socket_event_peer_timer_clear(muggle_socket_peer_t *peer)
+{
+	muggle_socket_event_timer_ctx_t *ctx = NULL;
+	if (peer->ev)
+	{
+		ctx = (muggle_socket_event_timer_ctx_t*)peer->ev->timers;
+	}
+
+	muggle_socket_peer_timer_t *timer = peer->timers;
+	while (timer)
+	{
+		muggle_socket_peer_timer_t *next = timer->next;
+
+		// wheel already destroyed when loop exit
+		if (ctx)
+		{
+			muggle_timer_wheel_cancel(&ctx->wheel, &timer->timer);
+		}
+		free(timer);
+
+		timer = next;
+	}
+	peer->timers = NULL;
+}
+
+muggle_socket_peer_timer_t* muggle_socket_peer_timer_add(
+	muggle_socket_peer_t *peer, int delay_ms, int interval_ms,
+	muggle_socket_event_peer_timer cb, void *data)
+{
+	muggle_socket_event_timer_ctx_t *ctx = muggle_socket_event_timer_ctx(peer);
+	if (ctx == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed add peer timer: peer not in running event loop");
+		return NULL;
+	}
+
+	muggle_socket_peer_timer_t *timer = (muggle_socket_peer_timer_t*)malloc(sizeof(muggle_socket_peer_timer_t));
+	if (timer == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed allocate memory for peer timer");
+		return NULL;
+	}
+
+	muggle_timer_wheel_timer_init(&timer->timer, muggle_socket_peer_timer_on_expire, NULL);
+	timer->peer = peer;
+	timer->interval_ms = interval_ms > 0 ? interval_ms : 0;
+	timer->cb = cb;
+	timer->data = data;
+
+	timer->prev = NULL;
+	timer->next = peer->timers;
+	if (peer->timers)
+	{
+		peer->timers->prev = timer;
+	}
+	peer->timers = timer;
+
+	muggle_timer_wheel_add(&ctx->wheel, &timer->timer,
+		muggle_socket_event_timer_delay(ctx, delay_ms), (uint64_t)timer->interval_ms);
+
+	return timer;
+}
+
+void muggle_socket_peer_timer_reset(muggle_socket_peer_timer_t *timer, int delay_ms)
+{
+	muggle_socket_event_timer_ctx_t *ctx = muggle_socket_event_timer_ctx(timer->peer);
+	if (ctx == NULL)
+	{
+		return;
+	}
+
+	muggle_timer_wheel_add(&ctx->wheel, &timer->timer,
+		muggle_socket_event_timer_delay(ctx, delay_ms), (uint64_t)timer->interval_ms);
+}
+
+void muggle_socket_peer_timer_cancel(muggle_socket_peer_timer_t *timer)
+{
+	muggle_socket_peer_t *peer = timer->peer;
+	if (peer->ev && peer->ev->timers)
+	{
+		muggle_socket_event_timer_ctx_t *ctx = (muggle_socket_event_timer_ctx_t*)peer->ev->timers;
+		muggle_timer_wheel_cancel(&ctx->wheel, &timer->timer);
+	}
+
+	if (timer->prev)
+	{
+		timer->prev->next = timer->next;
+	}
+	else
+	{
+		peer->timers = timer->next;
+	}
+	if (timer->next)
+	{
+		timer->next->prev = timer->prev;
+	}
+
+	free(timer);
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ *  @file         socket_event_timer.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec socket event - timers
+ *
+ * Every running event loop owns a timer wheel, on_timer of event (when
+ * timeout_ms > 0) and timers of peers are all in it. Wait timeout of
+ * event loop is the next expire of wheel, and clock is only read after
+ * wait when wheel is not empty.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_NET_SOCKET_EVENT_TIMER_H_
+#define MUGGLE_C_NET_SOCKET_EVENT_TIMER_H_
+
+#include "muggle/c/net/socket_event.h"
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief timers context of running event loop
+ */
+typedef struct muggle_socket_event_timer_ctx
+{
+	muggle_timer_wheel_t       wheel;
+	uint64_t                   now_ms;   //!< time of last update
+	muggle_timer_wheel_timer_t ev_timer; //!< periodic timer of on_timer
+}muggle_socket_event_timer_ctx_t;
+
+/**
+ * @brief create timer wheel of event loop
+ *
+ * @param ev  socket event
+ *
+ * @return 0 - success, otherwise failed
+ */
+int muggle_socket_event_timer_init(muggle_socket_event_t *ev);
+
+/**
+ * @brief destroy timer wheel of event loop, timers of peers are freed
+ * when peers removed from memory manager
+ *
+ * @param ev  socket event
+ */
+void muggle_socket_event_timer_destroy(muggle_socket_event_t *ev);
+
+/**
+ * @brief get timeout of next wait
+ *
+ * @param ev  socket event
+ *
+ * @return timeout in millisecond, -1 means wait forever
+ */
+int muggle_socket_event_timer_timeout(muggle_socket_event_t *ev);
+
+/**
+ * @brief invoke callbacks of expired timers, call it after every wait
+ *
+ * @param ev  socket event
+ * @param n   number of ready descriptors returned by wait
+ */
+void muggle_socket_event_timer_update(muggle_socket_event_t *ev, int n);
+
+/**
+ * @brief cancel and free all timers of peer
+ *
+ * @param peer  socket peer
+ */
+void muggle_socket_event_peer_timer_clear(muggle_socket_peer_t *peer);
+
+EXTERN_C_END
+
+#endif
@@ -11,10 +11,17 @@
 #include "socket_event_utils.h"
 #include <stdio.h>
 #include "muggle/c/log/log.h"
+#include "socket_event_memmgr.h"
+#include "socket_event_epoll.h"
+#include "socket_event_frame.h"
 
 void muggle_socket_event_on_message(muggle_socket_event_t *ev, muggle_socket_peer_t *peer)
 {
-	if (ev->on_message)
+	if (ev->on_frame && peer->peer_type == MUGGLE_SOCKET_PEER_TYPE_TCP_PEER)
+	{
+		muggle_socket_event_frame_recv(ev, peer);
+	}
+	else if (ev->on_message)
 	{
 		ev->on_message(ev, peer);
 	}
@@ -33,21 +40,31 @@ void muggle_socket_event_on_message(muggle_socket_event_t *ev, muggle_socket_pee
 	}
 }
 
-void muggle_socket_event_timer_handle(muggle_socket_event_t *ev, struct timespec *t1, struct timespec *t2)
+int muggle_socket_event_watch_write(muggle_socket_peer_t *peer, int enable)
 {
-	timespec_get(t2, TIME_UTC);
-	int interval_ms =
-		(int)((t2->tv_sec - t1->tv_sec) * 1000 +
-		(t2->tv_nsec - t1->tv_nsec) / 1000000);
-	if (interval_ms >= ev->timeout_ms)
+	muggle_socket_event_t *ev = peer->ev;
+	if (ev == NULL)
+	{
+		return -1;
+	}
+
+	switch (ev->ev_loop_type)
 	{
-		if (ev->on_timer)
+#if MUGGLE_PLATFORM_LINUX
+	case MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL:
+	case MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD:
 		{
-			ev->on_timer(ev);
-		}
-		t1->tv_sec = t2->tv_sec;
-		t1->tv_nsec = t2->tv_nsec;
+			return muggle_socket_event_epoll_watch_write(
+				ev->loop_fd, MUGGLE_SOCKET_PEER_LIST_NODE(peer), enable);
+		}break;
+#endif
+	default:
+		{
+			MUGGLE_LOG_ERROR("event loop type %d not support watch writable event", ev->ev_loop_type);
+		}break;
 	}
+
+	return -1;
 }
 
 void muggle_socket_event_accept(muggle_socket_peer_t *listen_peer, muggle_socket_peer_t *peer)
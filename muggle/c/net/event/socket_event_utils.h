@@ -11,7 +11,6 @@
 #ifndef MUGGLE_C_NET_SOCKET_EVENT_UTILS_H_
 #define MUGGLE_C_NET_SOCKET_EVENT_UTILS_H_
 
-#include <time.h>
 #include "muggle/c/net/socket_event.h"
 #include "muggle/c/memory/memory_pool.h"
 
@@ -26,13 +25,14 @@ EXTERN_C_BEGIN
 void muggle_socket_event_on_message(muggle_socket_event_t *ev, muggle_socket_peer_t *peer);
 
 /**
- * @brief socket event timer handle
+ * @brief enable or disable writable event of peer
  *
- * @param ev  socket event
- * @param t1  last timestamp
- * @param t2  current timestamp
+ * @param peer    socket peer in event loop
+ * @param enable  1 - watch writable event, 0 - stop watch
+ *
+ * @return 0 - success, otherwise failed
  */
-void muggle_socket_event_timer_handle(muggle_socket_event_t *ev, struct timespec *t1, struct timespec *t2);
+int muggle_socket_event_watch_write(muggle_socket_peer_t *peer, int enable);
 
 /**
  * @brief event listen peer accept
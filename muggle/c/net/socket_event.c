@@ -12,15 +12,27 @@
 #include <stdlib.h>
 #include <string.h>
 #include "muggle/c/log/log.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/base/atomic.h"
 #include "event/socket_event_memmgr.h"
 #include "event/socket_event_select.h"
 #include "event/socket_event_poll.h"
 #include "event/socket_event_epoll.h"
+#include "event/socket_event_multhread.h"
+#include "event/socket_event_io_uring.h"
 
 static int muggle_get_event_loop_type(int event_loop_type)
 {
 #if !MUGGLE_PLATFORM_LINUX
-	if (event_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL)
+	if (event_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL ||
+		event_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD)
+	{
+		event_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_NULL;
+	}
+#endif
+
+#if !MUGGLE_SOCKET_EVENT_HAS_IO_URING
+	if (event_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_IO_URING)
 	{
 		event_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_NULL;
 	}
@@ -105,12 +117,82 @@ static int muggle_socket_ev_arg_init(muggle_socket_event_init_arg_t *ev_init_arg
 	ev->to_exit = 0;
 	ev->datas = ev_init_arg->datas;
 
+	// set worker threads
+	if (ev->ev_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD)
+	{
+		ev->num_worker = ev_init_arg->num_worker;
+		if (ev->num_worker <= 0)
+		{
+			ev->num_worker = muggle_thread_hardware_concurrency();
+		}
+		if (ev->num_worker <= 0)
+		{
+			ev->num_worker = 1;
+		}
+	}
+
+	// set peer outbound queue, need writable event
+	ev->loop_fd = MUGGLE_INVALID_SOCKET;
+	if (ev_init_arg->send_buf_capacity > 0)
+	{
+		if (ev->ev_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL ||
+			ev->ev_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD)
+		{
+			ev->send_buf_capacity = ev_init_arg->send_buf_capacity;
+			ev->send_high_water = ev_init_arg->send_high_water;
+			if (ev->send_high_water <= 0 || ev->send_high_water > ev->send_buf_capacity)
+			{
+				ev->send_high_water = ev->send_buf_capacity / 2;
+			}
+		}
+		else
+		{
+			MUGGLE_LOG_WARNING("peer outbound queue only support epoll and multhread event loop");
+		}
+	}
+
+	// set peer receive buffer and framing
+	if (ev_init_arg->on_frame)
+	{
+		ev->recv_buf_capacity = ev_init_arg->recv_buf_capacity;
+		if (ev->recv_buf_capacity <= 0)
+		{
+			ev->recv_buf_capacity = MUGGLE_SOCKET_EVENT_DEFAULT_RECV_BUF_CAPACITY;
+		}
+
+		ev->frame_decode = ev_init_arg->frame_decode;
+		memcpy(&ev->length_field, &ev_init_arg->length_field, sizeof(ev->length_field));
+		if (ev->length_field.size == 0)
+		{
+			ev->length_field.size = 4;
+		}
+		if (ev->length_field.max_frame <= 0 || ev->length_field.max_frame > ev->recv_buf_capacity)
+		{
+			ev->length_field.max_frame = ev->recv_buf_capacity;
+		}
+
+		if (ev->frame_decode == NULL)
+		{
+			int size = ev->length_field.size;
+			if ((size != 1 && size != 2 && size != 4 && size != 8) ||
+				ev->length_field.offset < 0 ||
+				ev->length_field.offset + size > MUGGLE_SOCKET_EVENT_LENGTH_FIELD_MAX_END)
+			{
+				MUGGLE_LOG_ERROR("invalid length field: offset=%d, size=%d",
+					ev->length_field.offset, size);
+				return -1;
+			}
+		}
+	}
+
 	// set callbacks
 	ev->on_connect = ev_init_arg->on_connect;
 	ev->on_error = ev_init_arg->on_error;
 	ev->on_close = ev_init_arg->on_close;
 	ev->on_message = ev_init_arg->on_message;
 	ev->on_timer = ev_init_arg->on_timer;
+	ev->on_high_water = ev_init_arg->on_high_water;
+	ev->on_frame = ev_init_arg->on_frame;
 
 	// init memory manager
 	muggle_socket_event_memmgr_t *mem_mgr = (muggle_socket_event_memmgr_t*)malloc(sizeof(muggle_socket_event_memmgr_t));
@@ -142,8 +224,12 @@ static int muggle_socket_event_loop_run(muggle_socket_event_t *ev)
 	{
 	case MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD:
 	{
-		MUGGLE_LOG_ERROR("unimplemented event loop type: multhread, to be continued...");
+#if MUGGLE_PLATFORM_LINUX
+		ret = muggle_socket_event_multhread(ev);
+#else
+		MUGGLE_LOG_ERROR("multhread event loop support linux only");
 		ret = -1;
+#endif
 	}break;
 	case MUGGLE_SOCKET_EVENT_LOOP_TYPE_SELECT:
 	{
@@ -160,6 +246,20 @@ static int muggle_socket_event_loop_run(muggle_socket_event_t *ev)
 #else
 		MUGGLE_LOG_ERROR("epoll event loop support linux only");
 		ret = -1;
+#endif
+	}break;
+	case MUGGLE_SOCKET_EVENT_LOOP_TYPE_IO_URING:
+	{
+#if MUGGLE_SOCKET_EVENT_HAS_IO_URING
+		if (muggle_socket_event_io_uring(ev) != 0)
+		{
+			MUGGLE_LOG_WARNING("failed run io_uring event loop, fallback to epoll");
+			ev->ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL;
+			muggle_socket_event_epoll(ev);
+		}
+#else
+		MUGGLE_LOG_ERROR("io_uring event loop support linux only");
+		ret = -1;
 #endif
 	}break;
 	case MUGGLE_SOCKET_EVENT_LOOP_TYPE_IOCP:
@@ -238,5 +338,18 @@ int muggle_socket_event_loop(muggle_socket_event_t *ev)
 
 void muggle_socket_event_loop_exit(muggle_socket_event_t *ev)
 {
-	ev->to_exit = 1;
+	muggle_atomic_store(&ev->to_exit, 1, muggle_memory_order_release);
+
+#if MUGGLE_PLATFORM_LINUX
+	if (ev->main_ev)
+	{
+		ev = ev->main_ev;
+		muggle_atomic_store(&ev->to_exit, 1, muggle_memory_order_release);
+	}
+
+	if (ev->ev_loop_type == MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD)
+	{
+		muggle_socket_event_multhread_wake(ev);
+	}
+#endif
 }
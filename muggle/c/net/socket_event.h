@@ -14,21 +14,26 @@
 #include "muggle/c/net/socket.h"
 #include "muggle/c/net/socket_peer.h"
 #include "muggle/c/net/socket_utils.h"
+#include "muggle/c/time/timer_wheel.h"
 
 EXTERN_C_BEGIN
 
 enum
 {
 	MUGGLE_SOCKET_EVENT_LOOP_TYPE_NULL = 0,
-	MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD,  //!< multiple thread
+	MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD,  //!< multiple reactor, acceptor thread distribute peers to epoll workers, linux only
 	MUGGLE_SOCKET_EVENT_LOOP_TYPE_SELECT,     //!< select
 	MUGGLE_SOCKET_EVENT_LOOP_TYPE_POLL,       //!< poll
 	MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL,      //!< epoll
 	MUGGLE_SOCKET_EVENT_LOOP_TYPE_KQUEUE,     //!< kqueue
 	MUGGLE_SOCKET_EVENT_LOOP_TYPE_IOCP,       //!< iocp
+	MUGGLE_SOCKET_EVENT_LOOP_TYPE_IO_URING,   //!< io_uring, linux only, fallback to epoll when kernel not support
 	MUGGLE_SOCKET_EVENT_LOOP_TYPE_MAX,
 };
 
+#define MUGGLE_SOCKET_EVENT_DEFAULT_RECV_BUF_CAPACITY (64 * 1024)
+#define MUGGLE_SOCKET_EVENT_LENGTH_FIELD_MAX_END 64 //!< max offset + size of length field
+
 struct muggle_socket_event;
 
 /**
@@ -71,6 +76,92 @@ typedef void (*muggle_socket_event_timer)(struct muggle_socket_event *ev);
  */
 typedef void (*muggle_socket_event_close)(struct muggle_socket_event *ev, struct muggle_socket_peer *peer);
 
+/**
+ * @brief prototype of socket event callback - on outbound queue high water
+ *
+ * invoked when queued bytes of peer reach send_high_water, and invoked
+ * again with queued = 0 after the queue was drained, user could stop and
+ * resume produce for this peer
+ *
+ * @param ev           socket event pointer
+ * @param peer         socket peer
+ * @param queued       number of bytes in outbound queue of peer
+ */
+typedef void (*muggle_socket_event_high_water)(struct muggle_socket_event *ev, struct muggle_socket_peer *peer, int queued);
+
+/**
+ * @brief prototype of socket event callback - frame decode
+ *
+ * get length of the first frame in receive buffer of peer, bytes in
+ * buffer could be inspected by muggle_bytes_buffer_fetch or
+ * muggle_bytes_buffer_reader_fc, but must not be consumed
+ *
+ * @param ev           socket event pointer
+ * @param peer         socket peer
+ * @param bytes_buf    receive buffer of peer, readable bytes > 0
+ *
+ * @return
+ *     - positive: length of the first frame, include header
+ *     - 0: need more bytes to get length of frame
+ *     - negative: invalid frame, peer will be closed
+ */
+typedef int (*muggle_socket_event_frame_decode)(struct muggle_socket_event *ev, struct muggle_socket_peer *peer, muggle_bytes_buffer_t *bytes_buf);
+
+/**
+ * @brief prototype of socket event callback - on frame
+ *
+ * frame point to receive buffer of peer directly when it's contiguous,
+ * it's only valid in this callback
+ *
+ * @param ev           socket event pointer
+ * @param peer         socket peer
+ * @param frame        complete frame
+ * @param len          length of frame
+ */
+typedef void (*muggle_socket_event_frame)(struct muggle_socket_event *ev, struct muggle_socket_peer *peer, void *frame, int len);
+
+/**
+ * @brief length field of built-in length prefix frame decoder
+ *
+ * length of frame = value of length field + adjust, e.g.
+ *   - 4 bytes big endian length of body before body: {0, 4, 1, 4, 0}
+ *   - header {uint16, uint16, uint32 len of body} in little endian:
+ *     {4, 4, 0, 8, 0}
+ */
+typedef struct muggle_socket_event_length_field
+{
+	int offset;     //!< offset of length field in frame
+	int size;       //!< bytes of length field: 1, 2, 4 or 8, 0 means 4
+	int big_endian; //!< 1 - length field is big endian, 0 - little endian
+	int adjust;     //!< added to value of length field to get length of frame
+	int max_frame;  //!< max length of frame, 0 means recv_buf_capacity
+}muggle_socket_event_length_field_t;
+
+struct muggle_socket_peer_timer;
+
+/**
+ * @brief prototype of socket event callback - on peer timer
+ *
+ * @param ev           socket event pointer
+ * @param peer         socket peer that timer attached to
+ * @param timer        expired timer
+ */
+typedef void (*muggle_socket_event_peer_timer)(struct muggle_socket_event *ev, struct muggle_socket_peer *peer, struct muggle_socket_peer_timer *timer);
+
+/**
+ * @brief timer attached to socket peer
+ */
+typedef struct muggle_socket_peer_timer
+{
+	muggle_timer_wheel_timer_t      timer;
+	struct muggle_socket_peer_timer *prev;
+	struct muggle_socket_peer_timer *next;
+	muggle_socket_peer_t            *peer;
+	int                             interval_ms; //!< period, 0 means one shot
+	muggle_socket_event_peer_timer  cb;
+	void                            *data;       //!< user data
+}muggle_socket_peer_timer_t;
+
 /**
  * @brief socket event loop handle
  */
@@ -82,16 +173,36 @@ typedef struct muggle_socket_event
 	int  to_exit;
 	void *mem_mgr;
 	void *datas;
+	int  num_worker;                     //!< multhread loop: number of worker threads
+	struct muggle_socket_event *main_ev; //!< multhread loop: main event of worker event, NULL in main event
+	void *reactor;                       //!< multhread loop: reactors context
+	int  wake_ref;                       //!< multhread loop: number of threads waking up acceptor
+	muggle_socket_t loop_fd;             //!< epoll/multhread loop: epoll file descriptor of running loop
+	int  send_buf_capacity;              //!< capacity of peer outbound queue, 0 means disabled
+	int  send_high_water;                //!< high water mark of peer outbound queue
+	int  recv_buf_capacity;              //!< capacity of peer receive buffer, 0 means framing disabled
+	muggle_socket_event_frame_decode   frame_decode; //!< frame decoder, NULL means built-in length prefix decoder
+	muggle_socket_event_length_field_t length_field; //!< length field of built-in length prefix decoder
+	void *timers;                        //!< timer wheel of running loop
 
 	muggle_socket_event_connect on_connect;
 	muggle_socket_event_error   on_error;
 	muggle_socket_event_close   on_close;
 	muggle_socket_event_message on_message;
 	muggle_socket_event_timer   on_timer;
+	muggle_socket_event_high_water on_high_water;
+	muggle_socket_event_frame   on_frame;
 }muggle_socket_event_t;
 
 /**
  * @brief socket event loop input arguments
+ *
+ * in multhread loop, on_connect, on_message, on_error, on_close,
+ * on_high_water, on_frame and peer timers are invoked in the worker
+ * thread that owns the peer, on_timer is only invoked in the acceptor
+ * thread, workers don't run it; listen_peer passed to on_connect is a
+ * copy taken when accepted, only fd, addr and data of it are valid and it
+ * must not be retained or closed
  */
 typedef struct muggle_socket_event_init_arg
 {
@@ -100,8 +211,14 @@ typedef struct muggle_socket_event_init_arg
 	int                  cnt_peer;       //!< the number of socket descriptor in this arguments
 	muggle_socket_peer_t *peers;         //!< socket peer array, size is cnt_peer
 	muggle_socket_peer_t **p_peers;      //!< return peers holds by ev, if wanna use it in other thread, remember call retain function
-	int                  timeout_ms;     //!< event loop timer in millisec, -1, 0 or any positive number, the same as epoll timeout
+	int                  timeout_ms;     //!< interval of on_timer in millisec, -1 means no on_timer, 0 means never block and invoke on_timer when no event
 	void                 *datas;         //!< user custom data
+	int                  num_worker;     //!< worker threads of multhread loop, 0 means hardware concurrency
+	int                  send_buf_capacity; //!< capacity of per peer outbound queue, 0 means disabled, only support epoll and multhread loop
+	int                  send_high_water;   //!< invoke on_high_water when queued bytes reach it, 0 means half of send_buf_capacity
+	int                  recv_buf_capacity; //!< capacity of per peer receive buffer when on_frame is set, 0 means MUGGLE_SOCKET_EVENT_DEFAULT_RECV_BUF_CAPACITY
+	muggle_socket_event_frame_decode   frame_decode; //!< frame decoder when on_frame is set, NULL means built-in length prefix decoder
+	muggle_socket_event_length_field_t length_field; //!< length field of built-in length prefix decoder
 
 	// event callbacks
 	muggle_socket_event_connect on_connect; //!< callback for socket connect
@@ -109,6 +226,8 @@ typedef struct muggle_socket_event_init_arg
 	muggle_socket_event_close   on_close;   //!< callback for socket close, free peer soon, safe to free peer->data
 	muggle_socket_event_message on_message; //!< callback for socket on message
 	muggle_socket_event_timer   on_timer;   //!< callback for socket on timer
+	muggle_socket_event_high_water on_high_water; //!< callback for outbound queue reach high water or drained
+	muggle_socket_event_frame   on_frame;   //!< callback for complete frame of tcp peer, if set, event loop read bytes into receive buffer of peer and on_message is only invoked for udp peer
 }muggle_socket_event_init_arg_t;
 
 /**
@@ -137,11 +256,56 @@ int muggle_socket_event_loop(muggle_socket_event_t *ev);
 /**
  * @brief exit event loop 
  *
+ * in multhread loop, ev can be main event or event of any worker, all
+ * reactors exit
+ *
  * @param ev   socket event
  */
 MUGGLE_C_EXPORT
 void muggle_socket_event_loop_exit(muggle_socket_event_t *ev);
 
+/**
+ * @brief attach timer to peer
+ *
+ * timer is in timer wheel of the event loop that peer belongs to, it's
+ * valid until canceled or peer removed from event loop, one shot timer
+ * still could be reset after expired. callback is not invoked after peer
+ * closed
+ *
+ * @note only invoke timer functions in event loop thread
+ *
+ * @param peer         socket peer in running event loop
+ * @param delay_ms     expire after delay_ms
+ * @param interval_ms  period of timer, 0 means one shot
+ * @param cb           callback
+ * @param data         user data
+ *
+ * @return timer, NULL represent failed
+ */
+MUGGLE_C_EXPORT
+muggle_socket_peer_timer_t* muggle_socket_peer_timer_add(
+	muggle_socket_peer_t *peer, int delay_ms, int interval_ms,
+	muggle_socket_event_peer_timer cb, void *data);
+
+/**
+ * @brief restart peer timer, expire after delay_ms and keep period,
+ * e.g. reset idle timer when message arrived
+ *
+ * @param timer     peer timer
+ * @param delay_ms  expire after delay_ms
+ */
+MUGGLE_C_EXPORT
+void muggle_socket_peer_timer_reset(muggle_socket_peer_timer_t *timer, int delay_ms);
+
+/**
+ * @brief cancel and free peer timer, it's safe to invoke in callback of
+ * this timer
+ *
+ * @param timer  peer timer
+ */
+MUGGLE_C_EXPORT
+void muggle_socket_peer_timer_cancel(muggle_socket_peer_timer_t *timer);
+
 EXTERN_C_END
 
 #endif
@@ -9,10 +9,13 @@
  *****************************************************************************/
  
 #include "socket_peer.h"
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include "muggle/c/log/log.h"
 #include "socket_utils.h"
 #include "socket_event.h"
+#include "event/socket_event_utils.h"
 
 void muggle_socket_peer_init(
 	muggle_socket_peer_t *peer, muggle_socket_t fd,
@@ -97,6 +100,20 @@ int muggle_socket_peer_release(muggle_socket_peer_t *peer)
 
 		muggle_socket_close(peer->fd);
 		peer->fd = MUGGLE_INVALID_SOCKET;
+
+		if (peer->send_buf)
+		{
+			muggle_bytes_buffer_destroy(peer->send_buf);
+			free(peer->send_buf);
+			peer->send_buf = NULL;
+		}
+
+		if (peer->recv_buf)
+		{
+			muggle_bytes_buffer_destroy(peer->recv_buf);
+			free(peer->recv_buf);
+			peer->recv_buf = NULL;
+		}
 	}
 
 	return desired;
@@ -153,6 +170,31 @@ int muggle_socket_peer_recvfrom(
 
 int muggle_socket_peer_recv(muggle_socket_peer_t *peer, void *buf, size_t len, int flags)
 {
+#if MUGGLE_PLATFORM_LINUX
+	if (peer->recv_data)
+	{
+		// bytes already received by event loop, never read fd directly,
+		// otherwise order of bytes may be broken
+		if (peer->recv_len == 0)
+		{
+			errno = EAGAIN;
+			return MUGGLE_SOCKET_ERROR;
+		}
+
+		if (len > peer->recv_len)
+		{
+			len = peer->recv_len;
+		}
+		memcpy(buf, peer->recv_data, len);
+		if (!(flags & MSG_PEEK))
+		{
+			peer->recv_data += len;
+			peer->recv_len -= len;
+		}
+		return (int)len;
+	}
+#endif
+
 	int n = 0;
 	while (1)
 	{
@@ -187,7 +229,7 @@ int muggle_socket_peer_sendto(muggle_socket_peer_t *peer, const void *buf, size_
 	const struct sockaddr *dest_addr, socklen_t addrlen)
 {
 	int num_bytes = muggle_socket_sendto(peer->fd, buf, len, flags, dest_addr, addrlen);
-	if (num_bytes != len)
+	if (num_bytes != (int)len)
 	{
 		if (num_bytes == MUGGLE_SOCKET_ERROR)
 		{
@@ -205,10 +247,189 @@ int muggle_socket_peer_sendto(muggle_socket_peer_t *peer, const void *buf, size_
 	return num_bytes;
 }
 
+/**
+ * @brief put bytes into outbound queue of peer
+ *
+ * @return 0 - success, otherwise queue is full or failed allocate queue
+ */
+static int muggle_socket_peer_enqueue(muggle_socket_peer_t *peer, const char *buf, int len)
+{
+	muggle_socket_event_t *ev = peer->ev;
+
+	if (peer->send_buf == NULL)
+	{
+		muggle_bytes_buffer_t *send_buf = (muggle_bytes_buffer_t*)malloc(sizeof(muggle_bytes_buffer_t));
+		if (send_buf == NULL)
+		{
+			return -1;
+		}
+
+		// bytes buffer keep one byte empty
+		if (!muggle_bytes_buffer_init(send_buf, ev->send_buf_capacity + 1))
+		{
+			free(send_buf);
+			return -1;
+		}
+		peer->send_buf = send_buf;
+	}
+
+	if (!muggle_bytes_buffer_write(peer->send_buf, len, (void*)buf))
+	{
+		MUGGLE_LOG_WARNING("peer outbound queue full");
+		return -1;
+	}
+
+	if (!(peer->send_state & MUGGLE_SOCKET_PEER_SEND_WATCH))
+	{
+		if (muggle_socket_event_watch_write(peer, 1) != 0)
+		{
+			return -1;
+		}
+		peer->send_state |= MUGGLE_SOCKET_PEER_SEND_WATCH;
+	}
+
+	int queued = muggle_bytes_buffer_readable(peer->send_buf);
+	if (queued >= ev->send_high_water && !(peer->send_state & MUGGLE_SOCKET_PEER_SEND_HIGH_WATER))
+	{
+		peer->send_state |= MUGGLE_SOCKET_PEER_SEND_HIGH_WATER;
+		if (ev->on_high_water)
+		{
+			ev->on_high_water(ev, peer, queued);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief send bytes with outbound queue
+ */
+static int muggle_socket_peer_send_queue(muggle_socket_peer_t *peer, const void *buf, size_t len, int flags)
+{
+	if (peer->status != MUGGLE_SOCKET_PEER_STATUS_ACTIVE)
+	{
+		return MUGGLE_SOCKET_ERROR;
+	}
+
+	// keep order of bytes, append to queue if it's not empty
+	int num_bytes = 0;
+	if (peer->send_buf == NULL || muggle_bytes_buffer_readable(peer->send_buf) == 0)
+	{
+		num_bytes = muggle_socket_send(peer->fd, buf, len, flags);
+		if (num_bytes == (int)len)
+		{
+			return num_bytes;
+		}
+
+		if (num_bytes == MUGGLE_SOCKET_ERROR)
+		{
+			int last_errno = MUGGLE_SOCKET_LAST_ERRNO;
+			if (last_errno != MUGGLE_SYS_ERRNO_WOULDBLOCK && last_errno != MUGGLE_SYS_ERRNO_INTR)
+			{
+				char err_msg[1024] = { 0 };
+				muggle_socket_strerror(last_errno, err_msg, sizeof(err_msg));
+				MUGGLE_LOG_TRACE("failed send msg - %s", err_msg);
+
+				muggle_socket_peer_close(peer);
+				return num_bytes;
+			}
+			num_bytes = 0;
+		}
+	}
+
+	if (muggle_socket_peer_enqueue(peer, (const char*)buf + num_bytes, (int)len - num_bytes) != 0)
+	{
+		muggle_socket_peer_close(peer);
+		return MUGGLE_SOCKET_ERROR;
+	}
+
+	return (int)len;
+}
+
+int muggle_socket_peer_flush(muggle_socket_peer_t *peer)
+{
+	muggle_bytes_buffer_t *send_buf = peer->send_buf;
+	if (send_buf == NULL)
+	{
+		return 0;
+	}
+
+	while (1)
+	{
+		int cr = muggle_bytes_buffer_contiguous_readable(send_buf);
+		if (cr == 0)
+		{
+			break;
+		}
+
+		void *p = muggle_bytes_buffer_reader_fc(send_buf, cr);
+		int n = muggle_socket_send(peer->fd, p, (size_t)cr, 0);
+		if (n == MUGGLE_SOCKET_ERROR)
+		{
+			int last_errno = MUGGLE_SOCKET_LAST_ERRNO;
+			if (last_errno == MUGGLE_SYS_ERRNO_INTR)
+			{
+				continue;
+			}
+			else if (last_errno == MUGGLE_SYS_ERRNO_WOULDBLOCK)
+			{
+				// wait next writable event
+				return muggle_bytes_buffer_readable(send_buf);
+			}
+
+			char err_msg[1024] = { 0 };
+			muggle_socket_strerror(last_errno, err_msg, sizeof(err_msg));
+			MUGGLE_LOG_TRACE("failed send msg - %s", err_msg);
+
+			muggle_socket_peer_close(peer);
+			return -1;
+		}
+
+		muggle_bytes_buffer_reader_move(send_buf, n);
+		if (n < cr)
+		{
+			return muggle_bytes_buffer_readable(send_buf);
+		}
+	}
+
+	// drained
+	if (peer->send_state & MUGGLE_SOCKET_PEER_SEND_WATCH)
+	{
+		muggle_socket_event_watch_write(peer, 0);
+		peer->send_state &= ~MUGGLE_SOCKET_PEER_SEND_WATCH;
+	}
+
+	if (peer->send_state & MUGGLE_SOCKET_PEER_SEND_HIGH_WATER)
+	{
+		peer->send_state &= ~MUGGLE_SOCKET_PEER_SEND_HIGH_WATER;
+		if (peer->ev && peer->ev->on_high_water)
+		{
+			peer->ev->on_high_water(peer->ev, peer, 0);
+		}
+	}
+
+	return 0;
+}
+
+int muggle_socket_peer_send_queued(muggle_socket_peer_t *peer)
+{
+	if (peer->send_buf == NULL)
+	{
+		return 0;
+	}
+	return muggle_bytes_buffer_readable(peer->send_buf);
+}
+
 int muggle_socket_peer_send(muggle_socket_peer_t *peer, const void *buf, size_t len, int flags)
 {
+	if (peer->ev && peer->ev->send_buf_capacity > 0 &&
+		peer->peer_type == MUGGLE_SOCKET_PEER_TYPE_TCP_PEER)
+	{
+		return muggle_socket_peer_send_queue(peer, buf, len, flags);
+	}
+
 	int num_bytes = muggle_socket_send(peer->fd, buf, len, flags);
-	if (num_bytes != len)
+	if (num_bytes != (int)len)
 	{
 		if (num_bytes == MUGGLE_SOCKET_ERROR)
 		{
@@ -13,6 +13,7 @@
 
 #include "muggle/c/net/socket.h"
 #include "muggle/c/base/atomic.h"
+#include "muggle/c/memory/bytes_buffer.h"
 
 EXTERN_C_BEGIN
 
@@ -31,7 +32,14 @@ enum
 	MUGGLE_SOCKET_PEER_STATUS_CLOSED = 1,
 };
 
+enum
+{
+	MUGGLE_SOCKET_PEER_SEND_WATCH      = 0x01, //!< waiting writable event to flush outbound queue
+	MUGGLE_SOCKET_PEER_SEND_HIGH_WATER = 0x02, //!< outbound queue reached high water mark
+};
+
 struct muggle_socket_event;
+struct muggle_socket_peer_timer;
 
 /**
  * @brief socket peer
@@ -55,6 +63,12 @@ typedef struct muggle_socket_peer
 	muggle_socklen_t        addr_len;
 	void                    *data;
 	struct muggle_socket_event *ev;
+	const char              *recv_data; //!< bytes already received by event loop (io_uring), NULL means recv from fd
+	size_t                  recv_len;   //!< number of readable bytes in recv_data
+	muggle_bytes_buffer_t   *send_buf;  //!< outbound queue, allocated when send would block first time
+	int                     send_state; //!< bitwise or of MUGGLE_SOCKET_PEER_SEND_*
+	muggle_bytes_buffer_t   *recv_buf;  //!< receive buffer of framing, allocated when peer readable first time
+	struct muggle_socket_peer_timer *timers; //!< timers attached to peer
 }muggle_socket_peer_t;
 
 /**
@@ -128,6 +142,10 @@ int muggle_socket_peer_recvfrom(
  * @param flags flag
  *
  * @return 
+ *
+ * @note when peer->recv_data is not NULL (tcp peer in io_uring event loop),
+ * bytes are copied from recv_data, and return -1 with errno EAGAIN after
+ * all bytes were read, so user must read tcp peer by this function
  */
 MUGGLE_C_EXPORT
 int muggle_socket_peer_recv(muggle_socket_peer_t *peer, void *buf, size_t len, int flags);
@@ -157,10 +175,40 @@ int muggle_socket_peer_sendto(muggle_socket_peer_t *peer, const void *buf, size_
  * @param flags      flag
  *
  * @return 
+ *
+ * @note when outbound queue of event is enabled (send_buf_capacity of
+ * event init arguments), bytes can't be sent immediately are queued and
+ * flushed when socket become writable, return len if bytes are sent or
+ * queued; the peer is closed if queue is full. the queue is not thread
+ * safe, only send in event loop thread in this case
  */
 MUGGLE_C_EXPORT
 int muggle_socket_peer_send(muggle_socket_peer_t *peer, const void *buf, size_t len, int flags);
 
+/**
+ * @brief send bytes in outbound queue
+ *
+ * NOTE: event loop invoke it when peer become writable, user don't need
+ * to invoke it usually
+ *
+ * @param peer  socket peer pointer
+ *
+ * @return number of bytes still in outbound queue, negative number
+ * represent failed send and peer was closed
+ */
+MUGGLE_C_EXPORT
+int muggle_socket_peer_flush(muggle_socket_peer_t *peer);
+
+/**
+ * @brief get number of bytes in outbound queue
+ *
+ * @param peer  socket peer pointer
+ *
+ * @return number of queued bytes
+ */
+MUGGLE_C_EXPORT
+int muggle_socket_peer_send_queued(muggle_socket_peer_t *peer);
+
 EXTERN_C_END
 
 #endif
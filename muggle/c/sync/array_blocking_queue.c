@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "muggle/c/base/err.h"
+#include "muggle/c/time/deadline.h"
 
 static void muggle_array_blocking_queue_enqueue(muggle_array_blocking_queue_t *queue, void *data)
 {
@@ -126,3 +127,63 @@ void* muggle_array_blocking_queue_take(muggle_array_blocking_queue_t *queue)
 
 	return data;
 }
+
+int muggle_array_blocking_queue_try_take(muggle_array_blocking_queue_t *queue, void **data)
+{
+	int ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	if (queue->cnt == 0)
+	{
+		muggle_mutex_unlock(&queue->mutex);
+		return MUGGLE_ERR_EMPTY;
+	}
+	*data = muggle_array_blocking_queue_dequeue(queue);
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return MUGGLE_OK;
+}
+
+int muggle_array_blocking_queue_take_timeout(
+	muggle_array_blocking_queue_t *queue, void **data, const struct timespec *timeout)
+{
+	if (timeout == NULL)
+	{
+		*data = muggle_array_blocking_queue_take(queue);
+		return MUGGLE_OK;
+	}
+
+	struct timespec deadline, remain;
+	muggle_deadline_set(&deadline, timeout);
+
+	int ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	while (queue->cnt == 0)
+	{
+		if (!muggle_deadline_remain(&deadline, &remain))
+		{
+			muggle_mutex_unlock(&queue->mutex);
+			return MUGGLE_ERR_TIMEOUT;
+		}
+
+		// condition variable wait use absolute time in posix and relative time in windows
+#if MUGGLE_PLATFORM_WINDOWS
+		muggle_condition_variable_wait(&queue->cv_not_empty, &queue->mutex, &remain);
+#else
+		muggle_condition_variable_wait(&queue->cv_not_empty, &queue->mutex, &deadline);
+#endif
+	}
+	*data = muggle_array_blocking_queue_dequeue(queue);
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return MUGGLE_OK;
+}
@@ -12,6 +12,7 @@
 #define MUGGLE_C_ARRAY_BLOCKING_QUEUE_H_
 
 #include "muggle/c/base/macro.h"
+#include <time.h>
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/condition_variable.h"
 
@@ -82,6 +83,36 @@ int muggle_array_blocking_queue_put(muggle_array_blocking_queue_t *queue, void *
 MUGGLE_C_EXPORT
 void* muggle_array_blocking_queue_take(muggle_array_blocking_queue_t *queue);
 
+/**
+ * @brief try take data from queue without block
+ *
+ * @param queue  array blocking queue pointer
+ * @param data   store data pointer on success
+ *
+ * @return 
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_EMPTY if queue is empty
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_try_take(muggle_array_blocking_queue_t *queue, void **data);
+
+/**
+ * @brief take data from queue, block at most timeout
+ *
+ * @param queue    array blocking queue pointer
+ * @param data     store data pointer on success
+ * @param timeout  relative timeout, NULL means wait forever
+ *
+ * @return 
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT if queue still empty after timeout
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_take_timeout(
+	muggle_array_blocking_queue_t *queue, void **data, const struct timespec *timeout);
+
 EXTERN_C_END
 
 #endif
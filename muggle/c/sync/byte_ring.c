@@ -0,0 +1,219 @@
+/******************************************************************************
+ *  @file         byte_ring.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec byte ring
+ *****************************************************************************/
+
+#include "byte_ring.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+
+#define MUGGLE_BYTE_RING_ALIGN 8
+#define MUGGLE_BYTE_RING_PAD -1
+#define MUGGLE_BYTE_RING_ROUND_UP(n) \
+	(((n) + MUGGLE_BYTE_RING_ALIGN - 1) & ~(MUGGLE_BYTE_RING_ALIGN - 1))
+
+// positions increase monotonically, use unsigned arithmetic for wrap around
+#define MUGGLE_BYTE_RING_POS_ADD(pos, n) (muggle_atomic_int)((uint32_t)(pos) + (uint32_t)(n))
+#define MUGGLE_BYTE_RING_POS_DIFF(a, b) ((uint32_t)(a) - (uint32_t)(b))
+
+/*
+ * message header
+ *
+ * len: number of bytes of message, MUGGLE_BYTE_RING_PAD for pad mark
+ * skip: number of pad bytes at the tail of ring before this message
+ */
+typedef struct muggle_byte_ring_header
+{
+	int32_t len;
+	int32_t skip;
+}muggle_byte_ring_header_t;
+
+static inline
+muggle_atomic_int muggle_byte_ring_span(muggle_byte_ring_header_t *header)
+{
+	return header->skip + MUGGLE_BYTE_RING_ROUND_UP((int)sizeof(muggle_byte_ring_header_t) + header->len);
+}
+
+int muggle_byte_ring_init(muggle_byte_ring_t *r, muggle_atomic_int capacity, int flags)
+{
+	memset(r, 0, sizeof(*r));
+
+	if (capacity < (muggle_atomic_int)(sizeof(muggle_byte_ring_header_t) * 4))
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	capacity = (muggle_atomic_int)next_pow_of_2((uint64_t)capacity);
+	if (capacity <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	r->buffer = (char*)malloc(capacity);
+	if (r->buffer == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	// with pad bytes, a message use less than 2 * (header + len) bytes
+	r->capacity = capacity;
+	r->flags = flags;
+	r->max_msg_size = capacity / 2 - (int)sizeof(muggle_byte_ring_header_t);
+	r->next = 0;
+	r->cursor = 0;
+	r->read_cursor = 0;
+	r->n_sleeper = 0;
+
+	return MUGGLE_OK;
+}
+
+void muggle_byte_ring_destroy(muggle_byte_ring_t *r)
+{
+	if (r->buffer)
+	{
+		free(r->buffer);
+		r->buffer = NULL;
+	}
+}
+
+void* muggle_byte_ring_writer_reserve(muggle_byte_ring_t *r, int num_bytes)
+{
+	if (num_bytes <= 0 || num_bytes > r->max_msg_size)
+	{
+		return NULL;
+	}
+
+	muggle_atomic_int total = MUGGLE_BYTE_RING_ROUND_UP((int)sizeof(muggle_byte_ring_header_t) + num_bytes);
+	muggle_atomic_int pos = muggle_atomic_load(&r->next, muggle_memory_order_relaxed);
+	muggle_atomic_int offset, skip;
+	while (1)
+	{
+		offset = IDX_IN_POW_OF_2_RING(pos, r->capacity);
+		skip = (r->capacity - offset < total) ? r->capacity - offset : 0;
+
+		muggle_atomic_int r_cursor = muggle_atomic_load(&r->read_cursor, muggle_memory_order_acquire);
+		muggle_atomic_int end = MUGGLE_BYTE_RING_POS_ADD(pos, skip + total);
+		if (MUGGLE_BYTE_RING_POS_DIFF(end, r_cursor) > (uint32_t)r->capacity)
+		{
+			return NULL;
+		}
+
+		if (r->flags & MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER)
+		{
+			muggle_atomic_store(&r->next, end, muggle_memory_order_relaxed);
+			break;
+		}
+
+		if (muggle_atomic_cmp_exch_weak(&r->next, &pos, end, muggle_memory_order_relaxed))
+		{
+			break;
+		}
+	}
+
+	char *p = r->buffer + offset;
+	if (skip > 0)
+	{
+		((muggle_byte_ring_header_t*)p)->len = MUGGLE_BYTE_RING_PAD;
+		p = r->buffer;
+	}
+
+	muggle_byte_ring_header_t *header = (muggle_byte_ring_header_t*)p;
+	header->len = num_bytes;
+	header->skip = skip;
+
+	return p + sizeof(muggle_byte_ring_header_t);
+}
+
+void muggle_byte_ring_writer_commit(muggle_byte_ring_t *r, void *data)
+{
+	muggle_byte_ring_header_t *header =
+		(muggle_byte_ring_header_t*)((char*)data - sizeof(muggle_byte_ring_header_t));
+	muggle_atomic_int span = muggle_byte_ring_span(header);
+
+	if (r->flags & MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER)
+	{
+		muggle_atomic_store(&r->cursor, MUGGLE_BYTE_RING_POS_ADD(r->cursor, span), muggle_memory_order_release);
+	}
+	else
+	{
+		// wait previous reservations committed, then move cursor
+		muggle_atomic_int offset = (muggle_atomic_int)((char*)header - r->buffer);
+		muggle_atomic_int start = IDX_IN_POW_OF_2_RING(offset - header->skip, r->capacity);
+		muggle_atomic_int cur = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		while (IDX_IN_POW_OF_2_RING(cur, r->capacity) != start)
+		{
+			muggle_thread_yield();
+			cur = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		}
+		muggle_atomic_store(&r->cursor, MUGGLE_BYTE_RING_POS_ADD(cur, span), muggle_memory_order_release);
+	}
+
+	// same as muggle_ring_buffer_t, only enter kernel when reader parked
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&r->n_sleeper, muggle_memory_order_relaxed) != 0)
+	{
+		muggle_futex_wake_one(&r->cursor);
+	}
+}
+
+void* muggle_byte_ring_reader_fetch(muggle_byte_ring_t *r, int *num_bytes)
+{
+	muggle_atomic_int w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+	if (w_cursor == r->read_cursor)
+	{
+		return NULL;
+	}
+
+	char *p = r->buffer + IDX_IN_POW_OF_2_RING(r->read_cursor, r->capacity);
+	muggle_byte_ring_header_t *header = (muggle_byte_ring_header_t*)p;
+	if (header->len == MUGGLE_BYTE_RING_PAD)
+	{
+		header = (muggle_byte_ring_header_t*)r->buffer;
+	}
+
+	if (num_bytes)
+	{
+		*num_bytes = header->len;
+	}
+	return (char*)header + sizeof(muggle_byte_ring_header_t);
+}
+
+void* muggle_byte_ring_reader_wait(muggle_byte_ring_t *r, int *num_bytes)
+{
+	while (1)
+	{
+		void *data = muggle_byte_ring_reader_fetch(r, num_bytes);
+		if (data)
+		{
+			return data;
+		}
+
+		muggle_atomic_int w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		if (w_cursor == r->read_cursor)
+		{
+			muggle_atomic_fetch_add(&r->n_sleeper, 1, muggle_memory_order_seq_cst);
+			muggle_futex_wait(&r->cursor, w_cursor, NULL);
+			muggle_atomic_fetch_sub(&r->n_sleeper, 1, muggle_memory_order_relaxed);
+		}
+	}
+
+	return NULL;
+}
+
+void muggle_byte_ring_reader_move(muggle_byte_ring_t *r, void *data)
+{
+	muggle_byte_ring_header_t *header =
+		(muggle_byte_ring_header_t*)((char*)data - sizeof(muggle_byte_ring_header_t));
+	muggle_atomic_int span = muggle_byte_ring_span(header);
+	muggle_atomic_store(&r->read_cursor, MUGGLE_BYTE_RING_POS_ADD(r->read_cursor, span), muggle_memory_order_release);
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+ *  @file         byte_ring.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec byte ring
+ *
+ * Byte ring transfer variable length messages in place, for single or
+ * multiple writers and single reader
+ *
+ * writer reserve contiguous bytes, write message into it and commit, reader
+ * get view of committed message and move after use, no allocation and no copy
+ *
+ * every message has a 8 bytes header and is aligned to 8 bytes, when the
+ * bytes before the end of ring is not enough, writer put a pad mark at the
+ * tail (like the truncate position of muggle_bytes_buffer_t) and message is
+ * written from the beginning of ring
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_BYTE_RING_H_
+#define MUGGLE_C_BYTE_RING_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+
+EXTERN_C_BEGIN
+
+enum
+{
+	MUGGLE_BYTE_RING_FLAG_MULTI_WRITER  = 0x00, //!< default, allow multiple writers
+	MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER = 0x01, //!< user guarantee only one writer use this byte ring
+};
+
+/**
+ * @brief byte ring
+ */
+typedef struct muggle_byte_ring
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int capacity;
+	int flags;
+	int max_msg_size;
+	char *buffer;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int next;        //!< position of next reservation
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	muggle_atomic_int cursor;      //!< position of committed messages end
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int read_cursor; //!< position of reader
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
+	muggle_atomic_int n_sleeper;   //!< number of reader parked on futex of cursor
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(5);
+}muggle_byte_ring_t;
+
+/**
+ * @brief initialize byte ring
+ *
+ * @param r         pointer to byte ring
+ * @param capacity  number of bytes in ring, will be rounded up to power of 2
+ * @param flags     bit OR operation of MUGGLE_BYTE_RING_FLAG_*
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_byte_ring_init(muggle_byte_ring_t *r, muggle_atomic_int capacity, int flags);
+
+/**
+ * @brief destroy byte ring
+ *
+ * @param r  pointer to byte ring
+ */
+MUGGLE_C_EXPORT
+void muggle_byte_ring_destroy(muggle_byte_ring_t *r);
+
+/**
+ * @brief reserve contiguous bytes for writer
+ *
+ * @param r          pointer to byte ring
+ * @param num_bytes  number of bytes, must in range [1, r->max_msg_size]
+ *
+ * @return pointer to reserved bytes, NULL when ring is full or num_bytes is invalid
+ */
+MUGGLE_C_EXPORT
+void* muggle_byte_ring_writer_reserve(muggle_byte_ring_t *r, int num_bytes);
+
+/**
+ * @brief commit reserved bytes, make it visible to reader
+ *
+ * with multiple writers, messages are visible to reader in reserve order,
+ * so commit wait until all previous reservation committed
+ *
+ * @param r     pointer to byte ring
+ * @param data  pointer returned by muggle_byte_ring_writer_reserve
+ */
+MUGGLE_C_EXPORT
+void muggle_byte_ring_writer_commit(muggle_byte_ring_t *r, void *data);
+
+/**
+ * @brief get view of the first committed message without block
+ *
+ * @param r          pointer to byte ring
+ * @param num_bytes  store number of bytes of message
+ *
+ * @return pointer to message, NULL if no message committed
+ */
+MUGGLE_C_EXPORT
+void* muggle_byte_ring_reader_fetch(muggle_byte_ring_t *r, int *num_bytes);
+
+/**
+ * @brief get view of the first committed message, block until message committed
+ *
+ * @param r          pointer to byte ring
+ * @param num_bytes  store number of bytes of message
+ *
+ * @return pointer to message
+ */
+MUGGLE_C_EXPORT
+void* muggle_byte_ring_reader_wait(muggle_byte_ring_t *r, int *num_bytes);
+
+/**
+ * @brief release message, make the bytes of it writable again
+ *
+ * @param r     pointer to byte ring
+ * @param data  pointer returned by muggle_byte_ring_reader_fetch or muggle_byte_ring_reader_wait
+ */
+MUGGLE_C_EXPORT
+void muggle_byte_ring_reader_move(muggle_byte_ring_t *r, void *data);
+
+EXTERN_C_END
+
+#endif
@@ -15,6 +15,7 @@
 #include "muggle/c/base/utils.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
 
 static void muggle_channel_lock_write(muggle_channel_t *chan)
 {
@@ -22,7 +23,7 @@ static void muggle_channel_lock_write(muggle_channel_t *chan)
 	while (!muggle_atomic_cmp_exch_weak(&chan->write_futex, &expected, MUGGLE_CHANNEL_LOCK_STATUS_LOCK, muggle_memory_order_acquire)
 			&& expected != MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK)
 	{
-		muggle_futex_wait(&chan->write_futex, expected, NULL);
+		muggle_wait_strategy_wait(&chan->wait_strategy, &chan->write_futex, expected, NULL);
 		expected = MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK;
 	}
 }
@@ -81,6 +82,253 @@ static int muggle_channel_write_futex(muggle_channel_t *chan, void *data)
 	return MUGGLE_OK;
 }
 
+/***************** batch write *****************/
+static int muggle_channel_assign_batch(muggle_channel_t *chan, void **datas, int n)
+{
+	muggle_atomic_int n_free = IDX_IN_POW_OF_2_RING(chan->read_cursor - chan->write_cursor - 1, chan->capacity);
+	if (n > n_free)
+	{
+		n = (int)n_free;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		chan->blocks[IDX_IN_POW_OF_2_RING(chan->write_cursor + i, chan->capacity)].data = datas[i];
+	}
+	muggle_atomic_store(&chan->write_cursor, chan->write_cursor + n, muggle_memory_order_release);
+
+	return n;
+}
+static int muggle_channel_write_batch_mutex(muggle_channel_t *chan, void **datas, int n)
+{
+	muggle_mutex_lock(&chan->write_mutex);
+	n = muggle_channel_assign_batch(chan, datas, n);
+	muggle_mutex_unlock(&chan->write_mutex);
+
+	return n;
+}
+static int muggle_channel_write_batch_single_writer(muggle_channel_t *chan, void **datas, int n)
+{
+	return muggle_channel_assign_batch(chan, datas, n);
+}
+static int muggle_channel_write_batch_futex(muggle_channel_t *chan, void **datas, int n)
+{
+	muggle_channel_lock_write(chan);
+	n = muggle_channel_assign_batch(chan, datas, n);
+	muggle_channel_unlock_write(chan);
+
+	return n;
+}
+
+/***************** multiple reader *****************/
+/*
+ * bounded MPMC slot protocol: slot i is free for writer at position pos when
+ * seq == pos, and ready for reader at position pos when seq == pos + 1,
+ * after reader take data, seq is set to pos + capacity for next round of writer
+ */
+static int muggle_channel_mpmc_enqueue(muggle_channel_t *chan, void *data)
+{
+	muggle_channel_block_t *block = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		block = &chan->blocks[IDX_IN_POW_OF_2_RING(pos, chan->capacity)];
+		muggle_atomic_int seq = muggle_atomic_load(&block->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - pos;
+		if (diff == 0)
+		{
+			if (muggle_atomic_cmp_exch_weak(&chan->write_cursor, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return MUGGLE_ERR_FULL;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_relaxed);
+		}
+	}
+
+	block->data = data;
+	muggle_atomic_store(&block->seq, pos + 1, muggle_memory_order_release);
+
+	return MUGGLE_OK;
+}
+
+/*
+ * return 1 on success, 0 when channel is empty and the empty position is
+ * stored in *p_pos
+ */
+static int muggle_channel_mpmc_dequeue(muggle_channel_t *chan, void **data, muggle_atomic_int *p_pos)
+{
+	muggle_channel_block_t *block = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		block = &chan->blocks[IDX_IN_POW_OF_2_RING(pos, chan->capacity)];
+		muggle_atomic_int seq = muggle_atomic_load(&block->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - (pos + 1);
+		if (diff == 0)
+		{
+			if (muggle_atomic_cmp_exch_weak(&chan->read_cursor, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			*p_pos = pos;
+			return 0;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+		}
+	}
+
+	*data = block->data;
+	muggle_atomic_store(&block->seq, pos + chan->capacity, muggle_memory_order_release);
+
+	return 1;
+}
+
+static int muggle_channel_write_mpmc(muggle_channel_t *chan, void *data)
+{
+	return muggle_channel_mpmc_enqueue(chan, data);
+}
+static int muggle_channel_write_batch_mpmc(muggle_channel_t *chan, void **datas, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		if (muggle_channel_mpmc_enqueue(chan, datas[i]) != MUGGLE_OK)
+		{
+			return i;
+		}
+	}
+	return n;
+}
+static void* muggle_channel_read_mpmc_futex(struct muggle_channel *chan)
+{
+	void *data = NULL;
+	muggle_atomic_int pos = 0;
+	while (!muggle_channel_mpmc_dequeue(chan, &data, &pos))
+	{
+		muggle_atomic_int w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		if (w_cursor == pos)
+		{
+			muggle_wait_strategy_wait(&chan->wait_strategy, &chan->write_cursor, w_cursor, NULL);
+		}
+		else
+		{
+			// writer already claimed the slot but not publish yet
+			muggle_thread_yield();
+		}
+	}
+	return data;
+}
+static void* muggle_channel_read_mpmc_busy_loop(struct muggle_channel *chan)
+{
+	void *data = NULL;
+	muggle_atomic_int pos = 0;
+	while (!muggle_channel_mpmc_dequeue(chan, &data, &pos))
+	{
+		muggle_thread_yield();
+	}
+	return data;
+}
+static int muggle_channel_read_batch_mpmc(struct muggle_channel *chan, void **datas, int n)
+{
+	muggle_atomic_int pos = 0;
+	datas[0] = chan->fn_read(chan);
+	int cnt = 1;
+	while (cnt < n && muggle_channel_mpmc_dequeue(chan, &datas[cnt], &pos))
+	{
+		cnt++;
+	}
+	return cnt;
+}
+
+/***************** full policy *****************/
+static int muggle_channel_is_full(muggle_channel_t *chan)
+{
+	muggle_atomic_int w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_relaxed);
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_MULTI_READER)
+	{
+		muggle_channel_block_t *block = &chan->blocks[IDX_IN_POW_OF_2_RING(w_cursor, chan->capacity)];
+		return muggle_atomic_load(&block->seq, muggle_memory_order_acquire) - w_cursor < 0;
+	}
+
+	muggle_atomic_int r_cursor = muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+	return IDX_IN_POW_OF_2_RING(r_cursor - w_cursor - 1, chan->capacity) == 0;
+}
+
+/*
+ * writer increase n_write_sleeper before check full again and wait,
+ * reader issue a seq_cst fence after free space and only wake when
+ * n_write_sleeper is not zero, so writer can't miss the freed slot
+ */
+static void muggle_channel_wait_not_full(muggle_channel_t *chan)
+{
+	for (int i = 0; i < chan->write_block_spin; i++)
+	{
+		if (!muggle_channel_is_full(chan))
+		{
+			return;
+		}
+	}
+
+	muggle_atomic_int seq = muggle_atomic_load(&chan->write_wake_seq, muggle_memory_order_acquire);
+	muggle_atomic_fetch_add(&chan->n_write_sleeper, 1, muggle_memory_order_seq_cst);
+	if (muggle_channel_is_full(chan))
+	{
+		muggle_futex_wait(&chan->write_wake_seq, seq, NULL);
+	}
+	muggle_atomic_fetch_sub(&chan->n_write_sleeper, 1, muggle_memory_order_relaxed);
+}
+
+static void muggle_channel_wake_writer(muggle_channel_t *chan)
+{
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&chan->n_write_sleeper, muggle_memory_order_relaxed) != 0)
+	{
+		muggle_atomic_fetch_add(&chan->write_wake_seq, 1, muggle_memory_order_release);
+		muggle_futex_wake_all(&chan->write_wake_seq);
+	}
+}
+
+static void muggle_channel_drop_oldest(muggle_channel_t *chan)
+{
+	void *data = NULL;
+	muggle_atomic_int pos = 0;
+	if (muggle_channel_mpmc_dequeue(chan, &data, &pos) && chan->fn_drop)
+	{
+		chan->fn_drop(data);
+	}
+}
+
+/*
+ * handle full channel according to full policy
+ * return 1 if writer should try again, otherwise return 0
+ */
+static int muggle_channel_handle_full(muggle_channel_t *chan)
+{
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_BLOCK)
+	{
+		muggle_channel_wait_not_full(chan);
+		return 1;
+	}
+	else if (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST)
+	{
+		muggle_channel_drop_oldest(chan);
+		return 1;
+	}
+
+	return 0;
+}
+
 /***************** wake *****************/
 static void muggle_channel_wake_futex(struct muggle_channel *chan)
 {
@@ -106,7 +354,7 @@ static void* muggle_channel_read_futex(struct muggle_channel *chan)
 			return data;
 		}
 
-		muggle_futex_wait(&chan->write_cursor, w_cursor, NULL);
+		muggle_wait_strategy_wait(&chan->wait_strategy, &chan->write_cursor, w_cursor, NULL);
 	}
 
 	return NULL;
@@ -129,6 +377,90 @@ static void* muggle_channel_read_busy_loop(struct muggle_channel *chan)
 	return NULL;
 }
 
+/***************** batch read *****************/
+static int muggle_channel_fetch_batch(struct muggle_channel *chan, muggle_atomic_int w_cursor, void **datas, int n)
+{
+	muggle_atomic_int n_ready = IDX_IN_POW_OF_2_RING(w_cursor - chan->read_cursor - 1, chan->capacity);
+	if (n > n_ready)
+	{
+		n = (int)n_ready;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		datas[i] = chan->blocks[IDX_IN_POW_OF_2_RING(chan->read_cursor + 1 + i, chan->capacity)].data;
+	}
+	chan->read_cursor += n;
+
+	return n;
+}
+static int muggle_channel_read_batch_futex(struct muggle_channel *chan, void **datas, int n)
+{
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+	muggle_atomic_int w_cursor;
+	while (1)
+	{
+		w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, chan->capacity) != r_pos)
+		{
+			return muggle_channel_fetch_batch(chan, w_cursor, datas, n);
+		}
+
+		muggle_wait_strategy_wait(&chan->wait_strategy, &chan->write_cursor, w_cursor, NULL);
+	}
+
+	return 0;
+}
+static int muggle_channel_read_batch_busy_loop(struct muggle_channel *chan, void **datas, int n)
+{
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+	muggle_atomic_int w_cursor;
+	while (1)
+	{
+		w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, chan->capacity) != r_pos)
+		{
+			return muggle_channel_fetch_batch(chan, w_cursor, datas, n);
+		}
+
+		muggle_thread_yield();
+	}
+
+	return 0;
+}
+
+/***************** non-blocking read *****************/
+/*
+ * return 1 on success, 0 when channel is empty and reader can wait on
+ * write_cursor with value *p_w_cursor, -1 when writer already claimed the
+ * slot but not publish yet
+ */
+static int muggle_channel_try_fetch(muggle_channel_t *chan, void **data, muggle_atomic_int *p_w_cursor)
+{
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_MULTI_READER)
+	{
+		muggle_atomic_int pos = 0;
+		if (muggle_channel_mpmc_dequeue(chan, data, &pos))
+		{
+			return 1;
+		}
+
+		*p_w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		return *p_w_cursor == pos ? 0 : -1;
+	}
+
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+	*p_w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+	if (IDX_IN_POW_OF_2_RING(*p_w_cursor, chan->capacity) == r_pos)
+	{
+		return 0;
+	}
+
+	*data = chan->blocks[r_pos].data;
+	chan->read_cursor++;
+	return 1;
+}
+
 int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int flags)
 {
 	if (capacity <= 0)
@@ -142,10 +474,33 @@ int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int
 		return MUGGLE_ERR_INVALID_PARAM;
 	}
 
+	if ((flags & MUGGLE_CHANNEL_FLAG_WRITE_BLOCK) && (flags & MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST))
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	// writer drop oldest message as a reader, so it need multiple reader protocol
+	if (flags & MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST)
+	{
+		flags |= MUGGLE_CHANNEL_FLAG_MULTI_READER;
+	}
+
 	chan->capacity = capacity;
 	chan->flags = flags;
+	chan->fn_drop = NULL;
+	chan->write_block_spin = 0;
+	muggle_wait_strategy_init(&chan->wait_strategy, 0, 0, 0);
+	chan->n_write_sleeper = 0;
+	chan->write_wake_seq = 0;
 	chan->write_cursor = 0;
-	chan->read_cursor = capacity - 1;
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_MULTI_READER)
+	{
+		chan->read_cursor = 0;
+	}
+	else
+	{
+		chan->read_cursor = capacity - 1;
+	}
 	chan->write_futex = MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK;
 
 	int ret = muggle_mutex_init(&chan->write_mutex);
@@ -164,35 +519,75 @@ int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int
 	for (muggle_atomic_int i = 0; i < capacity; i++)
 	{
 		memset(&chan->blocks[i], 0, sizeof(muggle_channel_block_t));
+		chan->blocks[i].seq = i;
+	}
+
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_MULTI_READER)
+	{
+		chan->fn_write = muggle_channel_write_mpmc;
+		chan->fn_write_batch = muggle_channel_write_batch_mpmc;
+		chan->fn_read_batch = muggle_channel_read_batch_mpmc;
+		if (chan->flags & MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP)
+		{
+			chan->fn_read = muggle_channel_read_mpmc_busy_loop;
+			chan->fn_wake = muggle_channel_wake_busy_loop;
+		}
+		else
+		{
+			chan->fn_read = muggle_channel_read_mpmc_futex;
+			chan->fn_wake = muggle_channel_wake_futex;
+		}
+
+		return MUGGLE_OK;
 	}
 
 	if (chan->flags & MUGGLE_CHANNEL_FLAG_SINGLE_WRITER)
 	{
 		chan->fn_write = muggle_channel_write_single_writer;
+		chan->fn_write_batch = muggle_channel_write_batch_single_writer;
 	}
 	else if (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_FUTEX)
 	{
 		chan->fn_write = muggle_channel_write_futex;
+		chan->fn_write_batch = muggle_channel_write_batch_futex;
 	}
 	else
 	{
 		chan->fn_write = muggle_channel_write_mutex;
+		chan->fn_write_batch = muggle_channel_write_batch_mutex;
 	}
 
 	if (chan->flags & MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP)
 	{
 		chan->fn_read = muggle_channel_read_busy_loop;
+		chan->fn_read_batch = muggle_channel_read_batch_busy_loop;
 		chan->fn_wake = muggle_channel_wake_busy_loop;
 	}
 	else
 	{
 		chan->fn_read = muggle_channel_read_futex;
+		chan->fn_read_batch = muggle_channel_read_batch_futex;
 		chan->fn_wake = muggle_channel_wake_futex;
 	}
 
 	return MUGGLE_OK;
 }
 
+void muggle_channel_set_write_block_spin(muggle_channel_t *chan, int spin)
+{
+	chan->write_block_spin = spin > 0 ? spin : 0;
+}
+
+void muggle_channel_set_wait_strategy(muggle_channel_t *chan, const muggle_wait_strategy_t *ws)
+{
+	muggle_wait_strategy_init(&chan->wait_strategy, ws->spin, ws->yield, ws->flags);
+}
+
+void muggle_channel_set_drop_callback(muggle_channel_t *chan, fn_muggle_channel_drop fn_drop)
+{
+	chan->fn_drop = fn_drop;
+}
+
 void muggle_channel_destroy(muggle_channel_t *chan)
 {
 	if (chan->blocks)
@@ -207,6 +602,11 @@ void muggle_channel_destroy(muggle_channel_t *chan)
 int muggle_channel_write(muggle_channel_t *chan, void *data)
 {
 	int ret = chan->fn_write(chan, data);
+	while (ret == MUGGLE_ERR_FULL && muggle_channel_handle_full(chan))
+	{
+		ret = chan->fn_write(chan, data);
+	}
+
 	if (ret == 0)
 	{
 		chan->fn_wake(chan);
@@ -216,5 +616,126 @@ int muggle_channel_write(muggle_channel_t *chan, void *data)
 
 void* muggle_channel_read(muggle_channel_t *chan)
 {
-	return chan->fn_read(chan);
+	void *data = chan->fn_read(chan);
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_BLOCK)
+	{
+		muggle_channel_wake_writer(chan);
+	}
+	return data;
+}
+
+int muggle_channel_write_batch(muggle_channel_t *chan, void **datas, int n)
+{
+	if (n <= 0)
+	{
+		return 0;
+	}
+
+	int cnt = 0;
+	int need_wake = 0;
+	while (1)
+	{
+		int ret = chan->fn_write_batch(chan, datas + cnt, n - cnt);
+		if (ret > 0)
+		{
+			cnt += ret;
+			need_wake = 1;
+		}
+
+		if (cnt == n)
+		{
+			break;
+		}
+
+		// reader must see written datas before writer block
+		if (need_wake && (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_BLOCK))
+		{
+			chan->fn_wake(chan);
+			need_wake = 0;
+		}
+
+		if (!muggle_channel_handle_full(chan))
+		{
+			break;
+		}
+	}
+
+	if (need_wake)
+	{
+		chan->fn_wake(chan);
+	}
+	return cnt;
+}
+
+int muggle_channel_read_batch(muggle_channel_t *chan, void **datas, int n)
+{
+	if (n <= 0)
+	{
+		return 0;
+	}
+
+	int cnt = chan->fn_read_batch(chan, datas, n);
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_BLOCK)
+	{
+		muggle_channel_wake_writer(chan);
+	}
+	return cnt;
+}
+
+int muggle_channel_try_read(muggle_channel_t *chan, void **data)
+{
+	muggle_atomic_int w_cursor = 0;
+	if (muggle_channel_try_fetch(chan, data, &w_cursor) != 1)
+	{
+		return MUGGLE_ERR_EMPTY;
+	}
+
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_BLOCK)
+	{
+		muggle_channel_wake_writer(chan);
+	}
+	return MUGGLE_OK;
+}
+
+int muggle_channel_read_timeout(muggle_channel_t *chan, void **data, const struct timespec *timeout)
+{
+	if (timeout == NULL)
+	{
+		*data = muggle_channel_read(chan);
+		return MUGGLE_OK;
+	}
+
+	struct timespec deadline, remain;
+	muggle_deadline_set(&deadline, timeout);
+
+	muggle_atomic_int w_cursor = 0;
+	while (1)
+	{
+		int ret = muggle_channel_try_fetch(chan, data, &w_cursor);
+		if (ret == 1)
+		{
+			break;
+		}
+
+		if (!muggle_deadline_remain(&deadline, &remain))
+		{
+			return MUGGLE_ERR_TIMEOUT;
+		}
+
+		// writers of busy loop channel never wake readers
+		if (ret == 0 && !(chan->flags & MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP))
+		{
+			muggle_wait_strategy_wait(&chan->wait_strategy, &chan->write_cursor, w_cursor, &remain);
+		}
+		else
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_WRITE_BLOCK)
+	{
+		muggle_channel_wake_writer(chan);
+	}
+	return MUGGLE_OK;
 }
@@ -7,8 +7,10 @@
  *  @license      MIT License
  *  @brief        mugglec channel
  *
- * Passing data between threads, user must gurantee only one reader use channel at the same time
- * When channel full, write will failed and return enum MUGGLE_ERR_*
+ * Passing data between threads, user must gurantee only one reader use channel at the same time,
+ * unless channel initialized with MUGGLE_CHANNEL_FLAG_MULTI_READER
+ * When channel full, write will failed and return enum MUGGLE_ERR_*, unless channel initialized
+ * with MUGGLE_CHANNEL_FLAG_WRITE_BLOCK or MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST
  * When channel empty, read will block until data write into channel
  *
  * muggle_channel_t and muggle_ring_buffer_t with only one reader are very similar, but most important different is
@@ -20,8 +22,10 @@
 #define MUGGLE_C_CHANNEL_H_
 
 #include "muggle/c/base/macro.h"
+#include <time.h>
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
+#include "muggle/c/sync/wait_strategy.h"
 
 EXTERN_C_BEGIN
 
@@ -33,6 +37,9 @@ enum
 	MUGGLE_CHANNEL_FLAG_SINGLE_WRITER  = 0x01, //!< user guarantee only one writer use this channel
 	MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP = 0x02, //!< reader busy loop until read message from channel
 	MUGGLE_CHANNEL_FLAG_WRITE_FUTEX    = 0x04, //!< write lock use futex
+	MUGGLE_CHANNEL_FLAG_MULTI_READER   = 0x08, //!< allow multiple readers, use lock-free per slot sequence for read and write, ignore write lock flags
+	MUGGLE_CHANNEL_FLAG_WRITE_BLOCK    = 0x10, //!< when channel full, writer spin then block until reader free space
+	MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST = 0x20, //!< when channel full, writer drop the oldest message, imply MUGGLE_CHANNEL_FLAG_MULTI_READER
 };
 
 enum
@@ -47,6 +54,7 @@ enum
 typedef struct muggle_channel_block
 {
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int seq; //!< slot sequence, only for MUGGLE_CHANNEL_FLAG_MULTI_READER
 	void *data;
 }muggle_channel_block_t;
 
@@ -54,6 +62,9 @@ struct muggle_channel;
 typedef int (*fn_muggle_channel_write)(struct muggle_channel *chan, void *data);
 typedef void* (*fn_muggle_channel_read)(struct muggle_channel *chan);
 typedef void (*fn_muggle_channel_wake)(struct muggle_channel *chan);
+typedef int (*fn_muggle_channel_write_batch)(struct muggle_channel *chan, void **datas, int n);
+typedef int (*fn_muggle_channel_read_batch)(struct muggle_channel *chan, void **datas, int n);
+typedef void (*fn_muggle_channel_drop)(void *data);
 
 /**
  * @brief channel
@@ -66,6 +77,11 @@ typedef struct muggle_channel
 	fn_muggle_channel_write fn_write;
 	fn_muggle_channel_read  fn_read;
 	fn_muggle_channel_wake  fn_wake;
+	fn_muggle_channel_write_batch fn_write_batch;
+	fn_muggle_channel_read_batch  fn_read_batch;
+	fn_muggle_channel_drop  fn_drop;          //!< callback for message dropped by MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST
+	int                     write_block_spin; //!< number of spin before writer block, for MUGGLE_CHANNEL_FLAG_WRITE_BLOCK
+	muggle_wait_strategy_t  wait_strategy;    //!< how reader and futex write lock wait before park
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
 	muggle_atomic_int write_cursor;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
@@ -73,10 +89,13 @@ typedef struct muggle_channel
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
 	muggle_atomic_int write_futex;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
-	muggle_mutex_t write_mutex;
+	muggle_atomic_int n_write_sleeper; //!< number of writers blocked on full channel
+	muggle_atomic_int write_wake_seq;  //!< futex of writers blocked on full channel
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(5);
-	muggle_channel_block_t *blocks;
+	muggle_mutex_t write_mutex;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(6);
+	muggle_channel_block_t *blocks;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(7);
 }muggle_channel_t;
 
 /**
@@ -93,6 +112,41 @@ typedef struct muggle_channel
 MUGGLE_C_EXPORT
 int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int flags);
 
+/**
+ * @brief set number of spin before writer block on full channel
+ *
+ * only take effect with MUGGLE_CHANNEL_FLAG_WRITE_BLOCK
+ *
+ * @param chan  pointer to muggle_channel_t
+ * @param spin  number of full check before writer block, default 0
+ */
+MUGGLE_C_EXPORT
+void muggle_channel_set_write_block_spin(muggle_channel_t *chan, int spin);
+
+/**
+ * @brief set wait strategy of reader and futex write lock
+ *
+ * by default, waiter park on futex immediately, not take effect with
+ * MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP reader and mutex write lock
+ *
+ * @param chan  pointer to muggle_channel_t
+ * @param ws    wait strategy, it will be copied into channel
+ */
+MUGGLE_C_EXPORT
+void muggle_channel_set_wait_strategy(muggle_channel_t *chan, const muggle_wait_strategy_t *ws);
+
+/**
+ * @brief set callback for dropped message
+ *
+ * only take effect with MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST, callback will be
+ * invoked in writer's thread, user can release dropped message in it
+ *
+ * @param chan     pointer to muggle_channel_t
+ * @param fn_drop  drop callback
+ */
+MUGGLE_C_EXPORT
+void muggle_channel_set_drop_callback(muggle_channel_t *chan, fn_muggle_channel_drop fn_drop);
+
 /**
  * @brief destroy muggle_channel_t
  *
@@ -124,6 +178,61 @@ int muggle_channel_write(muggle_channel_t *chan, void *data);
 MUGGLE_C_EXPORT
 void* muggle_channel_read(muggle_channel_t *chan);
 
+/**
+ * @brief try read data from channel without block
+ *
+ * @param chan  pointer to muggle_channel_t
+ * @param data  store data pointer on success
+ *
+ * @return 
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_EMPTY if channel is empty
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_try_read(muggle_channel_t *chan, void **data);
+
+/**
+ * @brief read data from channel, block at most timeout
+ *
+ * @param chan     pointer to muggle_channel_t
+ * @param data     store data pointer on success
+ * @param timeout  relative timeout, NULL means wait forever
+ *
+ * @return 
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT if channel still empty after timeout
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_read_timeout(muggle_channel_t *chan, void **data, const struct timespec *timeout);
+
+/**
+ * @brief write a batch of data into channel
+ *
+ * claim free slots for datas with a single cursor move and wake reader once
+ *
+ * @param chan   pointer to muggle_channel_t
+ * @param datas  array of data pointer
+ * @param n      number of data in datas
+ *
+ * @return number of data written into channel, less than n means channel is full
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_write_batch(muggle_channel_t *chan, void **datas, int n);
+
+/**
+ * @brief read a batch of data from channel
+ *
+ * block until at least one data is ready, then get up to n ready data
+ *
+ * @param chan   pointer to muggle_channel_t
+ * @param datas  array for store data pointer
+ * @param n      max number of data to read
+ *
+ * @return number of data stored in datas
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_read_batch(muggle_channel_t *chan, void **datas, int n);
+
 EXTERN_C_END
 
 #endif
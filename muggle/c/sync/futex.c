@@ -43,6 +43,33 @@ void muggle_futex_wake_all(muggle_atomic_int *futex_addr)
 	WakeByAddressAll(futex_addr);
 }
 
+int muggle_futex_wait_shared(muggle_atomic_int *futex_addr, muggle_atomic_int val, const struct timespec *timeout)
+{
+	if (InterlockedOr(futex_addr, 0) != val)
+	{
+		return 0;
+	}
+
+	DWORD dwMilliseconds = 1;
+	if (timeout != NULL && timeout->tv_sec == 0 && timeout->tv_nsec == 0)
+	{
+		dwMilliseconds = 0;
+	}
+	Sleep(dwMilliseconds);
+
+	return 0;
+}
+
+void muggle_futex_wake_one_shared(muggle_atomic_int *futex_addr)
+{
+	(void)futex_addr;
+}
+
+void muggle_futex_wake_all_shared(muggle_atomic_int *futex_addr)
+{
+	(void)futex_addr;
+}
+
 
 #else
 
@@ -72,5 +99,20 @@ void muggle_futex_wake_all(muggle_atomic_int *futex_addr)
 	futex(futex_addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX, NULL, NULL, 0);
 }
 
+int muggle_futex_wait_shared(muggle_atomic_int *futex_addr, muggle_atomic_int val, const struct timespec *timeout)
+{
+	return futex(futex_addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+void muggle_futex_wake_one_shared(muggle_atomic_int *futex_addr)
+{
+	futex(futex_addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+void muggle_futex_wake_all_shared(muggle_atomic_int *futex_addr)
+{
+	futex(futex_addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
 
 #endif
@@ -45,6 +45,39 @@ void muggle_futex_wake_one(muggle_atomic_int *futex_addr);
 MUGGLE_C_EXPORT
 void muggle_futex_wake_all(muggle_atomic_int *futex_addr);
 
+/**
+ * @brief futex wait, futex word can be shared between processes
+ *
+ * muggle_futex_wait* only wake up waiters in the same process, use this one
+ * when futex word lives in shared memory.
+ * NOTE: on windows, WaitOnAddress can't cross process, it fallback to sleep
+ * at most 1 millisecond and return
+ *
+ * @param futex_addr  futex address
+ * @param val         futex wait value
+ * @param timeout     timeout
+ *
+ * @return
+ */
+MUGGLE_C_EXPORT
+int muggle_futex_wait_shared(muggle_atomic_int *futex_addr, muggle_atomic_int val, const struct timespec *timeout);
+
+/**
+ * @brief futex wake one thread, futex word can be shared between processes
+ *
+ * @param futex_addr  futex address
+ */
+MUGGLE_C_EXPORT
+void muggle_futex_wake_one_shared(muggle_atomic_int *futex_addr);
+
+/**
+ * @brief futex wake all thread, futex word can be shared between processes
+ *
+ * @param futex_addr  futex address
+ */
+MUGGLE_C_EXPORT
+void muggle_futex_wake_all_shared(muggle_atomic_int *futex_addr);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,546 @@
+/******************************************************************************
+ *  @file         ipc_ring_buffer.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec inter-process ring buffer
+ *****************************************************************************/
+
+#include "ipc_ring_buffer.h"
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
+
+#if !MUGGLE_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define MUGGLE_IPC_RING_BUFFER_MAGIC 0x4d495242 // "MIRB"
+#define MUGGLE_IPC_RING_BUFFER_ROUND_UP(x, align) (((x) + (align) - 1) / (align) * (align))
+
+enum
+{
+	MUGGLE_IPC_RING_BUFFER_STATE_INIT = 0,  //!< zero filled new memory or in the middle of initialization
+	MUGGLE_IPC_RING_BUFFER_STATE_READY = 1,
+	MUGGLE_IPC_RING_BUFFER_STATE_UNLINKED = 2, //!< name removed, attached peers should attach again
+};
+
+/**
+ * @brief slot header, followed by message bytes
+ */
+typedef struct muggle_ipc_ring_buffer_slot
+{
+	muggle_atomic_int seq;
+	muggle_atomic_int len;
+}muggle_ipc_ring_buffer_slot_t;
+
+#define MUGGLE_IPC_RING_BUFFER_BLOCKS_OFFSET \
+	MUGGLE_IPC_RING_BUFFER_ROUND_UP(sizeof(muggle_ipc_ring_buffer_header_t), MUGGLE_CACHE_LINE_SIZE)
+
+#define MUGGLE_IPC_RING_BUFFER_SLOT(r, pos) \
+	((muggle_ipc_ring_buffer_slot_t*)((r)->blocks + \
+		(size_t)IDX_IN_POW_OF_2_RING((pos), (r)->capacity) * (size_t)(r)->block_size))
+
+static void muggle_ipc_ring_buffer_mark_unlinked(const char *name);
+
+/***************** shared memory *****************/
+#if MUGGLE_PLATFORM_WINDOWS
+
+static void* muggle_ipc_ring_buffer_map_create(muggle_ipc_ring_buffer_t *r, const char *name, size_t size)
+{
+	r->handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+		(DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xffffffff), name);
+	if (r->handle == NULL)
+	{
+		return NULL;
+	}
+	if (GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		CloseHandle(r->handle);
+		r->handle = NULL;
+		return NULL;
+	}
+
+	void *p = MapViewOfFile(r->handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (p == NULL)
+	{
+		CloseHandle(r->handle);
+		r->handle = NULL;
+	}
+	return p;
+}
+
+static void* muggle_ipc_ring_buffer_map_open(muggle_ipc_ring_buffer_t *r, const char *name, size_t *size)
+{
+	r->handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+	if (r->handle == NULL)
+	{
+		return NULL;
+	}
+
+	void *p = MapViewOfFile(r->handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (p == NULL)
+	{
+		CloseHandle(r->handle);
+		r->handle = NULL;
+		return NULL;
+	}
+
+	MEMORY_BASIC_INFORMATION info;
+	if (VirtualQuery(p, &info, sizeof(info)) == 0)
+	{
+		UnmapViewOfFile(p);
+		CloseHandle(r->handle);
+		r->handle = NULL;
+		return NULL;
+	}
+	*size = (size_t)info.RegionSize;
+
+	return p;
+}
+
+static void muggle_ipc_ring_buffer_unmap(muggle_ipc_ring_buffer_t *r)
+{
+	if (r->header)
+	{
+		UnmapViewOfFile(r->header);
+	}
+	if (r->handle)
+	{
+		CloseHandle(r->handle);
+	}
+	r->header = NULL;
+	r->handle = NULL;
+}
+
+int muggle_ipc_ring_buffer_unlink(const char *name)
+{
+	// windows release file mapping after last handle closed
+	muggle_ipc_ring_buffer_mark_unlinked(name);
+	return MUGGLE_OK;
+}
+
+#else
+
+static void* muggle_ipc_ring_buffer_map_create(muggle_ipc_ring_buffer_t *r, const char *name, size_t size)
+{
+	// never resize or reinitialize memory that other processes may still
+	// map, it must be unlinked first
+	r->fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+	if (r->fd == -1)
+	{
+		return NULL;
+	}
+
+	if (ftruncate(r->fd, (off_t)size) != 0)
+	{
+		close(r->fd);
+		r->fd = -1;
+		shm_unlink(name);
+		return NULL;
+	}
+
+	void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0);
+	if (p == MAP_FAILED)
+	{
+		close(r->fd);
+		r->fd = -1;
+		shm_unlink(name);
+		return NULL;
+	}
+	return p;
+}
+
+static void* muggle_ipc_ring_buffer_map_open(muggle_ipc_ring_buffer_t *r, const char *name, size_t *size)
+{
+	r->fd = shm_open(name, O_RDWR, 0666);
+	if (r->fd == -1)
+	{
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(r->fd, &st) != 0 || st.st_size <= 0)
+	{
+		close(r->fd);
+		r->fd = -1;
+		return NULL;
+	}
+
+	void *p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0);
+	if (p == MAP_FAILED)
+	{
+		close(r->fd);
+		r->fd = -1;
+		return NULL;
+	}
+	*size = (size_t)st.st_size;
+
+	return p;
+}
+
+static void muggle_ipc_ring_buffer_unmap(muggle_ipc_ring_buffer_t *r)
+{
+	if (r->header)
+	{
+		munmap(r->header, r->map_size);
+	}
+	if (r->fd != -1)
+	{
+		close(r->fd);
+	}
+	r->header = NULL;
+	r->fd = -1;
+}
+
+int muggle_ipc_ring_buffer_unlink(const char *name)
+{
+	muggle_ipc_ring_buffer_mark_unlinked(name);
+	if (shm_unlink(name) != 0)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+	return MUGGLE_OK;
+}
+
+#endif
+
+/***************** create and attach *****************/
+/**
+ * @brief tell processes still attached to the ring that it's going away
+ */
+static void muggle_ipc_ring_buffer_mark_unlinked(const char *name)
+{
+	muggle_ipc_ring_buffer_t r;
+	memset(&r, 0, sizeof(r));
+#if !MUGGLE_PLATFORM_WINDOWS
+	r.fd = -1;
+#endif
+
+	size_t size = 0;
+	void *p = muggle_ipc_ring_buffer_map_open(&r, name, &size);
+	if (p == NULL)
+	{
+		return;
+	}
+	r.header = (muggle_ipc_ring_buffer_header_t*)p;
+	r.map_size = size;
+
+	if (size >= MUGGLE_IPC_RING_BUFFER_BLOCKS_OFFSET)
+	{
+		// wake parked readers, let them find out ring is stale
+		muggle_ipc_ring_buffer_header_t *h = r.header;
+		muggle_atomic_store(&h->state, MUGGLE_IPC_RING_BUFFER_STATE_UNLINKED, muggle_memory_order_seq_cst);
+		muggle_atomic_fetch_add(&h->wake_seq, 1, muggle_memory_order_seq_cst);
+		muggle_futex_wake_all_shared(&h->wake_seq);
+	}
+
+	muggle_ipc_ring_buffer_unmap(&r);
+}
+
+static void muggle_ipc_ring_buffer_init_header(muggle_ipc_ring_buffer_t *r)
+{
+	muggle_ipc_ring_buffer_header_t *h = r->header;
+
+	// memory is new and zero filled, state is INIT until ready, if creator
+	// crash before ready, attach will refuse this memory
+	h->magic = MUGGLE_IPC_RING_BUFFER_MAGIC;
+	h->capacity = r->capacity;
+	h->slot_size = r->slot_size;
+	h->block_size = r->block_size;
+	h->flags = r->flags;
+	h->total_size = (uint64_t)r->map_size;
+	muggle_atomic_store(&h->write_cursor, 0, muggle_memory_order_relaxed);
+	muggle_atomic_store(&h->read_cursor, 0, muggle_memory_order_relaxed);
+	for (muggle_atomic_int i = 0; i < r->capacity; i++)
+	{
+		muggle_ipc_ring_buffer_slot_t *slot = MUGGLE_IPC_RING_BUFFER_SLOT(r, i);
+		muggle_atomic_store(&slot->seq, i, muggle_memory_order_relaxed);
+		slot->len = 0;
+	}
+
+	// NOTE: if a reader process crash while parked, its n_sleeper count is
+	// never released, from then on every write pays a futex wake syscall,
+	// unlink and create the ring again to get rid of it
+	r->epoch = muggle_atomic_load(&h->epoch, muggle_memory_order_relaxed) + 1;
+	muggle_atomic_store(&h->epoch, r->epoch, muggle_memory_order_relaxed);
+	muggle_atomic_store(&h->state, MUGGLE_IPC_RING_BUFFER_STATE_READY, muggle_memory_order_release);
+}
+
+int muggle_ipc_ring_buffer_create(
+	muggle_ipc_ring_buffer_t *r, const char *name,
+	muggle_atomic_int capacity, muggle_atomic_int slot_size, int flags)
+{
+	memset(r, 0, sizeof(*r));
+#if !MUGGLE_PLATFORM_WINDOWS
+	r->fd = -1;
+#endif
+
+	if (name == NULL)
+	{
+		return MUGGLE_ERR_NULL_PARAM;
+	}
+	if (capacity <= 1 || slot_size <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	capacity = (muggle_atomic_int)next_pow_of_2((uint64_t)capacity);
+	if (capacity <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	r->capacity = capacity;
+	r->slot_size = slot_size;
+	r->block_size = (muggle_atomic_int)MUGGLE_IPC_RING_BUFFER_ROUND_UP(
+		sizeof(muggle_ipc_ring_buffer_slot_t) + (size_t)slot_size, MUGGLE_CACHE_LINE_SIZE);
+	r->flags = flags;
+	r->map_size = MUGGLE_IPC_RING_BUFFER_BLOCKS_OFFSET + (size_t)r->block_size * (size_t)capacity;
+
+	void *p = muggle_ipc_ring_buffer_map_create(r, name, r->map_size);
+	if (p == NULL)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+	r->header = (muggle_ipc_ring_buffer_header_t*)p;
+	r->blocks = (char*)p + MUGGLE_IPC_RING_BUFFER_BLOCKS_OFFSET;
+
+	muggle_ipc_ring_buffer_init_header(r);
+
+	return MUGGLE_OK;
+}
+
+int muggle_ipc_ring_buffer_attach(muggle_ipc_ring_buffer_t *r, const char *name)
+{
+	memset(r, 0, sizeof(*r));
+#if !MUGGLE_PLATFORM_WINDOWS
+	r->fd = -1;
+#endif
+
+	if (name == NULL)
+	{
+		return MUGGLE_ERR_NULL_PARAM;
+	}
+
+	size_t size = 0;
+	void *p = muggle_ipc_ring_buffer_map_open(r, name, &size);
+	if (p == NULL)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+	r->header = (muggle_ipc_ring_buffer_header_t*)p;
+	r->map_size = size;
+
+	if (size < MUGGLE_IPC_RING_BUFFER_BLOCKS_OFFSET)
+	{
+		muggle_ipc_ring_buffer_unmap(r);
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_ipc_ring_buffer_header_t *h = r->header;
+	if (muggle_atomic_load(&h->state, muggle_memory_order_acquire) != MUGGLE_IPC_RING_BUFFER_STATE_READY ||
+		h->magic != MUGGLE_IPC_RING_BUFFER_MAGIC)
+	{
+		muggle_ipc_ring_buffer_unmap(r);
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	r->epoch = muggle_atomic_load(&h->epoch, muggle_memory_order_relaxed);
+	r->capacity = h->capacity;
+	r->slot_size = h->slot_size;
+	r->block_size = h->block_size;
+	r->flags = h->flags;
+
+	// validate geometry against local mapping, never touch memory out of it
+	if (r->capacity <= 1 || IDX_IN_POW_OF_2_RING(r->capacity, r->capacity) != 0 ||
+		r->slot_size <= 0 ||
+		(size_t)r->block_size < sizeof(muggle_ipc_ring_buffer_slot_t) + (size_t)r->slot_size ||
+		MUGGLE_IPC_RING_BUFFER_BLOCKS_OFFSET + (size_t)r->block_size * (size_t)r->capacity > size)
+	{
+		muggle_ipc_ring_buffer_unmap(r);
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+	r->blocks = (char*)p + MUGGLE_IPC_RING_BUFFER_BLOCKS_OFFSET;
+
+	return MUGGLE_OK;
+}
+
+void muggle_ipc_ring_buffer_detach(muggle_ipc_ring_buffer_t *r)
+{
+	muggle_ipc_ring_buffer_unmap(r);
+	r->blocks = NULL;
+}
+
+int muggle_ipc_ring_buffer_is_stale(muggle_ipc_ring_buffer_t *r)
+{
+	muggle_ipc_ring_buffer_header_t *h = r->header;
+	return muggle_atomic_load(&h->state, muggle_memory_order_acquire) != MUGGLE_IPC_RING_BUFFER_STATE_READY ||
+		muggle_atomic_load(&h->epoch, muggle_memory_order_relaxed) != r->epoch;
+}
+
+/***************** write and read *****************/
+/*
+ * slot protocol is the same as muggle_channel_t with multiple readers: slot
+ * is free for writer at position pos when seq == pos, and ready for reader
+ * when seq == pos + 1, after reader copy message, seq is set to
+ * pos + capacity for next round of writer
+ */
+int muggle_ipc_ring_buffer_write(muggle_ipc_ring_buffer_t *r, const void *data, int num_bytes)
+{
+	if (num_bytes < 0 || num_bytes > r->slot_size)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_ipc_ring_buffer_header_t *h = r->header;
+	muggle_ipc_ring_buffer_slot_t *slot = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&h->write_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		slot = MUGGLE_IPC_RING_BUFFER_SLOT(r, pos);
+		muggle_atomic_int seq = muggle_atomic_load(&slot->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - pos;
+		if (diff == 0)
+		{
+			if (r->flags & MUGGLE_IPC_RING_BUFFER_FLAG_SINGLE_WRITER)
+			{
+				muggle_atomic_store(&h->write_cursor, pos + 1, muggle_memory_order_relaxed);
+				break;
+			}
+			if (muggle_atomic_cmp_exch_weak(&h->write_cursor, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return MUGGLE_ERR_FULL;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&h->write_cursor, muggle_memory_order_relaxed);
+		}
+	}
+
+	memcpy((char*)(slot + 1), data, (size_t)num_bytes);
+	slot->len = num_bytes;
+	muggle_atomic_store(&slot->seq, pos + 1, muggle_memory_order_release);
+
+	// pair with reader's increase of n_sleeper
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&h->n_sleeper, muggle_memory_order_relaxed) > 0)
+	{
+		muggle_atomic_fetch_add(&h->wake_seq, 1, muggle_memory_order_relaxed);
+		muggle_futex_wake_all_shared(&h->wake_seq);
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_ipc_ring_buffer_try_read(muggle_ipc_ring_buffer_t *r, void *buf, int *num_bytes)
+{
+	muggle_ipc_ring_buffer_header_t *h = r->header;
+	muggle_ipc_ring_buffer_slot_t *slot = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&h->read_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		slot = MUGGLE_IPC_RING_BUFFER_SLOT(r, pos);
+		muggle_atomic_int seq = muggle_atomic_load(&slot->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - (pos + 1);
+		if (diff == 0)
+		{
+			if (muggle_atomic_cmp_exch_weak(&h->read_cursor, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			// empty, or writer claimed slot but not publish yet, writer
+			// will wake sleeping reader after publish
+			return MUGGLE_ERR_EMPTY;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&h->read_cursor, muggle_memory_order_relaxed);
+		}
+	}
+
+	int len = slot->len;
+	if (len < 0 || len > r->slot_size)
+	{
+		len = 0;
+	}
+	memcpy(buf, (char*)(slot + 1), (size_t)len);
+	if (num_bytes)
+	{
+		*num_bytes = len;
+	}
+	muggle_atomic_store(&slot->seq, pos + r->capacity, muggle_memory_order_release);
+
+	return MUGGLE_OK;
+}
+
+int muggle_ipc_ring_buffer_read_timeout(
+	muggle_ipc_ring_buffer_t *r, void *buf, int *num_bytes, const struct timespec *timeout)
+{
+	muggle_ipc_ring_buffer_header_t *h = r->header;
+
+	struct timespec deadline, remain;
+	if (timeout)
+	{
+		muggle_deadline_set(&deadline, timeout);
+	}
+
+	while (1)
+	{
+		if (muggle_ipc_ring_buffer_try_read(r, buf, num_bytes) == MUGGLE_OK)
+		{
+			return MUGGLE_OK;
+		}
+
+		if (muggle_ipc_ring_buffer_is_stale(r))
+		{
+			return MUGGLE_ERR_INTERRUPT;
+		}
+
+		muggle_atomic_int wake_seq = muggle_atomic_load(&h->wake_seq, muggle_memory_order_relaxed);
+		muggle_atomic_fetch_add(&h->n_sleeper, 1, muggle_memory_order_seq_cst);
+
+		// check again after count self in sleeper, writer publish before
+		// this point is seen here, otherwise writer will see the sleeper
+		if (muggle_ipc_ring_buffer_try_read(r, buf, num_bytes) == MUGGLE_OK)
+		{
+			muggle_atomic_fetch_sub(&h->n_sleeper, 1, muggle_memory_order_relaxed);
+			return MUGGLE_OK;
+		}
+
+		if (timeout)
+		{
+			if (!muggle_deadline_remain(&deadline, &remain))
+			{
+				muggle_atomic_fetch_sub(&h->n_sleeper, 1, muggle_memory_order_relaxed);
+				return MUGGLE_ERR_TIMEOUT;
+			}
+			muggle_futex_wait_shared(&h->wake_seq, wake_seq, &remain);
+		}
+		else
+		{
+			muggle_futex_wait_shared(&h->wake_seq, wake_seq, NULL);
+		}
+		muggle_atomic_fetch_sub(&h->n_sleeper, 1, muggle_memory_order_relaxed);
+	}
+}
+
+int muggle_ipc_ring_buffer_read(muggle_ipc_ring_buffer_t *r, void *buf, int *num_bytes)
+{
+	return muggle_ipc_ring_buffer_read_timeout(r, buf, num_bytes, NULL);
+}
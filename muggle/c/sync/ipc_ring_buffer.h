@@ -0,0 +1,219 @@
+/******************************************************************************
+ *  @file         ipc_ring_buffer.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec inter-process ring buffer
+ *
+ * Ring buffer in named shared memory, for passing messages between processes
+ *
+ * cursors and fixed size slots are laid out in the shared memory, messages
+ * are copied into and out of slots, slots use the same per slot sequence
+ * protocol as muggle_channel_t with MUGGLE_CHANNEL_FLAG_MULTI_READER, so
+ * multiple writer and reader processes are allowed
+ *
+ * one process create the shared memory, other processes attach it. create
+ * fails if the name already exists, memory that other processes may still
+ * map is never resized or reinitialized. after a crashed process leave the
+ * ring in a broken state (e.g. died in the middle of initialization, or
+ * claimed slot but not publish), unlink the name and create again to
+ * recover, unlink marks the old ring stale, peers attached to it should
+ * check muggle_ipc_ring_buffer_is_stale and attach again
+ *
+ * NOTE: on windows, reader can't park across process, it sleep 1ms when
+ * there is no message
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_IPC_RING_BUFFER_H_
+#define MUGGLE_C_IPC_RING_BUFFER_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "muggle/c/base/atomic.h"
+
+#if MUGGLE_PLATFORM_WINDOWS
+#include <windows.h>
+#endif
+
+EXTERN_C_BEGIN
+
+enum
+{
+	MUGGLE_IPC_RING_BUFFER_FLAG_MULTI_WRITER  = 0x00, //!< default, allow multiple writers
+	MUGGLE_IPC_RING_BUFFER_FLAG_SINGLE_WRITER = 0x01, //!< user guarantee only one writer use this ring
+};
+
+/**
+ * @brief header of ipc ring buffer, lives in shared memory
+ */
+typedef struct muggle_ipc_ring_buffer_header
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	uint32_t magic;
+	muggle_atomic_int state;      //!< MUGGLE_IPC_RING_BUFFER_STATE_*
+	muggle_atomic_int epoch;      //!< increase every time ring is initialized
+	muggle_atomic_int capacity;   //!< number of slots
+	muggle_atomic_int slot_size;  //!< max bytes of message
+	muggle_atomic_int block_size; //!< bytes of slot with slot header
+	int flags;
+	uint64_t total_size;          //!< bytes of the whole shared memory
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int write_cursor;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	muggle_atomic_int read_cursor;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int n_sleeper;  //!< number of readers parked on wake_seq
+	muggle_atomic_int wake_seq;   //!< futex of readers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
+}muggle_ipc_ring_buffer_header_t;
+
+/**
+ * @brief process local handle of ipc ring buffer
+ */
+typedef struct muggle_ipc_ring_buffer
+{
+	muggle_ipc_ring_buffer_header_t *header;
+	char *blocks;
+	muggle_atomic_int capacity;   //!< copy of header, never trust shared memory for bounds
+	muggle_atomic_int slot_size;
+	muggle_atomic_int block_size;
+	int flags;
+	muggle_atomic_int epoch;      //!< epoch when create or attach
+	size_t map_size;
+#if MUGGLE_PLATFORM_WINDOWS
+	HANDLE handle;
+#else
+	int fd;
+#endif
+}muggle_ipc_ring_buffer_t;
+
+/**
+ * @brief create named ipc ring buffer and attach it
+ *
+ * @param r          ipc ring buffer handle
+ * @param name       shared memory name, e.g. "/my_ring"
+ * @param capacity   number of slots, will be rounded up to power of 2
+ * @param slot_size  max bytes of a single message
+ * @param flags      bit OR operation of MUGGLE_IPC_RING_BUFFER_FLAG_*
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_SYS_CALL if name already exists or failed map memory
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_create(
+	muggle_ipc_ring_buffer_t *r, const char *name,
+	muggle_atomic_int capacity, muggle_atomic_int slot_size, int flags);
+
+/**
+ * @brief attach named ipc ring buffer that created by other process
+ *
+ * @param r     ipc ring buffer handle
+ * @param name  shared memory name
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_SYS_CALL if shared memory not exists
+ *     - return MUGGLE_ERR_INVALID_PARAM if shared memory not initialized or broken
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_attach(muggle_ipc_ring_buffer_t *r, const char *name);
+
+/**
+ * @brief detach ipc ring buffer, shared memory is kept
+ *
+ * @param r  ipc ring buffer handle
+ */
+MUGGLE_C_EXPORT
+void muggle_ipc_ring_buffer_detach(muggle_ipc_ring_buffer_t *r);
+
+/**
+ * @brief remove name of shared memory and mark ring stale, memory is
+ * released after all processes detached
+ *
+ * @param name  shared memory name
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_unlink(const char *name);
+
+/**
+ * @brief check whether ring was unlinked after create or attach
+ *
+ * @param r  ipc ring buffer handle
+ *
+ * @return 1 if stale, user should detach and attach again
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_is_stale(muggle_ipc_ring_buffer_t *r);
+
+/**
+ * @brief copy message into ring
+ *
+ * @param r          ipc ring buffer handle
+ * @param data       message
+ * @param num_bytes  bytes of message, not greater than slot_size
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_FULL if ring is full
+ *     - return MUGGLE_ERR_INVALID_PARAM if num_bytes is invalid
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_write(muggle_ipc_ring_buffer_t *r, const void *data, int num_bytes);
+
+/**
+ * @brief copy message out of ring, block until message is ready
+ *
+ * @param r          ipc ring buffer handle
+ * @param buf        buffer with at least slot_size bytes
+ * @param num_bytes  store bytes of message
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_read(muggle_ipc_ring_buffer_t *r, void *buf, int *num_bytes);
+
+/**
+ * @brief copy message out of ring without block
+ *
+ * @param r          ipc ring buffer handle
+ * @param buf        buffer with at least slot_size bytes
+ * @param num_bytes  store bytes of message
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_EMPTY if ring is empty
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_try_read(muggle_ipc_ring_buffer_t *r, void *buf, int *num_bytes);
+
+/**
+ * @brief copy message out of ring, block at most timeout
+ *
+ * @param r          ipc ring buffer handle
+ * @param buf        buffer with at least slot_size bytes
+ * @param num_bytes  store bytes of message
+ * @param timeout    relative timeout, NULL means wait forever
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT if ring still empty after timeout
+ */
+MUGGLE_C_EXPORT
+int muggle_ipc_ring_buffer_read_timeout(
+	muggle_ipc_ring_buffer_t *r, void *buf, int *num_bytes, const struct timespec *timeout);
+
+EXTERN_C_END
+
+#endif
@@ -16,6 +16,7 @@
 #include "muggle/c/base/utils.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
 
 enum
 {
@@ -37,6 +38,9 @@ enum
 typedef void (*fn_muggle_ring_buffer_write)(muggle_ring_buffer_t *r, void *data);
 typedef void (*fn_muggle_ring_buffer_wake)(muggle_ring_buffer_t *r);
 typedef void* (*fn_muggle_ring_buffer_read)(muggle_ring_buffer_t *r, muggle_atomic_int idx);
+typedef void (*fn_muggle_ring_buffer_write_batch)(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int n);
+typedef muggle_atomic_int (*fn_muggle_ring_buffer_read_batch)(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int n);
 
 // convert flag to mode
 static int muggle_ring_buffer_get_mode(int flag, int *w_mode, int *r_mode)
@@ -131,10 +135,88 @@ inline static void muggle_ring_buffer_write_busy_loop(muggle_ring_buffer_t *r, v
 	}
 }
 
+// muggle ring_buffer batch write functions
+inline static void muggle_ring_buffer_assign_batch(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int n)
+{
+	for (muggle_atomic_int i = 0; i < n; ++i)
+	{
+		r->datas[IDX_IN_POW_OF_2_RING(idx + i, r->capacity)] = datas[i];
+	}
+}
+
+inline static void muggle_ring_buffer_write_batch_lock(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int n)
+{
+	muggle_mutex_lock(&r->write_mutex);
+
+	// assignment
+	muggle_ring_buffer_assign_batch(r, r->cursor, datas, n);
+
+	// move cursor
+	muggle_atomic_store(&r->cursor, r->cursor + n, muggle_memory_order_release);
+
+	muggle_mutex_unlock(&r->write_mutex);
+}
+
+inline static void muggle_ring_buffer_write_batch_single(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int n)
+{
+	// assignment
+	muggle_ring_buffer_assign_batch(r, r->cursor, datas, n);
+
+	// move cursor
+	muggle_atomic_store(&r->cursor, r->cursor + n, muggle_memory_order_release);
+}
+
+inline static void muggle_ring_buffer_write_batch_busy_loop(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int n)
+{
+	// move next
+	muggle_atomic_int idx = muggle_atomic_fetch_add(&r->next, n, muggle_memory_order_relaxed);
+
+	// assignment
+	muggle_ring_buffer_assign_batch(r, idx, datas, n);
+
+	// move cursor
+	muggle_atomic_int cur_idx = idx;
+	while (!muggle_atomic_cmp_exch_weak(&r->cursor, &cur_idx, idx + n, muggle_memory_order_release)
+			&& cur_idx != idx)
+	{
+		muggle_thread_yield();
+		cur_idx = idx;
+	}
+}
+
+// muggle ring_buffer sleep and wakeup helpers
+//
+// reader increase n_sleeper before enter futex wait, writer only enter kernel
+// when n_sleeper is not zero. the seq_cst RMW of reader and the seq_cst fence
+// of writer guarantee that, if writer see n_sleeper == 0, the reader's futex
+// wait must see the moved cursor and return immediately
+inline static void muggle_ring_buffer_sleep(
+	muggle_ring_buffer_t *r, muggle_atomic_int w_cursor, const struct timespec *timeout)
+{
+	if (muggle_wait_strategy_spin(&r->wait_strategy, &r->cursor, w_cursor))
+	{
+		return;
+	}
+
+	muggle_atomic_fetch_add(&r->n_sleeper, 1, muggle_memory_order_seq_cst);
+	muggle_futex_wait(&r->cursor, w_cursor, timeout);
+	muggle_atomic_fetch_sub(&r->n_sleeper, 1, muggle_memory_order_relaxed);
+}
+
+inline static int muggle_ring_buffer_has_sleeper(muggle_ring_buffer_t *r)
+{
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	return muggle_atomic_load(&r->n_sleeper, muggle_memory_order_relaxed) != 0;
+}
+
 // muggle ring_buffer wakeup functions
 inline static void muggle_ring_buffer_wake_wait(muggle_ring_buffer_t *r)
 {
-	muggle_futex_wake_all(&r->cursor);
+	if (muggle_ring_buffer_has_sleeper(r))
+	{
+		muggle_futex_wake_all(&r->cursor);
+	}
 }
 
 inline static void muggle_ring_buffer_wake_busy_loop(muggle_ring_buffer_t *r)
@@ -144,12 +226,18 @@ inline static void muggle_ring_buffer_wake_busy_loop(muggle_ring_buffer_t *r)
 
 inline static void muggle_ring_buffer_wake_single_wait(muggle_ring_buffer_t *r)
 {
-	muggle_futex_wake_one(&r->cursor);
+	if (muggle_ring_buffer_has_sleeper(r))
+	{
+		muggle_futex_wake_one(&r->cursor);
+	}
 }
 
 inline static void muggle_ring_buffer_wake_lock(muggle_ring_buffer_t *r)
 {
-	muggle_futex_wake_one(&r->cursor);
+	if (muggle_ring_buffer_has_sleeper(r))
+	{
+		muggle_futex_wake_one(&r->cursor);
+	}
 }
 
 // muggle ring_buffer read functions
@@ -164,7 +252,7 @@ inline static void* muggle_ring_buffer_read_wait(muggle_ring_buffer_t *r, muggle
 			return r->datas[r_pos];
 		}
 
-		muggle_futex_wait(&r->cursor, w_cursor, NULL);
+		muggle_ring_buffer_sleep(r, w_cursor, NULL);
 	} while (1);
 
 	return NULL;
@@ -201,13 +289,132 @@ inline static void* muggle_ring_buffer_read_lock(muggle_ring_buffer_t *r, muggle
 			r->read_cursor++;
 			break;
 		}
-		muggle_futex_wait(&r->cursor, w_cursor, NULL);
+		muggle_ring_buffer_sleep(r, w_cursor, NULL);
 	} while (1);
 	muggle_mutex_unlock(&r->read_mutex);
 
 	return ret;
 }
 
+// muggle ring_buffer batch read functions
+inline static muggle_atomic_int muggle_ring_buffer_fetch_batch(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, muggle_atomic_int w_cursor,
+	void **datas, muggle_atomic_int n)
+{
+	muggle_atomic_int cnt = IDX_IN_POW_OF_2_RING(w_cursor - idx, r->capacity);
+	if (cnt > n)
+	{
+		cnt = n;
+	}
+
+	for (muggle_atomic_int i = 0; i < cnt; ++i)
+	{
+		datas[i] = r->datas[IDX_IN_POW_OF_2_RING(idx + i, r->capacity)];
+	}
+
+	return cnt;
+}
+
+inline static muggle_atomic_int muggle_ring_buffer_read_batch_wait(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int n)
+{
+	muggle_atomic_int w_cursor;
+	do {
+		w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, r->capacity) != IDX_IN_POW_OF_2_RING(idx, r->capacity))
+		{
+			return muggle_ring_buffer_fetch_batch(r, idx, w_cursor, datas, n);
+		}
+
+		muggle_ring_buffer_sleep(r, w_cursor, NULL);
+	} while (1);
+
+	return 0;
+}
+
+inline static muggle_atomic_int muggle_ring_buffer_read_batch_busy_loop(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int n)
+{
+	muggle_atomic_int w_cursor;
+	do {
+		w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, r->capacity) != IDX_IN_POW_OF_2_RING(idx, r->capacity))
+		{
+			return muggle_ring_buffer_fetch_batch(r, idx, w_cursor, datas, n);
+		}
+
+		muggle_thread_yield();
+	} while (1);
+
+	return 0;
+}
+
+inline static muggle_atomic_int muggle_ring_buffer_read_batch_lock(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int n)
+{
+	(void)idx;
+
+	muggle_atomic_int cnt = 0;
+	muggle_mutex_lock(&r->read_mutex);
+	do {
+		muggle_atomic_int w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, r->capacity) != IDX_IN_POW_OF_2_RING(r->read_cursor, r->capacity))
+		{
+			cnt = muggle_ring_buffer_fetch_batch(r, r->read_cursor, w_cursor, datas, n);
+			r->read_cursor += cnt;
+			break;
+		}
+		muggle_ring_buffer_sleep(r, w_cursor, NULL);
+	} while (1);
+	muggle_mutex_unlock(&r->read_mutex);
+
+	return cnt;
+}
+
+// muggle ring_buffer non-blocking fetch
+//
+// return MUGGLE_OK on success, MUGGLE_ERR_EMPTY if no message ready, and
+// MUGGLE_ERR_ACQ_LOCK if message ready but read lock is held by other reader
+inline static int muggle_ring_buffer_try_fetch(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data, muggle_atomic_int *p_w_cursor)
+{
+	muggle_atomic_int w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+	*p_w_cursor = w_cursor;
+
+	if (r->read_mode != MUGGLE_RING_BUFFER_READ_MODE_LOCK)
+	{
+		muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(idx, r->capacity);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, r->capacity) == r_pos)
+		{
+			return MUGGLE_ERR_EMPTY;
+		}
+		*data = r->datas[r_pos];
+		return MUGGLE_OK;
+	}
+
+	muggle_atomic_int r_cursor = muggle_atomic_load(&r->read_cursor, muggle_memory_order_relaxed);
+	if (IDX_IN_POW_OF_2_RING(w_cursor, r->capacity) == IDX_IN_POW_OF_2_RING(r_cursor, r->capacity))
+	{
+		return MUGGLE_ERR_EMPTY;
+	}
+
+	if (muggle_mutex_trylock(&r->read_mutex) != MUGGLE_OK)
+	{
+		return MUGGLE_ERR_ACQ_LOCK;
+	}
+
+	int ret = MUGGLE_ERR_EMPTY;
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(r->read_cursor, r->capacity);
+	if (IDX_IN_POW_OF_2_RING(w_cursor, r->capacity) != r_pos)
+	{
+		*data = r->datas[r_pos];
+		r->read_cursor++;
+		ret = MUGGLE_OK;
+	}
+	muggle_mutex_unlock(&r->read_mutex);
+
+	return ret;
+}
 
 // write, wake and read callbacks
 static fn_muggle_ring_buffer_write muggle_ring_buffer_write_functions[MUGGLE_RING_BUFFER_WRITE_MODE_MAX] = {
@@ -230,6 +437,19 @@ static fn_muggle_ring_buffer_read muggle_ring_buffer_read_functions[MUGGLE_RING_
 	muggle_ring_buffer_read_lock, // MUGGLE_RING_BUFFER_READ_MODE_LOCK 
 };
 
+static fn_muggle_ring_buffer_write_batch muggle_ring_buffer_write_batch_functions[MUGGLE_RING_BUFFER_WRITE_MODE_MAX] = {
+	muggle_ring_buffer_write_batch_lock, // MUGGLE_RING_BUFFER_WRITE_MODE_LOCK 
+	muggle_ring_buffer_write_batch_single, // MUGGLE_RING_BUFFER_WRITE_MODE_SINGLE 
+	muggle_ring_buffer_write_batch_busy_loop // MUGGLE_RING_BUFFER_WRITE_MODE_BUSY_LOOP 
+};
+
+static fn_muggle_ring_buffer_read_batch muggle_ring_buffer_read_batch_functions[MUGGLE_RING_BUFFER_READ_MODE_MAX] = {
+	muggle_ring_buffer_read_batch_wait, // MUGGLE_RING_BUFFER_READ_MODE_WAIT 
+	muggle_ring_buffer_read_batch_wait, // MUGGLE_RING_BUFFER_READ_MODE_SINGLE_WAIT 
+	muggle_ring_buffer_read_batch_busy_loop, // MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP 
+	muggle_ring_buffer_read_batch_lock, // MUGGLE_RING_BUFFER_READ_MODE_LOCK 
+};
+
 int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity, int flag)
 {
 	memset(r, 0, sizeof(muggle_ring_buffer_t));
@@ -254,6 +474,8 @@ int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity,
 	r->next = 0;
 	r->cursor = 0;
 	r->read_cursor = 0;
+	r->n_sleeper = 0;
+	muggle_wait_strategy_init(&r->wait_strategy, 0, 0, 0);
 
 	ret = muggle_mutex_init(&r->write_mutex);
 	if (ret != MUGGLE_OK)
@@ -291,6 +513,11 @@ int muggle_ring_buffer_destroy(muggle_ring_buffer_t *r)
 	return MUGGLE_OK;
 }
 
+void muggle_ring_buffer_set_wait_strategy(muggle_ring_buffer_t *r, const muggle_wait_strategy_t *ws)
+{
+	muggle_wait_strategy_init(&r->wait_strategy, ws->spin, ws->yield, ws->flags);
+}
+
 int muggle_ring_buffer_write(muggle_ring_buffer_t *r, void *data)
 {
 	// write
@@ -307,3 +534,76 @@ void* muggle_ring_buffer_read(muggle_ring_buffer_t *r, muggle_atomic_int idx)
 	return (*muggle_ring_buffer_read_functions[r->read_mode])(r, idx);
 }
 
+int muggle_ring_buffer_write_batch(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int n)
+{
+	if (n <= 0 || n >= r->capacity)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	// write
+	(*muggle_ring_buffer_write_batch_functions[r->write_mode])(r, datas, n);
+
+	// wake
+	(*muggle_ring_buffer_wake_functions[r->read_mode])(r);
+
+	return MUGGLE_OK;
+}
+
+muggle_atomic_int muggle_ring_buffer_read_batch(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int n)
+{
+	if (n <= 0)
+	{
+		return 0;
+	}
+
+	return (*muggle_ring_buffer_read_batch_functions[r->read_mode])(r, idx, datas, n);
+}
+
+int muggle_ring_buffer_try_read(muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data)
+{
+	muggle_atomic_int w_cursor;
+	int ret = muggle_ring_buffer_try_fetch(r, idx, data, &w_cursor);
+	return ret == MUGGLE_OK ? MUGGLE_OK : MUGGLE_ERR_EMPTY;
+}
+
+int muggle_ring_buffer_read_timeout(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data, const struct timespec *timeout)
+{
+	if (timeout == NULL)
+	{
+		*data = muggle_ring_buffer_read(r, idx);
+		return MUGGLE_OK;
+	}
+
+	struct timespec deadline, remain;
+	muggle_deadline_set(&deadline, timeout);
+
+	muggle_atomic_int w_cursor;
+	while (1)
+	{
+		int ret = muggle_ring_buffer_try_fetch(r, idx, data, &w_cursor);
+		if (ret == MUGGLE_OK)
+		{
+			return MUGGLE_OK;
+		}
+
+		if (!muggle_deadline_remain(&deadline, &remain))
+		{
+			return MUGGLE_ERR_TIMEOUT;
+		}
+
+		// writers of busy loop ring buffer never wake readers
+		if (ret == MUGGLE_ERR_EMPTY && r->read_mode != MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP)
+		{
+			muggle_ring_buffer_sleep(r, w_cursor, &remain);
+		}
+		else
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	return MUGGLE_ERR_TIMEOUT;
+}
@@ -12,9 +12,11 @@
 #define MUGGLE_C_RING_BUFFER_H_
 
 #include "muggle/c/base/macro.h"
+#include <time.h>
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/condition_variable.h"
+#include "muggle/c/sync/wait_strategy.h"
 
 EXTERN_C_BEGIN
 
@@ -46,14 +48,17 @@ typedef struct muggle_ring_buffer_tag
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
 	muggle_atomic_int read_cursor; // for MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(5);
-	muggle_mutex_t write_mutex;
+	muggle_atomic_int n_sleeper; // number of readers parked on futex of cursor
+	muggle_wait_strategy_t wait_strategy; // how reader wait before park on futex of cursor
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(6);
-	muggle_mutex_t read_mutex;
+	muggle_mutex_t write_mutex;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(7);
-	muggle_condition_variable_t read_cv;
+	muggle_mutex_t read_mutex;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(8);
-	void **datas;
+	muggle_condition_variable_t read_cv;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(9);
+	void **datas;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(10);
 }muggle_ring_buffer_t;
 
 /**
@@ -82,6 +87,18 @@ int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity,
 MUGGLE_C_EXPORT
 int muggle_ring_buffer_destroy(muggle_ring_buffer_t *r);
 
+/**
+ * @brief set wait strategy of reader
+ *
+ * by default, reader park on futex immediately when no message ready,
+ * not take effect with MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP
+ *
+ * @param r   ring buffer pointer
+ * @param ws  wait strategy, it will be copied into ring buffer
+ */
+MUGGLE_C_EXPORT
+void muggle_ring_buffer_set_wait_strategy(muggle_ring_buffer_t *r, const muggle_wait_strategy_t *ws);
+
 /**
  * @brief write data into ring buffer
  *
@@ -106,6 +123,68 @@ int muggle_ring_buffer_write(muggle_ring_buffer_t *r, void *data);
 MUGGLE_C_EXPORT
 void* muggle_ring_buffer_read(muggle_ring_buffer_t *r, muggle_atomic_int idx);
 
+/**
+ * @brief try read data from ring buffer without block
+ *
+ * @param r     ring buffer pointer
+ * @param idx   index of data
+ * @param data  store data pointer on success
+ *
+ * @return 
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_EMPTY if no data ready
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_try_read(muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data);
+
+/**
+ * @brief read data from ring buffer, block at most timeout
+ *
+ * @param r        ring buffer pointer
+ * @param idx      index of data
+ * @param data     store data pointer on success
+ * @param timeout  relative timeout, NULL means wait forever
+ *
+ * @return 
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT if no data ready before timeout
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_read_timeout(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data, const struct timespec *timeout);
+
+/**
+ * @brief write a batch of data into ring buffer
+ *
+ * all datas are published with a single cursor move and at most one wake up
+ *
+ * @param r      ring buffer pointer
+ * @param datas  array of data pointer
+ * @param n      number of data in datas, must in range [1, capacity)
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_write_batch(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int n);
+
+/**
+ * @brief read a batch of data from ring buffer
+ *
+ * block until at least one data is ready, then get up to n ready data
+ *
+ * @param r      ring buffer pointer
+ * @param idx    index of first data, ignored with MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE
+ * @param datas  array for store data pointer
+ * @param n      max number of data to read
+ *
+ * @return number of data stored in datas, caller should move idx forward with it
+ */
+MUGGLE_C_EXPORT
+muggle_atomic_int muggle_ring_buffer_read_batch(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int n);
+
 EXTERN_C_END
 
 #endif
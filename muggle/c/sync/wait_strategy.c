@@ -0,0 +1,133 @@
+/******************************************************************************
+ *  @file         wait_strategy.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec wait strategy
+ *****************************************************************************/
+
+#include "wait_strategy.h"
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+
+static void muggle_wait_strategy_pause()
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+/*
+ * lower limit of adaptive spin, without spin the waiter never see change
+ * in spin loop, then number of spin never grow again when yield is 0
+ */
+static int muggle_wait_strategy_min_spin(muggle_wait_strategy_t *ws)
+{
+	int min_spin = ws->spin / MUGGLE_WAIT_STRATEGY_ADAPTIVE_MIN_SPIN_DIV;
+	if (min_spin == 0 && ws->spin > 0)
+	{
+		min_spin = 1;
+	}
+	return min_spin;
+}
+
+/*
+ * move current number of spin 1/8 toward target, it's a heuristic, so
+ * concurrent update from waiters racing on the same strategy are allowed
+ */
+static void muggle_wait_strategy_adapt(muggle_wait_strategy_t *ws, int cur, int target)
+{
+	int min_spin = muggle_wait_strategy_min_spin(ws);
+	if (target < min_spin)
+	{
+		target = min_spin;
+	}
+
+	int next = cur + (target - cur) / 8;
+	if (next == cur && target != cur)
+	{
+		next += target > cur ? 1 : -1;
+	}
+	muggle_atomic_store(&ws->adaptive_spin, next, muggle_memory_order_relaxed);
+}
+
+int muggle_wait_strategy_init(muggle_wait_strategy_t *ws, int spin, int yield, int flags)
+{
+	if (spin < 0 || yield < 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	ws->spin = spin;
+	ws->yield = yield;
+	ws->flags = flags;
+	ws->adaptive_spin = spin;
+
+	return MUGGLE_OK;
+}
+
+int muggle_wait_strategy_spin(muggle_wait_strategy_t *ws, muggle_atomic_int *futex_addr, muggle_atomic_int val)
+{
+	if (muggle_atomic_load(futex_addr, muggle_memory_order_relaxed) != val)
+	{
+		return 1;
+	}
+
+	int adaptive = ws->flags & MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE;
+	int n_spin = adaptive ?
+		(int)muggle_atomic_load(&ws->adaptive_spin, muggle_memory_order_relaxed) : ws->spin;
+
+	for (int i = 1; i <= n_spin; i++)
+	{
+		muggle_wait_strategy_pause();
+		if (muggle_atomic_load(futex_addr, muggle_memory_order_relaxed) != val)
+		{
+			if (adaptive)
+			{
+				// changed in spin, spin about twice as long as this time is enough
+				muggle_wait_strategy_adapt(ws, n_spin, i * 2 < ws->spin ? i * 2 : ws->spin);
+			}
+			return 1;
+		}
+	}
+
+	for (int i = 0; i < ws->yield; i++)
+	{
+		muggle_thread_yield();
+		if (muggle_atomic_load(futex_addr, muggle_memory_order_relaxed) != val)
+		{
+			if (adaptive)
+			{
+				// a little more spin may catch it without yield
+				muggle_wait_strategy_adapt(ws, n_spin, ws->spin);
+			}
+			return 1;
+		}
+	}
+
+	if (adaptive)
+	{
+		// need park, spin is a waste of cpu
+		muggle_wait_strategy_adapt(ws, n_spin, 0);
+	}
+	return 0;
+}
+
+void muggle_wait_strategy_wait(
+	muggle_wait_strategy_t *ws, muggle_atomic_int *futex_addr, muggle_atomic_int val,
+	const struct timespec *timeout)
+{
+	if (muggle_wait_strategy_spin(ws, futex_addr, val))
+	{
+		return;
+	}
+
+	muggle_futex_wait(futex_addr, val, timeout);
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *  @file         wait_strategy.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec wait strategy
+ *
+ * Wait strategy describe how a thread wait for a futex word changed:
+ * spin with cpu pause for a number of times, then yield for a number of
+ * times, at last park on futex. With MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE, the
+ * number of spin is tuned from observed wait result, waiter that usually
+ * need park will spin less and waiter that usually see the change soon
+ * after spin will spin more
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_WAIT_STRATEGY_H_
+#define MUGGLE_C_WAIT_STRATEGY_H_
+
+#include "muggle/c/base/macro.h"
+#include <time.h>
+#include "muggle/c/base/atomic.h"
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief adaptive spin never less than spin / MUGGLE_WAIT_STRATEGY_ADAPTIVE_MIN_SPIN_DIV
+ * (at least 1 when spin > 0), so it can grow again after parked
+ */
+#define MUGGLE_WAIT_STRATEGY_ADAPTIVE_MIN_SPIN_DIV 16
+
+enum
+{
+	MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE = 0x01, //!< auto tune number of spin, spin in strategy as upper limit
+};
+
+/**
+ * @brief wait strategy
+ */
+typedef struct muggle_wait_strategy
+{
+	int spin;   //!< number of spin with cpu pause before yield
+	int yield;  //!< number of yield before park on futex
+	int flags;  //!< bit OR operation of MUGGLE_WAIT_STRATEGY_FLAG_*
+	muggle_atomic_int adaptive_spin; //!< current number of spin for adaptive strategy
+}muggle_wait_strategy_t;
+
+/**
+ * @brief initialize wait strategy
+ *
+ * spin = 0 and yield = 0 means park on futex immediately
+ *
+ * @param ws     pointer to wait strategy
+ * @param spin   number of spin with cpu pause before yield
+ * @param yield  number of yield before park on futex
+ * @param flags  bit OR operation of MUGGLE_WAIT_STRATEGY_FLAG_*
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_wait_strategy_init(muggle_wait_strategy_t *ws, int spin, int yield, int flags);
+
+/**
+ * @brief spin and yield until futex word not equal to val
+ *
+ * caller should park on futex by itself when this function return 0
+ *
+ * @param ws          pointer to wait strategy
+ * @param futex_addr  futex address
+ * @param val         futex wait value
+ *
+ * @return
+ *     - return 1 if futex word changed before park
+ *     - return 0 if spin and yield are exhausted
+ */
+MUGGLE_C_EXPORT
+int muggle_wait_strategy_spin(muggle_wait_strategy_t *ws, muggle_atomic_int *futex_addr, muggle_atomic_int val);
+
+/**
+ * @brief spin, yield and then park on futex until futex word not equal to val
+ *
+ * @param ws          pointer to wait strategy
+ * @param futex_addr  futex address
+ * @param val         futex wait value
+ * @param timeout     relative timeout of park, NULL means wait forever
+ */
+MUGGLE_C_EXPORT
+void muggle_wait_strategy_wait(
+	muggle_wait_strategy_t *ws, muggle_atomic_int *futex_addr, muggle_atomic_int val,
+	const struct timespec *timeout);
+
+EXTERN_C_END
+
+#endif
@@ -0,0 +1,56 @@
+/******************************************************************************
+ *  @file         deadline.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec deadline for timed wait
+ *****************************************************************************/
+
+#include "deadline.h"
+
+#define MUGGLE_DEADLINE_NS_PER_SEC 1000000000L
+
+void muggle_deadline_set(struct timespec *deadline, const struct timespec *timeout)
+{
+	timespec_get(deadline, TIME_UTC);
+	deadline->tv_sec += timeout->tv_sec;
+	deadline->tv_nsec += timeout->tv_nsec;
+	while (deadline->tv_nsec >= MUGGLE_DEADLINE_NS_PER_SEC)
+	{
+		deadline->tv_sec += 1;
+		deadline->tv_nsec -= MUGGLE_DEADLINE_NS_PER_SEC;
+	}
+}
+
+int muggle_deadline_remain(const struct timespec *deadline, struct timespec *remain)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+
+	time_t sec = deadline->tv_sec - ts.tv_sec;
+	long nsec = deadline->tv_nsec - ts.tv_nsec;
+	if (nsec < 0)
+	{
+		sec -= 1;
+		nsec += MUGGLE_DEADLINE_NS_PER_SEC;
+	}
+
+	if (sec < 0 || (sec == 0 && nsec == 0))
+	{
+		if (remain)
+		{
+			remain->tv_sec = 0;
+			remain->tv_nsec = 0;
+		}
+		return 0;
+	}
+
+	if (remain)
+	{
+		remain->tv_sec = sec;
+		remain->tv_nsec = nsec;
+	}
+	return 1;
+}
@@ -0,0 +1,43 @@
+/******************************************************************************
+ *  @file         deadline.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec deadline for timed wait
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_DEADLINE_H_
+#define MUGGLE_C_DEADLINE_H_
+
+#include "muggle/c/base/macro.h"
+#include <time.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief set deadline as current time plus timeout
+ *
+ * @param deadline  deadline pointer
+ * @param timeout   relative timeout
+ */
+MUGGLE_C_EXPORT
+void muggle_deadline_set(struct timespec *deadline, const struct timespec *timeout);
+
+/**
+ * @brief get remaining time before deadline
+ *
+ * @param deadline  deadline pointer
+ * @param remain    store remaining time, could be NULL
+ *
+ * @return
+ *     - return 1 if deadline not reached
+ *     - return 0 if deadline already reached, and remain set to zero
+ */
+MUGGLE_C_EXPORT
+int muggle_deadline_remain(const struct timespec *deadline, struct timespec *remain);
+
+EXTERN_C_END
+
+#endif
@@ -0,0 +1,345 @@
+/******************************************************************************
+ *  @file         timer_wheel.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec hierarchical timer wheel
+ *****************************************************************************/
+
+#include "timer_wheel.h"
+#include <string.h>
+
+#if MUGGLE_PLATFORM_WINDOWS
+#include <intrin.h>
+#endif
+
+#define MUGGLE_TIMER_WHEEL_MAX_TICKS \
+	((uint64_t)1 << (MUGGLE_TIMER_WHEEL_BITS * MUGGLE_TIMER_WHEEL_LEVELS))
+
+/**
+ * @brief number of trailing zero bits, x must not be 0
+ */
+static inline int muggle_timer_wheel_ctz(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#elif MUGGLE_PLATFORM_WINDOWS && defined(_M_X64)
+	unsigned long idx;
+	_BitScanForward64(&idx, x);
+	return (int)idx;
+#else
+	int n = 0;
+	while ((x & 1) == 0)
+	{
+		x >>= 1;
+		++n;
+	}
+	return n;
+#endif
+}
+
+/**
+ * @brief distance from slot pos to the nearest non-empty slot after it,
+ * in range [1, MUGGLE_TIMER_WHEEL_SLOTS], bitmap must not be 0
+ */
+static inline int muggle_timer_wheel_next_slot(uint64_t bitmap, int pos)
+{
+	int n = (pos + 1) & MUGGLE_TIMER_WHEEL_MASK;
+	uint64_t rot = n == 0 ? bitmap : (bitmap >> n) | (bitmap << (MUGGLE_TIMER_WHEEL_SLOTS - n));
+	return muggle_timer_wheel_ctz(rot) + 1;
+}
+
+static inline void muggle_timer_wheel_list_init(muggle_timer_wheel_node_t *head)
+{
+	head->prev = head;
+	head->next = head;
+}
+
+static inline void muggle_timer_wheel_list_unlink(muggle_timer_wheel_node_t *node)
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->prev = NULL;
+	node->next = NULL;
+}
+
+/**
+ * @brief hash timer into slot by expire tick
+ */
+static void muggle_timer_wheel_place(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	uint64_t expire = timer->expire;
+	uint64_t diff = expire > wheel->current ? expire - wheel->current : 0;
+
+	int level = 0;
+	if (diff >= MUGGLE_TIMER_WHEEL_MAX_TICKS)
+	{
+		// beyond the top level, cascade again when reach the end of wheel
+		expire = wheel->current + MUGGLE_TIMER_WHEEL_MAX_TICKS - 1;
+		level = MUGGLE_TIMER_WHEEL_LEVELS - 1;
+	}
+	else
+	{
+		while (diff >> (MUGGLE_TIMER_WHEEL_BITS * (level + 1)))
+		{
+			++level;
+		}
+	}
+
+	int slot = (int)((expire >> (MUGGLE_TIMER_WHEEL_BITS * level)) & MUGGLE_TIMER_WHEEL_MASK);
+
+	muggle_timer_wheel_node_t *head = &wheel->slots[level][slot];
+	timer->node.prev = head->prev;
+	timer->node.next = head;
+	head->prev->next = &timer->node;
+	head->prev = &timer->node;
+
+	timer->level = level;
+	timer->slot = slot;
+	wheel->bitmap[level] |= (uint64_t)1 << slot;
+}
+
+/**
+ * @brief remove timer from its slot
+ */
+static void muggle_timer_wheel_remove(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	muggle_timer_wheel_node_t *head = &wheel->slots[timer->level][timer->slot];
+	muggle_timer_wheel_list_unlink(&timer->node);
+	if (head->next == head)
+	{
+		wheel->bitmap[timer->level] &= ~((uint64_t)1 << timer->slot);
+	}
+	timer->level = -1;
+}
+
+/**
+ * @brief move timers in upper levels into lower level, wheel->current is
+ * at the boundary of level 0
+ */
+static void muggle_timer_wheel_cascade(muggle_timer_wheel_t *wheel)
+{
+	for (int level = 1; level < MUGGLE_TIMER_WHEEL_LEVELS; level++)
+	{
+		int slot = (int)((wheel->current >> (MUGGLE_TIMER_WHEEL_BITS * level)) & MUGGLE_TIMER_WHEEL_MASK);
+		muggle_timer_wheel_node_t *head = &wheel->slots[level][slot];
+		if (head->next != head)
+		{
+			// detach list of slot, then hash timers again
+			muggle_timer_wheel_node_t list;
+			list.next = head->next;
+			list.prev = head->prev;
+			list.next->prev = &list;
+			list.prev->next = &list;
+			muggle_timer_wheel_list_init(head);
+			wheel->bitmap[level] &= ~((uint64_t)1 << slot);
+
+			while (list.next != &list)
+			{
+				muggle_timer_wheel_timer_t *timer = (muggle_timer_wheel_timer_t*)list.next;
+				muggle_timer_wheel_list_unlink(&timer->node);
+				muggle_timer_wheel_place(wheel, timer);
+			}
+		}
+
+		// upper level only move when this level wrap around
+		if (slot != 0)
+		{
+			break;
+		}
+	}
+}
+
+/**
+ * @brief invoke callbacks of timers in current slot of level 0
+ */
+static int muggle_timer_wheel_expire(muggle_timer_wheel_t *wheel)
+{
+	int cnt = 0;
+	int slot = (int)(wheel->current & MUGGLE_TIMER_WHEEL_MASK);
+	muggle_timer_wheel_node_t *head = &wheel->slots[0][slot];
+
+	// timer added in callback always expire in later tick, so it never
+	// come back into this slot
+	while (head->next != head)
+	{
+		muggle_timer_wheel_timer_t *timer = (muggle_timer_wheel_timer_t*)head->next;
+		muggle_timer_wheel_remove(wheel, timer);
+		--wheel->cnt;
+		++cnt;
+
+		// one shot timer may be freed in callback, don't touch it after
+		// callback returned
+		uint32_t interval = timer->interval;
+		wheel->running = timer;
+		timer->cb(wheel, timer);
+
+		// periodic timer that not added or canceled in callback
+		if (wheel->running == timer)
+		{
+			wheel->running = NULL;
+			if (interval > 0)
+			{
+				timer->expire += timer->interval;
+				if (timer->expire <= wheel->current)
+				{
+					timer->expire = wheel->current + 1;
+				}
+				muggle_timer_wheel_place(wheel, timer);
+				++wheel->cnt;
+			}
+		}
+	}
+
+	return cnt;
+}
+
+/**
+ * @brief the nearest tick that expire or cascade timers, wheel must not
+ * be empty
+ *
+ * level 0 give exact expire tick, upper level give the tick of cascade,
+ * which is not later than expire tick of timers in it
+ */
+static uint64_t muggle_timer_wheel_next_tick(muggle_timer_wheel_t *wheel)
+{
+	uint64_t next = UINT64_MAX;
+	for (int level = 0; level < MUGGLE_TIMER_WHEEL_LEVELS; level++)
+	{
+		if (wheel->bitmap[level] == 0)
+		{
+			continue;
+		}
+
+		int shift = MUGGLE_TIMER_WHEEL_BITS * level;
+		uint64_t block = wheel->current >> shift;
+		int pos = (int)(block & MUGGLE_TIMER_WHEEL_MASK);
+		uint64_t tick = (block + (uint64_t)muggle_timer_wheel_next_slot(wheel->bitmap[level], pos)) << shift;
+		if (tick < next)
+		{
+			next = tick;
+		}
+	}
+
+	return next;
+}
+
+void muggle_timer_wheel_init(muggle_timer_wheel_t *wheel, uint32_t tick_ms, uint64_t now_ms)
+{
+	memset(wheel, 0, sizeof(*wheel));
+	wheel->tick_ms = tick_ms > 0 ? tick_ms : 1;
+	wheel->current = now_ms / wheel->tick_ms;
+	for (int i = 0; i < MUGGLE_TIMER_WHEEL_LEVELS; i++)
+	{
+		for (int j = 0; j < MUGGLE_TIMER_WHEEL_SLOTS; j++)
+		{
+			muggle_timer_wheel_list_init(&wheel->slots[i][j]);
+		}
+	}
+}
+
+void muggle_timer_wheel_timer_init(muggle_timer_wheel_timer_t *timer, muggle_timer_wheel_cb cb, void *data)
+{
+	memset(timer, 0, sizeof(*timer));
+	timer->level = -1;
+	timer->cb = cb;
+	timer->data = data;
+}
+
+void muggle_timer_wheel_add(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer,
+	uint64_t delay_ms, uint64_t interval_ms)
+{
+	if (timer->level >= 0)
+	{
+		muggle_timer_wheel_remove(wheel, timer);
+		--wheel->cnt;
+	}
+	if (wheel->running == timer)
+	{
+		wheel->running = NULL;
+	}
+
+	uint64_t ticks = (delay_ms + wheel->tick_ms - 1) / wheel->tick_ms;
+	if (ticks == 0)
+	{
+		ticks = 1;
+	}
+
+	uint64_t interval = (interval_ms + wheel->tick_ms - 1) / wheel->tick_ms;
+	if (interval > UINT32_MAX)
+	{
+		interval = UINT32_MAX;
+	}
+
+	timer->expire = wheel->current + ticks;
+	timer->interval = (uint32_t)interval;
+	muggle_timer_wheel_place(wheel, timer);
+	++wheel->cnt;
+}
+
+void muggle_timer_wheel_cancel(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	if (timer->level >= 0)
+	{
+		muggle_timer_wheel_remove(wheel, timer);
+		--wheel->cnt;
+	}
+	if (wheel->running == timer)
+	{
+		wheel->running = NULL;
+	}
+}
+
+int muggle_timer_wheel_is_pending(const muggle_timer_wheel_timer_t *timer)
+{
+	return timer->level >= 0 ? 1 : 0;
+}
+
+int muggle_timer_wheel_advance(muggle_timer_wheel_t *wheel, uint64_t now_ms)
+{
+	uint64_t target = now_ms / wheel->tick_ms;
+	int cnt = 0;
+
+	while (wheel->current < target)
+	{
+		if (wheel->cnt == 0)
+		{
+			wheel->current = target;
+			break;
+		}
+
+		// skip ticks that neither expire nor cascade timers
+		uint64_t next = muggle_timer_wheel_next_tick(wheel);
+		if (next > target)
+		{
+			wheel->current = target;
+			break;
+		}
+
+		wheel->current = next;
+		if ((next & MUGGLE_TIMER_WHEEL_MASK) == 0)
+		{
+			muggle_timer_wheel_cascade(wheel);
+		}
+		cnt += muggle_timer_wheel_expire(wheel);
+	}
+
+	return cnt;
+}
+
+int64_t muggle_timer_wheel_next_timeout(muggle_timer_wheel_t *wheel, uint64_t now_ms)
+{
+	if (wheel->cnt == 0)
+	{
+		return -1;
+	}
+
+	uint64_t expire_ms = muggle_timer_wheel_next_tick(wheel) * wheel->tick_ms;
+	if (expire_ms <= now_ms)
+	{
+		return 0;
+	}
+	return (int64_t)(expire_ms - now_ms);
+}
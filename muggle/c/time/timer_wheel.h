@@ -0,0 +1,169 @@
+/******************************************************************************
+ *  @file         timer_wheel.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2021 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec hierarchical timer wheel
+ *
+ * MUGGLE_TIMER_WHEEL_LEVELS levels of MUGGLE_TIMER_WHEEL_SLOTS slots, timer
+ * is hashed into slot by expire tick, timers of upper level are cascaded
+ * into lower level when lower level wrap around.
+ *   - add/cancel: O(1)
+ *   - advance: O(expired timers), ticks without timer are skipped by
+ *     bitmap of non-empty slots
+ *   - next expire: O(levels)
+ *
+ * time is passed by caller in millisecond, so wheel is not bound to any
+ * clock. wheel is not thread safe
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_TIMER_WHEEL_H_
+#define MUGGLE_C_TIMER_WHEEL_H_
+
+#include "muggle/c/base/macro.h"
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_TIMER_WHEEL_BITS   6
+#define MUGGLE_TIMER_WHEEL_SLOTS  (1 << MUGGLE_TIMER_WHEEL_BITS)
+#define MUGGLE_TIMER_WHEEL_MASK   (MUGGLE_TIMER_WHEEL_SLOTS - 1)
+#define MUGGLE_TIMER_WHEEL_LEVELS 5 //!< cover 2^30 ticks, longer timer is cascaded again when reach the top
+
+struct muggle_timer_wheel;
+struct muggle_timer_wheel_timer;
+
+/**
+ * @brief prototype of timer callback
+ *
+ * timer is already removed from wheel when callback invoked, it's safe to
+ * add or cancel it in callback; periodic timer is added back after
+ * callback returned if it's not added or canceled in callback, so it must
+ * be canceled before freed in callback, one shot timer could be freed
+ * directly
+ *
+ * @param wheel  timer wheel
+ * @param timer  expired timer
+ */
+typedef void (*muggle_timer_wheel_cb)(struct muggle_timer_wheel *wheel, struct muggle_timer_wheel_timer *timer);
+
+/**
+ * @brief timer wheel list node
+ */
+typedef struct muggle_timer_wheel_node
+{
+	struct muggle_timer_wheel_node *prev;
+	struct muggle_timer_wheel_node *next;
+}muggle_timer_wheel_node_t;
+
+/**
+ * @brief timer, memory is owned by user
+ */
+typedef struct muggle_timer_wheel_timer
+{
+	muggle_timer_wheel_node_t node;
+	uint64_t                  expire;   //!< expire tick
+	uint32_t                  interval; //!< period in ticks, 0 means one shot
+	int                       level;    //!< level in wheel, -1 means not in wheel
+	int                       slot;     //!< slot in level
+	muggle_timer_wheel_cb     cb;       //!< callback
+	void                      *data;    //!< user data
+}muggle_timer_wheel_timer_t;
+
+/**
+ * @brief hierarchical timer wheel
+ */
+typedef struct muggle_timer_wheel
+{
+	uint64_t                  current;  //!< current tick
+	uint32_t                  tick_ms;  //!< millisecond per tick
+	uint64_t                  cnt;      //!< number of timers in wheel
+	uint64_t                  bitmap[MUGGLE_TIMER_WHEEL_LEVELS]; //!< non-empty slots
+	muggle_timer_wheel_node_t slots[MUGGLE_TIMER_WHEEL_LEVELS][MUGGLE_TIMER_WHEEL_SLOTS];
+	muggle_timer_wheel_timer_t *running; //!< timer in callback
+}muggle_timer_wheel_t;
+
+/**
+ * @brief initialize timer wheel
+ *
+ * @param wheel    timer wheel
+ * @param tick_ms  millisecond per tick, 0 means 1
+ * @param now_ms   current time in millisecond
+ */
+MUGGLE_C_EXPORT
+void muggle_timer_wheel_init(muggle_timer_wheel_t *wheel, uint32_t tick_ms, uint64_t now_ms);
+
+/**
+ * @brief initialize timer
+ *
+ * @param timer  timer
+ * @param cb     callback
+ * @param data   user data
+ */
+MUGGLE_C_EXPORT
+void muggle_timer_wheel_timer_init(muggle_timer_wheel_timer_t *timer, muggle_timer_wheel_cb cb, void *data);
+
+/**
+ * @brief add timer into wheel, if timer already in wheel, it's rescheduled
+ *
+ * @param wheel        timer wheel
+ * @param timer        initialized timer
+ * @param delay_ms     expire after delay_ms since current time of wheel,
+ *                     round up to tick, at least one tick
+ * @param interval_ms  period of timer, 0 means one shot
+ */
+MUGGLE_C_EXPORT
+void muggle_timer_wheel_add(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer,
+	uint64_t delay_ms, uint64_t interval_ms);
+
+/**
+ * @brief cancel timer, do nothing if timer not in wheel
+ *
+ * @param wheel  timer wheel
+ * @param timer  timer
+ */
+MUGGLE_C_EXPORT
+void muggle_timer_wheel_cancel(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer);
+
+/**
+ * @brief is timer in wheel
+ *
+ * @param timer  timer
+ *
+ * @return 1 - timer in wheel, 0 - not
+ */
+MUGGLE_C_EXPORT
+int muggle_timer_wheel_is_pending(const muggle_timer_wheel_timer_t *timer);
+
+/**
+ * @brief advance wheel to now_ms and invoke callbacks of expired timers
+ *
+ * @param wheel   timer wheel
+ * @param now_ms  current time in millisecond
+ *
+ * @return number of expired timers
+ */
+MUGGLE_C_EXPORT
+int muggle_timer_wheel_advance(muggle_timer_wheel_t *wheel, uint64_t now_ms);
+
+/**
+ * @brief get milliseconds until the next timer expire
+ *
+ * timers in upper level may expire later than returned value, then
+ * advance only cascade them, so it can be used as wait timeout directly
+ *
+ * @param wheel   timer wheel
+ * @param now_ms  current time in millisecond
+ *
+ * @return
+ *     - -1: no timer in wheel
+ *     - otherwise: milliseconds until next expire, 0 means already expired
+ */
+MUGGLE_C_EXPORT
+int64_t muggle_timer_wheel_next_timeout(muggle_timer_wheel_t *wheel, uint64_t now_ms);
+
+EXTERN_C_END
+
+#endif
@@ -54,6 +54,44 @@ TEST(array_blocking_queue, write_read_in_single_thread)
 	muggle_array_blocking_queue_destroy(&queue);
 }
 
+TEST(array_blocking_queue, try_take_and_take_timeout)
+{
+	muggle_array_blocking_queue_t queue;
+	int arr[2] = {0, 1};
+	void *data = NULL;
+
+	muggle_array_blocking_queue_init(&queue, 16);
+
+	// empty
+	EXPECT_EQ(muggle_array_blocking_queue_try_take(&queue, &data), MUGGLE_ERR_EMPTY);
+
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 10 * 1000 * 1000;
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_EQ(muggle_array_blocking_queue_take_timeout(&queue, &data, &timeout), MUGGLE_ERR_TIMEOUT);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 9);
+
+	// ready
+	muggle_array_blocking_queue_put(&queue, &arr[0]);
+	ASSERT_EQ(muggle_array_blocking_queue_try_take(&queue, &data), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 0);
+
+	// wake up by producer before timeout
+	std::thread producer([&queue, &arr]{
+		muggle_msleep(5);
+		muggle_array_blocking_queue_put(&queue, &arr[1]);
+	});
+	timeout.tv_sec = 5;
+	timeout.tv_nsec = 0;
+	ASSERT_EQ(muggle_array_blocking_queue_take_timeout(&queue, &data, &timeout), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 1);
+	producer.join();
+
+	muggle_array_blocking_queue_destroy(&queue);
+}
+
 void producer_consumer(int cnt_producer, int cnt_consumer, int cnt_interval, int interval_ms,
 	int capacity = 1024 * 2, int total = 10000)
 {
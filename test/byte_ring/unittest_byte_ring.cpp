@@ -0,0 +1,161 @@
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+struct byte_ring_msg
+{
+	int thread_idx;
+	int msg_idx;
+	int len;
+};
+
+TEST(byte_ring, init_destroy)
+{
+	muggle_byte_ring_t r;
+	EXPECT_EQ(muggle_byte_ring_init(&r, 0, 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_byte_ring_init(&r, 8, 0), MUGGLE_ERR_INVALID_PARAM);
+
+	ASSERT_EQ(muggle_byte_ring_init(&r, 1000, 0), MUGGLE_OK);
+	EXPECT_EQ(r.capacity, 1024);
+	EXPECT_GT(r.max_msg_size, 0);
+	muggle_byte_ring_destroy(&r);
+}
+
+TEST(byte_ring, write_read_in_single_thread)
+{
+	int flags[] = {
+		MUGGLE_BYTE_RING_FLAG_MULTI_WRITER,
+		MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER,
+	};
+	for (int f = 0; f < (int)(sizeof(flags) / sizeof(flags[0])); f++)
+	{
+		muggle_byte_ring_t r;
+		ASSERT_EQ(muggle_byte_ring_init(&r, 256, flags[f]), MUGGLE_OK);
+
+		// invalid size
+		EXPECT_TRUE(muggle_byte_ring_writer_reserve(&r, 0) == NULL);
+		EXPECT_TRUE(muggle_byte_ring_writer_reserve(&r, r.max_msg_size + 1) == NULL);
+
+		int num_bytes = 0;
+		EXPECT_TRUE(muggle_byte_ring_reader_fetch(&r, &num_bytes) == NULL);
+
+		// variable length messages wrap around many times
+		for (int i = 0; i < 1000; i++)
+		{
+			int len = 1 + (i * 7) % 60;
+			char *p = (char*)muggle_byte_ring_writer_reserve(&r, len);
+			ASSERT_TRUE(p != NULL);
+			memset(p, (char)i, len);
+
+			// not visible before commit
+			EXPECT_TRUE(muggle_byte_ring_reader_fetch(&r, &num_bytes) == NULL);
+			muggle_byte_ring_writer_commit(&r, p);
+
+			char *data = (char*)muggle_byte_ring_reader_fetch(&r, &num_bytes);
+			ASSERT_TRUE(data == p);
+			ASSERT_EQ(num_bytes, len);
+			for (int j = 0; j < len; j++)
+			{
+				ASSERT_EQ(data[j], (char)i);
+			}
+			muggle_byte_ring_reader_move(&r, data);
+		}
+
+		// full
+		int cnt = 0;
+		while (1)
+		{
+			char *p = (char*)muggle_byte_ring_writer_reserve(&r, 8);
+			if (p == NULL)
+			{
+				break;
+			}
+			muggle_byte_ring_writer_commit(&r, p);
+			cnt++;
+		}
+		// header + 8 bytes per message, at most one message space wasted by pad
+		EXPECT_LE(cnt, 256 / 16);
+		EXPECT_GE(cnt, 256 / 16 - 1);
+
+		while (1)
+		{
+			void *data = muggle_byte_ring_reader_fetch(&r, &num_bytes);
+			if (data == NULL)
+			{
+				break;
+			}
+			muggle_byte_ring_reader_move(&r, data);
+			cnt--;
+		}
+		EXPECT_EQ(cnt, 0);
+
+		muggle_byte_ring_destroy(&r);
+	}
+}
+
+void test_byte_ring_producer_consumer(int flags, int cnt_writer)
+{
+	muggle_byte_ring_t r;
+	ASSERT_EQ(muggle_byte_ring_init(&r, 1024 * 4, flags), MUGGLE_OK);
+
+	int msg_per_writer = 1024 * 32;
+
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([&r, i, msg_per_writer]{
+			for (int j = 0; j < msg_per_writer; j++)
+			{
+				int len = (int)sizeof(byte_ring_msg) + (j % 100);
+				byte_ring_msg *msg = NULL;
+				while ((msg = (byte_ring_msg*)muggle_byte_ring_writer_reserve(&r, len)) == NULL)
+				{
+					muggle_thread_yield();
+				}
+				msg->thread_idx = i;
+				msg->msg_idx = j;
+				msg->len = len;
+				muggle_byte_ring_writer_commit(&r, msg);
+			}
+		}));
+	}
+
+	std::vector<int> thread_msg_idx(cnt_writer, -1);
+	int total = cnt_writer * msg_per_writer;
+	for (int i = 0; i < total; i++)
+	{
+		int num_bytes = 0;
+		byte_ring_msg *msg = (byte_ring_msg*)muggle_byte_ring_reader_wait(&r, &num_bytes);
+		ASSERT_EQ(num_bytes, msg->len);
+		ASSERT_LT(msg->thread_idx, cnt_writer);
+		ASSERT_EQ(msg->msg_idx, thread_msg_idx[msg->thread_idx] + 1);
+		thread_msg_idx[msg->thread_idx] = msg->msg_idx;
+		muggle_byte_ring_reader_move(&r, msg);
+	}
+
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers[i].join();
+	}
+
+	int num_bytes = 0;
+	EXPECT_TRUE(muggle_byte_ring_reader_fetch(&r, &num_bytes) == NULL);
+
+	muggle_byte_ring_destroy(&r);
+}
+
+TEST(byte_ring, single_producer_consumer)
+{
+	test_byte_ring_producer_consumer(MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER, 1);
+}
+
+TEST(byte_ring, multi_producer_consumer)
+{
+	int hc = (int)std::thread::hardware_concurrency();
+	if (hc <= 1)
+	{
+		hc = 2;
+	}
+	test_byte_ring_producer_consumer(MUGGLE_BYTE_RING_FLAG_MULTI_WRITER, hc);
+}
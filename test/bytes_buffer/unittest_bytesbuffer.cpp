@@ -474,3 +474,88 @@ TEST(bytes_buffer, truncate)
 
 	muggle_bytes_buffer_destroy(&bytes_buf);
 }
+
+TEST(bytes_buffer, reader_move_wrap)
+{
+	int capacity = 16;
+	muggle_bytes_buffer_t bytes_buf;
+	bool ret = muggle_bytes_buffer_init(&bytes_buf, capacity);
+	ASSERT_TRUE(ret);
+
+	char space[2 * TEST_BYTES_BUF_SPACE];
+	for (int i = 0; i < (int)sizeof(space); ++i)
+	{
+		space[i] = (char)i;
+	}
+
+	// w jump to head and truncate tail: r = 8, w = 6, t = 12
+	ASSERT_TRUE(muggle_bytes_buffer_write(&bytes_buf, 12, space));
+	ASSERT_TRUE(muggle_bytes_buffer_reader_move(&bytes_buf, 8));
+	ASSERT_TRUE(muggle_bytes_buffer_write(&bytes_buf, 6, space + 12));
+	ASSERT_EQ(bytes_buf.r, 8);
+	ASSERT_EQ(bytes_buf.w, 6);
+	ASSERT_EQ(bytes_buf.t, 12);
+
+	// reader reach end mark, move to head
+	char *p = (char*)muggle_bytes_buffer_reader_fc(&bytes_buf, 4);
+	ASSERT_TRUE(p != NULL);
+	ASSERT_EQ(p[0], (char)8);
+	ASSERT_TRUE(muggle_bytes_buffer_reader_move(&bytes_buf, 4));
+	ASSERT_EQ(bytes_buf.r, 0);
+	ASSERT_EQ(muggle_bytes_buffer_readable(&bytes_buf), 6);
+
+	p = (char*)muggle_bytes_buffer_reader_fc(&bytes_buf, 6);
+	ASSERT_TRUE(p != NULL);
+	for (int i = 0; i < 6; ++i)
+	{
+		ASSERT_EQ(p[i], (char)(12 + i));
+	}
+	ASSERT_TRUE(muggle_bytes_buffer_reader_move(&bytes_buf, 6));
+	check_empty_status(&bytes_buf, capacity);
+
+	muggle_bytes_buffer_destroy(&bytes_buf);
+}
+
+TEST(bytes_buffer, writer_move_fc)
+{
+	int capacity = 16;
+	muggle_bytes_buffer_t bytes_buf;
+	bool ret = muggle_bytes_buffer_init(&bytes_buf, capacity);
+	ASSERT_TRUE(ret);
+
+	char space[TEST_BYTES_BUF_SPACE];
+	for (int i = 0; i < (int)sizeof(space); ++i)
+	{
+		space[i] = (char)i;
+	}
+
+	// writer in contiguous memory, write less than requested
+	char *p = (char*)muggle_bytes_buffer_writer_fc(&bytes_buf, 12);
+	ASSERT_TRUE(p == bytes_buf.buffer);
+	memcpy(p, space, 10);
+	ASSERT_TRUE(muggle_bytes_buffer_writer_move_fc(&bytes_buf, p, 10));
+	ASSERT_EQ(bytes_buf.w, 10);
+	ASSERT_TRUE(muggle_bytes_buffer_reader_move(&bytes_buf, 8));
+
+	// writer jump to head, write less than requested, tail is truncated
+	p = (char*)muggle_bytes_buffer_writer_fc(&bytes_buf, 7);
+	ASSERT_TRUE(p == bytes_buf.buffer);
+	memcpy(p, space + 10, 2);
+	ASSERT_TRUE(muggle_bytes_buffer_writer_move_fc(&bytes_buf, p, 2));
+	ASSERT_EQ(bytes_buf.t, 10);
+	ASSERT_EQ(bytes_buf.w, 2);
+	ASSERT_EQ(muggle_bytes_buffer_readable(&bytes_buf), 4);
+
+	char dst[4];
+	ASSERT_TRUE(muggle_bytes_buffer_read(&bytes_buf, 4, dst));
+	for (int i = 0; i < 4; ++i)
+	{
+		ASSERT_EQ(dst[i], (char)(8 + i));
+	}
+	check_empty_status(&bytes_buf, capacity);
+
+	// not writer memory
+	ASSERT_FALSE(muggle_bytes_buffer_writer_move_fc(&bytes_buf, bytes_buf.buffer + 3, 1));
+
+	muggle_bytes_buffer_destroy(&bytes_buf);
+}
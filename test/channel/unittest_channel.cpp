@@ -1,4 +1,5 @@
 #include <thread>
+#include <chrono>
 #include <vector>
 #include <map>
 #include "gtest/gtest.h"
@@ -11,7 +12,7 @@ struct chan_data
 	int thread_msg_idx;
 };
 
-void test_chan(int flags, int cnt_writer)
+void test_chan(int flags, int cnt_writer, const muggle_wait_strategy_t *ws = NULL)
 {
 	muggle_atomic_int capacity = 1024 * 4;
 	int cnt_msg = capacity * 32;
@@ -20,6 +21,10 @@ void test_chan(int flags, int cnt_writer)
 
 	muggle_channel_t chan;
 	muggle_channel_init(&chan, capacity, flags);
+	if (ws)
+	{
+		muggle_channel_set_wait_strategy(&chan, ws);
+	}
 
 	std::map<int, int> thread_cnts;
 	for (int i = 0; i < cnt_writer; i++)
@@ -86,6 +91,357 @@ void test_chan(int flags, int cnt_writer)
 	muggle_channel_destroy(&chan);
 }
 
+void test_chan_batch(int flags, int cnt_writer, int batch_size)
+{
+	muggle_atomic_int capacity = 1024 * 4;
+	int cnt_msg = capacity * 32;
+	muggle_atomic_int msg_idx = 0;
+	chan_data *datas = (chan_data*)malloc(cnt_msg * sizeof(chan_data));
+
+	muggle_channel_t chan;
+	muggle_channel_init(&chan, capacity, flags);
+
+	std::map<int, int> thread_cnts;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		thread_cnts[i] = 0;
+	}
+
+	// write
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		threads.push_back(std::thread([i, batch_size, &chan, &msg_idx, &cnt_msg, &datas]{
+			muggle_msleep(1);
+			int thread_msg_idx = 0;
+			std::vector<void*> batch(batch_size);
+
+			while (true)
+			{
+				int n = 0;
+				for (; n < batch_size; n++)
+				{
+					muggle_atomic_int cur_idx = muggle_atomic_fetch_add(&msg_idx, 1, muggle_memory_order_relaxed);
+					if (cur_idx >= cnt_msg)
+					{
+						break;
+					}
+
+					datas[cur_idx].idx = cur_idx;
+					datas[cur_idx].thread_idx = i;
+					datas[cur_idx].thread_msg_idx = thread_msg_idx++;
+					batch[n] = &datas[cur_idx];
+				}
+
+				int n_written = 0;
+				while (n_written < n)
+				{
+					int ret = muggle_channel_write_batch(&chan, &batch[n_written], n - n_written);
+					ASSERT_GE(ret, 0);
+					n_written += ret;
+					if (n_written < n)
+					{
+						muggle_msleep(1);
+					}
+				}
+
+				if (n < batch_size)
+				{
+					break;
+				}
+			} 
+		}));
+	}
+
+	// read
+	int recv_cnt = 0;
+	std::vector<void*> batch(batch_size);
+	while (recv_cnt < cnt_msg)
+	{
+		int n = muggle_channel_read_batch(&chan, batch.data(), batch_size);
+		ASSERT_GT(n, 0);
+		ASSERT_LE(n, batch_size);
+		for (int i = 0; i < n; i++)
+		{
+			chan_data *data = (chan_data*)batch[i];
+			ASSERT_LT(data->thread_idx, cnt_writer);
+			ASSERT_EQ(data->thread_msg_idx, thread_cnts[data->thread_idx]);
+			thread_cnts[data->thread_idx]++;
+			recv_cnt++;
+		}
+	}
+
+	// join thread
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		threads[i].join();
+	}
+
+	// free resource
+	free(datas);
+	muggle_channel_destroy(&chan);
+}
+
+void test_chan_mpmc(int flags, int cnt_writer, int cnt_reader)
+{
+	muggle_atomic_int capacity = 1024 * 4;
+	int cnt_msg = capacity * 32;
+	muggle_atomic_int msg_idx = 0;
+	chan_data *datas = (chan_data*)malloc(cnt_msg * sizeof(chan_data));
+	muggle_atomic_int *recv_flags = (muggle_atomic_int*)malloc(cnt_msg * sizeof(muggle_atomic_int));
+	memset(recv_flags, 0, cnt_msg * sizeof(muggle_atomic_int));
+	chan_data exit_data;
+
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, capacity, flags | MUGGLE_CHANNEL_FLAG_MULTI_READER), MUGGLE_OK);
+
+	// read
+	muggle_atomic_int recv_cnt = 0;
+	std::vector<std::thread> readers;
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		readers.push_back(std::thread([cnt_writer, &chan, &exit_data, &recv_cnt, &recv_flags]{
+			std::vector<int> thread_msg_idx(cnt_writer, -1);
+			while (true)
+			{
+				chan_data *data = (chan_data*)muggle_channel_read(&chan);
+				if (data == &exit_data)
+				{
+					break;
+				}
+
+				ASSERT_LT(data->thread_idx, cnt_writer);
+				ASSERT_GT(data->thread_msg_idx, thread_msg_idx[data->thread_idx]);
+				thread_msg_idx[data->thread_idx] = data->thread_msg_idx;
+				ASSERT_EQ(muggle_atomic_fetch_add(&recv_flags[data->idx], 1, muggle_memory_order_relaxed), 0);
+				muggle_atomic_fetch_add(&recv_cnt, 1, muggle_memory_order_relaxed);
+			}
+		}));
+	}
+
+	// write
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([i, &chan, &msg_idx, &cnt_msg, &datas]{
+			muggle_msleep(1);
+			int thread_msg_idx = 0;
+
+			muggle_atomic_int cur_idx = 0;
+			while (true)
+			{
+				cur_idx = muggle_atomic_fetch_add(&msg_idx, 1, muggle_memory_order_relaxed);
+				if (cur_idx >= cnt_msg)
+				{
+					break;
+				}
+
+				datas[cur_idx].idx = cur_idx;
+				datas[cur_idx].thread_idx = i;
+				datas[cur_idx].thread_msg_idx = thread_msg_idx++;
+
+				while (muggle_channel_write(&chan, &datas[cur_idx]) == MUGGLE_ERR_FULL)
+				{
+					muggle_thread_yield();
+				}
+			} 
+		}));
+	}
+
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers[i].join();
+	}
+
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		while (muggle_channel_write(&chan, &exit_data) == MUGGLE_ERR_FULL)
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		readers[i].join();
+	}
+
+	ASSERT_EQ(recv_cnt, cnt_msg);
+
+	// free resource
+	free(recv_flags);
+	free(datas);
+	muggle_channel_destroy(&chan);
+}
+
+void test_chan_write_block(int flags, int cnt_writer, int spin)
+{
+	muggle_atomic_int capacity = 8;
+	int cnt_msg = 1024 * 16;
+	muggle_atomic_int msg_idx = 0;
+	chan_data *datas = (chan_data*)malloc(cnt_msg * sizeof(chan_data));
+
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, capacity, flags | MUGGLE_CHANNEL_FLAG_WRITE_BLOCK), MUGGLE_OK);
+	muggle_channel_set_write_block_spin(&chan, spin);
+
+	// read
+	int recv_cnt = 0;
+	std::thread reader([cnt_writer, cnt_msg, &chan, &recv_cnt]{
+		std::vector<int> thread_msg_idx(cnt_writer, -1);
+		while (recv_cnt < cnt_msg)
+		{
+			chan_data *data = (chan_data*)muggle_channel_read(&chan);
+			if (data == NULL)
+			{
+				continue;
+			}
+
+			ASSERT_LT(data->thread_idx, cnt_writer);
+			ASSERT_EQ(data->thread_msg_idx, thread_msg_idx[data->thread_idx] + 1);
+			thread_msg_idx[data->thread_idx] = data->thread_msg_idx;
+			recv_cnt++;
+		}
+	});
+
+	// write, never failed in block mode
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([i, &chan, &msg_idx, &cnt_msg, &datas]{
+			int thread_msg_idx = 0;
+			while (true)
+			{
+				muggle_atomic_int cur_idx = muggle_atomic_fetch_add(&msg_idx, 1, muggle_memory_order_relaxed);
+				if (cur_idx >= cnt_msg)
+				{
+					break;
+				}
+
+				datas[cur_idx].idx = cur_idx;
+				datas[cur_idx].thread_idx = i;
+				datas[cur_idx].thread_msg_idx = thread_msg_idx++;
+				ASSERT_EQ(muggle_channel_write(&chan, &datas[cur_idx]), MUGGLE_OK);
+			}
+		}));
+	}
+
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers[i].join();
+	}
+	reader.join();
+
+	ASSERT_EQ(recv_cnt, cnt_msg);
+
+	free(datas);
+	muggle_channel_destroy(&chan);
+}
+
+void test_chan_try_read_and_read_timeout(int flags)
+{
+	muggle_channel_t chan;
+	int arr[2] = {0, 1};
+	void *data = NULL;
+
+	ASSERT_EQ(muggle_channel_init(&chan, 16, flags), MUGGLE_OK);
+
+	// empty
+	EXPECT_EQ(muggle_channel_try_read(&chan, &data), MUGGLE_ERR_EMPTY);
+
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 10 * 1000 * 1000;
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_EQ(muggle_channel_read_timeout(&chan, &data, &timeout), MUGGLE_ERR_TIMEOUT);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 9);
+
+	// ready
+	ASSERT_EQ(muggle_channel_write(&chan, &arr[0]), MUGGLE_OK);
+	ASSERT_EQ(muggle_channel_try_read(&chan, &data), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 0);
+
+	// wake up by writer before timeout
+	std::thread writer([&chan, &arr]{
+		muggle_msleep(5);
+		muggle_channel_write(&chan, &arr[1]);
+	});
+	timeout.tv_sec = 5;
+	timeout.tv_nsec = 0;
+	ASSERT_EQ(muggle_channel_read_timeout(&chan, &data, &timeout), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 1);
+	writer.join();
+
+	muggle_channel_destroy(&chan);
+}
+
+static muggle_atomic_int s_drop_cnt = 0;
+static void on_chan_drop(void *data)
+{
+	(void)data;
+	muggle_atomic_fetch_add(&s_drop_cnt, 1, muggle_memory_order_relaxed);
+}
+
+TEST(channel, write_block)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency() * 2;
+	if (cnt_writer <= 0)
+	{
+		cnt_writer = 4;
+	}
+
+	test_chan_write_block(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER, 1, 0);
+	test_chan_write_block(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER, 1, 64);
+	test_chan_write_block(0, cnt_writer, 0);
+	test_chan_write_block(MUGGLE_CHANNEL_FLAG_WRITE_FUTEX, cnt_writer, 64);
+	test_chan_write_block(MUGGLE_CHANNEL_FLAG_MULTI_READER, cnt_writer, 0);
+}
+
+TEST(channel, write_drop_oldest)
+{
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, 8, MUGGLE_CHANNEL_FLAG_WRITE_BLOCK | MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST), MUGGLE_ERR_INVALID_PARAM);
+
+	ASSERT_EQ(muggle_channel_init(&chan, 8, MUGGLE_CHANNEL_FLAG_WRITE_DROP_OLDEST), MUGGLE_OK);
+	muggle_channel_set_drop_callback(&chan, on_chan_drop);
+	s_drop_cnt = 0;
+
+	int cnt_msg = 100;
+	std::vector<int> datas(cnt_msg);
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		datas[i] = i;
+		ASSERT_EQ(muggle_channel_write(&chan, &datas[i]), MUGGLE_OK);
+	}
+
+	// only newest capacity messages remain
+	ASSERT_EQ(s_drop_cnt, cnt_msg - 8);
+	for (int i = cnt_msg - 8; i < cnt_msg; i++)
+	{
+		int *data = (int*)muggle_channel_read(&chan);
+		ASSERT_TRUE(data != NULL);
+		ASSERT_EQ(*data, i);
+	}
+
+	muggle_channel_destroy(&chan);
+}
+
+TEST(channel, try_read_and_read_timeout)
+{
+	int flags[] = {
+		0,
+		MUGGLE_CHANNEL_FLAG_SINGLE_WRITER,
+		MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP,
+		MUGGLE_CHANNEL_FLAG_MULTI_READER,
+		MUGGLE_CHANNEL_FLAG_MULTI_READER | MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP,
+		MUGGLE_CHANNEL_FLAG_WRITE_BLOCK,
+	};
+	for (int i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); i++)
+	{
+		test_chan_try_read_and_read_timeout(flags[i]);
+	}
+}
 
 TEST(channel, default_wr)
 {
@@ -118,3 +474,62 @@ TEST(channel, single_w_busyloop_r)
 {
 	test_chan(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER | MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP, 1);
 }
+
+TEST(channel, wait_strategy)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency() * 2;
+	if (cnt_writer <= 0)
+	{
+		cnt_writer = 4;
+	}
+
+	muggle_wait_strategy_t ws;
+	ASSERT_EQ(muggle_wait_strategy_init(&ws, 256, 8, 0), MUGGLE_OK);
+	test_chan(MUGGLE_CHANNEL_FLAG_WRITE_FUTEX, cnt_writer, &ws);
+
+	ASSERT_EQ(muggle_wait_strategy_init(&ws, 1024, 8, MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE), MUGGLE_OK);
+	test_chan(MUGGLE_CHANNEL_FLAG_WRITE_FUTEX, cnt_writer, &ws);
+	test_chan(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER, 1, &ws);
+}
+
+TEST(channel, batch_wr)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency() * 2;
+	if (cnt_writer <= 0)
+	{
+		cnt_writer = 4;
+	}
+
+	int flags[] = {
+		0,
+		MUGGLE_CHANNEL_FLAG_WRITE_FUTEX,
+		MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP,
+		MUGGLE_CHANNEL_FLAG_WRITE_FUTEX | MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP,
+	};
+	for (int i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); i++)
+	{
+		test_chan_batch(flags[i], cnt_writer, 16);
+	}
+}
+
+TEST(channel, single_w_batch_wr)
+{
+	test_chan_batch(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER, 1, 1);
+	test_chan_batch(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER, 1, 64);
+	test_chan_batch(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER | MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP, 1, 64);
+}
+
+TEST(channel, mpmc)
+{
+	int hc = (int)std::thread::hardware_concurrency();
+	if (hc <= 1)
+	{
+		hc = 2;
+	}
+
+	test_chan_mpmc(0, 1, 1);
+	test_chan_mpmc(0, 1, hc);
+	test_chan_mpmc(0, hc, 1);
+	test_chan_mpmc(0, hc, hc);
+	test_chan_mpmc(MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP, hc, hc);
+}
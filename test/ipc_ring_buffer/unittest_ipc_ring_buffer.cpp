@@ -0,0 +1,271 @@
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#if !MUGGLE_PLATFORM_WINDOWS
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+#define TEST_IPC_RING_NAME "/muggle_test_ipc_ring"
+
+class IpcRingBufferFixture : public ::testing::Test
+{
+public:
+	virtual void SetUp() override
+	{
+		muggle_ipc_ring_buffer_unlink(TEST_IPC_RING_NAME);
+	}
+
+	virtual void TearDown() override
+	{
+		muggle_ipc_ring_buffer_unlink(TEST_IPC_RING_NAME);
+	}
+};
+
+TEST_F(IpcRingBufferFixture, create_attach)
+{
+	muggle_ipc_ring_buffer_t r;
+	EXPECT_EQ(muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME), MUGGLE_ERR_SYS_CALL);
+	EXPECT_EQ(muggle_ipc_ring_buffer_create(&r, TEST_IPC_RING_NAME, 0, 64, 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_ipc_ring_buffer_create(&r, TEST_IPC_RING_NAME, 16, 0, 0), MUGGLE_ERR_INVALID_PARAM);
+
+	muggle_ipc_ring_buffer_t w;
+	ASSERT_EQ(muggle_ipc_ring_buffer_create(&w, TEST_IPC_RING_NAME, 10, 60, 0), MUGGLE_OK);
+	EXPECT_EQ(w.capacity, 16);
+	EXPECT_EQ(w.slot_size, 60);
+	EXPECT_EQ(w.block_size % MUGGLE_CACHE_LINE_SIZE, 0);
+
+	ASSERT_EQ(muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME), MUGGLE_OK);
+	EXPECT_EQ(r.capacity, w.capacity);
+	EXPECT_EQ(r.slot_size, w.slot_size);
+	EXPECT_EQ(r.block_size, w.block_size);
+	EXPECT_EQ(muggle_ipc_ring_buffer_is_stale(&r), 0);
+
+	muggle_ipc_ring_buffer_detach(&r);
+	muggle_ipc_ring_buffer_detach(&w);
+}
+
+TEST_F(IpcRingBufferFixture, write_read)
+{
+	muggle_ipc_ring_buffer_t w, r;
+	ASSERT_EQ(muggle_ipc_ring_buffer_create(&w, TEST_IPC_RING_NAME, 8, 32, 0), MUGGLE_OK);
+	ASSERT_EQ(muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME), MUGGLE_OK);
+
+	char buf[32];
+	int num_bytes = 0;
+	EXPECT_EQ(muggle_ipc_ring_buffer_try_read(&r, buf, &num_bytes), MUGGLE_ERR_EMPTY);
+
+	struct timespec timeout = { 0, 1000 * 1000 };
+	EXPECT_EQ(muggle_ipc_ring_buffer_read_timeout(&r, buf, &num_bytes, &timeout), MUGGLE_ERR_TIMEOUT);
+
+	EXPECT_EQ(muggle_ipc_ring_buffer_write(&w, buf, 33), MUGGLE_ERR_INVALID_PARAM);
+
+	for (int i = 0; i < 8; i++)
+	{
+		char msg[32];
+		int len = snprintf(msg, sizeof(msg), "msg %d", i) + 1;
+		ASSERT_EQ(muggle_ipc_ring_buffer_write(&w, msg, len), MUGGLE_OK);
+	}
+	EXPECT_EQ(muggle_ipc_ring_buffer_write(&w, "x", 1), MUGGLE_ERR_FULL);
+
+	for (int round = 0; round < 3; round++)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			char msg[32];
+			int len = snprintf(msg, sizeof(msg), "msg %d", round * 8 + i) + 1;
+
+			ASSERT_EQ(muggle_ipc_ring_buffer_read(&r, buf, &num_bytes), MUGGLE_OK);
+			ASSERT_EQ(num_bytes, len);
+			ASSERT_STREQ(buf, msg);
+
+			len = snprintf(msg, sizeof(msg), "msg %d", (round + 1) * 8 + i) + 1;
+			ASSERT_EQ(muggle_ipc_ring_buffer_write(&w, msg, len), MUGGLE_OK);
+		}
+	}
+
+	muggle_ipc_ring_buffer_detach(&r);
+	muggle_ipc_ring_buffer_detach(&w);
+}
+
+TEST_F(IpcRingBufferFixture, reinit)
+{
+	muggle_ipc_ring_buffer_t w, r;
+	ASSERT_EQ(muggle_ipc_ring_buffer_create(&w, TEST_IPC_RING_NAME, 8, 16, 0), MUGGLE_OK);
+	ASSERT_EQ(muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME), MUGGLE_OK);
+
+	// simulate writer crashed after claim slot but before publish
+	muggle_atomic_store(&w.header->write_cursor, 1, muggle_memory_order_relaxed);
+	ASSERT_EQ(muggle_ipc_ring_buffer_write(&w, "a", 2), MUGGLE_OK);
+
+	char buf[16];
+	int num_bytes = 0;
+	EXPECT_EQ(muggle_ipc_ring_buffer_try_read(&r, buf, &num_bytes), MUGGLE_ERR_EMPTY);
+
+	// restart creator, existing ring is never reinitialized in place
+	muggle_ipc_ring_buffer_detach(&w);
+	EXPECT_EQ(muggle_ipc_ring_buffer_create(&w, TEST_IPC_RING_NAME, 8, 16, 0), MUGGLE_ERR_SYS_CALL);
+	EXPECT_EQ(muggle_ipc_ring_buffer_is_stale(&r), 0);
+
+	// smaller geometry, old mapping of reader is still valid
+	ASSERT_EQ(muggle_ipc_ring_buffer_unlink(TEST_IPC_RING_NAME), MUGGLE_OK);
+	ASSERT_EQ(muggle_ipc_ring_buffer_create(&w, TEST_IPC_RING_NAME, 2, 8, 0), MUGGLE_OK);
+
+	EXPECT_EQ(muggle_ipc_ring_buffer_is_stale(&r), 1);
+	EXPECT_EQ(muggle_ipc_ring_buffer_try_read(&r, buf, &num_bytes), MUGGLE_ERR_EMPTY);
+	EXPECT_EQ(muggle_ipc_ring_buffer_read(&r, buf, &num_bytes), MUGGLE_ERR_INTERRUPT);
+	muggle_ipc_ring_buffer_detach(&r);
+
+	ASSERT_EQ(muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME), MUGGLE_OK);
+	EXPECT_EQ(muggle_ipc_ring_buffer_is_stale(&r), 0);
+	EXPECT_EQ(r.capacity, 2);
+	ASSERT_EQ(muggle_ipc_ring_buffer_write(&w, "b", 2), MUGGLE_OK);
+	ASSERT_EQ(muggle_ipc_ring_buffer_read(&r, buf, &num_bytes), MUGGLE_OK);
+	EXPECT_EQ(num_bytes, 2);
+	EXPECT_STREQ(buf, "b");
+
+	// creator crashed in the middle of initialization
+	muggle_atomic_store(&w.header->state, 0, muggle_memory_order_relaxed);
+	muggle_ipc_ring_buffer_t r2;
+	EXPECT_EQ(muggle_ipc_ring_buffer_attach(&r2, TEST_IPC_RING_NAME), MUGGLE_ERR_INVALID_PARAM);
+
+	muggle_ipc_ring_buffer_detach(&r);
+	muggle_ipc_ring_buffer_detach(&w);
+}
+
+TEST_F(IpcRingBufferFixture, multi_producer_consumer)
+{
+	const int cnt_writer = 4;
+	const int cnt_reader = 2;
+	const int cnt_msg = 20000;
+
+	muggle_ipc_ring_buffer_t w;
+	ASSERT_EQ(muggle_ipc_ring_buffer_create(&w, TEST_IPC_RING_NAME, 64, sizeof(int) * 2, 0), MUGGLE_OK);
+
+	std::vector<std::vector<int>> recv(cnt_reader);
+	std::vector<std::thread> readers;
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		readers.push_back(std::thread([&recv, i] {
+			muggle_ipc_ring_buffer_t r;
+			ASSERT_EQ(muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME), MUGGLE_OK);
+			while (1)
+			{
+				int msg[2];
+				int num_bytes = 0;
+				ASSERT_EQ(muggle_ipc_ring_buffer_read(&r, msg, &num_bytes), MUGGLE_OK);
+				ASSERT_EQ(num_bytes, (int)sizeof(msg));
+				if (msg[0] < 0)
+				{
+					break;
+				}
+				recv[i].push_back(msg[0] * cnt_msg + msg[1]);
+			}
+			muggle_ipc_ring_buffer_detach(&r);
+		}));
+	}
+
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([i] {
+			muggle_ipc_ring_buffer_t r;
+			ASSERT_EQ(muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME), MUGGLE_OK);
+			for (int j = 0; j < cnt_msg; j++)
+			{
+				int msg[2] = { i, j };
+				while (muggle_ipc_ring_buffer_write(&r, msg, sizeof(msg)) != MUGGLE_OK)
+				{
+					muggle_thread_yield();
+				}
+			}
+			muggle_ipc_ring_buffer_detach(&r);
+		}));
+	}
+	for (auto &t : writers)
+	{
+		t.join();
+	}
+
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		int msg[2] = { -1, -1 };
+		while (muggle_ipc_ring_buffer_write(&w, msg, sizeof(msg)) != MUGGLE_OK)
+		{
+			muggle_thread_yield();
+		}
+	}
+	for (auto &t : readers)
+	{
+		t.join();
+	}
+
+	std::vector<int> cnt(cnt_writer * cnt_msg, 0);
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		for (int v : recv[i])
+		{
+			ASSERT_GE(v, 0);
+			ASSERT_LT(v, cnt_writer * cnt_msg);
+			cnt[v]++;
+		}
+	}
+	for (int v : cnt)
+	{
+		ASSERT_EQ(v, 1);
+	}
+
+	muggle_ipc_ring_buffer_detach(&w);
+}
+
+#if !MUGGLE_PLATFORM_WINDOWS
+TEST_F(IpcRingBufferFixture, cross_process)
+{
+	const int cnt_msg = 10000;
+
+	muggle_ipc_ring_buffer_t w;
+	ASSERT_EQ(muggle_ipc_ring_buffer_create(&w, TEST_IPC_RING_NAME, 16, sizeof(int),
+		MUGGLE_IPC_RING_BUFFER_FLAG_SINGLE_WRITER), MUGGLE_OK);
+
+	pid_t pid = fork();
+	ASSERT_NE(pid, -1);
+	if (pid == 0)
+	{
+		// child: consumer, exit code 0 means all messages in order
+		muggle_ipc_ring_buffer_t r;
+		if (muggle_ipc_ring_buffer_attach(&r, TEST_IPC_RING_NAME) != MUGGLE_OK)
+		{
+			_exit(1);
+		}
+		for (int i = 0; i < cnt_msg; i++)
+		{
+			int v = -1;
+			int num_bytes = 0;
+			if (muggle_ipc_ring_buffer_read(&r, &v, &num_bytes) != MUGGLE_OK ||
+				num_bytes != (int)sizeof(v) || v != i)
+			{
+				_exit(2);
+			}
+		}
+		muggle_ipc_ring_buffer_detach(&r);
+		_exit(0);
+	}
+
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		while (muggle_ipc_ring_buffer_write(&w, &i, sizeof(i)) != MUGGLE_OK)
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	int status = 0;
+	ASSERT_EQ(waitpid(pid, &status, 0), pid);
+	ASSERT_TRUE(WIFEXITED(status));
+	EXPECT_EQ(WEXITSTATUS(status), 0);
+
+	muggle_ipc_ring_buffer_detach(&w);
+}
+#endif
@@ -1,6 +1,13 @@
+#include <string>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 #include "muggle/c/log/log_level.h"
 #include "muggle/c/muggle_c.h"
+#if !MUGGLE_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 TEST(log, log_level)
 {
@@ -68,3 +75,909 @@ TEST(log, log_fmt)
 
 	ASSERT_STREQ(buf, expect);
 }
+
+TEST(log, log_fmt_cached)
+{
+	muggle_log_fmt_t *complicated = muggle_log_fmt_get_complicated();
+	muggle_log_fmt_t *cached = muggle_log_fmt_get_cached();
+
+	const char *files[] = {
+		__FILE__,
+		"/a/b/c/d.c",
+		"a\\b\\win.c",
+		"nodir.c",
+	};
+	const long nsecs[] = { 0, 1000000, 999999999, 123456789 };
+
+	muggle_log_msg_t msg = {
+		MUGGLE_LOG_LEVEL_WARNING,
+		{0, 0},
+		0,
+		{__FILE__, __LINE__, __FUNCTION__},
+		"log formatter"
+	};
+	timespec_get(&msg.ts, TIME_UTC);
+	msg.tid = muggle_thread_current_id();
+
+	char buf[MUGGLE_LOG_MSG_MAX_LEN];
+	char expect[MUGGLE_LOG_MSG_MAX_LEN];
+	for (int round = 0; round < 2; round++)
+	{
+		for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+		{
+			for (size_t j = 0; j < sizeof(nsecs) / sizeof(nsecs[0]); j++)
+			{
+				msg.src_loc.file = files[i];
+				msg.ts.tv_sec += (time_t)j * 3601;
+				msg.ts.tv_nsec = nsecs[j];
+				msg.src_loc.line = (unsigned int)(i * 1000 + j);
+
+				int n = complicated->fmt_func(&msg, expect, sizeof(expect));
+				ASSERT_EQ(cached->fmt_func(&msg, buf, sizeof(buf)), n);
+				ASSERT_STREQ(buf, expect);
+			}
+		}
+	}
+
+	// truncate
+	msg.src_loc.file = __FILE__;
+	complicated->fmt_func(&msg, expect, sizeof(expect));
+	ASSERT_EQ(cached->fmt_func(&msg, buf, 16), 15);
+	ASSERT_EQ(std::string(buf), std::string(expect, 15));
+}
+
+struct test_log_record_handler
+{
+	muggle_log_handler_t handler;
+	std::vector<std::string> *payloads;
+};
+
+static int test_log_record_handler_write(muggle_log_handler_t *base_handler, const muggle_log_msg_t *msg)
+{
+	test_log_record_handler *handler = (test_log_record_handler*)base_handler;
+	handler->payloads->push_back(msg->payload);
+	return 0;
+}
+
+TEST(log, async_logger)
+{
+	std::vector<std::string> payloads;
+
+	test_log_record_handler handler;
+	ASSERT_EQ(muggle_log_handler_init_default(&handler.handler), 0);
+	handler.handler.write = test_log_record_handler_write;
+	handler.handler.destroy = muggle_log_handler_destroy_default;
+	handler.payloads = &payloads;
+
+	// few slots, producers must wait for slots recycled
+	muggle_async_logger_t async_logger;
+	ASSERT_EQ(muggle_async_logger_init(&async_logger, 8), 0);
+	muggle_logger_t *logger = (muggle_logger_t*)&async_logger;
+	logger->add_handler(logger, &handler.handler);
+
+	const int cnt_thread = 4;
+	const int cnt_msg = 2000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([logger, i] {
+			for (int j = 0; j < cnt_msg; j++)
+			{
+				MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%d-%d", i, j);
+			}
+		}));
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	// payload longer than slot is truncated
+	std::string long_str(MUGGLE_LOG_MSG_MAX_LEN, 'x');
+	MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%s", long_str.c_str());
+
+	logger->destroy(logger);
+	handler.handler.destroy(&handler.handler);
+
+	ASSERT_EQ((int)payloads.size(), cnt_thread * cnt_msg + 1);
+
+	std::vector<int> next_idx(cnt_thread, 0);
+	for (int i = 0; i < cnt_thread * cnt_msg; i++)
+	{
+		int thread_idx = -1, msg_idx = -1;
+		ASSERT_EQ(sscanf(payloads[i].c_str(), "%d-%d", &thread_idx, &msg_idx), 2);
+		ASSERT_GE(thread_idx, 0);
+		ASSERT_LT(thread_idx, cnt_thread);
+		ASSERT_EQ(msg_idx, next_idx[thread_idx]);
+		next_idx[thread_idx]++;
+	}
+
+	const std::string &last = payloads[cnt_thread * cnt_msg];
+	ASSERT_GT(last.size(), 0);
+	ASSERT_LT(last.size(), (size_t)MUGGLE_ASYNC_LOGGER_SLOT_SIZE);
+	ASSERT_EQ(last, long_str.substr(0, last.size()));
+}
+
+static std::string test_deferred_format(size_t record_size, const char *format, ...)
+{
+	std::vector<char> record(record_size);
+	va_list args;
+	va_start(args, format);
+	size_t len = muggle_log_deferred_encode(record.data(), record.size(), format, args);
+	va_end(args);
+
+	char buf[MUGGLE_LOG_MSG_MAX_LEN];
+	int n = muggle_log_deferred_decode(record.data(), len, buf, sizeof(buf));
+	if (n < 0)
+	{
+		return "";
+	}
+	return std::string(buf, n);
+}
+
+#define TEST_DEFERRED_EXPECT(format, ...) \
+do \
+{ \
+	char expect[MUGGLE_LOG_MSG_MAX_LEN]; \
+	snprintf(expect, sizeof(expect), format, ##__VA_ARGS__); \
+	ASSERT_EQ(test_deferred_format(MUGGLE_LOG_MSG_MAX_LEN, format, ##__VA_ARGS__), std::string(expect)); \
+} while (0)
+
+TEST(log, async_logger_lanes)
+{
+	std::vector<std::string> payloads;
+
+	test_log_record_handler handler;
+	ASSERT_EQ(muggle_log_handler_init_default(&handler.handler), 0);
+	handler.handler.write = test_log_record_handler_write;
+	handler.handler.destroy = muggle_log_handler_destroy_default;
+	handler.payloads = &payloads;
+
+	// more threads than lanes, the rest threads share channel
+	const int max_lane = 4;
+	muggle_async_logger_t async_logger;
+	ASSERT_EQ(muggle_async_logger_init_lanes(&async_logger, 32, max_lane, 8), 0);
+	muggle_logger_t *logger = (muggle_logger_t*)&async_logger;
+	logger->add_handler(logger, &handler.handler);
+
+	const int cnt_thread = 8;
+	const int cnt_msg = 2000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([logger, i] {
+			for (int j = 0; j < cnt_msg; j++)
+			{
+				MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%d-%d", i, j);
+			}
+		}));
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	muggle_logger_flush(logger);
+	ASSERT_EQ((int)payloads.size(), cnt_thread * cnt_msg);
+	ASSERT_EQ((int)async_logger.num_lane, cnt_thread);
+
+	logger->destroy(logger);
+	handler.handler.destroy(&handler.handler);
+
+	std::vector<int> next_idx(cnt_thread, 0);
+	for (int i = 0; i < cnt_thread * cnt_msg; i++)
+	{
+		int thread_idx = -1, msg_idx = -1;
+		ASSERT_EQ(sscanf(payloads[i].c_str(), "%d-%d", &thread_idx, &msg_idx), 2);
+		ASSERT_GE(thread_idx, 0);
+		ASSERT_LT(thread_idx, cnt_thread);
+		ASSERT_EQ(msg_idx, next_idx[thread_idx]);
+		next_idx[thread_idx]++;
+	}
+}
+
+static int test_log_slow_handler_write(muggle_log_handler_t *base_handler, const muggle_log_msg_t *msg)
+{
+	muggle_msleep(2);
+	return test_log_record_handler_write(base_handler, msg);
+}
+
+TEST(log, async_logger_workers)
+{
+	std::vector<std::string> fast_payloads;
+	std::vector<std::string> slow_payloads;
+
+	test_log_record_handler fast_handler;
+	ASSERT_EQ(muggle_log_handler_init_default(&fast_handler.handler), 0);
+	fast_handler.handler.write = test_log_record_handler_write;
+	fast_handler.handler.destroy = muggle_log_handler_destroy_default;
+	fast_handler.payloads = &fast_payloads;
+
+	test_log_record_handler slow_handler;
+	ASSERT_EQ(muggle_log_handler_init_default(&slow_handler.handler), 0);
+	slow_handler.handler.write = test_log_slow_handler_write;
+	slow_handler.handler.destroy = muggle_log_handler_destroy_default;
+	slow_handler.payloads = &slow_payloads;
+
+	muggle_async_logger_t async_logger;
+	ASSERT_EQ(muggle_async_logger_init(&async_logger, 64), 0);
+	muggle_logger_t *logger = (muggle_logger_t*)&async_logger;
+	logger->add_handler(logger, &fast_handler.handler);
+	logger->add_handler(logger, &slow_handler.handler);
+
+	// slow handler drop messages instead of delay fast handler
+	int flags[2] = { 0, MUGGLE_ASYNC_LOGGER_WORKER_FLAG_DROP };
+	ASSERT_EQ(muggle_async_logger_start_workers(&async_logger, 8, flags), 0);
+	ASSERT_NE(muggle_async_logger_start_workers(&async_logger, 8, NULL), 0);
+	ASSERT_NE(logger->add_handler(logger, &fast_handler.handler), 0);
+
+	const int cnt_msg = 200;
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%d", i);
+	}
+	muggle_logger_flush(logger);
+
+	ASSERT_EQ((int)fast_payloads.size(), cnt_msg);
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		ASSERT_EQ(fast_payloads[i], std::to_string(i));
+	}
+
+	muggle_async_logger_worker_stats_t stats;
+	ASSERT_EQ(muggle_async_logger_get_worker_stats(&async_logger, 0, &stats), 0);
+	ASSERT_EQ(stats.cnt_write, (uint64_t)cnt_msg);
+	ASSERT_EQ(stats.cnt_drop, 0u);
+	ASSERT_EQ(stats.lag, 0u);
+
+	ASSERT_EQ(muggle_async_logger_get_worker_stats(&async_logger, 1, &stats), 0);
+	ASSERT_GT(stats.cnt_drop, 0u);
+	ASSERT_EQ(stats.cnt_push + stats.cnt_drop, (uint64_t)cnt_msg);
+	ASSERT_EQ(stats.cnt_write, stats.cnt_push);
+	ASSERT_EQ(stats.lag, 0u);
+	ASSERT_LE(stats.max_lag, 8u);
+	ASSERT_EQ((uint64_t)slow_payloads.size(), stats.cnt_write);
+
+	ASSERT_NE(muggle_async_logger_get_worker_stats(&async_logger, 2, &stats), 0);
+
+	logger->destroy(logger);
+	fast_handler.handler.destroy(&fast_handler.handler);
+	slow_handler.handler.destroy(&slow_handler.handler);
+}
+
+TEST(log, deferred_format)
+{
+	TEST_DEFERRED_EXPECT("hello world");
+	TEST_DEFERRED_EXPECT("100%% done");
+	TEST_DEFERRED_EXPECT("%d %i %5d %-5d| %05d %+d", -1, 2, 3, 4, 5, 6);
+	TEST_DEFERRED_EXPECT("%hhd %hd %ld %lld", (signed char)-3, (short)-300, -100000L, -10000000000LL);
+	TEST_DEFERRED_EXPECT("%u %x %X %o %#x", 1u, 255u, 255u, 8u, 16u);
+	TEST_DEFERRED_EXPECT("%hhu %hu %lu %llu", (unsigned char)250, (unsigned short)65000, 100000UL, 10000000000ULL);
+	TEST_DEFERRED_EXPECT("%zu %td %jd", (size_t)12345, (ptrdiff_t)-7, (intmax_t)-9);
+	TEST_DEFERRED_EXPECT("%c%c%c", 'a', 'b', 'c');
+	TEST_DEFERRED_EXPECT("%f %.2f %e %g %10.3f", 3.14159, 2.71828, 1e10, 0.0001, -1.5);
+	TEST_DEFERRED_EXPECT("%Lf", (long double)1.25);
+	TEST_DEFERRED_EXPECT("%*d|%-*d|%.*f|%*.*f", 5, 1, 5, 2, 3, 1.23456, 8, 2, 9.876);
+	TEST_DEFERRED_EXPECT("%p", (void*)0x1234);
+	TEST_DEFERRED_EXPECT("%s|%10s|%-10s|%.3s|%.*s", "abc", "abc", "abc", "abcdef", 2, "abcdef");
+	TEST_DEFERRED_EXPECT("%s %d %s %f", "mixed", 42, "args", 0.5);
+
+	// string is copied, release caller buffer after encode
+	{
+		std::vector<char> record(256);
+		char *s = (char*)malloc(16);
+		strcpy(s, "temporary");
+		size_t len = 0;
+		{
+			struct encoder
+			{
+				static size_t encode(char *buf, size_t bufsize, const char *format, ...)
+				{
+					va_list args;
+					va_start(args, format);
+					size_t len = muggle_log_deferred_encode(buf, bufsize, format, args);
+					va_end(args);
+					return len;
+				}
+			};
+			len = encoder::encode(record.data(), record.size(), "str: %s", s);
+		}
+		memset(s, 'x', 15);
+		free(s);
+
+		char buf[256];
+		muggle_log_deferred_decode(record.data(), len, buf, sizeof(buf));
+		ASSERT_STREQ(buf, "str: temporary");
+	}
+
+	// null string
+	ASSERT_EQ(test_deferred_format(256, "%s", (const char*)NULL), "(null)");
+
+	// string with precision is not required to be null-terminated
+	{
+		char not_terminated[4] = { 'a', 'b', 'c', 'd' };
+		TEST_DEFERRED_EXPECT("%.3s|%.4s|%.*s", not_terminated, not_terminated, 2, not_terminated);
+		TEST_DEFERRED_EXPECT("%.*s|%-*.*s|", -1, "abc", 5, 4, not_terminated);
+	}
+
+	// unsupported conversion can't be encoded
+	{
+		std::vector<char> record(256);
+		struct encoder
+		{
+			static size_t encode(char *buf, size_t bufsize, const char *format, ...)
+			{
+				va_list args;
+				va_start(args, format);
+				size_t len = muggle_log_deferred_encode(buf, bufsize, format, args);
+				va_end(args);
+				return len;
+			}
+		};
+		int n = 0;
+		ASSERT_EQ(encoder::encode(record.data(), record.size(), "a %d b %n c %d", 1, &n, 2), 0u);
+		ASSERT_EQ(encoder::encode(record.data(), record.size(), "a %d b %ls", 1, L"wide"), 0u);
+	}
+
+	// record too small, string truncated and rest args dropped
+	ASSERT_EQ(test_deferred_format(sizeof(void*) + 4 + 4, "%s %d", "abcdef", 1), "abc ");
+	ASSERT_EQ(test_deferred_format(sizeof(void*) + 4, "%d %d", 1, 2), "");
+}
+
+TEST(log, async_logger_deferred)
+{
+	std::vector<std::string> payloads;
+
+	test_log_record_handler handler;
+	ASSERT_EQ(muggle_log_handler_init_default(&handler.handler), 0);
+	handler.handler.write = test_log_record_handler_write;
+	handler.handler.destroy = muggle_log_handler_destroy_default;
+	handler.payloads = &payloads;
+
+	muggle_async_logger_t async_logger;
+	ASSERT_EQ(muggle_async_logger_init(&async_logger, 8), 0);
+	muggle_logger_t *logger = (muggle_logger_t*)&async_logger;
+	logger->add_handler(logger, &handler.handler);
+
+	const int cnt_msg = 1000;
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		muggle_async_logger_set_deferred(&async_logger, i % 2 == 0);
+
+		std::string s = "msg" + std::to_string(i);
+		MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%s %d %.1f", s.c_str(), i, i / 2.0);
+	}
+
+	logger->destroy(logger);
+	handler.handler.destroy(&handler.handler);
+
+	ASSERT_EQ((int)payloads.size(), cnt_msg);
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		char expect[64];
+		snprintf(expect, sizeof(expect), "msg%d %d %.1f", i, i, i / 2.0);
+		ASSERT_EQ(payloads[i], std::string(expect));
+	}
+}
+
+TEST(log, async_logger_deferred_fallback)
+{
+	std::vector<std::string> payloads;
+
+	test_log_record_handler handler;
+	ASSERT_EQ(muggle_log_handler_init_default(&handler.handler), 0);
+	handler.handler.write = test_log_record_handler_write;
+	handler.handler.destroy = muggle_log_handler_destroy_default;
+	handler.payloads = &payloads;
+
+	muggle_async_logger_t async_logger;
+	ASSERT_EQ(muggle_async_logger_init(&async_logger, 8), 0);
+	muggle_logger_t *logger = (muggle_logger_t*)&async_logger;
+	logger->add_handler(logger, &handler.handler);
+	muggle_async_logger_set_deferred(&async_logger, 1);
+
+	// unsupported conversion is formatted eagerly instead of truncated
+	MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%d %ls %d", 1, L"wide", 2);
+
+	// precision limit bytes copied from buffer without '\0'
+	char not_terminated[4] = { 'a', 'b', 'c', 'd' };
+	MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%.2s|%.*s", not_terminated, 3, not_terminated);
+
+	logger->destroy(logger);
+	handler.handler.destroy(&handler.handler);
+
+	ASSERT_EQ(payloads.size(), 2u);
+	ASSERT_EQ(payloads[0], "1 wide 2");
+	ASSERT_EQ(payloads[1], "ab|abc");
+}
+
+static int test_log_count_lines(const char *filepath)
+{
+	FILE *fp = fopen(filepath, "rb");
+	if (fp == NULL)
+	{
+		return -1;
+	}
+
+	int cnt = 0;
+	int c = 0;
+	while ((c = fgetc(fp)) != EOF)
+	{
+		if (c == '\n')
+		{
+			cnt++;
+		}
+	}
+	fclose(fp);
+
+	return cnt;
+}
+
+TEST(log, file_handler_buffered)
+{
+	const char *filepath = "unittest_log_buffered.log";
+	muggle_os_remove(filepath);
+
+	muggle_log_file_handler_t handler;
+	ASSERT_EQ(muggle_log_file_handler_init(&handler, filepath, "wb"), 0);
+	ASSERT_EQ(muggle_log_handler_set_buffer((muggle_log_handler_t*)&handler, 64 * 1024, 0), 0);
+
+	muggle_sync_logger_t sync_logger;
+	muggle_sync_logger_init(&sync_logger);
+	muggle_logger_t *logger = (muggle_logger_t*)&sync_logger;
+	logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+
+	// records stay in buffer
+	for (int i = 0; i < 10; i++)
+	{
+		MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "buffered %d", i);
+	}
+	ASSERT_EQ(test_log_count_lines(filepath), 0);
+
+	// explicit flush
+	muggle_logger_flush(logger);
+	ASSERT_EQ(test_log_count_lines(filepath), 10);
+
+	// error level flush immediately
+	MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "buffered");
+	MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_ERROR, "error");
+	ASSERT_EQ(test_log_count_lines(filepath), 12);
+
+	// buffer full
+	std::string s(1000, 'x');
+	for (int i = 0; i < 100; i++)
+	{
+		MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%s", s.c_str());
+	}
+	int cnt = test_log_count_lines(filepath);
+	ASSERT_GT(cnt, 12);
+	ASSERT_LT(cnt, 112);
+
+	// destroy flush remain records
+	logger->destroy(logger);
+	handler.handler.destroy((muggle_log_handler_t*)&handler);
+	ASSERT_EQ(test_log_count_lines(filepath), 112);
+
+	muggle_os_remove(filepath);
+}
+
+#if !MUGGLE_PLATFORM_WINDOWS
+TEST(log, mmap_handler)
+{
+	const char *filepath = "unittest_log_mmap.log";
+	const unsigned int backup_count = 10;
+	char backup[MUGGLE_MAX_PATH];
+	muggle_os_remove(filepath);
+	for (unsigned int i = 1; i <= backup_count; i++)
+	{
+		snprintf(backup, sizeof(backup), "%s.%u", filepath, i);
+		muggle_os_remove(backup);
+	}
+
+	// small window, records cross window boundary
+	muggle_log_mmap_handler_t handler;
+	ASSERT_EQ(muggle_log_mmap_handler_init(&handler, filepath, 4096, 64 * 1024, backup_count,
+		MUGGLE_LOG_MMAP_FLAG_SYNC_ERROR | MUGGLE_LOG_MMAP_FLAG_SYNC_SHUTDOWN), 0);
+
+	muggle_sync_logger_t sync_logger;
+	muggle_sync_logger_init(&sync_logger);
+	muggle_logger_t *logger = (muggle_logger_t*)&sync_logger;
+	logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+
+	// records visible without flush
+	std::string s(600, 'x');
+	const int cnt_msg = 200;
+	for (int i = 0; i < 10; i++)
+	{
+		MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "%s", s.c_str());
+	}
+	ASSERT_EQ(test_log_count_lines(filepath), 10);
+	for (int i = 10; i < cnt_msg; i++)
+	{
+		MUGGLE_LOG(logger, i % 50 ? MUGGLE_LOG_LEVEL_INFO : MUGGLE_LOG_LEVEL_ERROR, "%s", s.c_str());
+	}
+
+	logger->destroy(logger);
+	handler.handler.destroy((muggle_log_handler_t*)&handler);
+
+	// rotated, and no preallocated tail left
+	int total = 0;
+	for (unsigned int i = 0; i <= backup_count; i++)
+	{
+		if (i == 0)
+		{
+			snprintf(backup, sizeof(backup), "%s", filepath);
+		}
+		else
+		{
+			snprintf(backup, sizeof(backup), "%s.%u", filepath, i);
+		}
+
+		FILE *fp = fopen(backup, "rb");
+		if (fp == NULL)
+		{
+			continue;
+		}
+		int c = 0, last = 0;
+		while ((c = fgetc(fp)) != EOF)
+		{
+			ASSERT_NE(c, 0);
+			last = c;
+		}
+		fclose(fp);
+		if (last)
+		{
+			ASSERT_EQ(last, '\n');
+		}
+
+		int cnt = test_log_count_lines(backup);
+		ASSERT_GT(cnt, 0);
+		total += cnt;
+	}
+	ASSERT_EQ(total, cnt_msg);
+	int cnt_last = test_log_count_lines(filepath);
+
+	// reopen and append
+	ASSERT_EQ(muggle_log_mmap_handler_init(&handler, filepath, 0, 0, backup_count, 0), 0);
+	muggle_sync_logger_init(&sync_logger);
+	logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+	MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "append");
+	logger->destroy(logger);
+	handler.handler.destroy((muggle_log_handler_t*)&handler);
+	ASSERT_EQ(test_log_count_lines(filepath), cnt_last + 1);
+
+	muggle_os_remove(filepath);
+	for (unsigned int i = 1; i <= backup_count; i++)
+	{
+		snprintf(backup, sizeof(backup), "%s.%u", filepath, i);
+		muggle_os_remove(backup);
+	}
+}
+
+static int test_log_payload_fmt_func(const muggle_log_msg_t *msg, char *buf, size_t bufsize)
+{
+	return (int)snprintf(buf, bufsize, "%s\n", msg->payload);
+}
+
+TEST(log, mmap_handler_map_failed)
+{
+	const char *filepath = "unittest_log_mmap_map_failed.log";
+	muggle_os_remove(filepath);
+
+	muggle_log_mmap_handler_t handler;
+	ASSERT_EQ(muggle_log_mmap_handler_init(&handler, filepath, 4096, 0, 0, 0), 0);
+	muggle_log_fmt_t formatter = {
+		MUGGLE_LOG_FMT_LEVEL,
+		test_log_payload_fmt_func
+	};
+	muggle_log_handler_set_fmt((muggle_log_handler_t*)&handler, &formatter);
+
+	std::string s(999, 'x');
+	muggle_log_msg_t msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.level = MUGGLE_LOG_LEVEL_INFO;
+	msg.payload = s.c_str();
+
+	muggle_log_handler_t *base_handler = (muggle_log_handler_t*)&handler;
+	for (int i = 0; i < 4; i++)
+	{
+		ASSERT_EQ(base_handler->write(base_handler, &msg), 1000);
+	}
+
+	// preallocate next window failed with read only fd
+	int rdwr_fd = dup(handler.fd);
+	int rdonly_fd = open(filepath, O_RDONLY);
+	ASSERT_NE(rdwr_fd, -1);
+	ASSERT_NE(rdonly_fd, -1);
+	ASSERT_NE(dup2(rdonly_fd, handler.fd), -1);
+
+	ASSERT_EQ(base_handler->write(base_handler, &msg), 4096 - 4000);
+	ASSERT_LT(base_handler->write(base_handler, &msg), 0);
+
+	// map retried in next write
+	ASSERT_NE(dup2(rdwr_fd, handler.fd), -1);
+	close(rdonly_fd);
+	close(rdwr_fd);
+	ASSERT_EQ(base_handler->write(base_handler, &msg), 1000);
+
+	handler.handler.destroy(base_handler);
+
+	FILE *fp = fopen(filepath, "rb");
+	ASSERT_TRUE(fp != NULL);
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fclose(fp);
+	ASSERT_EQ(size, 4096 + 1000);
+
+	muggle_os_remove(filepath);
+}
+#endif
+
+TEST(log, async_logger_flush)
+{
+	const char *filepath = "unittest_log_async_flush.log";
+	muggle_os_remove(filepath);
+
+	muggle_log_file_handler_t handler;
+	ASSERT_EQ(muggle_log_file_handler_init(&handler, filepath, "wb"), 0);
+	ASSERT_EQ(muggle_log_handler_set_buffer((muggle_log_handler_t*)&handler, 1024 * 1024, 0), 0);
+
+	muggle_async_logger_t async_logger;
+	ASSERT_EQ(muggle_async_logger_init(&async_logger, 64), 0);
+	muggle_logger_t *logger = (muggle_logger_t*)&async_logger;
+	logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+
+	for (int round = 1; round <= 5; round++)
+	{
+		for (int i = 0; i < 100; i++)
+		{
+			MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "round %d, msg %d", round, i);
+		}
+		muggle_logger_flush(logger);
+		ASSERT_EQ(test_log_count_lines(filepath), round * 100);
+	}
+
+	logger->destroy(logger);
+	handler.handler.destroy((muggle_log_handler_t*)&handler);
+
+	muggle_os_remove(filepath);
+}
+
+static std::string test_log_read_file(const char *filepath)
+{
+	std::string content;
+	FILE *fp = fopen(filepath, "rb");
+	if (fp == NULL)
+	{
+		return content;
+	}
+
+	char buf[4096];
+	size_t n = 0;
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+	{
+		content.append(buf, n);
+	}
+	fclose(fp);
+
+	return content;
+}
+
+TEST(log, lz_compress)
+{
+	std::vector<std::string> inputs;
+	inputs.push_back("");
+	inputs.push_back("abc");
+	inputs.push_back(std::string(100000, 'a'));
+
+	std::string text;
+	for (int i = 0; i < 2000; i++)
+	{
+		text += "INFO|2026-10-17 12:00:00|unittest_log.cpp:1|lz_compress - message " + std::to_string(i) + "\n";
+	}
+	inputs.push_back(text);
+
+	std::string noise;
+	uint32_t seed = 12345;
+	for (int i = 0; i < 50000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		noise.push_back((char)(seed >> 16));
+	}
+	inputs.push_back(noise);
+
+	for (const std::string &input : inputs)
+	{
+		std::vector<char> comp(MUGGLE_LOG_LZ_COMPRESS_BOUND(input.size()));
+		size_t comp_len = muggle_log_lz_compress(input.data(), input.size(), comp.data(), comp.size());
+		ASSERT_GT(comp_len, 0u);
+
+		std::vector<char> raw(input.size() + 1);
+		int n = muggle_log_lz_decompress(comp.data(), comp_len, raw.data(), raw.size());
+		ASSERT_EQ(n, (int)input.size());
+		ASSERT_EQ(std::string(raw.data(), n), input);
+	}
+
+	// repetitive text shrink
+	std::vector<char> comp(MUGGLE_LOG_LZ_COMPRESS_BOUND(text.size()));
+	size_t comp_len = muggle_log_lz_compress(text.data(), text.size(), comp.data(), comp.size());
+	ASSERT_LT(comp_len, text.size() / 4);
+
+	// output too small
+	ASSERT_LT(muggle_log_lz_decompress(comp.data(), comp_len, comp.data(), 16), 0);
+
+	// file
+	const char *raw_path = "unittest_log_lz.txt";
+	const char *comp_path = "unittest_log_lz.txt.lz";
+	const char *out_path = "unittest_log_lz.out";
+	FILE *fp = fopen(raw_path, "wb");
+	ASSERT_TRUE(fp != NULL);
+	for (int i = 0; i < 20; i++)
+	{
+		fwrite(text.data(), 1, text.size(), fp);
+		fwrite(noise.data(), 1, 1000, fp);
+	}
+	fclose(fp);
+
+	ASSERT_EQ(muggle_log_lz_compress_file(raw_path, comp_path), 0);
+	ASSERT_EQ(muggle_log_lz_decompress_file(comp_path, out_path), 0);
+	ASSERT_EQ(test_log_read_file(raw_path), test_log_read_file(out_path));
+	ASSERT_LT(test_log_read_file(comp_path).size(), test_log_read_file(raw_path).size() / 2);
+	ASSERT_NE(muggle_log_lz_decompress_file(raw_path, out_path), 0);
+
+	muggle_os_remove(raw_path);
+	muggle_os_remove(comp_path);
+	muggle_os_remove(out_path);
+}
+
+TEST(log, rotate_handler_compress)
+{
+	const char *filepath = "unittest_log_rotate_compress.log";
+	char path[MUGGLE_MAX_PATH];
+	for (int i = 0; i <= 4; i++)
+	{
+		snprintf(path, sizeof(path), "%s.%d.lz", filepath, i);
+		muggle_os_remove(path);
+	}
+	muggle_os_remove(filepath);
+
+	muggle_log_file_rotate_handler_t handler;
+	ASSERT_EQ(muggle_log_file_rotate_handler_init(&handler, filepath, 16 * 1024, 3), 0);
+	ASSERT_EQ(muggle_log_file_rotate_handler_set_rotate_flags(&handler, MUGGLE_LOG_ROTATE_FLAG_COMPRESS), 0);
+	muggle_log_handler_set_fmt((muggle_log_handler_t*)&handler, muggle_log_fmt_get_simple());
+
+	muggle_sync_logger_t sync_logger;
+	ASSERT_EQ(muggle_sync_logger_init(&sync_logger), 0);
+	muggle_logger_t *logger = (muggle_logger_t*)&sync_logger;
+	logger->add_handler(logger, (muggle_log_handler_t*)&handler);
+
+	const int cnt_msg = 5000;
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		MUGGLE_LOG(logger, MUGGLE_LOG_LEVEL_INFO, "rotate compress message %d", i);
+	}
+
+	// destroy wait all background tasks done
+	logger->destroy(logger);
+	handler.handler.destroy((muggle_log_handler_t*)&handler);
+
+	for (int i = 1; i <= 3; i++)
+	{
+		snprintf(path, sizeof(path), "%s.%d.lz", filepath, i);
+		ASSERT_TRUE(muggle_path_exists(path));
+		snprintf(path, sizeof(path), "%s.%d", filepath, i);
+		ASSERT_FALSE(muggle_path_exists(path));
+	}
+	snprintf(path, sizeof(path), "%s.4.lz", filepath);
+	ASSERT_FALSE(muggle_path_exists(path));
+
+	// newest backup end right before active file
+	const char *out_path = "unittest_log_rotate_compress.out";
+	snprintf(path, sizeof(path), "%s.1.lz", filepath);
+	ASSERT_EQ(muggle_log_lz_decompress_file(path, out_path), 0);
+	std::string backup = test_log_read_file(out_path);
+	std::string active = test_log_read_file(filepath);
+	ASSERT_FALSE(backup.empty());
+	ASSERT_FALSE(active.empty());
+
+	int last_backup = -1, first_active = -1;
+	size_t pos = backup.rfind("message ", backup.size() - 2);
+	ASSERT_NE(pos, std::string::npos);
+	last_backup = atoi(backup.c_str() + pos + strlen("message "));
+	pos = active.find("message ");
+	ASSERT_NE(pos, std::string::npos);
+	first_active = atoi(active.c_str() + pos + strlen("message "));
+	ASSERT_EQ(last_backup + 1, first_active);
+
+	muggle_os_remove(out_path);
+	muggle_os_remove(filepath);
+	for (int i = 1; i <= 3; i++)
+	{
+		snprintf(path, sizeof(path), "%s.%d.lz", filepath, i);
+		muggle_os_remove(path);
+	}
+}
+
+TEST(log, rotate_worker_shift_raw_backup)
+{
+	const char *filepath = "unittest_log_rotate_raw.log";
+	char path[MUGGLE_MAX_PATH];
+	for (int i = 1; i <= 4; i++)
+	{
+		snprintf(path, sizeof(path), "%s.%d", filepath, i);
+		muggle_os_remove(path);
+		snprintf(path, sizeof(path), "%s.%d.lz", filepath, i);
+		muggle_os_remove(path);
+	}
+
+	// raw backup left by failed compression
+	snprintf(path, sizeof(path), "%s.1", filepath);
+	FILE *fp = fopen(path, "wb");
+	ASSERT_TRUE(fp != NULL);
+	fputs("raw backup", fp);
+	fclose(fp);
+
+	muggle_log_rotate_worker_t *worker = muggle_log_rotate_worker_create(MUGGLE_LOG_ROTATE_FLAG_COMPRESS);
+	ASSERT_TRUE(worker != NULL);
+	for (int i = 0; i < 3; i++)
+	{
+		fp = fopen(filepath, "wb");
+		ASSERT_TRUE(fp != NULL);
+		fprintf(fp, "active file %d", i);
+		fclose(fp);
+		ASSERT_EQ(muggle_log_rotate_worker_backups(worker, filepath, 3), 0);
+	}
+	muggle_log_rotate_worker_destroy(worker);
+
+	// raw backup shifted with compressed ones and removed out of count
+	for (int i = 1; i <= 3; i++)
+	{
+		snprintf(path, sizeof(path), "%s.%d.lz", filepath, i);
+		ASSERT_TRUE(muggle_path_exists(path));
+		muggle_os_remove(path);
+	}
+	for (int i = 1; i <= 4; i++)
+	{
+		snprintf(path, sizeof(path), "%s.%d", filepath, i);
+		ASSERT_FALSE(muggle_path_exists(path));
+	}
+}
+
+TEST(log, time_rot_handler_compress)
+{
+	muggle_log_file_time_rot_handler_t handler;
+	ASSERT_EQ(muggle_log_file_time_rot_handler_init(&handler,
+		"unittest_log_time_rot_compress.log", MUGGLE_LOG_TIME_ROTATE_UNIT_SEC, 1, false), 0);
+	ASSERT_EQ(muggle_log_file_time_rot_handler_set_rotate_flags(&handler, MUGGLE_LOG_ROTATE_FLAG_COMPRESS), 0);
+	muggle_log_handler_set_fmt((muggle_log_handler_t*)&handler, muggle_log_fmt_get_simple());
+
+	// drive rotation with timestamp of message
+	std::vector<std::string> files;
+	muggle_log_msg_t msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.level = MUGGLE_LOG_LEVEL_INFO;
+	msg.src_loc.file = __FILE__;
+	msg.src_loc.line = __LINE__;
+	msg.src_loc.func = __FUNCTION__;
+	msg.payload = "time rotate compress";
+	msg.ts.tv_sec = handler.last_sec;
+	for (int i = 0; i < 3; i++)
+	{
+		msg.ts.tv_sec++;
+		files.push_back(handler.curr_filepath);
+		handler.handler.write((muggle_log_handler_t*)&handler, &msg);
+	}
+	std::string active = handler.curr_filepath;
+	handler.handler.destroy((muggle_log_handler_t*)&handler);
+
+	for (const std::string &file : files)
+	{
+		ASSERT_NE(file, active);
+		ASSERT_FALSE(muggle_path_exists(file.c_str()));
+		std::string lz_path = file + MUGGLE_LOG_LZ_FILE_EXT;
+		ASSERT_TRUE(muggle_path_exists(lz_path.c_str()));
+		muggle_os_remove(lz_path.c_str());
+	}
+	ASSERT_TRUE(muggle_path_exists(active.c_str()));
+	muggle_os_remove(active.c_str());
+}
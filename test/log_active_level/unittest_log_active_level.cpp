@@ -0,0 +1,89 @@
+#define MUGGLE_LOG_ACTIVE_LEVEL MUGGLE_LOG_ACTIVE_WARNING
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+struct test_log_record_handler
+{
+	muggle_log_handler_t handler;
+	std::vector<std::string> *payloads;
+};
+
+static int test_log_record_handler_write(muggle_log_handler_t *base_handler, const muggle_log_msg_t *msg)
+{
+	test_log_record_handler *handler = (test_log_record_handler*)base_handler;
+	handler->payloads->push_back(msg->payload);
+	return 0;
+}
+
+static int s_cnt_eval = 0;
+
+static int test_log_eval_arg(int v)
+{
+	s_cnt_eval++;
+	return v;
+}
+
+class LogActiveLevelFixture : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		ASSERT_EQ(muggle_log_handler_init_default(&handler_.handler), 0);
+		handler_.handler.write = test_log_record_handler_write;
+		handler_.handler.destroy = muggle_log_handler_destroy_default;
+		handler_.payloads = &payloads_;
+
+		muggle_sync_logger_init(&sync_logger_);
+		logger_ = (muggle_logger_t*)&sync_logger_;
+		s_cnt_eval = 0;
+	}
+
+	void TearDown() override
+	{
+		logger_->destroy(logger_);
+		handler_.handler.destroy(&handler_.handler);
+	}
+
+protected:
+	std::vector<std::string> payloads_;
+	test_log_record_handler handler_;
+	muggle_sync_logger_t sync_logger_;
+	muggle_logger_t *logger_;
+};
+
+TEST_F(LogActiveLevelFixture, compile_time)
+{
+	muggle_log_handler_set_level(&handler_.handler, MUGGLE_LOG_LEVEL_TRACE);
+	logger_->add_handler(logger_, &handler_.handler);
+
+	// lower than MUGGLE_LOG_ACTIVE_LEVEL, removed even handler accept it
+	MUGGLE_LOG(logger_, MUGGLE_LOG_LEVEL_INFO, "%d", test_log_eval_arg(1));
+	MUGGLE_LOG(logger_, MUGGLE_LOG_LEVEL_DEBUG, "%d", test_log_eval_arg(2));
+	EXPECT_EQ(s_cnt_eval, 0);
+	EXPECT_EQ(payloads_.size(), 0);
+
+	MUGGLE_LOG(logger_, MUGGLE_LOG_LEVEL_WARNING, "%d", test_log_eval_arg(3));
+	MUGGLE_LOG(logger_, MUGGLE_LOG_LEVEL_ERROR, "%d", test_log_eval_arg(4));
+	EXPECT_EQ(s_cnt_eval, 2);
+	ASSERT_EQ(payloads_.size(), 2);
+	EXPECT_EQ(payloads_[0], "3");
+	EXPECT_EQ(payloads_[1], "4");
+}
+
+TEST_F(LogActiveLevelFixture, runtime)
+{
+	muggle_log_handler_set_level(&handler_.handler, MUGGLE_LOG_LEVEL_ERROR);
+	logger_->add_handler(logger_, &handler_.handler);
+
+	// active at compile time, but lower than logger's lowest level
+	MUGGLE_LOG(logger_, MUGGLE_LOG_LEVEL_WARNING, "%d", test_log_eval_arg(1));
+	EXPECT_EQ(s_cnt_eval, 0);
+	EXPECT_EQ(payloads_.size(), 0);
+
+	MUGGLE_LOG(logger_, MUGGLE_LOG_LEVEL_ERROR, "%d", test_log_eval_arg(2));
+	EXPECT_EQ(s_cnt_eval, 1);
+	ASSERT_EQ(payloads_.size(), 1);
+	EXPECT_EQ(payloads_[0], "2");
+}
@@ -148,6 +148,109 @@ TEST(ring_buffer, write_read_in_single_thread)
 	}
 }
 
+void test_write_read_batch_in_single_thread(int flag)
+{
+	muggle_ring_buffer_t r;
+	muggle_atomic_int capacity = 16;
+	muggle_atomic_int pos = 0;
+	int arr[160];
+	void *datas[16];
+
+	muggle_ring_buffer_init(&r, capacity, flag);
+
+	EXPECT_EQ(muggle_ring_buffer_write_batch(&r, datas, 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_ring_buffer_write_batch(&r, datas, capacity), MUGGLE_ERR_INVALID_PARAM);
+
+	// write batch with different size, read batch with fixed size
+	int write_idx = 0;
+	int read_idx = 0;
+	for (int batch = 1; batch < capacity / 2; ++batch)
+	{
+		for (int i = 0; i < batch; ++i)
+		{
+			arr[write_idx] = write_idx;
+			datas[i] = &arr[write_idx];
+			++write_idx;
+		}
+		ASSERT_EQ(muggle_ring_buffer_write_batch(&r, datas, batch), MUGGLE_OK);
+
+		while (read_idx < write_idx)
+		{
+			muggle_atomic_int cnt = muggle_ring_buffer_read_batch(&r, pos, datas, 4);
+			ASSERT_GT(cnt, 0);
+			ASSERT_LE(cnt, 4);
+			for (muggle_atomic_int i = 0; i < cnt; ++i)
+			{
+				EXPECT_EQ(*(int*)datas[i], read_idx);
+				++read_idx;
+			}
+			pos += cnt;
+		}
+	}
+
+	muggle_ring_buffer_destroy(&r);
+}
+TEST(ring_buffer, write_read_batch_in_single_thread)
+{
+	for (int w_flag = 0; w_flag < (int)(sizeof(w_flags) / sizeof(w_flags[0])); ++w_flag)
+	{
+		for (int r_flag = 0; r_flag < (int)(sizeof(r_flags) / sizeof(r_flags[0])); ++r_flag)
+		{
+			test_write_read_batch_in_single_thread(w_flags[w_flag] | r_flags[r_flag]);
+		}
+	}
+}
+
+void test_try_read_and_read_timeout(int flag)
+{
+	muggle_ring_buffer_t r;
+	muggle_atomic_int pos = 0;
+	int arr[2] = {0, 1};
+	void *data = NULL;
+
+	muggle_ring_buffer_init(&r, 16, flag);
+
+	// empty
+	EXPECT_EQ(muggle_ring_buffer_try_read(&r, pos, &data), MUGGLE_ERR_EMPTY);
+
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 10 * 1000 * 1000;
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_EQ(muggle_ring_buffer_read_timeout(&r, pos, &data, &timeout), MUGGLE_ERR_TIMEOUT);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 9);
+
+	// ready
+	muggle_ring_buffer_write(&r, &arr[0]);
+	ASSERT_EQ(muggle_ring_buffer_try_read(&r, pos, &data), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 0);
+	++pos;
+
+	// wake up by writer before timeout
+	std::thread writer([&r, &arr]{
+		muggle_msleep(5);
+		muggle_ring_buffer_write(&r, &arr[1]);
+	});
+	timeout.tv_sec = 5;
+	timeout.tv_nsec = 0;
+	ASSERT_EQ(muggle_ring_buffer_read_timeout(&r, pos, &data, &timeout), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 1);
+	writer.join();
+
+	muggle_ring_buffer_destroy(&r);
+}
+TEST(ring_buffer, try_read_and_read_timeout)
+{
+	for (int w_flag = 0; w_flag < (int)(sizeof(w_flags) / sizeof(w_flags[0])); ++w_flag)
+	{
+		for (int r_flag = 0; r_flag < (int)(sizeof(r_flags) / sizeof(r_flags[0])); ++r_flag)
+		{
+			test_try_read_and_read_timeout(w_flags[w_flag] | r_flags[r_flag]);
+		}
+	}
+}
+
 void producer_consumer(int flag, int cnt_producer, int cnt_consumer, int cnt_interval, int interval_ms,
 	int capacity = 1024 * 2, int total = 10000)
 {
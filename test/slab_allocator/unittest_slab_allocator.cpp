@@ -0,0 +1,150 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(slab_allocator, size_class)
+{
+	EXPECT_EQ(muggle_slab_allocator_size_class(0), 0);
+	EXPECT_EQ(muggle_slab_allocator_size_class(1), 0);
+	EXPECT_EQ(muggle_slab_allocator_size_class(16), 0);
+	EXPECT_EQ(muggle_slab_allocator_size_class(17), 1);
+	EXPECT_EQ(muggle_slab_allocator_size_class(32), 1);
+	EXPECT_EQ(muggle_slab_allocator_size_class(33), 2);
+	EXPECT_EQ(muggle_slab_allocator_size_class(1024), 6);
+	EXPECT_EQ(muggle_slab_allocator_size_class(64 * 1024), MUGGLE_SLAB_ALLOCATOR_NUM_CLASS - 1);
+	EXPECT_EQ(muggle_slab_allocator_size_class(64 * 1024 + 1), MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS);
+}
+
+static void test_slab_alloc_free(int flags)
+{
+	muggle_slab_allocator_t allocator;
+	ASSERT_EQ(muggle_slab_allocator_init(&allocator, flags | MUGGLE_SLAB_ALLOCATOR_FLAG_STATS, 64 * 1024), MUGGLE_OK);
+
+	size_t sizes[] = { 0, 1, 15, 16, 17, 100, 1000, 4096, 10000, 65536, 65537, 200000 };
+	const int cnt_sizes = (int)(sizeof(sizes) / sizeof(sizes[0]));
+
+	std::vector<void*> ptrs;
+	for (int round = 0; round < 20; round++)
+	{
+		for (int i = 0; i < cnt_sizes; i++)
+		{
+			void *p = muggle_slab_allocator_alloc(&allocator, sizes[i]);
+			ASSERT_TRUE(p != NULL);
+			ASSERT_GE(muggle_slab_allocator_usable_size(p), sizes[i]);
+			ASSERT_EQ((uintptr_t)p % 8, 0);
+			memset(p, (int)i, sizes[i]);
+			ptrs.push_back(p);
+		}
+	}
+
+	for (int round = 0; round < 20; round++)
+	{
+		for (int i = 0; i < cnt_sizes; i++)
+		{
+			unsigned char *p = (unsigned char*)ptrs[round * cnt_sizes + i];
+			for (size_t j = 0; j < sizes[i]; j++)
+			{
+				ASSERT_EQ(p[j], (unsigned char)i);
+			}
+			muggle_slab_allocator_free(&allocator, p);
+		}
+	}
+
+	muggle_slab_class_stats_t stats;
+	ASSERT_EQ(muggle_slab_allocator_get_stats(&allocator, 0, &stats), MUGGLE_OK);
+	EXPECT_EQ(stats.size, 16);
+	EXPECT_EQ(stats.cnt_alloc, 20 * 4);
+	EXPECT_EQ(stats.cnt_free, 20 * 4);
+	EXPECT_EQ(stats.cnt_fallback, 0);
+
+	ASSERT_EQ(muggle_slab_allocator_get_stats(&allocator, MUGGLE_SLAB_ALLOCATOR_NUM_CLASS - 1, &stats), MUGGLE_OK);
+	EXPECT_EQ(stats.size, 64 * 1024);
+	EXPECT_EQ(stats.cnt_alloc, 20);
+	if (flags & MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE)
+	{
+		EXPECT_EQ(stats.cnt_fallback, 20 - stats.capacity);
+	}
+	else
+	{
+		EXPECT_EQ(stats.cnt_fallback, 0);
+	}
+
+	ASSERT_EQ(muggle_slab_allocator_get_stats(&allocator, MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS, &stats), MUGGLE_OK);
+	EXPECT_EQ(stats.size, 0);
+	EXPECT_EQ(stats.cnt_alloc, 20 * 2);
+	EXPECT_EQ(stats.cnt_free, 20 * 2);
+
+	EXPECT_EQ(muggle_slab_allocator_get_stats(&allocator, -1, &stats), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_slab_allocator_get_stats(&allocator, MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS + 1, &stats), MUGGLE_ERR_INVALID_PARAM);
+
+	muggle_slab_allocator_destroy(&allocator);
+}
+
+TEST(slab_allocator, alloc_free)
+{
+	test_slab_alloc_free(0);
+}
+
+TEST(slab_allocator, alloc_free_thread_safe)
+{
+	test_slab_alloc_free(MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE);
+}
+
+TEST(slab_allocator, mul_thread)
+{
+	muggle_slab_allocator_t allocator;
+	ASSERT_EQ(muggle_slab_allocator_init(&allocator,
+		MUGGLE_SLAB_ALLOCATOR_FLAG_THREAD_SAFE | MUGGLE_SLAB_ALLOCATOR_FLAG_STATS, 256 * 1024), MUGGLE_OK);
+
+	const int cnt_thread = 4;
+	const int cnt_msg = 10000;
+
+	// allocate in writers and free in reader
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, 1024, MUGGLE_CHANNEL_FLAG_WRITE_BLOCK), MUGGLE_OK);
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&allocator, &chan, i] {
+			for (int j = 0; j < cnt_msg; j++)
+			{
+				size_t size = (size_t)(8 << ((i + j) % 12));
+				int *p = (int*)muggle_slab_allocator_alloc(&allocator, size);
+				ASSERT_TRUE(p != NULL);
+				p[0] = (int)size;
+				p[1] = i;
+				muggle_channel_write(&chan, p);
+			}
+		}));
+	}
+
+	int cnt_recv = 0;
+	while (cnt_recv < cnt_thread * cnt_msg)
+	{
+		int *p = (int*)muggle_channel_read(&chan);
+		ASSERT_GE(muggle_slab_allocator_usable_size(p), (size_t)p[0]);
+		muggle_slab_allocator_free(&allocator, p);
+		cnt_recv++;
+	}
+
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+	muggle_channel_destroy(&chan);
+
+	uint64_t total_alloc = 0, total_free = 0;
+	for (int i = 0; i <= MUGGLE_SLAB_ALLOCATOR_LARGE_CLASS; i++)
+	{
+		muggle_slab_class_stats_t stats;
+		ASSERT_EQ(muggle_slab_allocator_get_stats(&allocator, i, &stats), MUGGLE_OK);
+		total_alloc += stats.cnt_alloc;
+		total_free += stats.cnt_free;
+	}
+	EXPECT_EQ(total_alloc, (uint64_t)cnt_thread * cnt_msg);
+	EXPECT_EQ(total_free, (uint64_t)cnt_thread * cnt_msg);
+
+	muggle_slab_allocator_destroy(&allocator);
+}
@@ -0,0 +1,842 @@
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#if MUGGLE_PLATFORM_LINUX
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define TEST_SOCKET_EVENT_SEND_CHUNK (64 * 1024)
+#define TEST_SOCKET_EVENT_SEND_BYTES (1024 * 1024)
+
+static int test_socket_event_listen(muggle_socket_peer_t *listen_peer)
+{
+	if (muggle_tcp_listen("127.0.0.1", "0", 64, listen_peer) == MUGGLE_INVALID_SOCKET)
+	{
+		return -1;
+	}
+
+	struct sockaddr_in addr;
+	socklen_t addr_len = sizeof(addr);
+	if (getsockname(listen_peer->fd, (struct sockaddr*)&addr, &addr_len) != 0)
+	{
+		return -1;
+	}
+	return ntohs(addr.sin_port);
+}
+
+/**
+ * connect with small receive buffer, so server can't send all bytes at once
+ */
+static muggle_socket_t test_socket_event_connect(int port, int rcvbuf)
+{
+	muggle_socket_t fd = muggle_socket_create(AF_INET, SOCK_STREAM, 0);
+	if (fd == MUGGLE_INVALID_SOCKET)
+	{
+		return MUGGLE_INVALID_SOCKET;
+	}
+
+	if (rcvbuf > 0)
+	{
+		setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+	}
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons((uint16_t)port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+	{
+		muggle_socket_close(fd);
+		return MUGGLE_INVALID_SOCKET;
+	}
+
+	return fd;
+}
+
+static char test_socket_event_byte(int offset)
+{
+	return (char)(offset % 251);
+}
+
+static void test_socket_event_on_exit_timer(struct muggle_socket_event *ev)
+{
+	// guard, never block test forever
+	MUGGLE_LOG_ERROR("socket event test timeout");
+	muggle_socket_event_loop_exit(ev);
+}
+
+struct test_socket_event_timer_ctx
+{
+	int cnt;
+	std::set<muggle_thread_id> tids;
+};
+
+static void test_socket_event_on_timer(struct muggle_socket_event *ev)
+{
+	test_socket_event_timer_ctx *ctx = (test_socket_event_timer_ctx*)ev->datas;
+	ctx->cnt++;
+	ctx->tids.insert(muggle_thread_current_id());
+	if (ctx->cnt == 5)
+	{
+		muggle_socket_event_loop_exit(ev);
+	}
+}
+
+TEST(socket_event, multhread_on_timer)
+{
+	muggle_socket_peer_t listen_peer;
+	ASSERT_NE(muggle_tcp_listen("127.0.0.1", "0", 64, &listen_peer), MUGGLE_INVALID_SOCKET);
+
+	test_socket_event_timer_ctx ctx;
+	ctx.cnt = 0;
+
+	muggle_socket_event_init_arg_t ev_init_arg;
+	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+	ev_init_arg.ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD;
+	ev_init_arg.hints_max_peer = 64;
+	ev_init_arg.cnt_peer = 1;
+	ev_init_arg.peers = &listen_peer;
+	ev_init_arg.timeout_ms = 10;
+	ev_init_arg.datas = &ctx;
+	ev_init_arg.num_worker = 4;
+	ev_init_arg.on_timer = test_socket_event_on_timer;
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+
+	// on_timer only run in acceptor thread, once per interval
+	muggle_thread_id loop_tid = 0;
+	std::thread t([&ev, &loop_tid]{
+		loop_tid = muggle_thread_current_id();
+		muggle_socket_event_loop(&ev);
+	});
+	t.join();
+
+	ASSERT_EQ(ctx.cnt, 5);
+	ASSERT_EQ(ctx.tids.size(), 1U);
+	ASSERT_EQ(*ctx.tids.begin(), loop_tid);
+}
+
+static void test_socket_event_on_exit_now(struct muggle_socket_event *ev)
+{
+	muggle_socket_event_loop_exit(ev);
+}
+
+TEST(socket_event, multhread_exit_race)
+{
+	// loop exit by itself while other thread keep exiting it
+	for (int i = 0; i < 50; i++)
+	{
+		muggle_socket_peer_t listen_peer;
+		ASSERT_NE(muggle_tcp_listen("127.0.0.1", "0", 64, &listen_peer), MUGGLE_INVALID_SOCKET);
+
+		muggle_socket_event_init_arg_t ev_init_arg;
+		memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+		ev_init_arg.ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD;
+		ev_init_arg.hints_max_peer = 64;
+		ev_init_arg.cnt_peer = 1;
+		ev_init_arg.peers = &listen_peer;
+		ev_init_arg.timeout_ms = 1;
+		ev_init_arg.num_worker = 4;
+		ev_init_arg.on_timer = test_socket_event_on_exit_now;
+
+		muggle_socket_event_t ev;
+		ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+
+		std::atomic<bool> done(false);
+		std::thread t([&ev, &done]{
+			muggle_socket_event_loop(&ev);
+			done = true;
+		});
+		while (!done)
+		{
+			muggle_socket_event_loop_exit(&ev);
+		}
+		t.join();
+	}
+}
+
+struct test_socket_event_listen_ctx
+{
+	int data = 0;
+	muggle_socket_t listen_fd = MUGGLE_INVALID_SOCKET;
+	void *connect_data = nullptr;
+	muggle_socket_t connect_fd = MUGGLE_INVALID_SOCKET;
+	int connect_peer_type = -1;
+};
+
+static void test_socket_event_listen_on_connect(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *listen_peer, struct muggle_socket_peer *peer)
+{
+	(void)peer;
+
+	test_socket_event_listen_ctx *ctx = (test_socket_event_listen_ctx*)ev->datas;
+	ctx->connect_data = listen_peer->data;
+	ctx->connect_fd = listen_peer->fd;
+	ctx->connect_peer_type = listen_peer->peer_type;
+	muggle_socket_event_loop_exit(ev);
+}
+
+TEST(socket_event, multhread_on_connect_listen_peer)
+{
+	muggle_socket_peer_t listen_peer;
+	int port = test_socket_event_listen(&listen_peer);
+	ASSERT_GT(port, 0);
+
+	test_socket_event_listen_ctx ctx;
+	listen_peer.data = &ctx.data;
+	ctx.listen_fd = listen_peer.fd;
+
+	muggle_socket_event_init_arg_t ev_init_arg;
+	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+	ev_init_arg.ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD;
+	ev_init_arg.hints_max_peer = 64;
+	ev_init_arg.cnt_peer = 1;
+	ev_init_arg.peers = &listen_peer;
+	ev_init_arg.timeout_ms = 10000;
+	ev_init_arg.datas = &ctx;
+	ev_init_arg.num_worker = 2;
+	ev_init_arg.on_connect = test_socket_event_listen_on_connect;
+	ev_init_arg.on_timer = test_socket_event_on_exit_timer;
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+	std::thread t([&ev]{
+		muggle_socket_event_loop(&ev);
+	});
+
+	muggle_socket_t fd = test_socket_event_connect(port, 0);
+	ASSERT_NE(fd, MUGGLE_INVALID_SOCKET);
+	t.join();
+	muggle_socket_close(fd);
+
+	// worker get copy of listen peer, user data and fd are kept
+	ASSERT_EQ(ctx.connect_data, (void*)&ctx.data);
+	ASSERT_EQ(ctx.connect_fd, ctx.listen_fd);
+	ASSERT_EQ(ctx.connect_peer_type, MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN);
+}
+
+struct test_socket_event_send_ctx
+{
+	int sent = 0;
+	int round = 0;
+	std::vector<int> queued_after_send;
+	std::vector<bool> watch_after_send;
+	std::vector<int> high_water;
+	bool watch_after_drain = true;
+	int cnt_close = 0; //!< peers closed before loop exit
+	bool exiting = false;
+};
+
+/**
+ * send one round bytes in chunks, socket send buffer is small, so the
+ * first chunk is partial written and the others are queued
+ */
+static void test_socket_event_send_round(struct muggle_socket_event *ev, struct muggle_socket_peer *peer)
+{
+	test_socket_event_send_ctx *ctx = (test_socket_event_send_ctx*)ev->datas;
+
+	char buf[TEST_SOCKET_EVENT_SEND_CHUNK];
+	for (int i = 0; i < TEST_SOCKET_EVENT_SEND_BYTES / TEST_SOCKET_EVENT_SEND_CHUNK; i++)
+	{
+		for (int j = 0; j < (int)sizeof(buf); j++)
+		{
+			buf[j] = test_socket_event_byte(ctx->sent + j);
+		}
+
+		int n = muggle_socket_peer_send(peer, buf, sizeof(buf), 0);
+		if (n != (int)sizeof(buf))
+		{
+			break;
+		}
+		ctx->sent += n;
+	}
+
+	ctx->round++;
+	ctx->queued_after_send.push_back(muggle_socket_peer_send_queued(peer));
+	ctx->watch_after_send.push_back((peer->send_state & MUGGLE_SOCKET_PEER_SEND_WATCH) != 0);
+}
+
+static void test_socket_event_send_on_connect(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *listen_peer, struct muggle_socket_peer *peer)
+{
+	(void)listen_peer;
+
+	int sndbuf = 4096;
+	setsockopt(peer->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+	test_socket_event_send_round(ev, peer);
+}
+
+static void test_socket_event_send_on_high_water(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *peer, int queued)
+{
+	test_socket_event_send_ctx *ctx = (test_socket_event_send_ctx*)ev->datas;
+	ctx->high_water.push_back(queued);
+	if (queued != 0)
+	{
+		return;
+	}
+
+	// drained, EPOLLOUT disarmed; send again and it must be armed again
+	ctx->watch_after_drain = (peer->send_state & MUGGLE_SOCKET_PEER_SEND_WATCH) != 0;
+	if (ctx->round == 1)
+	{
+		test_socket_event_send_round(ev, peer);
+	}
+	else
+	{
+		ctx->exiting = true;
+		muggle_socket_event_loop_exit(ev);
+	}
+}
+
+static void test_socket_event_send_on_close(struct muggle_socket_event *ev, struct muggle_socket_peer *peer)
+{
+	(void)peer;
+
+	// all peers closed when loop exit
+	test_socket_event_send_ctx *ctx = (test_socket_event_send_ctx*)ev->datas;
+	if (ctx->exiting)
+	{
+		return;
+	}
+
+	ctx->cnt_close++;
+	ctx->exiting = true;
+	muggle_socket_event_loop_exit(ev);
+}
+
+static void test_socket_event_send_init_arg(
+	muggle_socket_event_init_arg_t *ev_init_arg, int ev_loop_type,
+	muggle_socket_peer_t *listen_peer, test_socket_event_send_ctx *ctx)
+{
+	memset(ev_init_arg, 0, sizeof(*ev_init_arg));
+	ev_init_arg->ev_loop_type = ev_loop_type;
+	ev_init_arg->hints_max_peer = 64;
+	ev_init_arg->cnt_peer = 1;
+	ev_init_arg->peers = listen_peer;
+	ev_init_arg->timeout_ms = 10000;
+	ev_init_arg->datas = ctx;
+	ev_init_arg->num_worker = 1;
+	ev_init_arg->on_connect = test_socket_event_send_on_connect;
+	ev_init_arg->on_close = test_socket_event_send_on_close;
+	ev_init_arg->on_high_water = test_socket_event_send_on_high_water;
+	ev_init_arg->on_timer = test_socket_event_on_exit_timer;
+}
+
+static void test_socket_event_send_queue(int ev_loop_type)
+{
+	muggle_socket_peer_t listen_peer;
+	int port = test_socket_event_listen(&listen_peer);
+	ASSERT_GT(port, 0);
+
+	test_socket_event_send_ctx *ctx = new test_socket_event_send_ctx;
+	muggle_socket_event_init_arg_t ev_init_arg;
+	test_socket_event_send_init_arg(&ev_init_arg, ev_loop_type, &listen_peer, ctx);
+	ev_init_arg.send_buf_capacity = 4 * TEST_SOCKET_EVENT_SEND_BYTES;
+	ev_init_arg.send_high_water = TEST_SOCKET_EVENT_SEND_CHUNK;
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+	std::thread t([&ev]{
+		muggle_socket_event_loop(&ev);
+	});
+
+	// client read slowly, bytes keep order across partial writes and queue
+	muggle_socket_t fd = test_socket_event_connect(port, 4096);
+	ASSERT_NE(fd, MUGGLE_INVALID_SOCKET);
+	muggle_msleep(50);
+
+	int total = 0;
+	bool order_ok = true;
+	char buf[4096];
+	while (total < 2 * TEST_SOCKET_EVENT_SEND_BYTES)
+	{
+		int n = muggle_socket_recv(fd, buf, sizeof(buf), 0);
+		if (n <= 0)
+		{
+			break;
+		}
+		for (int i = 0; i < n; i++)
+		{
+			if (buf[i] != test_socket_event_byte(total + i))
+			{
+				order_ok = false;
+			}
+		}
+		total += n;
+	}
+
+	t.join();
+	muggle_socket_close(fd);
+
+	ASSERT_EQ(total, 2 * TEST_SOCKET_EVENT_SEND_BYTES);
+	ASSERT_TRUE(order_ok);
+	ASSERT_EQ(ctx->round, 2);
+	ASSERT_EQ(ctx->sent, 2 * TEST_SOCKET_EVENT_SEND_BYTES);
+	for (int i = 0; i < 2; i++)
+	{
+		// partial written and remain queued, EPOLLOUT armed
+		ASSERT_GT(ctx->queued_after_send[i], 0);
+		ASSERT_TRUE(ctx->watch_after_send[i]);
+	}
+	ASSERT_FALSE(ctx->watch_after_drain);
+
+	// reach high water and drained, twice
+	ASSERT_EQ(ctx->high_water.size(), 4U);
+	ASSERT_GE(ctx->high_water[0], TEST_SOCKET_EVENT_SEND_CHUNK);
+	ASSERT_EQ(ctx->high_water[1], 0);
+	ASSERT_GE(ctx->high_water[2], TEST_SOCKET_EVENT_SEND_CHUNK);
+	ASSERT_EQ(ctx->high_water[3], 0);
+	ASSERT_EQ(ctx->cnt_close, 0);
+
+	delete ctx;
+}
+
+TEST(socket_event, send_queue_epoll)
+{
+	test_socket_event_send_queue(MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL);
+}
+
+TEST(socket_event, send_queue_multhread)
+{
+	test_socket_event_send_queue(MUGGLE_SOCKET_EVENT_LOOP_TYPE_MULTHREAD);
+}
+
+TEST(socket_event, send_queue_full)
+{
+	muggle_socket_peer_t listen_peer;
+	int port = test_socket_event_listen(&listen_peer);
+	ASSERT_GT(port, 0);
+
+	test_socket_event_send_ctx *ctx = new test_socket_event_send_ctx;
+	muggle_socket_event_init_arg_t ev_init_arg;
+	test_socket_event_send_init_arg(&ev_init_arg, MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL, &listen_peer, ctx);
+	ev_init_arg.send_buf_capacity = TEST_SOCKET_EVENT_SEND_CHUNK;
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+	std::thread t([&ev]{
+		muggle_socket_event_loop(&ev);
+	});
+
+	// client never read, queue full and peer closed
+	muggle_socket_t fd = test_socket_event_connect(port, 4096);
+	ASSERT_NE(fd, MUGGLE_INVALID_SOCKET);
+
+	t.join();
+	muggle_socket_close(fd);
+
+	ASSERT_EQ(ctx->round, 1);
+	ASSERT_LT(ctx->sent, TEST_SOCKET_EVENT_SEND_BYTES);
+	ASSERT_EQ(ctx->cnt_close, 1);
+
+	delete ctx;
+}
+
+#endif
+
+#if MUGGLE_PLATFORM_LINUX
+
+struct test_socket_event_frame_ctx
+{
+	std::vector<std::string> frames;
+	int cnt_close = 0;
+	bool exiting = false;
+};
+
+static void test_socket_event_frame_on_frame(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *peer, void *frame, int len)
+{
+	(void)peer;
+
+	// frame is length prefix + body
+	test_socket_event_frame_ctx *ctx = (test_socket_event_frame_ctx*)ev->datas;
+	ctx->frames.push_back(std::string((const char*)frame + 4, len - 4));
+}
+
+static void test_socket_event_frame_on_close(struct muggle_socket_event *ev, struct muggle_socket_peer *peer)
+{
+	// all peers closed when loop exit
+	test_socket_event_frame_ctx *ctx = (test_socket_event_frame_ctx*)ev->datas;
+	if (ctx->exiting || peer->peer_type != MUGGLE_SOCKET_PEER_TYPE_TCP_PEER)
+	{
+		return;
+	}
+
+	ctx->cnt_close++;
+	ctx->exiting = true;
+	muggle_socket_event_loop_exit(ev);
+}
+
+static void test_socket_event_frame_init_arg(
+	muggle_socket_event_init_arg_t *ev_init_arg,
+	muggle_socket_peer_t *listen_peer, test_socket_event_frame_ctx *ctx, int recv_buf_capacity)
+{
+	memset(ev_init_arg, 0, sizeof(*ev_init_arg));
+	ev_init_arg->ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL;
+	ev_init_arg->hints_max_peer = 64;
+	ev_init_arg->cnt_peer = 1;
+	ev_init_arg->peers = listen_peer;
+	ev_init_arg->timeout_ms = 10000;
+	ev_init_arg->datas = ctx;
+	ev_init_arg->recv_buf_capacity = recv_buf_capacity;
+	ev_init_arg->length_field.offset = 0;
+	ev_init_arg->length_field.size = 4;
+	ev_init_arg->length_field.big_endian = 1;
+	ev_init_arg->length_field.adjust = 4;
+	ev_init_arg->on_close = test_socket_event_frame_on_close;
+	ev_init_arg->on_frame = test_socket_event_frame_on_frame;
+	ev_init_arg->on_timer = test_socket_event_on_exit_timer;
+}
+
+static std::string test_socket_event_frame_pack(const std::string &body)
+{
+	uint32_t len = htonl((uint32_t)body.size());
+	return std::string((const char*)&len, sizeof(len)) + body;
+}
+
+static void test_socket_event_frame_send(muggle_socket_t fd, const std::string &bytes)
+{
+	muggle_socket_send(fd, bytes.data(), bytes.size(), 0);
+	muggle_msleep(20);
+}
+
+TEST(socket_event, frame_recv)
+{
+	muggle_socket_peer_t listen_peer;
+	int port = test_socket_event_listen(&listen_peer);
+	ASSERT_GT(port, 0);
+
+	test_socket_event_frame_ctx *ctx = new test_socket_event_frame_ctx;
+	muggle_socket_event_init_arg_t ev_init_arg;
+	test_socket_event_frame_init_arg(&ev_init_arg, &listen_peer, ctx, 1024);
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+	std::thread t([&ev]{
+		muggle_socket_event_loop(&ev);
+	});
+
+	muggle_socket_t fd = test_socket_event_connect(port, 0);
+	ASSERT_NE(fd, MUGGLE_INVALID_SOCKET);
+	muggle_msleep(20);
+
+	// multiple frames in one read
+	test_socket_event_frame_send(fd,
+		test_socket_event_frame_pack("a") +
+		test_socket_event_frame_pack("bb") +
+		test_socket_event_frame_pack("ccc"));
+
+	// split header and body
+	std::string frame = test_socket_event_frame_pack("dddd");
+	test_socket_event_frame_send(fd, frame.substr(0, 2));
+	test_socket_event_frame_send(fd, frame.substr(2, 4));
+	test_socket_event_frame_send(fd, frame.substr(6));
+
+	// oversize length, peer closed
+	uint32_t oversize = htonl(4096);
+	test_socket_event_frame_send(fd, std::string((const char*)&oversize, sizeof(oversize)));
+
+	char buf[16];
+	ASSERT_EQ(muggle_socket_recv(fd, buf, sizeof(buf), 0), 0);
+
+	t.join();
+	muggle_socket_close(fd);
+
+	ASSERT_EQ(ctx->frames.size(), 4U);
+	ASSERT_EQ(ctx->frames[0], "a");
+	ASSERT_EQ(ctx->frames[1], "bb");
+	ASSERT_EQ(ctx->frames[2], "ccc");
+	ASSERT_EQ(ctx->frames[3], "dddd");
+	ASSERT_EQ(ctx->cnt_close, 1);
+
+	delete ctx;
+}
+
+TEST(socket_event, frame_recv_small_buffer)
+{
+	muggle_socket_peer_t listen_peer;
+	int port = test_socket_event_listen(&listen_peer);
+	ASSERT_GT(port, 0);
+
+	// receive buffer only hold a few frames, writer jump to head with
+	// short read and frames wrap around the end of buffer
+	test_socket_event_frame_ctx *ctx = new test_socket_event_frame_ctx;
+	muggle_socket_event_init_arg_t ev_init_arg;
+	test_socket_event_frame_init_arg(&ev_init_arg, &listen_peer, ctx, 64);
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+	std::thread t([&ev]{
+		muggle_socket_event_loop(&ev);
+	});
+
+	muggle_socket_t fd = test_socket_event_connect(port, 0);
+	ASSERT_NE(fd, MUGGLE_INVALID_SOCKET);
+
+	std::vector<std::string> bodies;
+	std::string bytes;
+	for (int i = 0; i < 500; i++)
+	{
+		bodies.push_back(std::string(1 + i % 40, (char)('a' + i % 26)));
+		bytes += test_socket_event_frame_pack(bodies.back());
+	}
+
+	size_t pos = 0;
+	int chunk = 1;
+	while (pos < bytes.size())
+	{
+		size_t n = std::min(bytes.size() - pos, (size_t)chunk);
+		ASSERT_EQ(muggle_socket_send(fd, bytes.data() + pos, n, MSG_NOSIGNAL), (int)n);
+		pos += n;
+		chunk = chunk % 97 + 13;
+		if (pos % 7 == 0)
+		{
+			muggle_msleep(1);
+		}
+	}
+
+	// frames received before closed by remote are still delivered
+	muggle_socket_close(fd);
+	t.join();
+
+	ASSERT_EQ(ctx->frames.size(), bodies.size());
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		ASSERT_EQ(ctx->frames[i], bodies[i]);
+	}
+	ASSERT_EQ(ctx->cnt_close, 1);
+
+	delete ctx;
+}
+
+#endif
+
+#if MUGGLE_PLATFORM_LINUX
+
+static int64_t test_socket_event_elapsed_ms(const std::chrono::steady_clock::time_point &since)
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - since).count();
+}
+
+struct test_socket_event_peer_timer_ctx
+{
+	int cnt_one_shot = 0;
+	int cnt_periodic = 0;
+	int cnt_closed_timer = 0;
+	int cnt_closed_timer_on_close = -1;
+	int64_t one_shot_elapsed_ms = 0;
+	std::chrono::steady_clock::time_point ts_connect;
+
+	muggle_socket_peer_timer_t *timer = NULL;
+	std::chrono::steady_clock::time_point ts_add;
+	std::vector<int64_t> elapsed_ms;
+};
+
+static void test_socket_event_peer_timer_one_shot(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *peer, struct muggle_socket_peer_timer *timer)
+{
+	(void)timer;
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	ctx->cnt_one_shot++;
+	ctx->one_shot_elapsed_ms = test_socket_event_elapsed_ms(ctx->ts_connect);
+
+	// timers of peer are canceled when peer closed
+	muggle_socket_peer_close(peer);
+}
+
+static void test_socket_event_peer_timer_periodic(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *peer, struct muggle_socket_peer_timer *timer)
+{
+	(void)peer;
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	ctx->cnt_periodic++;
+	if (ctx->cnt_periodic == 3)
+	{
+		muggle_socket_peer_timer_cancel(timer);
+	}
+}
+
+static void test_socket_event_peer_timer_closed(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *peer, struct muggle_socket_peer_timer *timer)
+{
+	(void)peer;
+	(void)timer;
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	ctx->cnt_closed_timer++;
+}
+
+static void test_socket_event_peer_timer_on_connect(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *listen_peer, struct muggle_socket_peer *peer)
+{
+	(void)listen_peer;
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	ctx->ts_connect = std::chrono::steady_clock::now();
+	muggle_socket_peer_timer_add(peer, 100, 0, test_socket_event_peer_timer_one_shot, NULL);
+	muggle_socket_peer_timer_add(peer, 10, 10, test_socket_event_peer_timer_periodic, NULL);
+	muggle_socket_peer_timer_add(peer, 5, 5, test_socket_event_peer_timer_closed, NULL);
+}
+
+static void test_socket_event_peer_timer_on_close(struct muggle_socket_event *ev, struct muggle_socket_peer *peer)
+{
+	if (peer->peer_type != MUGGLE_SOCKET_PEER_TYPE_TCP_PEER)
+	{
+		return;
+	}
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	if (ctx->cnt_closed_timer_on_close < 0)
+	{
+		ctx->cnt_closed_timer_on_close = ctx->cnt_closed_timer;
+	}
+}
+
+static void test_socket_event_peer_timer_on_timer(struct muggle_socket_event *ev)
+{
+	// loop keep running for a while after peer closed
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	if (ctx->cnt_closed_timer_on_close >= 0)
+	{
+		muggle_socket_event_loop_exit(ev);
+	}
+}
+
+TEST(socket_event, peer_timer)
+{
+	muggle_socket_peer_t listen_peer;
+	int port = test_socket_event_listen(&listen_peer);
+	ASSERT_GT(port, 0);
+
+	test_socket_event_peer_timer_ctx *ctx = new test_socket_event_peer_timer_ctx;
+	muggle_socket_event_init_arg_t ev_init_arg;
+	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+	ev_init_arg.ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL;
+	ev_init_arg.hints_max_peer = 64;
+	ev_init_arg.cnt_peer = 1;
+	ev_init_arg.peers = &listen_peer;
+	ev_init_arg.timeout_ms = 100;
+	ev_init_arg.datas = ctx;
+	ev_init_arg.on_connect = test_socket_event_peer_timer_on_connect;
+	ev_init_arg.on_close = test_socket_event_peer_timer_on_close;
+	ev_init_arg.on_timer = test_socket_event_peer_timer_on_timer;
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+	std::thread t([&ev]{
+		muggle_socket_event_loop(&ev);
+	});
+
+	muggle_socket_t fd = test_socket_event_connect(port, 0);
+	ASSERT_NE(fd, MUGGLE_INVALID_SOCKET);
+
+	t.join();
+	muggle_socket_close(fd);
+
+	// add
+	ASSERT_EQ(ctx->cnt_one_shot, 1);
+	ASSERT_GE(ctx->one_shot_elapsed_ms, 90);
+
+	// cancel in callback
+	ASSERT_EQ(ctx->cnt_periodic, 3);
+
+	// canceled when peer closed
+	ASSERT_GT(ctx->cnt_closed_timer, 0);
+	ASSERT_EQ(ctx->cnt_closed_timer, ctx->cnt_closed_timer_on_close);
+
+	delete ctx;
+}
+
+static void test_socket_event_peer_timer_reset_cb(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *peer, struct muggle_socket_peer_timer *timer)
+{
+	(void)peer;
+	(void)timer;
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	ctx->elapsed_ms.push_back(test_socket_event_elapsed_ms(ctx->ts_add));
+	if (ctx->elapsed_ms.size() == 2)
+	{
+		muggle_socket_event_loop_exit(ev);
+	}
+}
+
+static void test_socket_event_peer_timer_reset_on_connect(
+	struct muggle_socket_event *ev, struct muggle_socket_peer *listen_peer, struct muggle_socket_peer *peer)
+{
+	(void)listen_peer;
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	ctx->ts_add = std::chrono::steady_clock::now();
+	ctx->timer = muggle_socket_peer_timer_add(peer, 100, 0, test_socket_event_peer_timer_reset_cb, NULL);
+}
+
+static void test_socket_event_peer_timer_reset_on_message(struct muggle_socket_event *ev, struct muggle_socket_peer *peer)
+{
+	char buf[16];
+	while (muggle_socket_peer_recv(peer, buf, sizeof(buf), 0) > 0);
+
+	test_socket_event_peer_timer_ctx *ctx = (test_socket_event_peer_timer_ctx*)ev->datas;
+	ctx->ts_add = std::chrono::steady_clock::now();
+	muggle_socket_peer_timer_reset(ctx->timer, 100);
+}
+
+TEST(socket_event, peer_timer_reset_after_long_wait)
+{
+	muggle_socket_peer_t listen_peer;
+	int port = test_socket_event_listen(&listen_peer);
+	ASSERT_GT(port, 0);
+
+	// loop block in wait for a long time, timer added or reset in
+	// callbacks still expire after delay since now
+	test_socket_event_peer_timer_ctx *ctx = new test_socket_event_peer_timer_ctx;
+	muggle_socket_event_init_arg_t ev_init_arg;
+	memset(&ev_init_arg, 0, sizeof(ev_init_arg));
+	ev_init_arg.ev_loop_type = MUGGLE_SOCKET_EVENT_LOOP_TYPE_EPOLL;
+	ev_init_arg.hints_max_peer = 64;
+	ev_init_arg.cnt_peer = 1;
+	ev_init_arg.peers = &listen_peer;
+	ev_init_arg.timeout_ms = 10000;
+	ev_init_arg.datas = ctx;
+	ev_init_arg.on_connect = test_socket_event_peer_timer_reset_on_connect;
+	ev_init_arg.on_message = test_socket_event_peer_timer_reset_on_message;
+	ev_init_arg.on_timer = test_socket_event_on_exit_timer;
+
+	muggle_socket_event_t ev;
+	ASSERT_EQ(muggle_socket_event_init(&ev_init_arg, &ev), 0);
+	std::thread t([&ev]{
+		muggle_socket_event_loop(&ev);
+	});
+
+	muggle_msleep(300);
+	muggle_socket_t fd = test_socket_event_connect(port, 0);
+	ASSERT_NE(fd, MUGGLE_INVALID_SOCKET);
+
+	muggle_msleep(400);
+	ASSERT_EQ(muggle_socket_send(fd, "x", 1, 0), 1);
+
+	t.join();
+	muggle_socket_close(fd);
+
+	ASSERT_EQ(ctx->elapsed_ms.size(), 2U);
+	ASSERT_GE(ctx->elapsed_ms[0], 90);
+	ASSERT_GE(ctx->elapsed_ms[1], 90);
+
+	delete ctx;
+}
+
+#endif
@@ -0,0 +1,223 @@
+#include <vector>
+#include <set>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+struct tc_data
+{
+	int idx;
+	int thread_idx;
+};
+
+TEST(tc_memory_pool, init)
+{
+	muggle_tc_memory_pool_t pool;
+	EXPECT_EQ(muggle_tc_memory_pool_init(&pool, 0, sizeof(tc_data), 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_tc_memory_pool_init(&pool, 8, 0, 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_tc_memory_pool_init(&pool, 8, sizeof(tc_data), -1), MUGGLE_ERR_INVALID_PARAM);
+
+	ASSERT_EQ(muggle_tc_memory_pool_init(&pool, 100, sizeof(tc_data), 0), MUGGLE_OK);
+	EXPECT_EQ(pool.capacity, 100);
+	EXPECT_EQ(pool.batch_size, 64);
+	EXPECT_EQ(pool.block_size % MUGGLE_CACHE_LINE_SIZE, 0);
+	muggle_tc_memory_pool_destroy(&pool);
+}
+
+TEST(tc_memory_pool, single_thread)
+{
+	const int capacity = 10;
+	muggle_tc_memory_pool_t pool;
+	ASSERT_EQ(muggle_tc_memory_pool_init(&pool, capacity, sizeof(tc_data), 4), MUGGLE_OK);
+
+	muggle_tc_memory_pool_cache_t cache;
+	muggle_tc_memory_pool_cache_init(&cache, &pool);
+
+	for (int round = 0; round < 3; round++)
+	{
+		std::set<void*> ptrs;
+		for (int i = 0; i < capacity; i++)
+		{
+			void *p = muggle_tc_memory_pool_alloc(&cache);
+			ASSERT_TRUE(p != NULL);
+			ptrs.insert(p);
+		}
+		ASSERT_EQ((int)ptrs.size(), capacity);
+		ASSERT_TRUE(muggle_tc_memory_pool_alloc(&cache) == NULL);
+
+		for (void *p : ptrs)
+		{
+			muggle_tc_memory_pool_free(&cache, p);
+		}
+	}
+
+	// alloc and free in cache never touch global depot
+	muggle_tc_memory_pool_cache_destroy(&cache);
+	muggle_tc_memory_pool_cache_init(&cache, &pool);
+	for (int i = 0; i < 100; i++)
+	{
+		void *p = muggle_tc_memory_pool_alloc(&cache);
+		ASSERT_TRUE(p != NULL);
+		muggle_tc_memory_pool_free(&cache, p);
+	}
+	EXPECT_EQ(cache.cnt_alloc, 100);
+	EXPECT_EQ(cache.cnt_free, 100);
+	EXPECT_EQ(cache.cnt_refill, 1);
+	EXPECT_EQ(cache.cnt_alloc_hit, 99);
+	EXPECT_EQ(cache.cnt_free_hit, 100);
+	EXPECT_EQ(cache.cnt_flush, 0);
+
+	muggle_tc_memory_pool_cache_destroy(&cache);
+	muggle_tc_memory_pool_destroy(&pool);
+}
+
+TEST(tc_memory_pool, flush_refill)
+{
+	const int capacity = 64;
+	muggle_tc_memory_pool_t pool;
+	ASSERT_EQ(muggle_tc_memory_pool_init(&pool, capacity, sizeof(tc_data), 4), MUGGLE_OK);
+
+	muggle_tc_memory_pool_cache_t alloc_cache, free_cache;
+	muggle_tc_memory_pool_cache_init(&alloc_cache, &pool);
+	muggle_tc_memory_pool_cache_init(&free_cache, &pool);
+
+	// alloc in one cache and free in another cache, blocks flow through depot
+	for (int round = 0; round < 10; round++)
+	{
+		std::vector<void*> ptrs;
+		void *p = NULL;
+		while ((p = muggle_tc_memory_pool_alloc(&alloc_cache)) != NULL)
+		{
+			ptrs.push_back(p);
+		}
+		ASSERT_GE((int)ptrs.size(), capacity - 2 * 4);
+
+		for (void *p : ptrs)
+		{
+			muggle_tc_memory_pool_free(&free_cache, p);
+		}
+		ASSERT_LE(free_cache.loaded_cnt + free_cache.prev_cnt, 2 * 4);
+	}
+	EXPECT_GT(alloc_cache.cnt_refill, 0);
+	EXPECT_GT(free_cache.cnt_flush, 0);
+
+	muggle_tc_memory_pool_cache_destroy(&alloc_cache);
+	muggle_tc_memory_pool_cache_destroy(&free_cache);
+
+	// all blocks back to depot
+	muggle_tc_memory_pool_cache_t cache;
+	muggle_tc_memory_pool_cache_init(&cache, &pool);
+	std::set<void*> ptrs;
+	void *p = NULL;
+	while ((p = muggle_tc_memory_pool_alloc(&cache)) != NULL)
+	{
+		ptrs.insert(p);
+	}
+	EXPECT_EQ((int)ptrs.size(), capacity);
+	for (void *p : ptrs)
+	{
+		muggle_tc_memory_pool_free(&cache, p);
+	}
+	muggle_tc_memory_pool_cache_destroy(&cache);
+
+	muggle_tc_memory_pool_destroy(&pool);
+}
+
+TEST(tc_memory_pool, mul_thread)
+{
+	const int capacity = 1024 * 16;
+	const int cnt_loop = 20000;
+	muggle_tc_memory_pool_t pool;
+	ASSERT_EQ(muggle_tc_memory_pool_init(&pool, capacity, sizeof(tc_data), 16), MUGGLE_OK);
+
+	int hc = (int)std::thread::hardware_concurrency() * 2;
+	if (hc < 4)
+	{
+		hc = 4;
+	}
+
+	// every thread allocate data and pass it to next thread to free
+	muggle_channel_t *chans = (muggle_channel_t*)malloc(sizeof(muggle_channel_t) * hc);
+	for (int i = 0; i < hc; i++)
+	{
+		ASSERT_EQ(muggle_channel_init(&chans[i], 256, 0), MUGGLE_OK);
+	}
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < hc; i++)
+	{
+		int thread_idx = i;
+		threads.push_back(std::thread([&, thread_idx] {
+			muggle_tc_memory_pool_cache_t cache;
+			muggle_tc_memory_pool_cache_init(&cache, &pool);
+
+			muggle_channel_t *out_chan = &chans[(thread_idx + 1) % hc];
+			muggle_channel_t *in_chan = &chans[thread_idx];
+			int cnt_recv = 0;
+			for (int j = 0; j < cnt_loop; j++)
+			{
+				tc_data *p = NULL;
+				while ((p = (tc_data*)muggle_tc_memory_pool_alloc(&cache)) == NULL)
+				{
+					std::this_thread::yield();
+				}
+				p->idx = j;
+				p->thread_idx = thread_idx;
+
+				// drain input when output is full, avoid all threads wait each other
+				void *data = NULL;
+				bool written = false;
+				while (!written)
+				{
+					written = muggle_channel_write(out_chan, p) == MUGGLE_OK;
+					while (muggle_channel_try_read(in_chan, &data) == MUGGLE_OK)
+					{
+						tc_data *d = (tc_data*)data;
+						ASSERT_EQ(d->thread_idx, (thread_idx + hc - 1) % hc);
+						ASSERT_EQ(d->idx, cnt_recv);
+						cnt_recv++;
+						muggle_tc_memory_pool_free(&cache, d);
+					}
+					if (!written)
+					{
+						std::this_thread::yield();
+					}
+				}
+			}
+			while (cnt_recv < cnt_loop)
+			{
+				tc_data *d = (tc_data*)muggle_channel_read(in_chan);
+				ASSERT_EQ(d->idx, cnt_recv);
+				cnt_recv++;
+				muggle_tc_memory_pool_free(&cache, d);
+			}
+
+			muggle_tc_memory_pool_cache_destroy(&cache);
+		}));
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	for (int i = 0; i < hc; i++)
+	{
+		muggle_channel_destroy(&chans[i]);
+	}
+	free(chans);
+
+	// no block lost or duplicated
+	muggle_tc_memory_pool_cache_t cache;
+	muggle_tc_memory_pool_cache_init(&cache, &pool);
+	std::set<void*> ptrs;
+	void *p = NULL;
+	while ((p = muggle_tc_memory_pool_alloc(&cache)) != NULL)
+	{
+		ptrs.insert(p);
+	}
+	EXPECT_EQ((int)ptrs.size(), capacity);
+	EXPECT_EQ((int)cache.cnt_alloc, capacity + 1);
+	muggle_tc_memory_pool_cache_destroy(&cache);
+
+	muggle_tc_memory_pool_destroy(&pool);
+}
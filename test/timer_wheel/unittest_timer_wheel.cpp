@@ -0,0 +1,251 @@
+#include <vector>
+#include <random>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+struct test_timer
+{
+	muggle_timer_wheel_timer_t timer;
+	uint64_t expect_ms;
+	uint64_t fired_ms;
+	int      cnt_fired;
+};
+
+static uint64_t s_now_ms = 0;
+
+static void test_timer_on_expire(muggle_timer_wheel_t *, muggle_timer_wheel_timer_t *timer)
+{
+	struct test_timer *t = (struct test_timer*)timer->data;
+	t->fired_ms = s_now_ms;
+	t->cnt_fired++;
+}
+
+static void test_timer_cancel_self(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	struct test_timer *t = (struct test_timer*)timer->data;
+	t->cnt_fired++;
+	if (t->cnt_fired == 3)
+	{
+		muggle_timer_wheel_cancel(wheel, timer);
+	}
+}
+
+static void test_timer_add(muggle_timer_wheel_t *wheel, struct test_timer *t,
+	uint64_t delay_ms, muggle_timer_wheel_cb cb)
+{
+	muggle_timer_wheel_timer_init(&t->timer, cb, t);
+	t->expect_ms = s_now_ms + delay_ms;
+	t->fired_ms = 0;
+	t->cnt_fired = 0;
+	muggle_timer_wheel_add(wheel, &t->timer, delay_ms, 0);
+}
+
+TEST(timer_wheel, one_shot)
+{
+	muggle_timer_wheel_t wheel;
+	s_now_ms = 1000;
+	muggle_timer_wheel_init(&wheel, 1, s_now_ms);
+
+	struct test_timer t;
+	test_timer_add(&wheel, &t, 10, test_timer_on_expire);
+	EXPECT_TRUE(muggle_timer_wheel_is_pending(&t.timer));
+	EXPECT_EQ(muggle_timer_wheel_next_timeout(&wheel, s_now_ms), 10);
+
+	s_now_ms = 1009;
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), 0);
+	EXPECT_EQ(muggle_timer_wheel_next_timeout(&wheel, s_now_ms), 1);
+
+	s_now_ms = 1010;
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), 1);
+	EXPECT_EQ(t.cnt_fired, 1);
+	EXPECT_EQ(t.fired_ms, 1010);
+	EXPECT_FALSE(muggle_timer_wheel_is_pending(&t.timer));
+	EXPECT_EQ(muggle_timer_wheel_next_timeout(&wheel, s_now_ms), -1);
+
+	// zero delay expire in next tick
+	test_timer_add(&wheel, &t, 0, test_timer_on_expire);
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), 0);
+	s_now_ms++;
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), 1);
+}
+
+TEST(timer_wheel, cancel)
+{
+	muggle_timer_wheel_t wheel;
+	s_now_ms = 0;
+	muggle_timer_wheel_init(&wheel, 1, s_now_ms);
+
+	std::vector<struct test_timer> timers(1000);
+	for (size_t i = 0; i < timers.size(); i++)
+	{
+		test_timer_add(&wheel, &timers[i], 1 + i * 37, test_timer_on_expire);
+	}
+	EXPECT_EQ(wheel.cnt, timers.size());
+
+	for (size_t i = 0; i < timers.size(); i += 2)
+	{
+		muggle_timer_wheel_cancel(&wheel, &timers[i].timer);
+		muggle_timer_wheel_cancel(&wheel, &timers[i].timer);
+	}
+	EXPECT_EQ(wheel.cnt, timers.size() / 2);
+
+	s_now_ms = 1000 * 37 + 1;
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), (int)timers.size() / 2);
+	for (size_t i = 0; i < timers.size(); i++)
+	{
+		EXPECT_EQ(timers[i].cnt_fired, i % 2 == 0 ? 0 : 1);
+	}
+	EXPECT_EQ(wheel.cnt, 0);
+	for (int i = 0; i < MUGGLE_TIMER_WHEEL_LEVELS; i++)
+	{
+		EXPECT_EQ(wheel.bitmap[i], 0);
+	}
+}
+
+TEST(timer_wheel, periodic)
+{
+	muggle_timer_wheel_t wheel;
+	s_now_ms = 0;
+	muggle_timer_wheel_init(&wheel, 1, s_now_ms);
+
+	struct test_timer t1, t2;
+	muggle_timer_wheel_timer_init(&t1.timer, test_timer_on_expire, &t1);
+	t1.cnt_fired = 0;
+	muggle_timer_wheel_add(&wheel, &t1.timer, 100, 100);
+
+	muggle_timer_wheel_timer_init(&t2.timer, test_timer_cancel_self, &t2);
+	t2.cnt_fired = 0;
+	muggle_timer_wheel_add(&wheel, &t2.timer, 10, 10);
+
+	for (s_now_ms = 1; s_now_ms <= 1000; s_now_ms++)
+	{
+		muggle_timer_wheel_advance(&wheel, s_now_ms);
+		if (s_now_ms % 100 == 0)
+		{
+			EXPECT_EQ(t1.cnt_fired, (int)(s_now_ms / 100));
+			EXPECT_EQ(t1.fired_ms, s_now_ms);
+		}
+	}
+	EXPECT_EQ(t1.cnt_fired, 10);
+	EXPECT_EQ(t2.cnt_fired, 3);
+	EXPECT_TRUE(muggle_timer_wheel_is_pending(&t1.timer));
+	EXPECT_FALSE(muggle_timer_wheel_is_pending(&t2.timer));
+}
+
+static int s_cnt_free_self = 0;
+
+static void test_timer_free_self(muggle_timer_wheel_t *wheel, muggle_timer_wheel_timer_t *timer)
+{
+	// periodic timer must be canceled before freed
+	if (timer->interval > 0)
+	{
+		muggle_timer_wheel_cancel(wheel, timer);
+	}
+	free(timer);
+	s_cnt_free_self++;
+}
+
+TEST(timer_wheel, free_in_callback)
+{
+	muggle_timer_wheel_t wheel;
+	s_now_ms = 0;
+	s_cnt_free_self = 0;
+	muggle_timer_wheel_init(&wheel, 1, s_now_ms);
+
+	for (int i = 0; i < 16; i++)
+	{
+		muggle_timer_wheel_timer_t *timer =
+			(muggle_timer_wheel_timer_t*)malloc(sizeof(muggle_timer_wheel_timer_t));
+		ASSERT_TRUE(timer != NULL);
+		muggle_timer_wheel_timer_init(timer, test_timer_free_self, NULL);
+		muggle_timer_wheel_add(&wheel, timer, 10 + i % 4, i % 2 ? 10 : 0);
+	}
+
+	for (s_now_ms = 1; s_now_ms <= 100; s_now_ms++)
+	{
+		muggle_timer_wheel_advance(&wheel, s_now_ms);
+	}
+	EXPECT_EQ(s_cnt_free_self, 16);
+	EXPECT_EQ(wheel.cnt, 0U);
+	EXPECT_EQ(muggle_timer_wheel_next_timeout(&wheel, s_now_ms), -1);
+}
+
+TEST(timer_wheel, tick)
+{
+	muggle_timer_wheel_t wheel;
+	s_now_ms = 1005;
+	muggle_timer_wheel_init(&wheel, 10, s_now_ms);
+
+	// current tick is 100, expire at tick 103
+	struct test_timer t;
+	test_timer_add(&wheel, &t, 25, test_timer_on_expire);
+	EXPECT_EQ(muggle_timer_wheel_next_timeout(&wheel, s_now_ms), 25);
+
+	s_now_ms = 1029;
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), 0);
+	s_now_ms = 1030;
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), 1);
+}
+
+TEST(timer_wheel, random)
+{
+	muggle_timer_wheel_t wheel;
+	s_now_ms = 123456789;
+	muggle_timer_wheel_init(&wheel, 1, s_now_ms);
+
+	std::mt19937_64 rng(0);
+	std::vector<struct test_timer> timers(10000);
+	for (size_t i = 0; i < timers.size(); i++)
+	{
+		// cover all levels
+		uint64_t max_delay = (uint64_t)1 << (MUGGLE_TIMER_WHEEL_BITS * (1 + i % 4));
+		test_timer_add(&wheel, &timers[i], 1 + rng() % max_delay, test_timer_on_expire);
+	}
+
+	// drive wheel like event loop, wait next timeout or random time
+	size_t cnt_fired = 0;
+	while (cnt_fired < timers.size())
+	{
+		int64_t timeout = muggle_timer_wheel_next_timeout(&wheel, s_now_ms);
+		ASSERT_GE(timeout, 0);
+
+		uint64_t step = (uint64_t)timeout;
+		if (rng() % 2)
+		{
+			step = rng() % (step + 1);
+		}
+		s_now_ms += step;
+		cnt_fired += (size_t)muggle_timer_wheel_advance(&wheel, s_now_ms);
+	}
+	EXPECT_EQ(muggle_timer_wheel_next_timeout(&wheel, s_now_ms), -1);
+
+	for (size_t i = 0; i < timers.size(); i++)
+	{
+		ASSERT_EQ(timers[i].cnt_fired, 1);
+		ASSERT_EQ(timers[i].fired_ms, timers[i].expect_ms);
+	}
+}
+
+TEST(timer_wheel, long_jump)
+{
+	muggle_timer_wheel_t wheel;
+	s_now_ms = 0;
+	muggle_timer_wheel_init(&wheel, 1, s_now_ms);
+
+	struct test_timer near_timer, far_timer;
+	test_timer_add(&wheel, &near_timer, 5, test_timer_on_expire);
+	test_timer_add(&wheel, &far_timer, ((uint64_t)1 << 31) + 7, test_timer_on_expire);
+
+	s_now_ms = 1000000;
+	EXPECT_EQ(muggle_timer_wheel_advance(&wheel, s_now_ms), 1);
+	EXPECT_EQ(near_timer.cnt_fired, 1);
+
+	while (far_timer.cnt_fired == 0)
+	{
+		int64_t timeout = muggle_timer_wheel_next_timeout(&wheel, s_now_ms);
+		ASSERT_GT(timeout, 0);
+		s_now_ms += (uint64_t)timeout;
+		muggle_timer_wheel_advance(&wheel, s_now_ms);
+	}
+	EXPECT_EQ(far_timer.fired_ms, far_timer.expect_ms);
+}
@@ -0,0 +1,89 @@
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(wait_strategy, init)
+{
+	muggle_wait_strategy_t ws;
+	EXPECT_EQ(muggle_wait_strategy_init(&ws, -1, 0, 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_wait_strategy_init(&ws, 0, -1, 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_wait_strategy_init(&ws, 64, 4, 0), MUGGLE_OK);
+	EXPECT_EQ(ws.spin, 64);
+	EXPECT_EQ(ws.yield, 4);
+	EXPECT_EQ(ws.adaptive_spin, 64);
+}
+
+TEST(wait_strategy, spin)
+{
+	muggle_wait_strategy_t ws;
+	muggle_atomic_int x = 0;
+
+	muggle_wait_strategy_init(&ws, 64, 4, 0);
+	EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 1), 1);
+	EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 0), 0);
+
+	muggle_wait_strategy_init(&ws, 0, 0, 0);
+	EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 1), 1);
+	EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 0), 0);
+}
+
+TEST(wait_strategy, adaptive)
+{
+	muggle_wait_strategy_t ws;
+	muggle_atomic_int x = 0;
+
+	// always need park, spin decrease to lower limit
+	muggle_wait_strategy_init(&ws, 1024, 0, MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE);
+	for (int i = 0; i < 1024; i++)
+	{
+		EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 0), 0);
+	}
+	EXPECT_EQ(ws.adaptive_spin, 1024 / MUGGLE_WAIT_STRATEGY_ADAPTIVE_MIN_SPIN_DIV);
+
+	muggle_wait_strategy_init(&ws, 8, 0, MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE);
+	for (int i = 0; i < 64; i++)
+	{
+		EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 0), 0);
+	}
+	EXPECT_EQ(ws.adaptive_spin, 1);
+
+	// change observed in yield, spin increase
+	muggle_wait_strategy_init(&ws, 1024, 1, MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE);
+	ws.adaptive_spin = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 1), 1);
+	}
+	EXPECT_EQ(ws.adaptive_spin, 0);
+
+	std::thread t([&x]{
+		muggle_msleep(5);
+		muggle_atomic_store(&x, 1, muggle_memory_order_relaxed);
+	});
+	muggle_wait_strategy_init(&ws, 1024, 1000000, MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE);
+	ws.adaptive_spin = 0;
+	EXPECT_EQ(muggle_wait_strategy_spin(&ws, &x, 0), 1);
+	EXPECT_GT(ws.adaptive_spin, 0);
+	EXPECT_LE(ws.adaptive_spin, 1024);
+	t.join();
+}
+
+TEST(wait_strategy, wait)
+{
+	muggle_wait_strategy_t ws;
+	muggle_atomic_int x = 0;
+
+	muggle_wait_strategy_init(&ws, 128, 4, MUGGLE_WAIT_STRATEGY_FLAG_ADAPTIVE);
+	std::thread t([&x]{
+		muggle_msleep(5);
+		muggle_atomic_store(&x, 1, muggle_memory_order_relaxed);
+		muggle_futex_wake_all(&x);
+	});
+	while (muggle_atomic_load(&x, muggle_memory_order_acquire) == 0)
+	{
+		muggle_wait_strategy_wait(&ws, &x, 0, NULL);
+	}
+	t.join();
+
+	EXPECT_EQ(x, 1);
+}